@@ -89,6 +89,7 @@ PATH=/afs/cern.ch/work/r/rovere/protocolbuf/bin
 #include <mutex>
 #include <list>
 #include "DQMServices/Core/src/ROOTFilePB.pb.h"
+#include "DQMServices/Core/interface/DQMSnapshot.h"
 #include <google/protobuf/io/coded_stream.h>
 #include <google/protobuf/io/gzip_stream.h>
 #include <google/protobuf/io/zero_copy_stream_impl.h>
@@ -303,9 +304,60 @@ int encodeFile(const std::string &output_filename,
   return 0;
 }
 
+/** Write @a obj into directory @a path of the current file, creating
+the intermediate directories as needed. */
+void writeToDirectory(const std::string &path, TObject *obj) {
+  gDirectory->cd("/");
+  // Find the first path component.
+  size_t start = 0;
+  size_t end = path.find('/', start);
+  if (end == std::string::npos)
+  end = path.size();
+  while (true)
+  {
+    std::string part(path, start, end-start);
+    if (! gDirectory->Get(part.c_str()))
+      gDirectory->mkdir(part.c_str());
+    gDirectory->cd(part.c_str());
+    // Stop if we reached the end, ignoring any trailing '/'.
+    if (end+1 >= path.size())
+      break;
+    // Find the next path component.
+    start = end+1;
+    end = path.find('/', start);
+    if (end == std::string::npos)
+      end = path.size();
+  }
+  obj->Write();
+  DEBUG(1, obj->GetName() << std::endl);
+}
+
+int convertSnapshot(const std::string &output_filename,
+                    const std::string &input_filename) {
+  TFile output(output_filename.c_str(), "RECREATE");
+  DEBUG(0, "Converting snapshot " << input_filename << std::endl);
+
+  DQMSnapshotReader reader(input_filename);
+  std::string fullpath;
+  uint32_t flags;
+  TObject *obj = nullptr;
+  while (reader.read(fullpath, flags, &obj)) {
+    DEBUG(1, fullpath << std::endl);
+    size_t slash = fullpath.rfind('/');
+    std::string path(fullpath, 0, slash == std::string::npos ? 0 : slash);
+    writeToDirectory(path, obj);
+    delete obj;
+  }
+  output.Close();
+  return 0;
+}
+
 int convertFile(const std::string &output_filename,
                 const std::vector<std::string> &filenames) {
   assert(filenames.size() == 1);
+  if (DQMSnapshotReader::isSnapshot(filenames[0]))
+    return convertSnapshot(output_filename, filenames[0]);
+
   TFile output(output_filename.c_str(), "RECREATE");
   DEBUG(0, "Converting file " << filenames[0] << std::endl);
   dqmstorepb::ROOTFilePB dqmstore_message;
@@ -333,29 +385,7 @@ int convertFile(const std::string &output_filename,
     TObject *obj = extractNextObject(buf);
     std::string path,objname;
     get_info(h, path, objname, &obj);
-    gDirectory->cd("/");
-    // Find the first path component.
-    size_t start = 0;
-    size_t end = path.find('/', start);
-    if (end == std::string::npos)
-    end = path.size();
-    while (true)
-    {
-      std::string part(path, start, end-start);
-      if (! gDirectory->Get(part.c_str()))
-        gDirectory->mkdir(part.c_str());
-      gDirectory->cd(part.c_str());
-      // Stop if we reached the end, ignoring any trailing '/'.
-      if (end+1 >= path.size())
-        break;
-      // Find the next path component.
-      start = end+1;
-      end = path.find('/', start);
-      if (end == std::string::npos)
-        end = path.size();
-    }
-    obj->Write();
-    DEBUG(1, obj->GetName() << std::endl);
+    writeToDirectory(path, obj);
   }
   output.Close();
   return 0;
@@ -560,7 +590,7 @@ showusage(void)
   std::cerr << "Usage: " << app_name
             << " [--[no-]debug] TASK OPTIONS\n\n  "
             << app_name << " [OPTIONS] add [-j NUM_THREADS] -o OUTPUT_FILE [DAT FILE...]\n  "
-            << app_name << " [OPTIONS] convert -o ROOT_FILE DAT_FILE\n  "
+            << app_name << " [OPTIONS] convert -o ROOT_FILE DAT_FILE|SNAPSHOT_FILE\n  "
             << app_name << " [OPTIONS] encode -o DAT_FILE ROOT_FILE\n  "
             << app_name << " [OPTIONS] dump [DAT FILE...]\n  ";
   return ERR_BADCFG;
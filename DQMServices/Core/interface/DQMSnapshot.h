@@ -0,0 +1,85 @@
+#ifndef DQMSERVICES_CORE_DQM_SNAPSHOT_H
+# define DQMSERVICES_CORE_DQM_SNAPSHOT_H
+
+/** Compact binary snapshot of DQM monitor elements.
+
+    A snapshot file starts with an eight byte header ("DQMS", format
+    version, compression flag) followed by one record per object: the
+    full path name, the DQMNet flags and the object type, then for
+    strings their value and for histograms their layout (title,
+    minimum and maximum, axes with their labels, profile range and
+    error option) and their raw arrays: bin contents, sum of squares
+    of weights, profile bin entries, and statistics.  The arrays are
+    copied as they are in memory, in the byte order of the host, so
+    writing and reading a snapshot does not go through the ROOT
+    streamers.  The records are encoded with the protocol buffer
+    coded streams, gzip compressed (fast) unless disabled.
+
+    Only the histogram classes a MonitorElement can hold and
+    TObjString are supported; drawing attributes are not stored.
+    Quality reports are stored as TObjString records named after the
+    monitor element and the quality test, with the value written by
+    MonitorElement::qualityTagString(), as in the ROOT files.
+
+    Each record is decoded with its own coded stream, so that the
+    protocol buffer limit on the bytes read by a coded stream applies
+    to a single record rather than to the whole file. */
+
+# include <memory>
+# include <string>
+# include <stdint.h>
+
+namespace google { namespace protobuf { namespace io {
+  class ZeroCopyInputStream;
+  class FileInputStream; class FileOutputStream;
+  class GzipInputStream; class GzipOutputStream;
+  class CodedInputStream; class CodedOutputStream;
+}}}
+
+class TObject;
+
+class DQMSnapshotWriter
+{
+public:
+  DQMSnapshotWriter(const std::string &filename, bool compress = true);
+  ~DQMSnapshotWriter(void);
+
+  void write(const std::string &fullpath, uint32_t flags, TObject *obj);
+  void close(void);
+
+private:
+  DQMSnapshotWriter(const DQMSnapshotWriter &) = delete;
+  DQMSnapshotWriter &operator=(const DQMSnapshotWriter &) = delete;
+
+  std::string filename_;
+  int fd_;
+  std::unique_ptr<google::protobuf::io::FileOutputStream> file_;
+  std::unique_ptr<google::protobuf::io::GzipOutputStream> gzip_;
+  std::unique_ptr<google::protobuf::io::CodedOutputStream> coded_;
+};
+
+class DQMSnapshotReader
+{
+public:
+  explicit DQMSnapshotReader(const std::string &filename);
+  ~DQMSnapshotReader(void);
+
+  /** Read the next record.  Returns false at the end of the file,
+      otherwise fills @a fullpath and @a flags and returns in @a obj a
+      new object, not attached to any directory, owned by the caller. */
+  bool read(std::string &fullpath, uint32_t &flags, TObject **obj);
+
+  static bool isSnapshot(const std::string &filename);
+
+private:
+  DQMSnapshotReader(const DQMSnapshotReader &) = delete;
+  DQMSnapshotReader &operator=(const DQMSnapshotReader &) = delete;
+
+  std::string filename_;
+  int fd_;
+  std::unique_ptr<google::protobuf::io::FileInputStream> file_;
+  std::unique_ptr<google::protobuf::io::GzipInputStream> gzip_;
+  google::protobuf::io::ZeroCopyInputStream *input_;
+};
+
+#endif // DQMSERVICES_CORE_DQM_SNAPSHOT_H
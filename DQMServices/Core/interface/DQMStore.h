@@ -15,6 +15,7 @@
 # include <cassert>
 # include <mutex>
 # include <thread>
+# include <tuple>
 # include <execinfo.h>
 # include <stdio.h>
 # include <stdlib.h>
@@ -539,6 +540,12 @@ class DQMStore
 				       const uint32_t run = 0,
 				       const uint32_t lumi = 0,
 				       const bool resetMEsAfterWriting = false);
+  void                          saveSnapshot(const std::string &filename,
+                                             const std::string &path = "",
+                                             const uint32_t run = 0,
+                                             const uint32_t lumi = 0,
+                                             const bool resetMEsAfterWriting = false,
+                                             const bool compress = true);
   void                          save(const std::string &filename,
                                      const std::string &path = "",
                                      const std::string &pattern = "",
@@ -591,6 +598,12 @@ class DQMStore
                                            const std::string &prepend = "",
                                            OpenRunDirs stripdirs = StripRunDirs,
                                            bool fileMustExist = true);
+  bool                          readFileSnapshot(const std::string &filename,
+                                                 bool fileMustExist = true);
+  void                          importObject(TObject *obj,
+                                             const std::string &path,
+                                             const std::string &objname,
+                                             uint32_t flags);
   bool                          readFile(const std::string &filename,
                                          bool overwrite = false,
                                          const std::string &path ="",
@@ -635,6 +648,16 @@ class DQMStore
 
   void deleteUnusedLumiHistograms(uint32_t run, uint32_t lumi);
  private:
+  std::vector<MonitorElement *> & localMEs(uint32_t run,
+                                           uint32_t streamId,
+                                           uint32_t moduleId);
+  void indexLocalME(MonitorElement *me);
+  void mergeLocalMEs(uint32_t run,
+                     uint32_t lumi,
+                     uint32_t streamId,
+                     uint32_t moduleId,
+                     bool lumiMEs,
+                     const char *context);
 
   // ---------------- Miscellaneous -----------------------------
   void        initializeFrom(const edm::ParameterSet&);
@@ -696,6 +719,16 @@ class DQMStore
   typedef std::map<std::string, QCriterion *>                           QCMap;
   typedef std::map<std::string, QCriterion *(*)(const std::string &)>   QAMap;
 
+  // Multithread merging: local MEs of each (run, stream, module), and
+  // the global MEs they were last merged into, per (run, module).
+  struct MergeCache {
+    std::vector<MonitorElement *> globals;
+    std::vector<uint32_t>         lumis;
+  };
+  typedef std::tuple<uint32_t, uint32_t, uint32_t>                      LocalMEKey;
+  typedef std::map<LocalMEKey, std::vector<MonitorElement *> >          LocalMEMap;
+  typedef std::map<std::pair<uint32_t, uint32_t>, MergeCache>           MergeCacheMap;
+
   unsigned                      verbose_;
   unsigned                      verboseQT_;
   bool                          reset_;
@@ -718,6 +751,9 @@ class DQMStore
   QAMap                         qalgos_;
   QTestSpecs                    qtestspecs_;
 
+  LocalMEMap                    localMEs_;
+  MergeCacheMap                 mergeCache_;
+
   std::mutex book_mutex_;
   IBooker * ibooker_;
   IGetter * igetter_;
@@ -0,0 +1,596 @@
+#include "DQMServices/Core/interface/DQMSnapshot.h"
+#include "DQMServices/Core/interface/DQMNet.h"
+#include "DQMServices/Core/src/DQMError.h"
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/gzip_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl.h>
+#include "TH1F.h"
+#include "TH1S.h"
+#include "TH1D.h"
+#include "TH2F.h"
+#include "TH2S.h"
+#include "TH2D.h"
+#include "TH3F.h"
+#include "TProfile.h"
+#include "TProfile2D.h"
+#include "TObjString.h"
+#include "THashList.h"
+#include <cassert>
+#include <climits>
+#include <cstring>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+using google::protobuf::io::CodedInputStream;
+using google::protobuf::io::CodedOutputStream;
+using google::protobuf::io::FileInputStream;
+using google::protobuf::io::FileOutputStream;
+using google::protobuf::io::GzipInputStream;
+using google::protobuf::io::GzipOutputStream;
+
+static const char     s_magic[4] = { 'D', 'Q', 'M', 'S' };
+static const unsigned s_version = 1;
+static const unsigned s_compressed = 0x01;
+static const uint32_t s_end = DQMNet::DQM_PROP_TYPE_INVALID;
+
+//////////////////////////////////////////////////////////////////////
+/// Map an object to the DQMNet type of its record, or
+/// DQM_PROP_TYPE_INVALID if it cannot be stored in a snapshot.
+static uint32_t
+objectType(const TObject *obj)
+{
+  TClass *c = obj->IsA();
+  if (c == TObjString::Class()) return DQMNet::DQM_PROP_TYPE_STRING;
+  if (c == TH1F::Class())       return DQMNet::DQM_PROP_TYPE_TH1F;
+  if (c == TH1S::Class())       return DQMNet::DQM_PROP_TYPE_TH1S;
+  if (c == TH1D::Class())       return DQMNet::DQM_PROP_TYPE_TH1D;
+  if (c == TH2F::Class())       return DQMNet::DQM_PROP_TYPE_TH2F;
+  if (c == TH2S::Class())       return DQMNet::DQM_PROP_TYPE_TH2S;
+  if (c == TH2D::Class())       return DQMNet::DQM_PROP_TYPE_TH2D;
+  if (c == TH3F::Class())       return DQMNet::DQM_PROP_TYPE_TH3F;
+  if (c == TProfile::Class())   return DQMNet::DQM_PROP_TYPE_TPROF;
+  if (c == TProfile2D::Class()) return DQMNet::DQM_PROP_TYPE_TPROF2D;
+  return DQMNet::DQM_PROP_TYPE_INVALID;
+}
+
+/// Number of statistics filled by TH1::GetStats() for each type.
+static unsigned
+statsSize(uint32_t type)
+{
+  switch (type)
+  {
+  case DQMNet::DQM_PROP_TYPE_TH2F:
+  case DQMNet::DQM_PROP_TYPE_TH2S:
+  case DQMNet::DQM_PROP_TYPE_TH2D:
+    return 7;
+  case DQMNet::DQM_PROP_TYPE_TH3F:
+    return 11;
+  case DQMNet::DQM_PROP_TYPE_TPROF:
+    return 6;
+  case DQMNet::DQM_PROP_TYPE_TPROF2D:
+    return 9;
+  default:
+    return 4;
+  }
+}
+
+static bool
+isProfile(uint32_t type)
+{
+  return type == DQMNet::DQM_PROP_TYPE_TPROF || type == DQMNet::DQM_PROP_TYPE_TPROF2D;
+}
+
+//////////////////////////////////////////////////////////////////////
+static void
+writeString(CodedOutputStream &out, const std::string &s)
+{
+  out.WriteVarint32(s.size());
+  out.WriteString(s);
+}
+
+static void
+writeDouble(CodedOutputStream &out, double value)
+{
+  uint64_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  out.WriteLittleEndian64(bits);
+}
+
+template <class ARRAY>
+static void
+writeArray(CodedOutputStream &out, const ARRAY &a)
+{
+  out.WriteVarint32(a.fN);
+  out.WriteRaw(a.fArray, a.fN * sizeof(*a.fArray));
+}
+
+static void
+writeAxis(CodedOutputStream &out, const TAxis *axis)
+{
+  const TArrayD *edges = axis->GetXbins();
+  out.WriteVarint32(axis->GetNbins());
+  writeDouble(out, axis->GetXmin());
+  writeDouble(out, axis->GetXmax());
+  writeArray(out, *edges);
+  writeString(out, axis->GetTitle());
+
+  THashList *labels = axis->GetLabels();
+  out.WriteVarint32(labels ? labels->GetSize() : 0);
+  if (labels)
+  {
+    TIter next(labels);
+    while (TObjString *label = static_cast<TObjString *>(next()))
+    {
+      out.WriteVarint32(label->GetUniqueID());
+      writeString(out, label->GetString().Data());
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////
+static bool
+readString(CodedInputStream &in, std::string &s)
+{
+  uint32_t size;
+  return in.ReadVarint32(&size) && in.ReadString(&s, size);
+}
+
+static bool
+readDouble(CodedInputStream &in, double &value)
+{
+  uint64_t bits;
+  if (! in.ReadLittleEndian64(&bits))
+    return false;
+  memcpy(&value, &bits, sizeof(value));
+  return true;
+}
+
+template <class ARRAY>
+static bool
+readArray(CodedInputStream &in, ARRAY &a)
+{
+  uint32_t n;
+  if (! in.ReadVarint32(&n) || n > INT_MAX / sizeof(*a.fArray))
+    return false;
+  a.Set(n);
+  return in.ReadRaw(a.fArray, n * sizeof(*a.fArray));
+}
+
+struct SnapshotAxis
+{
+  uint32_t nbins;
+  double   xmin;
+  double   xmax;
+  TArrayD  edges;
+  std::string title;
+  std::vector<std::pair<uint32_t, std::string> > labels;
+};
+
+static bool
+readAxis(CodedInputStream &in, SnapshotAxis &axis)
+{
+  uint32_t nlabels;
+  if (! (in.ReadVarint32(&axis.nbins)
+         && readDouble(in, axis.xmin)
+         && readDouble(in, axis.xmax)
+         && readArray(in, axis.edges)
+         && readString(in, axis.title)
+         && in.ReadVarint32(&nlabels)))
+    return false;
+
+  axis.labels.resize(nlabels);
+  for (uint32_t i = 0; i < nlabels; ++i)
+    if (! (in.ReadVarint32(&axis.labels[i].first)
+           && readString(in, axis.labels[i].second)))
+      return false;
+  return true;
+}
+
+static void
+setAxis(TAxis *axis, const SnapshotAxis &from)
+{
+  if (from.edges.fN)
+    axis->Set(from.nbins, from.edges.fArray);
+  axis->SetTitle(from.title.c_str());
+  for (size_t i = 0; i < from.labels.size(); ++i)
+    axis->SetBinLabel(from.labels[i].first, from.labels[i].second.c_str());
+}
+
+//////////////////////////////////////////////////////////////////////
+DQMSnapshotWriter::DQMSnapshotWriter(const std::string &filename, bool compress /* = true */)
+  : filename_(filename),
+    fd_(-1)
+{
+  fd_ = ::open(filename.c_str(),
+               O_WRONLY | O_CREAT | O_TRUNC,
+               S_IRUSR | S_IWUSR |
+               S_IRGRP | S_IWGRP |
+               S_IROTH);
+  if (fd_ == -1)
+    raiseDQMError("DQMSnapshot", "Failed to create file '%s'", filename.c_str());
+
+  // The header is never compressed, so that the reader knows how to
+  // decode the rest of the file.
+  unsigned char header[8] = { 0 };
+  memcpy(header, s_magic, sizeof(s_magic));
+  header[4] = s_version;
+  header[5] = compress ? s_compressed : 0;
+  if (::write(fd_, header, sizeof(header)) != sizeof(header))
+  {
+    ::close(fd_);
+    raiseDQMError("DQMSnapshot", "Failed to write header to file '%s'", filename.c_str());
+  }
+
+  file_.reset(new FileOutputStream(fd_));
+  if (compress)
+  {
+    GzipOutputStream::Options options;
+    options.format = GzipOutputStream::GZIP;
+    options.compression_level = 1;
+    gzip_.reset(new GzipOutputStream(file_.get(), options));
+    coded_.reset(new CodedOutputStream(gzip_.get()));
+  }
+  else
+    coded_.reset(new CodedOutputStream(file_.get()));
+}
+
+DQMSnapshotWriter::~DQMSnapshotWriter(void)
+{
+  if (coded_)
+  {
+    try { close(); }
+    catch (...) {}
+  }
+}
+
+/// Append @a obj, a TObjString or a MonitorElement histogram, under
+/// @a fullpath with DQMNet @a flags.
+void
+DQMSnapshotWriter::write(const std::string &fullpath, uint32_t flags, TObject *obj)
+{
+  assert(coded_);
+  uint32_t type = objectType(obj);
+  if (type == DQMNet::DQM_PROP_TYPE_INVALID)
+    raiseDQMError("DQMSnapshot", "Cannot write object '%s' of class '%s' to a snapshot",
+                  fullpath.c_str(), obj->ClassName());
+
+  CodedOutputStream &out = *coded_;
+  out.WriteVarint32(type);
+  writeString(out, fullpath);
+  out.WriteVarint32(flags);
+
+  if (type == DQMNet::DQM_PROP_TYPE_STRING)
+  {
+    writeString(out, static_cast<TObjString *>(obj)->GetString().Data());
+    return;
+  }
+
+  TH1 *h = static_cast<TH1 *>(obj);
+  writeString(out, h->GetTitle());
+  out.WriteVarint32(h->CanExtend());
+  writeDouble(out, h->GetMinimumStored());
+  writeDouble(out, h->GetMaximumStored());
+  writeAxis(out, h->GetXaxis());
+  if (h->GetDimension() > 1)
+    writeAxis(out, h->GetYaxis());
+  if (h->GetDimension() > 2)
+    writeAxis(out, h->GetZaxis());
+
+  if (TProfile *p = dynamic_cast<TProfile *>(h))
+  {
+    writeDouble(out, p->GetYmin());
+    writeDouble(out, p->GetYmax());
+    writeString(out, p->GetErrorOption());
+  }
+  else if (TProfile2D *p = dynamic_cast<TProfile2D *>(h))
+  {
+    writeDouble(out, p->GetZmin());
+    writeDouble(out, p->GetZmax());
+    writeString(out, p->GetErrorOption());
+  }
+
+  switch (type)
+  {
+  case DQMNet::DQM_PROP_TYPE_TH1F:
+  case DQMNet::DQM_PROP_TYPE_TH2F:
+  case DQMNet::DQM_PROP_TYPE_TH3F:
+    writeArray(out, *dynamic_cast<TArrayF *>(h));
+    break;
+  case DQMNet::DQM_PROP_TYPE_TH1S:
+  case DQMNet::DQM_PROP_TYPE_TH2S:
+    writeArray(out, *dynamic_cast<TArrayS *>(h));
+    break;
+  default:
+    writeArray(out, *dynamic_cast<TArrayD *>(h));
+    break;
+  }
+  writeArray(out, *h->GetSumw2());
+
+  if (isProfile(type))
+  {
+    // The bin entries are only reachable bin by bin.
+    TArrayD entries(h->GetNcells());
+    TArrayD *binSumw2;
+    if (TProfile *p = dynamic_cast<TProfile *>(h))
+    {
+      for (int i = 0; i < entries.fN; ++i)
+        entries.fArray[i] = p->GetBinEntries(i);
+      binSumw2 = p->GetBinSumw2();
+    }
+    else
+    {
+      TProfile2D *p = static_cast<TProfile2D *>(h);
+      for (int i = 0; i < entries.fN; ++i)
+        entries.fArray[i] = p->GetBinEntries(i);
+      binSumw2 = p->GetBinSumw2();
+    }
+    writeArray(out, entries);
+    writeArray(out, *binSumw2);
+  }
+
+  double stats[TH1::kNstat];
+  unsigned nstats = statsSize(type);
+  h->GetStats(stats);
+  writeDouble(out, h->GetEntries());
+  out.WriteVarint32(nstats);
+  out.WriteRaw(stats, nstats * sizeof(*stats));
+}
+
+/// Terminate and flush the snapshot.  Called by the destructor if
+/// needed, but only an explicit call reports errors.
+void
+DQMSnapshotWriter::close(void)
+{
+  if (! coded_)
+    return;
+
+  coded_->WriteVarint32(s_end);
+  bool ok = ! coded_->HadError();
+  coded_.reset();
+  if (gzip_)
+    ok = gzip_->Close() && ok;
+  gzip_.reset();
+  ok = file_->Close() && ok;
+  file_.reset();
+
+  if (! ok)
+    raiseDQMError("DQMSnapshot", "Failed to write snapshot file '%s'", filename_.c_str());
+}
+
+//////////////////////////////////////////////////////////////////////
+DQMSnapshotReader::DQMSnapshotReader(const std::string &filename)
+  : filename_(filename),
+    fd_(-1),
+    input_(0)
+{
+  if ((fd_ = ::open(filename.c_str(), O_RDONLY)) == -1)
+    raiseDQMError("DQMSnapshot", "Failed to open file '%s'", filename.c_str());
+
+  unsigned char header[8];
+  if (::read(fd_, header, sizeof(header)) != sizeof(header)
+      || memcmp(header, s_magic, sizeof(s_magic))
+      || header[4] != s_version)
+  {
+    ::close(fd_);
+    raiseDQMError("DQMSnapshot", "File '%s' is not a DQM snapshot of version %u",
+                  filename.c_str(), s_version);
+  }
+
+  file_.reset(new FileInputStream(fd_));
+  file_->SetCloseOnDelete(true);
+  if (header[5] & s_compressed)
+  {
+    gzip_.reset(new GzipInputStream(file_.get(), GzipInputStream::GZIP));
+    input_ = gzip_.get();
+  }
+  else
+    input_ = file_.get();
+}
+
+DQMSnapshotReader::~DQMSnapshotReader(void)
+{
+  gzip_.reset();
+  file_.reset();
+}
+
+/// Check whether @a filename starts with a snapshot header.
+bool
+DQMSnapshotReader::isSnapshot(const std::string &filename)
+{
+  char magic[sizeof(s_magic)];
+  int fd = ::open(filename.c_str(), O_RDONLY);
+  if (fd == -1)
+    return false;
+  bool ok = (::read(fd, magic, sizeof(magic)) == sizeof(magic)
+             && ! memcmp(magic, s_magic, sizeof(s_magic)));
+  ::close(fd);
+  return ok;
+}
+
+bool
+DQMSnapshotReader::read(std::string &fullpath, uint32_t &flags, TObject **obj)
+{
+  // A coded stream stops reading after INT_MAX bytes: use a new one
+  // for each record.  Its destructor gives the bytes it buffered but
+  // did not consume back to the underlying stream.
+  CodedInputStream in(input_);
+  in.SetTotalBytesLimit(INT_MAX, -1);
+  uint32_t type;
+
+  *obj = 0;
+  if (! in.ReadVarint32(&type))
+    raiseDQMError("DQMSnapshot", "Unexpected end of snapshot file '%s'", filename_.c_str());
+  if (type == s_end)
+    return false;
+
+  if (! (readString(in, fullpath) && in.ReadVarint32(&flags)))
+    raiseDQMError("DQMSnapshot", "Corrupted snapshot file '%s'", filename_.c_str());
+
+  if (type == DQMNet::DQM_PROP_TYPE_STRING)
+  {
+    std::string value;
+    if (! readString(in, value))
+      raiseDQMError("DQMSnapshot", "Corrupted element '%s' in snapshot file '%s'",
+                    fullpath.c_str(), filename_.c_str());
+    *obj = new TObjString(value.c_str());
+    return true;
+  }
+
+  size_t slash = fullpath.rfind('/');
+  std::string name(fullpath, slash == std::string::npos ? 0 : slash+1);
+  std::string title;
+  uint32_t extend;
+  double minimum, maximum;
+  double vmin = 0, vmax = 0;
+  std::string option;
+  SnapshotAxis x, y, z;
+  bool ok = (readString(in, title)
+             && in.ReadVarint32(&extend)
+             && readDouble(in, minimum)
+             && readDouble(in, maximum)
+             && readAxis(in, x));
+
+  std::unique_ptr<TH1> h;
+  switch (type)
+  {
+  case DQMNet::DQM_PROP_TYPE_TH1F:
+  case DQMNet::DQM_PROP_TYPE_TH1S:
+  case DQMNet::DQM_PROP_TYPE_TH1D:
+    if (! ok)
+      break;
+    if (type == DQMNet::DQM_PROP_TYPE_TH1F)
+      h.reset(new TH1F(name.c_str(), title.c_str(), x.nbins, x.xmin, x.xmax));
+    else if (type == DQMNet::DQM_PROP_TYPE_TH1S)
+      h.reset(new TH1S(name.c_str(), title.c_str(), x.nbins, x.xmin, x.xmax));
+    else
+      h.reset(new TH1D(name.c_str(), title.c_str(), x.nbins, x.xmin, x.xmax));
+    break;
+
+  case DQMNet::DQM_PROP_TYPE_TH2F:
+  case DQMNet::DQM_PROP_TYPE_TH2S:
+  case DQMNet::DQM_PROP_TYPE_TH2D:
+    if (! (ok = ok && readAxis(in, y)))
+      break;
+    if (type == DQMNet::DQM_PROP_TYPE_TH2F)
+      h.reset(new TH2F(name.c_str(), title.c_str(), x.nbins, x.xmin, x.xmax, y.nbins, y.xmin, y.xmax));
+    else if (type == DQMNet::DQM_PROP_TYPE_TH2S)
+      h.reset(new TH2S(name.c_str(), title.c_str(), x.nbins, x.xmin, x.xmax, y.nbins, y.xmin, y.xmax));
+    else
+      h.reset(new TH2D(name.c_str(), title.c_str(), x.nbins, x.xmin, x.xmax, y.nbins, y.xmin, y.xmax));
+    break;
+
+  case DQMNet::DQM_PROP_TYPE_TH3F:
+    if (! (ok = ok && readAxis(in, y) && readAxis(in, z)))
+      break;
+    h.reset(new TH3F(name.c_str(), title.c_str(),
+                     x.nbins, x.xmin, x.xmax,
+                     y.nbins, y.xmin, y.xmax,
+                     z.nbins, z.xmin, z.xmax));
+    break;
+
+  case DQMNet::DQM_PROP_TYPE_TPROF:
+    if (! (ok = ok && readDouble(in, vmin) && readDouble(in, vmax) && readString(in, option)))
+      break;
+    h.reset(new TProfile(name.c_str(), title.c_str(), x.nbins, x.xmin, x.xmax,
+                         vmin, vmax, option.c_str()));
+    break;
+
+  case DQMNet::DQM_PROP_TYPE_TPROF2D:
+    if (! (ok = ok && readAxis(in, y)
+           && readDouble(in, vmin) && readDouble(in, vmax) && readString(in, option)))
+      break;
+    h.reset(new TProfile2D(name.c_str(), title.c_str(),
+                           x.nbins, x.xmin, x.xmax,
+                           y.nbins, y.xmin, y.xmax,
+                           vmin, vmax, option.c_str()));
+    break;
+
+  default:
+    raiseDQMError("DQMSnapshot", "Unknown type %u of element '%s' in snapshot file '%s'",
+                  type, fullpath.c_str(), filename_.c_str());
+  }
+
+  if (! ok)
+    raiseDQMError("DQMSnapshot", "Corrupted element '%s' in snapshot file '%s'",
+                  fullpath.c_str(), filename_.c_str());
+
+  h->SetDirectory(0);
+  setAxis(h->GetXaxis(), x);
+  if (h->GetDimension() > 1)
+    setAxis(h->GetYaxis(), y);
+  if (h->GetDimension() > 2)
+    setAxis(h->GetZaxis(), z);
+  h->SetCanExtend(extend);
+  h->SetMinimum(minimum);
+  h->SetMaximum(maximum);
+
+  int ncells = h->GetNcells();
+  switch (type)
+  {
+  case DQMNet::DQM_PROP_TYPE_TH1F:
+  case DQMNet::DQM_PROP_TYPE_TH2F:
+  case DQMNet::DQM_PROP_TYPE_TH3F:
+    ok = readArray(in, *dynamic_cast<TArrayF *>(h.get()))
+         && dynamic_cast<TArrayF *>(h.get())->fN == ncells;
+    break;
+  case DQMNet::DQM_PROP_TYPE_TH1S:
+  case DQMNet::DQM_PROP_TYPE_TH2S:
+    ok = readArray(in, *dynamic_cast<TArrayS *>(h.get()))
+         && dynamic_cast<TArrayS *>(h.get())->fN == ncells;
+    break;
+  default:
+    ok = readArray(in, *dynamic_cast<TArrayD *>(h.get()))
+         && dynamic_cast<TArrayD *>(h.get())->fN == ncells;
+    break;
+  }
+
+  TArrayD sumw2;
+  ok = ok && readArray(in, sumw2) && (sumw2.fN == 0 || sumw2.fN == ncells);
+  if (ok)
+    *h->GetSumw2() = sumw2;
+
+  if (ok && isProfile(type))
+  {
+    TArrayD entries;
+    TArrayD binSumw2;
+    ok = (readArray(in, entries)
+          && entries.fN == ncells
+          && readArray(in, binSumw2)
+          && (binSumw2.fN == 0 || binSumw2.fN == ncells));
+    if (ok)
+    {
+      if (TProfile *p = dynamic_cast<TProfile *>(h.get()))
+      {
+        for (int i = 0; i < ncells; ++i)
+          p->SetBinEntries(i, entries.fArray[i]);
+        *p->GetBinSumw2() = binSumw2;
+      }
+      else
+      {
+        TProfile2D *p = static_cast<TProfile2D *>(h.get());
+        for (int i = 0; i < ncells; ++i)
+          p->SetBinEntries(i, entries.fArray[i]);
+        *p->GetBinSumw2() = binSumw2;
+      }
+    }
+  }
+
+  double entries;
+  uint32_t nstats;
+  double stats[TH1::kNstat];
+  ok = (ok
+        && readDouble(in, entries)
+        && in.ReadVarint32(&nstats)
+        && nstats == statsSize(type)
+        && in.ReadRaw(stats, nstats * sizeof(*stats)));
+  if (! ok)
+    raiseDQMError("DQMSnapshot", "Corrupted element '%s' in snapshot file '%s'",
+                  fullpath.c_str(), filename_.c_str());
+
+  h->SetEntries(entries);
+  h->PutStats(stats);
+  *obj = h.release();
+  return true;
+}
@@ -1,5 +1,6 @@
 #include "DQMServices/Core/interface/Standalone.h"
 #include "DQMServices/Core/interface/DQMStore.h"
+#include "DQMServices/Core/interface/DQMSnapshot.h"
 #include "DQMServices/Core/interface/QReport.h"
 #include "DQMServices/Core/interface/QTest.h"
 #include "DQMServices/Core/src/ROOTFilePB.pb.h"
@@ -16,8 +17,11 @@
 #include "TClass.h"
 #include "TSystem.h"
 #include "TBufferFile.h"
+#include "tbb/parallel_for.h"
+#include "tbb/task_arena.h"
 #include <iterator>
 #include <cerrno>
+#include <unistd.h>
 #include <boost/algorithm/string.hpp>
 
 #include <fstream>
@@ -63,6 +67,7 @@ static const lat::Regexp s_rxmeqr2 ("^st\\.(\\d+)\\.(.*)$");
 static const lat::Regexp s_rxtrace ("(.*)\\((.*)\\+0x.*\\).*");
 static const lat::Regexp s_rxself  ("^[^()]*DQMStore::.*");
 static const lat::Regexp s_rxpbfile (".*\\.pb$");
+static const lat::Regexp s_rxsnapfile (".*\\.dqmsnap$");
 
 //////////////////////////////////////////////////////////////////////
 /// Check whether the @a path is a subdirectory of @a ofdir.  Returns
@@ -370,65 +375,14 @@ void DQMStore::mergeAndResetMEsRunSummaryCache(uint32_t run,
     return;
   }
 
-  std::string null_str("");
-  MonitorElement proto(&null_str, null_str, run, streamId, moduleId);
   // Since this accesses the data, the operation must be
   // be locked.
   std::lock_guard<std::mutex> guard(book_mutex_);
 
-  std::set<MonitorElement>::const_iterator e = data_.end();
-  std::set<MonitorElement>::const_iterator i = data_.lower_bound(proto);
-  while (i != e) {
-    if (i->data_.run != run
-        || i->data_.streamId != streamId
-        || i->data_.moduleId != moduleId)
-      break;
-
-    // Handle Run-based histograms only.
-    if (i->getLumiFlag() || LSbasedMode_) {
-      ++i;
-      continue;
-    }
-
-    // don't call the copy constructor
-    // we are just searching for a global histogram - a copy is not necessary
-    MonitorElement global_me(*i, MonitorElementNoCloneTag());
-    global_me.globalize();
-
-    std::set<MonitorElement>::const_iterator me = data_.find(global_me);
-    if (me != data_.end()) {
-      if (verbose_ > 1)
-	      std::cout << "Found global Object, using it --> " << me->getFullname() << std::endl;
-
-      //don't take any action if the ME is an INT || FLOAT || STRING
-      if(me->kind() >= MonitorElement::DQM_KIND_TH1F)
-	{
-	  if(me->getTH1()->CanExtendAllAxes() && i->getTH1()->CanExtendAllAxes()) {
-	    TList list;
-	    list.Add(i->getTH1());
-	    if( -1 == me->getTH1()->Merge(&list)) {
-	      std::cout << "mergeAndResetMEsRunSummaryCache: Failed to merge DQM element "<<me->getFullname();
-	    }
-	  }
-	  else {
-            if (i->getTH1()->GetEntries())
-	      me->getTH1()->Add(i->getTH1());
-          }
-	}
-    } else {
-      if (verbose_ > 1)
-        std::cout << "No global Object found. " << std::endl;
-      std::pair<std::set<MonitorElement>::const_iterator, bool> gme;
-
-      // this makes an actual and a single copy with Clone()'ed th1
-      MonitorElement actual_global_me(*i);
-      actual_global_me.globalize();
-      gme = data_.insert(std::move(actual_global_me));
-      assert(gme.second);
-    }
-    // TODO(rovere): eventually reset the local object and mark it as reusable??
-    ++i;
-  }
+  // Handle Run-based histograms only.
+  mergeLocalMEs(run, 0, streamId, moduleId, false,
+                "mergeAndResetMEsRunSummaryCache");
+  // TODO(rovere): eventually reset the local object and mark it as reusable??
 }
 
 void DQMStore::mergeAndResetMEsLuminositySummaryCache(uint32_t run,
@@ -440,67 +394,172 @@ void DQMStore::mergeAndResetMEsLuminositySummaryCache(uint32_t run,
               << run << 	" lumi: " << lumi
               << ", stream: " << streamId
               << " module: " << moduleId << std::endl;
-  std::string null_str("");
-  MonitorElement proto(&null_str, null_str, run, streamId, moduleId);
 
   // Since this accesses the data, the operation must be
   // be locked.
   std::lock_guard<std::mutex> guard(book_mutex_);
 
-  std::set<MonitorElement>::const_iterator e = data_.end();
-  std::set<MonitorElement>::const_iterator i = data_.lower_bound(proto);
-
-  while (i != e) {
+  // Handle LS-based histograms only, and make the local MEs reusable
+  // for the next LS.
+  mergeLocalMEs(run, lumi, streamId, moduleId, true,
+                "mergeAndResetMEsLuminositySummaryCache");
+}
+
+/** Return the local MEs booked by module @a moduleId in stream @a
+    streamId for run @a run, in the order of the MEMap. The index is
+    built from data_ on first use, and MEs booked afterwards are
+    appended by book(), so that the position of an ME in the vector
+    stays fixed for the lifetime of the entry. Must be called with
+    book_mutex_ held. */
+std::vector<MonitorElement *> &
+DQMStore::localMEs(uint32_t run, uint32_t streamId, uint32_t moduleId) {
+  LocalMEKey key(run, streamId, moduleId);
+  LocalMEMap::iterator found = localMEs_.find(key);
+  if (found != localMEs_.end())
+    return found->second;
+
+  std::vector<MonitorElement *> &locals = localMEs_[key];
+  std::string null_str("");
+  MonitorElement proto(&null_str, null_str, run, streamId, moduleId);
+  MEMap::const_iterator e = data_.end();
+  MEMap::const_iterator i = data_.lower_bound(proto);
+  for ( ; i != e; ++i) {
     if (i->data_.run != run
         || i->data_.streamId != streamId
         || i->data_.moduleId != moduleId)
       break;
+    locals.push_back(const_cast<MonitorElement *>(&*i));
+  }
+  return locals;
+}
 
-    // Handle LS-based histograms only.
-    if (not (i->getLumiFlag() || LSbasedMode_)) {
-      ++i;
+/** Append a newly booked local ME to its index in localMEs_, if the
+    index was already built. Must be called with book_mutex_ held. */
+void DQMStore::indexLocalME(MonitorElement *me) {
+  if (! enableMultiThread_ || (me->data_.streamId == 0 && me->data_.moduleId == 0))
+    return;
+  LocalMEMap::iterator found = localMEs_.find(LocalMEKey(me->data_.run,
+                                                         me->data_.streamId,
+                                                         me->data_.moduleId));
+  if (found != localMEs_.end())
+    found->second.push_back(me);
+}
+
+/** Merge the local MEs of (@a run, @a streamId, @a moduleId) into
+    their global counterparts for @a lumi. Only the MEs whose lumi
+    flag matches @a lumiMEs are handled; with @a lumiMEs the local MEs
+    are reset once merged.
+
+    All the streams of a module book the same MEs in the same order,
+    so the global ME found for the n-th local ME of one stream is
+    remembered in mergeCache_ and reused for the n-th local ME of the
+    other streams, which avoids a lookup in data_ per ME and per
+    stream. A cached pointer is only trusted if it was resolved for
+    the same lumi and refers to the same directory and name; the
+    cache is cleared whenever MEs are removed from data_.
+
+    Globals are resolved, created and, for histograms with extendable
+    axes, merged serially. The remaining TH1::Add() calls touch one
+    distinct pair of histograms each and are run in parallel, in an
+    isolated region: the thread holding book_mutex_ must not pick up an
+    unrelated task, that could try to take the mutex again while waiting.
+    Must be called with book_mutex_ held. */
+void DQMStore::mergeLocalMEs(uint32_t run,
+                             uint32_t lumi,
+                             uint32_t streamId,
+                             uint32_t moduleId,
+                             bool lumiMEs,
+                             const char *context) {
+  std::vector<MonitorElement *> const &locals = localMEs(run, streamId, moduleId);
+  MergeCache &cache = mergeCache_[std::make_pair(run, moduleId)];
+  if (cache.globals.size() < locals.size()) {
+    cache.globals.resize(locals.size(), nullptr);
+    cache.lumis.resize(locals.size(), 0);
+  }
+
+  std::vector<std::pair<MonitorElement *, MonitorElement *> > toAdd;
+  std::vector<MonitorElement *> merged;
+  toAdd.reserve(locals.size());
+  merged.reserve(locals.size());
+
+  for (size_t index = 0; index < locals.size(); ++index) {
+    MonitorElement *local = locals[index];
+    if ((local->getLumiFlag() || LSbasedMode_) != lumiMEs)
       continue;
+    merged.push_back(local);
+
+    MonitorElement *global = cache.globals[index];
+    if (! global
+        || cache.lumis[index] != lumi
+        || global->data_.dirname != local->data_.dirname
+        || global->data_.objname != local->data_.objname) {
+      // don't call the copy constructor
+      // we are just searching for a global histogram - a copy is not necessary
+      MonitorElement global_me(*local, MonitorElementNoCloneTag());
+      global_me.globalize();
+      global_me.setLumi(lumi);
+
+      MEMap::const_iterator me = data_.find(global_me);
+      if (me == data_.end()) {
+        if (verbose_ > 1)
+          std::cout << "No global Object found. " << std::endl;
+
+        // this makes an actual and a single copy with Clone()'ed th1
+        MonitorElement actual_global_me(*local);
+        actual_global_me.globalize();
+        actual_global_me.setLumi(lumi);
+        std::pair<MEMap::const_iterator, bool> gme = data_.insert(std::move(actual_global_me));
+        assert(gme.second);
+        cache.globals[index] = const_cast<MonitorElement *>(&*gme.first);
+        cache.lumis[index] = lumi;
+        continue;
+      }
+
+      global = const_cast<MonitorElement *>(&*me);
+      cache.globals[index] = global;
+      cache.lumis[index] = lumi;
     }
 
-    MonitorElement global_me(*i, MonitorElementNoCloneTag());
-    global_me.globalize();
-    global_me.setLumi(lumi);
-    std::set<MonitorElement>::const_iterator me = data_.find(global_me);
-    if (me != data_.end()) {
-      if (verbose_ > 1)
-	      std::cout << "Found global Object, using it --> " << me->getFullname() << std::endl;
-
-      //don't take any action if the ME is an INT || FLOAT || STRING
-      if(me->kind() >= MonitorElement::DQM_KIND_TH1F)
-	{
-	  if(me->getTH1()->CanExtendAllAxes() && i->getTH1()->CanExtendAllAxes()) {
-	    TList list;
-	    list.Add(i->getTH1());
-	    if( -1 == me->getTH1()->Merge(&list)) {
-	      std::cout << "mergeAndResetMEsLuminositySummaryCache: Failed to merge DQM element "<<me->getFullname();
-	    }
-	  }
-	  else {
-            if (i->getTH1()->GetEntries())
-	      me->getTH1()->Add(i->getTH1());
-          }
-	}
-    } else {
-      if (verbose_ > 1)
-        std::cout << "No global Object found. " << std::endl;
-      std::pair<std::set<MonitorElement>::const_iterator, bool> gme;
-
-      // this makes an actual and a single copy with Clone()'ed th1
-      MonitorElement actual_global_me(*i);
-      actual_global_me.globalize();
-      actual_global_me.setLumi(lumi);
-      gme = data_.insert(std::move(actual_global_me));
-      assert(gme.second);
+    if (verbose_ > 1)
+      std::cout << "Found global Object, using it --> " << global->getFullname() << std::endl;
+
+    //don't take any action if the ME is an INT || FLOAT || STRING
+    if (global->kind() < MonitorElement::DQM_KIND_TH1F)
+      continue;
+
+    TH1 *h = local->getTH1();
+    if (global->getTH1()->CanExtendAllAxes() && h->CanExtendAllAxes()) {
+      TList list;
+      list.Add(h);
+      if (-1 == global->getTH1()->Merge(&list)) {
+        std::cout << context << ": Failed to merge DQM element " << global->getFullname();
+      }
+    } else if (h->GetEntries()) {
+      // TH1::Add() falls back to a merge, which books temporary
+      // histograms, when labelled axes differ: keep those serial.
+      if (h->GetXaxis()->GetLabels() || h->GetYaxis()->GetLabels() || h->GetZaxis()->GetLabels())
+        global->getTH1()->Add(h);
+      else
+        toAdd.push_back(std::make_pair(global, local));
     }
-    // make the ME reusable for the next LS
-    const_cast<MonitorElement*>(&*i)->Reset();
-    ++i;
   }
+
+  // Below this size the overhead of scheduling tasks is not worth it.
+  if (toAdd.size() < 64) {
+    for (auto const &p : toAdd)
+      p.first->getTH1()->Add(p.second->getTH1());
+  } else {
+    tbb::this_task_arena::isolate([&toAdd] {
+      tbb::parallel_for(size_t(0), toAdd.size(), [&toAdd](size_t n) {
+        toAdd[n].first->getTH1()->Add(toAdd[n].second->getTH1());
+      });
+    });
+  }
+
+  // make the MEs reusable for the next LS
+  if (lumiMEs)
+    for (MonitorElement *local : merged)
+      local->Reset();
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -853,6 +912,7 @@ DQMStore::book(const std::string &dir, const std::string &name,
     MonitorElement proto(&*dirs_.find(dir), name, run_, streamId_, moduleId_);
     me = const_cast<MonitorElement &>(*data_.insert(std::move(proto)).first)
       .initialise((MonitorElement::Kind)kind, h);
+    indexLocalME(me);
 
     // Initialise quality test information.
     QTestSpecs::iterator qi = qtestspecs_.begin();
@@ -915,7 +975,9 @@ DQMStore::book(const std::string &dir,
     // Create it and return for initialisation.
     assert(dirs_.count(dir));
     MonitorElement proto(&*dirs_.find(dir), name, run_, streamId_, moduleId_);
-    return &const_cast<MonitorElement &>(*data_.insert(std::move(proto)).first);
+    MonitorElement *me = &const_cast<MonitorElement &>(*data_.insert(std::move(proto)).first);
+    indexLocalME(me);
+    return me;
   }
 }
 
@@ -2166,6 +2228,19 @@ DQMStore::deleteUnusedLumiHistograms(uint32_t run, uint32_t lumi)
 
     data_.erase(temp);
   }
+
+  // Forget the global MEs just deleted, the other cached entries
+  // of this run (run-based MEs, other lumis) stay valid; the entries
+  // of the previous runs are dropped.
+  MergeCacheMap::iterator first = mergeCache_.lower_bound(std::make_pair(run, uint32_t(0)));
+  first = mergeCache_.erase(mergeCache_.begin(), first);
+  for (MergeCacheMap::iterator c = first;
+       c != mergeCache_.end() && c->first.first == run; ++c) {
+    MergeCache &cache = c->second;
+    for (size_t index = 0; index < cache.globals.size(); ++index)
+      if (cache.lumis[index] == lumi)
+        cache.globals[index] = nullptr;
+  }
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -2642,6 +2717,107 @@ void DQMStore::savePB(const std::string &filename,
 }
 
 
+/** Save the monitor elements under @a path into the binary snapshot
+    @a filename, see DQMSnapshot.h.  Selects the same elements as
+    savePB(), plus the references under "Reference/<path>" and the
+    quality reports as save() does, but writes the raw histogram arrays
+    instead of streaming each object, which makes it cheap enough to
+    take every lumi. */
+void DQMStore::saveSnapshot(const std::string &filename,
+                            const std::string &path /* = "" */,
+                            const uint32_t run /* = 0 */,
+                            const uint32_t lumi /* = 0 */,
+                            const bool resetMEsAfterWriting /* = false */,
+                            const bool compress /* = true */)
+{
+  std::lock_guard<std::mutex> guard(book_mutex_);
+
+  std::set<std::string>::iterator di, de;
+  MEMap::iterator mi, me = data_.end();
+  int nme = 0;
+
+  if (verbose_)
+    std::cout << "\n DQMStore: Opening snapshot file '"
+              << filename << "'"<< std::endl;
+
+  DQMSnapshotWriter writer(filename, compress);
+
+  // Prepare a path for the reference object selection.
+  std::string refpath;
+  refpath.reserve(s_referenceDirName.size() + path.size() + 2);
+  refpath += s_referenceDirName;
+  if (! path.empty())
+  {
+    refpath += '/';
+    refpath += path;
+  }
+
+  // Loop over the directory structure.
+  for (di = dirs_.begin(), de = dirs_.end(); di != de; ++di)
+  {
+    // Check if we should process this directory.  We process the
+    // requested part of the object tree, including references.
+    if (! path.empty()
+        && ! isSubdirectory(path, *di)
+        && ! isSubdirectory(refpath, *di))
+      continue;
+
+    // Loop over monitor elements in this directory.
+    MonitorElement proto(&*di, std::string(), run, 0, 0);
+    if (enableMultiThread_)
+      proto.setLumi(lumi);
+
+    mi = data_.lower_bound(proto);
+    for ( ; mi != me && isSubdirectory(*di, *mi->data_.dirname); ++mi)
+    {
+      // Upper bound in the loop over the MEs
+      if (enableMultiThread_ && ((*mi).lumi() != lumi))
+        break;
+
+      // Skip if it isn't a direct child.
+      if (*di != *mi->data_.dirname)
+        continue;
+
+      // See savePB() for the handling of run 0.
+      if (run != 0 && (mi->data_.streamId !=0 || mi->data_.moduleId !=0))
+        continue;
+
+      if (verbose_ > 1)
+        std::cout << "DQMStore::saveSnapshot: saving monitor element '"
+                  << *mi->data_.dirname << "/" << mi->data_.objname << "'"
+                  << "flags " << mi->data_.flags << "\n";
+
+      nme++;
+      std::string fullpath((*mi->data_.dirname) + '/' + mi->data_.objname);
+      if (mi->kind() < MonitorElement::DQM_KIND_TH1F) {
+        TObjString value(mi->tagString().c_str());
+        writer.write(fullpath, mi->data_.flags, &value);
+      } else {
+        writer.write(fullpath, mi->data_.flags, mi->object_);
+      }
+
+      // Save quality reports if this is not in reference section.
+      if (! isSubdirectory(s_referenceDirName, *mi->data_.dirname))
+        for (const DQMNet::QValue &qv : mi->data_.qreports) {
+          TObjString value(mi->qualityTagString(qv).c_str());
+          writer.write(fullpath + '.' + qv.qtname, 0, &value);
+        }
+
+      //reset the ME just written to make it available for the next LS (online)
+      if (resetMEsAfterWriting)
+        const_cast<MonitorElement*>(&*mi)->Reset();
+    }
+  }
+
+  writer.close();
+
+  // Maybe make some noise.
+  if (verbose_)
+    std::cout << "DQMStore::saveSnapshot: successfully wrote " << nme
+              << " objects from path '" << path
+              << "' into DQM file '" << filename << "'\n";
+}
+
 /// save directory with monitoring objects into root file <filename>;
 /// include quality test results with status >= minimum_status
 /// (defined in Core/interface/QTestStatus.h);
@@ -3034,10 +3210,12 @@ DQMStore::load(const std::string &filename,
       std::cout << "DQMStore::load: in overwrite mode   " << "\n";
   }
 
-  if (!s_rxpbfile.match(filename, 0, 0))
-    return readFile(filename, overwrite, "", "", stripdirs, fileMustExist);
-  else
+  if (s_rxpbfile.match(filename, 0, 0))
     return readFilePB(filename, overwrite, "", "", stripdirs, fileMustExist);
+  else if (s_rxsnapfile.match(filename, 0, 0))
+    return readFileSnapshot(filename, fileMustExist);
+  else
+    return readFile(filename, overwrite, "", "", stripdirs, fileMustExist);
 }
 
 /// private readFile <filename>, and copy MonitorElements;
@@ -3176,29 +3354,73 @@ DQMStore::readFilePB(const std::string &filename,
     const dqmstorepb::ROOTFilePB::Histo &h = dqmstore_message.histo(i);
     get_info(h, path, objname, &obj);
 
-    setCurrentFolder(path);
-    if (obj)
-    {
-      /* Before calling the extract() check if histogram exists:
-       * if it does - flags for the given monitor are already set (and merged)
-       * else - set the flags after the histogram is created.
-       */
-      MonitorElement *me = findObject(path, objname);
-
-      /* Run histograms should be collated and not overwritten,
-       * Lumi histograms should be overwritten (and collate flag is not checked)
-       */
-      bool overwrite = h.flags() & DQMNet::DQM_PROP_LUMI;
-      bool collate = !(h.flags() & DQMNet::DQM_PROP_LUMI);
-      extract(static_cast<TObject *>(obj), path, overwrite, collate);
-
-      if (me == nullptr) {
-        me = findObject(path, objname);
-        me->data_.flags = h.flags();
-      }
+    importObject(obj, path, objname, h.flags());
+  }
 
-      delete obj;
-    }
+  cd();
+  return true;
+}
+
+/** Extract @a obj, read from a PB or snapshot file, into the monitor
+    element @a objname of directory @a path, and delete it. */
+void
+DQMStore::importObject(TObject *obj,
+                       const std::string &path,
+                       const std::string &objname,
+                       uint32_t flags)
+{
+  setCurrentFolder(path);
+  if (obj)
+  {
+    /* Before calling the extract() check if histogram exists:
+     * if it does - flags for the given monitor are already set (and merged)
+     * else - set the flags after the histogram is created.
+     */
+    MonitorElement *me = findObject(path, objname);
+
+    /* Run histograms should be collated and not overwritten,
+     * Lumi histograms should be overwritten (and collate flag is not checked)
+     */
+    bool overwrite = flags & DQMNet::DQM_PROP_LUMI;
+    bool collate = !(flags & DQMNet::DQM_PROP_LUMI);
+    extract(static_cast<TObject *>(obj), path, overwrite, collate);
+
+    // Quality reports are attached to their monitor element, there is
+    // no monitor element of their own name.
+    if (me == nullptr && (me = findObject(path, objname)))
+      me->data_.flags = flags;
+
+    delete obj;
+  }
+}
+
+/// private readFileSnapshot <filename>, and copy MonitorElements
+/// as readFilePB() does.
+bool
+DQMStore::readFileSnapshot(const std::string &filename,
+                           bool fileMustExist /* =true */)
+{
+  if (verbose_)
+    std::cout << "DQMStore::readFile: reading from file '" << filename << "'\n";
+
+  if (::access(filename.c_str(), R_OK) != 0) {
+    if (fileMustExist)
+      raiseDQMError("DQMStore", "Failed to open file '%s'", filename.c_str());
+    else
+      if (verbose_)
+        std::cout << "DQMStore::readFile: file '" << filename << "' does not exist, continuing\n";
+    return false;
+  }
+
+  DQMSnapshotReader reader(filename);
+  std::string fullpath;
+  uint32_t flags;
+  TObject *obj = nullptr;
+  while (reader.read(fullpath, flags, &obj)) {
+    size_t slash = fullpath.rfind('/');
+    std::string path(fullpath, 0, slash == std::string::npos ? 0 : slash);
+    std::string objname(fullpath, slash == std::string::npos ? 0 : slash+1);
+    importObject(obj, path, objname, flags);
   }
 
   cd();
@@ -3222,6 +3444,8 @@ DQMStore::rmdir(const std::string &path)
   MEMap::iterator i = data_.lower_bound(proto);
   while (i != e && isSubdirectory(*cleaned, *i->data_.dirname))
     data_.erase(i++);
+  localMEs_.clear();
+  mergeCache_.clear();
 
   std::set<std::string>::iterator de = dirs_.end();
   std::set<std::string>::iterator di = dirs_.lower_bound(*cleaned);
@@ -3241,6 +3465,8 @@ DQMStore::removeContents(const std::string &dir)
       data_.erase(i++);
     else
       ++i;
+  localMEs_.clear();
+  mergeCache_.clear();
 }
 
 /// erase all monitoring elements in current directory (not including subfolders);
@@ -3266,7 +3492,11 @@ DQMStore::removeElement(const std::string &dir, const std::string &name, bool wa
   MonitorElement proto(&dir, name);
   MEMap::iterator pos = data_.find(proto);
   if (pos != data_.end())
+  {
     data_.erase(pos);
+    localMEs_.clear();
+    mergeCache_.clear();
+  }
   else if (warning)
     std::cout << "DQMStore: WARNING: attempt to remove non-existent"
               << " monitor element '" << name << "' in '" << dir << "'\n";
@@ -0,0 +1,152 @@
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "DQMServices/Core/interface/DQMSnapshot.h"
+#include "DQMServices/Core/interface/DQMNet.h"
+#include "TH1F.h"
+#include "TH2S.h"
+#include "TProfile.h"
+#include "TObjString.h"
+
+/*
+ * Test case for the round trip of objects through a DQM snapshot file
+ *
+ */
+
+static bool sameContents(TH1 *a, TH1 *b)
+{
+	if (a->GetNcells() != b->GetNcells()
+	    || a->GetEntries() != b->GetEntries()
+	    || std::string(a->GetTitle()) != b->GetTitle())
+		return false;
+
+	for (int i = 0; i < a->GetNcells(); ++i)
+		if (a->GetBinContent(i) != b->GetBinContent(i)
+		    || a->GetBinError(i) != b->GetBinError(i))
+			return false;
+
+	return std::fabs(a->GetMean() - b->GetMean()) < 1e-12
+		&& std::fabs(a->GetRMS() - b->GetRMS()) < 1e-12;
+}
+
+int main(int argc, char** argv)
+{
+	const double edges[] = { 0., 1., 2., 5., 10. };
+	TH1F h1("h1", "variable bins;x;entries", 4, edges);
+	TH2S h2("h2", "labels", 3, 0., 3., 2, -1., 1.);
+	TProfile p("p", "profile", 10, 0., 10., -5., 5., "s");
+	h1.SetDirectory(0);
+	h2.SetDirectory(0);
+	p.SetDirectory(0);
+
+	h1.Sumw2();
+	for (int i = 0; i < 100; ++i)
+	{
+		h1.Fill(i * 0.11, 0.5 + i % 3);
+		h2.Fill(i % 4, (i % 7) / 3.5 - 1.);
+		p.Fill(i % 11, std::sin(i));
+	}
+	h2.GetXaxis()->SetBinLabel(2, "middle");
+
+	for (int compress = 0; compress < 2; ++compress)
+	{
+		std::string filename = compress ? "DQMSnapshotTest_z.dqmsnap" : "DQMSnapshotTest.dqmsnap";
+		{
+			DQMSnapshotWriter writer(filename, compress);
+			TObjString value("<i>=42</i>");
+			writer.write("Test/i", DQMNet::DQM_PROP_TYPE_INT, &value);
+			writer.write("Test/h1", DQMNet::DQM_PROP_TYPE_TH1F, &h1);
+			writer.write("Test/sub/h2", DQMNet::DQM_PROP_TYPE_TH2S, &h2);
+			writer.write("Test/p", DQMNet::DQM_PROP_TYPE_TPROF | DQMNet::DQM_PROP_LUMI, &p);
+			writer.close();
+		}
+
+		if (! DQMSnapshotReader::isSnapshot(filename))
+		{
+			std::cout << "Error: " << filename << " not recognised as a snapshot" << std::endl;
+			return 1;
+		}
+
+		DQMSnapshotReader reader(filename);
+		TH1 *expected[] = { 0, &h1, &h2, &p };
+		std::string fullpath;
+		uint32_t flags;
+		TObject *obj;
+		int n = 0;
+		while (reader.read(fullpath, flags, &obj))
+		{
+			std::unique_ptr<TObject> guard(obj);
+			bool ok = (n < 4);
+			if (ok && n == 0)
+				ok = (fullpath == "Test/i"
+				      && std::string(static_cast<TObjString *>(obj)->GetName()) == "<i>=42</i>");
+			else if (ok)
+				ok = (obj->IsA() == expected[n]->IsA()
+				      && obj->GetName() == std::string(expected[n]->GetName())
+				      && sameContents(static_cast<TH1 *>(obj), expected[n]));
+			if (ok && n == 2)
+				ok = (std::string(static_cast<TH1 *>(obj)->GetXaxis()->GetBinLabel(2)) == "middle");
+			if (ok && n == 3)
+				ok = (flags & DQMNet::DQM_PROP_LUMI)
+					&& std::string(static_cast<TProfile *>(obj)->GetErrorOption()) == "s"
+					&& static_cast<TProfile *>(obj)->GetYmax() == 5.;
+			if (! ok)
+			{
+				std::cout << "Error: element " << n << " (" << fullpath
+					  << ") did not survive the round trip in " << filename << std::endl;
+				return 1;
+			}
+			++n;
+		}
+
+		if (n != 4)
+		{
+			std::cout << "Error: read " << n << " elements from " << filename << std::endl;
+			return 1;
+		}
+		std::remove(filename.c_str());
+	}
+
+	// Many records, each read with its own coded stream: the records
+	// straddle the buffers of the underlying file and gzip streams.
+	for (int compress = 0; compress < 2; ++compress)
+	{
+		std::string filename = compress ? "DQMSnapshotTest_many_z.dqmsnap" : "DQMSnapshotTest_many.dqmsnap";
+		const int nrecords = 5000;
+		{
+			DQMSnapshotWriter writer(filename, compress);
+			for (int i = 0; i < nrecords; ++i)
+				writer.write("Test/h1", DQMNet::DQM_PROP_TYPE_TH1F, &h1);
+			writer.close();
+		}
+
+		DQMSnapshotReader reader(filename);
+		std::string fullpath;
+		uint32_t flags;
+		TObject *obj;
+		int n = 0;
+		while (reader.read(fullpath, flags, &obj))
+		{
+			std::unique_ptr<TObject> guard(obj);
+			if (! sameContents(static_cast<TH1 *>(obj), &h1))
+			{
+				std::cout << "Error: record " << n << " did not survive the round trip in "
+					  << filename << std::endl;
+				return 1;
+			}
+			++n;
+		}
+		if (n != nrecords)
+		{
+			std::cout << "Error: read " << n << " elements from " << filename << std::endl;
+			return 1;
+		}
+		std::remove(filename.c_str());
+	}
+
+	// test was ok
+	return 0;
+}
@@ -32,6 +32,7 @@ DQMFileSaverOnline::DQMFileSaverOnline(const edm::ParameterSet& ps)
     : DQMFileSaverBase(ps) {
   backupLumiCount_ = ps.getUntrackedParameter<int>("backupLumiCount", 1);
   keepBackupLumi_ = ps.getUntrackedParameter<bool>("keepBackupLumi", false);
+  snapshotBackupLumi_ = ps.getUntrackedParameter<bool>("snapshotBackupLumi", false);
 }
 
 DQMFileSaverOnline::~DQMFileSaverOnline() {}
@@ -65,8 +66,13 @@ void DQMFileSaverOnline::makeSnapshot(const FileParameters& fp,
 
   std::string prefix = filename(fp, false);
 
-  std::string root_fp = prefix + ".root" + suffix;
-  std::string meta_fp = prefix + ".root.origin" + suffix;
+  // lumi backups can be written as binary snapshots (see DQMSnapshot.h),
+  // the final file is always a ROOT file
+  bool snapshot = snapshotBackupLumi_ && !final;
+  std::string ext = snapshot ? ".dqmsnap" : ".root";
+
+  std::string root_fp = prefix + ext + suffix;
+  std::string meta_fp = prefix + ext + ".origin" + suffix;
 
   std::string tmp_root_fp = root_fp + ".tmp";
   std::string tmp_meta_fp = meta_fp + ".tmp";
@@ -74,23 +80,34 @@ void DQMFileSaverOnline::makeSnapshot(const FileParameters& fp,
   // run_ and lumi_ are ignored if dqmstore is not in multithread mode
   edm::Service<DQMStore> store;
 
-  logFileAction("Writing DQM Root file: ", root_fp);
-  // logFileAction("Writing DQM Origin file: ", meta_fp);
-
-  char rewrite[128];
-  snprintf(rewrite, 128, "\\1Run %ld/\\2/Run summary", fp.run_);
+  if (snapshot) {
+    logFileAction("Writing DQM snapshot file: ", root_fp);
 
-  store->save(tmp_root_fp,                      /* filename      */
-              "",                               /* path          */
-              "^(Reference/)?([^/]+)",          /* pattern       */
-              rewrite,                          /* rewrite       */
-              store->mtEnabled() ? fp.run_ : 0, /* run           */
-              0,                                /* lumi          */
-              fp.saveReference_,                /* ref           */
-              fp.saveReferenceQMin_,            /* ref minStatus */
-              "RECREATE",                       /* fileupdate    */
-              false                             /* resetMEs      */
-              );
+    store->saveSnapshot(tmp_root_fp,                      /* filename */
+                        "",                               /* path     */
+                        store->mtEnabled() ? fp.run_ : 0, /* run      */
+                        0,                                /* lumi     */
+                        false                             /* resetMEs */
+                        );
+  } else {
+    logFileAction("Writing DQM Root file: ", root_fp);
+    // logFileAction("Writing DQM Origin file: ", meta_fp);
+
+    char rewrite[128];
+    snprintf(rewrite, 128, "\\1Run %ld/\\2/Run summary", fp.run_);
+
+    store->save(tmp_root_fp,                      /* filename      */
+                "",                               /* path          */
+                "^(Reference/)?([^/]+)",          /* pattern       */
+                rewrite,                          /* rewrite       */
+                store->mtEnabled() ? fp.run_ : 0, /* run           */
+                0,                                /* lumi          */
+                fp.saveReference_,                /* ref           */
+                fp.saveReferenceQMin_,            /* ref minStatus */
+                "RECREATE",                       /* fileupdate    */
+                false                             /* resetMEs      */
+                );
+  }
 
   // write metadata
   // format.origin: md5:d566a34b27f48d507150a332b189398b 294835
@@ -184,6 +201,13 @@ void DQMFileSaverOnline::fillDescriptions(
           "ever deleted. Useful for ML applications, which use backups as a "
           "'history' of what happened during the run.");
 
+  desc.addUntracked<bool>("snapshotBackupLumi", false)
+      ->setComment(
+          "Write the backup files as binary DQM snapshots instead of ROOT "
+          "files, which is much cheaper. They can be converted to ROOT with "
+          "'fastHadd convert'. The file saved at the end of the run is always "
+          "a ROOT file.");
+
   DQMFileSaverBase::fillDescription(desc);
 
   descriptions.add("saver", desc);
@@ -27,6 +27,7 @@ class DQMFileSaverOnline : public DQMFileSaverBase {
  protected:
   int backupLumiCount_;
   bool keepBackupLumi_;
+  bool snapshotBackupLumi_;
 
   // snapshot making
   struct SnapshotFiles {
@@ -19,5 +19,8 @@ dqmSaver = cms.EDAnalyzer("DQMFileSaverOnline",
     backupLumiCount = cms.untracked.int32(-1),
 
     # Set to true to preserve 'lumi backup'.
-    keepBackupLumi = cms.untracked.bool(False)
+    keepBackupLumi = cms.untracked.bool(False),
+
+    # Set to true to write the 'lumi backup' as a binary DQM snapshot.
+    snapshotBackupLumi = cms.untracked.bool(False)
 )
@@ -68,6 +68,16 @@ public:
   typedef cms_uint32_t Word32;
   typedef cms_uint64_t Word64;
 
+  // Digis unpacked from one FED, stored flat in the order of the data words,
+  // with the DetId of each digi. "modules" lists the DetId of each unpacked
+  // ROC, so that the modules are known even if none of their pixels is valid.
+  struct DigiBuffer {
+    std::vector<cms_uint32_t> modules;
+    std::vector<cms_uint32_t> rawIds;
+    std::vector<PixelDigi> digis;
+    void clear() { modules.clear(); rawIds.clear(); digis.clear(); }
+  };
+
   PixelDataFormatter(const SiPixelFedCabling* map, bool phase1=false);
 
   void setErrorStatus(bool ErrorStatus);
@@ -80,6 +90,12 @@ public:
 
   void interpretRawData(bool& errorsInEvent, int fedId,  const FEDRawData & data, Collection & digis, Errors & errors);
 
+  // same as above, the digis are appended to a flat buffer
+  void interpretRawData(bool& errorsInEvent, int fedId,  const FEDRawData & data, DigiBuffer & digis, Errors & errors);
+
+  // fills "digis" with the buffers, as if the FEDs were unpacked to the collection in the order of the buffers
+  static void fillCollection(const std::vector<DigiBuffer> & buffers, Collection & digis);
+
   void formatRawData( unsigned int lvl1_ID, RawData & fedRawData, const Digis & digis);
 
 private:
@@ -109,6 +125,9 @@ private:
 
   int checkError(const Word32& data) const;
 
+  template<typename Filler>
+  void unpackRawData(bool& errorsInEvent, int fedId,  const FEDRawData & data, Filler & filler, Errors & errors);
+
   int digi2word(  cms_uint32_t detId, const PixelDigi& digi,
                   std::map<int, std::vector<Word32> > & words) const;
   int digi2wordPhase1Layer1(  cms_uint32_t detId, const PixelDigi& digi,
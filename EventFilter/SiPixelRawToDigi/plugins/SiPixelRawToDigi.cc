@@ -37,6 +37,8 @@
 #include "TH1D.h"
 #include "TFile.h"
 
+#include "tbb/parallel_for.h"
+
 using namespace std;
 
 // -----------------------------------------------------------------------------
@@ -101,6 +103,8 @@ SiPixelRawToDigi::SiPixelRawToDigi( const edm::ParameterSet& conf )
   //CablingMap could have a label //Tav
   cablingMapLabel = config_.getParameter<std::string> ("CablingMapLabel");
 
+  useParallelUnpacking = config_.getParameter<bool> ("UseParallelUnpacking");
+
 }
 
 
@@ -148,6 +152,7 @@ SiPixelRawToDigi::fillDescriptions(edm::ConfigurationDescriptions& descriptions)
   desc.add<bool>("UsePilotBlade",false)->setComment("##  Use pilot blades");
   desc.add<bool>("UsePhase1",false)->setComment("##  Use phase1");
   desc.add<std::string>("CablingMapLabel","")->setComment("CablingMap label"); //Tav
+  desc.add<bool>("UseParallelUnpacking",false)->setComment("## Unpack the FEDs in parallel to flat buffers, then fill the collection at once");
   desc.addOptional<bool>("CheckPixelOrder");  // never used, kept for back-compatibility
   descriptions.add("siPixelRawToDigi",desc);
 }
@@ -210,24 +215,8 @@ void SiPixelRawToDigi::produce( edm::Event& ev,
     LogDebug("SiPixelRawToDigi") << "region2unpack #modules (BPIX,EPIX,total): "<<regions_->nBarrelModules()<<" "<<regions_->nForwardModules()<<" "<<regions_->nModules();
   }
 
-  for (auto aFed = fedIds.begin(); aFed != fedIds.end(); ++aFed) {
-    int fedId = *aFed;
-
-    if(!usePilotBlade && (fedId==40) ) continue; // skip pilot blade data
-
-    if (regions_ && !regions_->mayUnpackFED(fedId)) continue;
-
-    if(debug) LogDebug("SiPixelRawToDigi")<< " PRODUCE DIGI FOR FED: " <<  fedId << endl;
-
-    PixelDataFormatter::Errors errors;
-
-    //get event data for this fed
-    const FEDRawData& fedRawData = buffers->FEDData( fedId );
-
-    //convert data to digi and strip off errors
-    formatter.interpretRawData( errorsInEvent, fedId, fedRawData, *collection, errors);
-
-    //pack errors into collection
+  //pack errors into collection
+  auto packErrors = [&](PixelDataFormatter::Errors & errors) {
     if(includeErrors) {
       typedef PixelDataFormatter::Errors::iterator IE;
       for (IE is = errors.begin(); is != errors.end(); is++) {
@@ -264,6 +253,56 @@ void SiPixelRawToDigi::produce( edm::Event& ev,
 	}
       }
     }
+  };
+
+  std::vector<int> fedsToUnpack;
+  for (auto aFed = fedIds.begin(); aFed != fedIds.end(); ++aFed) {
+    int fedId = *aFed;
+
+    if(!usePilotBlade && (fedId==40) ) continue; // skip pilot blade data
+
+    if (regions_ && !regions_->mayUnpackFED(fedId)) continue;
+
+    fedsToUnpack.push_back(fedId);
+  }
+
+  int nWordsInEvent = 0;
+  if (useParallelUnpacking) {
+    // each FED is unpacked to its own buffers, with its own copy of the formatter;
+    // the errors and the digis are then stored in the order of the FEDs
+    const unsigned int nFeds = fedsToUnpack.size();
+    std::vector<PixelDataFormatter::DigiBuffer> digiBuffers(nFeds);
+    std::vector<PixelDataFormatter::Errors> fedErrors(nFeds);
+    std::vector<char> fedErrorsInEvent(nFeds, false);
+    std::vector<int> fedWords(nFeds, 0);
+    tbb::parallel_for(0U, nFeds, [&](unsigned int i) {
+	PixelDataFormatter fedFormatter(formatter);
+	bool errorsInFed = false;
+	fedFormatter.interpretRawData( errorsInFed, fedsToUnpack[i], buffers->FEDData( fedsToUnpack[i] ), digiBuffers[i], fedErrors[i]);
+	fedErrorsInEvent[i] = errorsInFed;
+	fedWords[i] = fedFormatter.nWords();
+      });
+    for (unsigned int i = 0; i < nFeds; ++i) {
+      errorsInEvent |= fedErrorsInEvent[i];
+      nWordsInEvent += fedWords[i];
+      packErrors(fedErrors[i]);
+    }
+    PixelDataFormatter::fillCollection(digiBuffers, *collection);
+  } else {
+    for (int fedId : fedsToUnpack) {
+      if(debug) LogDebug("SiPixelRawToDigi")<< " PRODUCE DIGI FOR FED: " <<  fedId << endl;
+
+      PixelDataFormatter::Errors errors;
+
+      //get event data for this fed
+      const FEDRawData& fedRawData = buffers->FEDData( fedId );
+
+      //convert data to digi and strip off errors
+      formatter.interpretRawData( errorsInEvent, fedId, fedRawData, *collection, errors);
+
+      packErrors(errors);
+    }
+    nWordsInEvent = formatter.nWords();
   }
 
   if(includeErrors) {
@@ -276,9 +315,9 @@ void SiPixelRawToDigi::produce( edm::Event& ev,
     theTimer->stop();
     LogDebug("SiPixelRawToDigi") << "TIMING IS: (real)" << theTimer->realTime() ;
     ndigis += formatter.nDigis();
-    nwords += formatter.nWords();
+    nwords += nWordsInEvent;
     LogDebug("SiPixelRawToDigi") << " (Words/Digis) this ev: "
-         <<formatter.nWords()<<"/"<<formatter.nDigis() << "--- all :"<<nwords<<"/"<<ndigis;
+         <<nWordsInEvent<<"/"<<formatter.nDigis() << "--- all :"<<nwords<<"/"<<ndigis;
     hCPU->Fill( theTimer->realTime() ); 
     hDigi->Fill(formatter.nDigis());
   }
@@ -61,5 +61,6 @@ private:
   bool usePilotBlade;
   bool usePhase1;
   std::string cablingMapLabel;
+  bool useParallelUnpacking;
 };
 #endif
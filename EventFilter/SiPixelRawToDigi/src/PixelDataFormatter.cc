@@ -16,6 +16,7 @@
 #include "FWCore/Utilities/interface/Exception.h"
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
 
+#include <algorithm>
 #include <bitset>
 #include <sstream>
 #include <iostream>
@@ -52,10 +53,43 @@ namespace {
   // constexpr PixelDataFormatter::Word32 PXID_mask = ~(~PixelDataFormatter::Word32(0) << PXID_bits);
   // constexpr PixelDataFormatter::Word32 ADC_mask  = ~(~PixelDataFormatter::Word32(0) << ADC_bits);
   //const bool DANEK = false;
+
+  // the outputs of interpretRawData
+  class CollectionFiller {
+  public:
+    CollectionFiller(PixelDataFormatter::Collection & digis) : theDigis(digis) {}
+    void newModule(cms_uint32_t rawId) {
+      detDigis = &theDigis.find_or_insert(rawId);
+      if ( (*detDigis).empty() ) (*detDigis).data.reserve(32); // avoid the first relocations
+    }
+    void add(int row, int col, int adc) {
+      (*detDigis).data.emplace_back(row, col, adc);
+      LogTrace("") << (*detDigis).data.back();
+    }
+  private:
+    PixelDataFormatter::Collection & theDigis;
+    edm::DetSet<PixelDigi> * detDigis=nullptr;
+  };
+
+  class BufferFiller {
+  public:
+    BufferFiller(PixelDataFormatter::DigiBuffer & digis) : theDigis(digis) {}
+    void newModule(cms_uint32_t rawId) {
+      theDigis.modules.push_back(rawId);
+      theRawId = rawId;
+    }
+    void add(int row, int col, int adc) {
+      theDigis.rawIds.push_back(theRawId);
+      theDigis.digis.emplace_back(row, col, adc);
+    }
+  private:
+    PixelDataFormatter::DigiBuffer & theDigis;
+    cms_uint32_t theRawId=0;
+  };
 }
 
 PixelDataFormatter::PixelDataFormatter( const SiPixelFedCabling* map, bool phase)
-  : theDigiCounter(0), theWordCounter(0), theCablingTree(map), badPixelInfo(0), modulesToUnpack(0), phase1(phase)
+  : theDigiCounter(0), theWordCounter(0), theCablingTree(map), theFrameReverter(nullptr), badPixelInfo(0), modulesToUnpack(0), phase1(phase)
 {
   int s32 = sizeof(Word32);
   int s64 = sizeof(Word64);
@@ -125,6 +159,53 @@ void PixelDataFormatter::passFrameReverter(const SiPixelFrameReverter* reverter)
 }
 
 void PixelDataFormatter::interpretRawData(bool& errorsInEvent, int fedId, const FEDRawData& rawData, Collection & digis, Errors& errors)
+{
+  CollectionFiller filler(digis);
+  unpackRawData(errorsInEvent, fedId, rawData, filler, errors);
+}
+
+void PixelDataFormatter::interpretRawData(bool& errorsInEvent, int fedId, const FEDRawData& rawData, DigiBuffer & digis, Errors& errors)
+{
+  BufferFiller filler(digis);
+  unpackRawData(errorsInEvent, fedId, rawData, filler, errors);
+}
+
+void PixelDataFormatter::fillCollection(const std::vector<DigiBuffer> & buffers, Collection & digis)
+{
+  std::vector<cms_uint32_t> modules;
+  for (auto const & buffer : buffers) modules.insert(modules.end(), buffer.modules.begin(), buffer.modules.end());
+  std::sort(modules.begin(), modules.end());
+  modules.erase(std::unique(modules.begin(), modules.end()), modules.end());
+
+  std::vector<edm::DetSet<PixelDigi> > detSets;
+  detSets.reserve(modules.size());
+  for (auto rawId : modules) detSets.emplace_back(rawId);
+
+  // the digis of a module are consecutive in the buffers, the module is looked up once per sequence
+  auto forEachSequence = [&](const DigiBuffer & buffer, auto && action) {
+    unsigned int n = buffer.rawIds.size();
+    for (unsigned int b = 0, e = 0; b < n; b = e) {
+      auto rawId = buffer.rawIds[b];
+      for (e = b+1; e < n && buffer.rawIds[e]==rawId; ++e);
+      auto & detSet = detSets[std::lower_bound(modules.begin(), modules.end(), rawId) - modules.begin()];
+      action(detSet, b, e);
+    }
+  };
+  std::vector<unsigned int> sizes(modules.size(), 0);
+  for (auto const & buffer : buffers)
+    forEachSequence(buffer, [&](edm::DetSet<PixelDigi> & detSet, unsigned int b, unsigned int e) { sizes[&detSet-&detSets.front()] += e-b; });
+  for (unsigned int i = 0; i < modules.size(); ++i) detSets[i].data.reserve(sizes[i]);
+  for (auto const & buffer : buffers)
+    forEachSequence(buffer, [&](edm::DetSet<PixelDigi> & detSet, unsigned int b, unsigned int e) {
+	detSet.data.insert(detSet.data.end(), buffer.digis.begin()+b, buffer.digis.begin()+e);
+      });
+
+  Collection collection(detSets);
+  digis.swap(collection);
+}
+
+template<typename Filler>
+void PixelDataFormatter::unpackRawData(bool& errorsInEvent, int fedId, const FEDRawData& rawData, Filler & filler, Errors& errors)
 {
   using namespace sipixelobjects;
 
@@ -166,7 +247,6 @@ void PixelDataFormatter::interpretRawData(bool& errorsInEvent, int fedId, const
   int layer = 0;
   PixelROC const * rocp=nullptr;
   bool skipROC=false;
-  edm::DetSet<PixelDigi> * detDigis=nullptr;
 
   const  Word32 * bw =(const  Word32 *)(header+1);
   const  Word32 * ew =(const  Word32 *)(trailer);
@@ -208,8 +288,7 @@ void PixelDataFormatter::interpretRawData(bool& errorsInEvent, int fedId, const
       skipROC= modulesToUnpack && ( modulesToUnpack->find(rawId) == modulesToUnpack->end());
       if (skipROC) continue;
       
-      detDigis = &digis.find_or_insert(rawId);
-      if ( (*detDigis).empty() ) (*detDigis).data.reserve(32); // avoid the first relocations
+      filler.newModule(rawId);
     }
 
     // skip is roc to be skipped ot invalid
@@ -258,9 +337,8 @@ void PixelDataFormatter::interpretRawData(bool& errorsInEvent, int fedId, const
     }    
 
     GlobalPixel global = rocp->toGlobal( *local ); // global pixel coordinate (in module)
-    (*detDigis).data.emplace_back(global.row, global.col, adc);
+    filler.add(global.row, global.col, adc);
     //if(DANEK) cout<<global.row<<" "<<global.col<<" "<<adc<<endl;    
-    LogTrace("") << (*detDigis).data.back();
   }
 
 }
@@ -0,0 +1,79 @@
+// File: ComparePixelDigis.cc
+// Description: check that two collections of pixel digis and of raw data
+// errors are the same, module by module and digi by digi, the empty modules
+// (with ROCs unpacked but no valid pixel) included.
+// Throws at the first difference.
+//--------------------------------------------
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/Utilities/interface/InputTag.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+
+#include "DataFormats/Common/interface/DetSetVector.h"
+#include "DataFormats/SiPixelDigi/interface/PixelDigi.h"
+#include "DataFormats/SiPixelRawData/interface/SiPixelRawDataError.h"
+
+class ComparePixelDigis : public edm::global::EDAnalyzer<> {
+public:
+  explicit ComparePixelDigis(const edm::ParameterSet& conf) :
+    refToken_(consumes<edm::DetSetVector<PixelDigi> >(conf.getParameter<edm::InputTag>("reference"))),
+    testToken_(consumes<edm::DetSetVector<PixelDigi> >(conf.getParameter<edm::InputTag>("test"))),
+    refErrorToken_(consumes<edm::DetSetVector<SiPixelRawDataError> >(conf.getParameter<edm::InputTag>("reference"))),
+    testErrorToken_(consumes<edm::DetSetVector<SiPixelRawDataError> >(conf.getParameter<edm::InputTag>("test"))) {}
+
+  void analyze(edm::StreamID, const edm::Event& ev, const edm::EventSetup&) const override;
+
+private:
+  const edm::EDGetTokenT<edm::DetSetVector<PixelDigi> > refToken_;
+  const edm::EDGetTokenT<edm::DetSetVector<PixelDigi> > testToken_;
+  const edm::EDGetTokenT<edm::DetSetVector<SiPixelRawDataError> > refErrorToken_;
+  const edm::EDGetTokenT<edm::DetSetVector<SiPixelRawDataError> > testErrorToken_;
+};
+
+void ComparePixelDigis::analyze(edm::StreamID, const edm::Event& ev, const edm::EventSetup&) const {
+  edm::Handle<edm::DetSetVector<PixelDigi> > ref, test;
+  ev.getByToken(refToken_, ref);
+  ev.getByToken(testToken_, test);
+
+  if (ref->size() != test->size())
+    throw cms::Exception("ComparePixelDigis") << "different number of modules: " << ref->size() << ' ' << test->size();
+  unsigned int nDigis = 0, nEmpty = 0;
+  for (auto ia = ref->begin(), ib = test->begin(); ia != ref->end(); ++ia, ++ib) {
+    if (ia->detId() != ib->detId())
+      throw cms::Exception("ComparePixelDigis") << "different modules " << ia->detId() << ' ' << ib->detId();
+    if (ia->size() != ib->size())
+      throw cms::Exception("ComparePixelDigis") << "different number of digis in " << ia->detId();
+    for (unsigned int i = 0; i < ia->size(); ++i) {
+      if ((*ia)[i].packedData() != (*ib)[i].packedData())
+	throw cms::Exception("ComparePixelDigis") << "different digi " << i << " in " << ia->detId();
+    }
+    nDigis += ia->size();
+    if (ia->empty()) ++nEmpty;
+  }
+
+  edm::Handle<edm::DetSetVector<SiPixelRawDataError> > refErrors, testErrors;
+  ev.getByToken(refErrorToken_, refErrors);
+  ev.getByToken(testErrorToken_, testErrors);
+  if (refErrors.isValid() != testErrors.isValid())
+    throw cms::Exception("ComparePixelDigis") << "errors in one collection only";
+  if (refErrors.isValid()) {
+    if (refErrors->size() != testErrors->size())
+      throw cms::Exception("ComparePixelDigis") << "different number of modules with errors";
+    for (auto ia = refErrors->begin(), ib = testErrors->begin(); ia != refErrors->end(); ++ia, ++ib) {
+      if (ia->detId() != ib->detId() || ia->size() != ib->size())
+	throw cms::Exception("ComparePixelDigis") << "different errors in " << ia->detId();
+      for (unsigned int i = 0; i < ia->size(); ++i) {
+	if ((*ia)[i].getWord64() != (*ib)[i].getWord64() || (*ia)[i].getWord32() != (*ib)[i].getWord32() ||
+	    (*ia)[i].getType() != (*ib)[i].getType() || (*ia)[i].getFedId() != (*ib)[i].getFedId())
+	  throw cms::Exception("ComparePixelDigis") << "different error " << i << " in " << ia->detId();
+      }
+    }
+  }
+
+  LogDebug("ComparePixelDigis") << ref->size() << " modules, " << nEmpty << " of them empty, " << nDigis << " digis";
+}
+
+DEFINE_FWK_MODULE(ComparePixelDigis);
@@ -0,0 +1,87 @@
+// PixelDataFormatter::fillCollection against the collection filled as by the
+// sequential unpacking: one find_or_insert per module, digis appended in order
+
+#include "EventFilter/SiPixelRawToDigi/interface/PixelDataFormatter.h"
+
+#include <iostream>
+#include <map>
+#include <random>
+#include <vector>
+
+namespace {
+
+  std::mt19937 rng(2017);
+
+  int uniform(int a, int b) { return std::uniform_int_distribution<int>(a,b)(rng); }
+
+  // FEDs of a few modules each, some of them shared by two FEDs, with
+  // several ROCs per module and some ROCs without any valid pixel
+  std::vector<PixelDataFormatter::DigiBuffer> makeBuffers(unsigned int nFeds) {
+    std::vector<PixelDataFormatter::DigiBuffer> buffers(nFeds);
+    for (unsigned int fed = 0; fed < nFeds; ++fed) {
+      auto & buffer = buffers[fed];
+      int nRocs = uniform(0,40);
+      for (int roc = 0; roc < nRocs; ++roc) {
+	// the same module can be met again after another one
+	cms_uint32_t rawId = 302000000 + 1000*uniform(0,3*nFeds) + uniform(0,1);
+	buffer.modules.push_back(rawId);
+	int nPixels = uniform(-2,6);
+	for (int i = 0; i < nPixels; ++i) {
+	  buffer.rawIds.push_back(rawId);
+	  buffer.digis.emplace_back(uniform(0,159), uniform(0,415), uniform(1,255));
+	}
+      }
+    }
+    return buffers;
+  }
+
+  int failures = 0;
+
+  void check(const std::vector<PixelDataFormatter::DigiBuffer> & buffers) {
+    std::map<cms_uint32_t, std::vector<PixelDigi> > reference;
+    for (auto const & buffer : buffers) {
+      for (auto rawId : buffer.modules) reference[rawId];
+      for (unsigned int i = 0; i < buffer.digis.size(); ++i) reference[buffer.rawIds[i]].push_back(buffer.digis[i]);
+    }
+
+    PixelDataFormatter::Collection digis;
+    PixelDataFormatter::fillCollection(buffers, digis);
+
+    if (digis.size() != reference.size()) {
+      std::cout << digis.size() << " modules instead of " << reference.size() << std::endl;
+      ++failures;
+      return;
+    }
+    auto ir = reference.begin();
+    for (auto const & detSet : digis) {
+      bool same = detSet.detId() == ir->first && detSet.size() == ir->second.size();
+      for (unsigned int i = 0; same && i < detSet.size(); ++i)
+	same = detSet.data[i].packedData() == ir->second[i].packedData();
+      if (!same) {
+	std::cout << "module " << detSet.detId() << " differs from " << ir->first << std::endl;
+	++failures;
+      }
+      ++ir;
+    }
+  }
+
+}
+
+
+int main() {
+  check(std::vector<PixelDataFormatter::DigiBuffer>());
+  check(std::vector<PixelDataFormatter::DigiBuffer>(3));
+  for (unsigned int nFeds : {1, 2, 10, 40}) {
+    for (int trial = 0; trial < 20; ++trial) check(makeBuffers(nFeds));
+  }
+  // only modules without valid pixels
+  PixelDataFormatter::DigiBuffer empty;
+  empty.modules = {302001000, 302000000, 302001000};
+  check(std::vector<PixelDataFormatter::DigiBuffer>(2, empty));
+
+  if (failures) {
+    std::cout << failures << " failures" << std::endl;
+    return 1;
+  }
+  return 0;
+}
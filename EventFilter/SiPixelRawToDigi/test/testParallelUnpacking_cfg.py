@@ -0,0 +1,49 @@
+# check that SiPixelRawToDigi gives the same digis and errors with
+# UseParallelUnpacking True and False, the modules with unpacked ROCs
+# but no valid pixel included (ComparePixelDigis throws at the first difference)
+#
+##############################################################################
+
+import FWCore.ParameterSet.Config as cms
+
+process = cms.Process("ParallelUnpackingTest")
+
+process.load("FWCore.MessageLogger.MessageLogger_cfi")
+process.load("Configuration.Geometry.GeometryIdeal_cff")
+process.load("Configuration.StandardSequences.MagneticField_38T_cff")
+process.load("Configuration.StandardSequences.FrontierConditions_GlobalTag_cff")
+process.load("Configuration.StandardSequences.Services_cff")
+
+process.load("EventFilter.SiPixelRawToDigi.SiPixelRawToDigi_cfi")
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(100)
+)
+
+# several threads, so that the FEDs are unpacked concurrently
+process.options = cms.untracked.PSet(
+    numberOfThreads = cms.untracked.uint32(4),
+    numberOfStreams = cms.untracked.uint32(0)
+)
+
+process.source = cms.Source("PoolSource",
+  fileNames = cms.untracked.vstring(
+  '/store/relval/CMSSW_7_1_0_pre8/RelValTTbar/GEN-SIM-DIGI-RAW-HLTDEBUG/PU_PRE_STA71_V4-v1/00000/06397C95-91E2-E311-963D-02163E00B776.root',
+  )
+)
+
+process.GlobalTag.globaltag = "START71_V1::All"
+
+# reference
+process.siPixelDigis.InputLabel = 'rawDataCollector'
+process.siPixelDigis.IncludeErrors = True
+process.siPixelDigis.UseParallelUnpacking = False
+
+process.siPixelDigisParallel = process.siPixelDigis.clone(UseParallelUnpacking = True)
+
+process.compareParallel = cms.EDAnalyzer("ComparePixelDigis",
+    reference = cms.InputTag("siPixelDigis"),
+    test = cms.InputTag("siPixelDigisParallel")
+)
+
+process.p = cms.Path(process.siPixelDigis*process.siPixelDigisParallel*process.compareParallel)
@@ -43,6 +43,7 @@ namespace edm {
     static void reportReadBranches();
     static void reportReadBranch(InputType inputType, std::string const& branchname);
 
+    std::string const& fileName() const {return fileName_;}
     TObject* Get(char const* name) {return file_->Get(name);}
     TFileCacheRead* GetCacheRead() const {return file_->GetCacheRead();}
     void SetCacheRead(TFileCacheRead* tfcr) {file_->SetCacheRead(tfcr, NULL, TFile::kDoNotDisconnect);}
@@ -15,36 +15,116 @@
 
 #include "TBranch.h"
 #include "TClass.h"
+#include "TFile.h"
+#include "TTree.h"
 
 #include <cassert>
+#include <mutex>
+#include <unordered_map>
 
 namespace edm {
 
+  // When concurrent reads are enabled, each stream reads its products through its own
+  // TFile and TTree, so that no ROOT object is shared between streams.
+  // The mutex only serializes modules of the same stream reading the same event.
+  struct RootDelayedReader::StreamReadContext {
+    std::mutex mutex_;
+    std::unique_ptr<TFile> file_;
+    TTree* tree_ = nullptr;
+    std::unordered_map<TBranch const*, TBranch*> branches_;
+  };
+
   RootDelayedReader::RootDelayedReader(
       RootTree const& tree,
       std::shared_ptr<InputFile> filePtr,
-      InputType inputType) :
+      InputType inputType,
+      unsigned int nIndexes,
+      bool concurrentReads) :
    tree_(tree),
    filePtr_(filePtr),
    nextReader_(),
    resourceAcquirer_(inputType == InputType::Primary ? new SharedResourcesAcquirer() : static_cast<SharedResourcesAcquirer*>(nullptr)),
    inputType_(inputType),
-   wrapperBaseTClass_(TClass::GetClass("edm::WrapperBase")) {
+   wrapperBaseTClass_(TClass::GetClass("edm::WrapperBase")),
+   streamContexts_() {
      if(inputType == InputType::Primary) {
        auto resources = SharedResourcesRegistry::instance()->createAcquirerForSourceDelayedReader();
        resourceAcquirer_=std::make_unique<SharedResourcesAcquirer>(std::move(resources.first));
        mutex_ = resources.second;
+       if(concurrentReads) {
+         streamContexts_.reserve(nIndexes);
+         for(unsigned int index = 0; index < nIndexes; ++index) {
+           streamContexts_.emplace_back(std::make_unique<StreamReadContext>());
+         }
+       }
      }
   }
 
   RootDelayedReader::~RootDelayedReader() {
+    closeStreamReadContexts();
   }
 
   std::pair<SharedResourcesAcquirer*, std::recursive_mutex*>
   RootDelayedReader::sharedResources_() const {
+    if(!streamContexts_.empty()) {
+      // Streams do not share any ROOT object, so reads need not be serialized.
+      return std::pair<SharedResourcesAcquirer*, std::recursive_mutex*>(nullptr, nullptr);
+    }
     return std::make_pair(resourceAcquirer_.get(), mutex_.get());
   }
 
+  void
+  RootDelayedReader::closeStreamReadContexts() {
+    for(auto& context : streamContexts_) {
+      std::lock_guard<std::mutex> guard(context->mutex_);
+      context->branches_.clear();
+      context->tree_ = nullptr;
+      if(context->file_) {
+        // See InputFile.cc for why a TContext is needed here.
+        TDirectory::TContext contextEraser;
+        context->file_->Close();
+        context->file_.reset();
+      }
+    }
+  }
+
+  void
+  RootDelayedReader::openStreamReadContext(StreamReadContext& context) const {
+    std::string const& fileName = filePtr_->fileName();
+    {
+      TDirectory::TContext contextEraser;
+      context.file_.reset(TFile::Open(fileName.c_str()));
+    }
+    if(!context.file_ || context.file_->IsZombie()) {
+      context.file_.reset();
+      throw Exception(errors::FileOpenError, "RootDelayedReader::openStreamReadContext()")
+        << "Could not reopen file " << fileName << " for concurrent delayed reads.\n";
+    }
+    context.tree_ = dynamic_cast<TTree*>(context.file_->Get(tree_.tree()->GetName()));
+    if(context.tree_ == nullptr) {
+      throw Exception(errors::FileReadError, "RootDelayedReader::openStreamReadContext()")
+        << "The TTree " << tree_.tree()->GetName() << " could not be found when reopening file " << fileName << ".\n";
+    }
+  }
+
+  void
+  RootDelayedReader::getEntryFromStreamContext(StreamReadContext& context, TBranch* branch, EntryNumber entryNumber, void** address) const {
+    std::lock_guard<std::mutex> guard(context.mutex_);
+    if(context.tree_ == nullptr) {
+      openStreamReadContext(context);
+    }
+    TBranch*& streamBranch = context.branches_[branch];
+    if(streamBranch == nullptr) {
+      streamBranch = context.tree_->GetBranch(branch->GetName());
+      if(streamBranch == nullptr) {
+        throw Exception(errors::FileReadError, "RootDelayedReader::getEntryFromStreamContext()")
+          << "Branch " << branch->GetName() << " could not be found when reopening file " << filePtr_->fileName() << ".\n";
+      }
+    }
+    streamBranch->SetAddress(address);
+    roottree::getEntry(streamBranch, entryNumber);
+  }
+
   std::unique_ptr<WrapperBase>
   RootDelayedReader::getProduct_(BranchKey const& k, EDProductGetter const* ep) {
     if (lastException_) {
@@ -80,6 +160,17 @@ namespace edm {
     }
     void* p = cp->New();
     std::unique_ptr<WrapperBase> edp = getWrapperBasePtr(p, branchInfo.offsetToWrapperBase_); 
+    if(!streamContexts_.empty()) {
+      // A failure here only affects the TTree private to this stream, so there is
+      // no need to remember the exception for the other threads.
+      getEntryFromStreamContext(*streamContexts_[ep->transitionIndex()], br, tree_.entryNumberForIndex(ep->transitionIndex()), &p);
+      if(tree_.branchType() == InEvent) {
+        // The job report is not thread safe, so take the source lock just for the report.
+        std::lock_guard<std::recursive_mutex> guard(*mutex_);
+        InputFile::reportReadBranch(inputType_, std::string(br->GetName()));
+      }
+      return edp;
+    }
     br->SetAddress(&p);
     try{
       tree_.getEntry(br, tree_.entryNumberForIndex(ep->transitionIndex()));
@@ -17,7 +17,9 @@ RootDelayedReader.h // used by ROOT input sources
 #include <memory>
 #include <string>
 #include <exception>
+#include <vector>
 
+class TBranch;
 class TClass;
 namespace edm {
   class InputFile;
@@ -38,7 +40,9 @@ namespace edm {
     RootDelayedReader(
       RootTree const& tree,
       std::shared_ptr<InputFile> filePtr,
-      InputType inputType);
+      InputType inputType,
+      unsigned int nIndexes,
+      bool concurrentReads);
 
     virtual ~RootDelayedReader();
 
@@ -58,7 +62,14 @@ namespace edm {
       postEventReadFromSourceSignal_ = postEventReadSource;
     }
 
+    // Closes the per-stream files opened for concurrent reads.
+    // Must be called before the primary file is closed.
+    void closeStreamReadContexts();
+
   private:
+    // Private TFile/TTree handle used by one stream when concurrent reads are enabled.
+    struct StreamReadContext;
+
     virtual std::unique_ptr<WrapperBase> getProduct_(BranchKey const& k, EDProductGetter const* ep) override;
     virtual void mergeReaders_(DelayedReader* other) override {nextReader_ = other;}
     virtual void reset_() override {nextReader_ = nullptr;}
@@ -68,6 +79,8 @@ namespace edm {
     iterator branchIter(BranchKey const& k) const {return branches().find(k);}
     bool found(iterator const& iter) const {return iter != branches().end();}
     BranchInfo const& getBranchInfo(iterator const& iter) const {return iter->second; }
+    void openStreamReadContext(StreamReadContext& context) const;
+    void getEntryFromStreamContext(StreamReadContext& context, TBranch* branch, EntryNumber entryNumber, void** address) const;
     // NOTE: filePtr_ appears to be unused, but is needed to prevent
     // the file containing the branch from being reclaimed.
     RootTree const& tree_;
@@ -77,6 +90,8 @@ namespace edm {
     std::shared_ptr<std::recursive_mutex> mutex_;
     InputType inputType_;
     edm::propagate_const<TClass*> wrapperBaseTClass_;
+    // Empty unless concurrent reads are enabled, in which case there is one entry per stream.
+    std::vector<std::unique_ptr<StreamReadContext>> streamContexts_;
     
     signalslot::Signal<void(StreamContext const&, ModuleCallingContext const&)> const* preEventReadFromSourceSignal_ = nullptr;
     signalslot::Signal<void(StreamContext const&, ModuleCallingContext const&)> const* postEventReadFromSourceSignal_ = nullptr;
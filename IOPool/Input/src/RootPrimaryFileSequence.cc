@@ -33,7 +33,8 @@ namespace edm {
     treeCacheSize_(noEventSort_ ? pset.getUntrackedParameter<unsigned int>("cacheSize") : 0U),
     duplicateChecker_(new DuplicateChecker(pset)),
     usingGoToEvent_(false),
-    enablePrefetching_(false) {
+    enablePrefetching_(false),
+    concurrentDelayedReads_(pset.getUntrackedParameter<bool>("concurrentDelayedReads")) {
 
     // The SiteLocalConfig controls the TTreeCache size and the prefetching settings.
     Service<SiteLocalConfig> pSLC;
@@ -143,7 +144,8 @@ namespace edm {
           input_.bypassVersionCheck(),
           input_.labelRawDataLikeMC(),
           usingGoToEvent_,
-          enablePrefetching_);
+          enablePrefetching_,
+          concurrentDelayedReads_);
   }
 
   bool RootPrimaryFileSequence::nextFile() {
@@ -334,6 +336,10 @@ namespace edm {
     desc.addUntracked<std::string>("branchesMustMatch", defaultString)
         ->setComment("'strict':     Branches in each input file must match those in the first file.\n"
                      "'permissive': Branches in each input file may be any subset of those in the first file.");
+    desc.addUntracked<bool>("concurrentDelayedReads", false)
+        ->setComment("True:  Each stream reads event products on demand through its own handle on the input file,\n"
+                     "       so delayed reads from different streams are not serialized.\n"
+                     "False: All delayed reads share the file and are serialized with the source.");
 
     EventSkipperByID::fillDescription(desc);
     DuplicateChecker::fillDescription(desc);
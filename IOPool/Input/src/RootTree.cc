@@ -32,7 +32,8 @@ namespace edm {
                      unsigned int cacheSize,
                      unsigned int learningEntries,
                      bool enablePrefetching,
-                     InputType inputType) :
+                     InputType inputType,
+                     bool concurrentDelayedReads) :
     filePtr_(filePtr),
     tree_(dynamic_cast<TTree*>(filePtr_.get() != nullptr ? filePtr_->Get(BranchTypeToProductTreeName(branchType).c_str()) : nullptr)),
     metaTree_(dynamic_cast<TTree*>(filePtr_.get() != nullptr ? filePtr_->Get(BranchTypeToMetaDataTreeName(branchType).c_str()) : nullptr)),
@@ -58,7 +59,7 @@ namespace edm {
     enablePrefetching_(enablePrefetching),
     //enableTriggerCache_(branchType_ == InEvent),
     enableTriggerCache_(false), // Disable, for now. Using the trigger cache in the multithreaded environment causes the assert on line 331 to fire occasionally.
-    rootDelayedReader_(new RootDelayedReader(*this, filePtr, inputType)),
+    rootDelayedReader_(new RootDelayedReader(*this, filePtr, inputType, nIndexes, concurrentDelayedReads)),
     branchEntryInfoBranch_(metaTree_ ? getProductProvenanceBranch(metaTree_, branchType_) : (tree_ ? getProductProvenanceBranch(tree_, branchType_) : 0)),
     infoTree_(dynamic_cast<TTree*>(filePtr_.get() != nullptr ? filePtr->Get(BranchTypeToInfoTreeName(branchType).c_str()) : nullptr)) // backward compatibility
     {
@@ -440,6 +441,8 @@ namespace edm {
     // We make sure the treeCache_ is detached from the file,
     // so that ROOT does not also delete it.
     filePtr_->SetCacheRead(0);
+    // The per-stream files used for concurrent delayed reads must not outlive the primary file.
+    rootDelayedReader_->closeStreamReadContexts();
     // We *must* delete the TTreeCache here because the TFilePrefetch object
     // references the TFile.  If TFile is closed, before the TTreeCache is
     // deleted, the TFilePrefetch may continue to do TFile operations, causing
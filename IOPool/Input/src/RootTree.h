@@ -77,7 +77,8 @@ namespace edm {
              unsigned int cacheSize,
              unsigned int learningEntries,
              bool enablePrefetching,
-             InputType inputType);
+             InputType inputType,
+             bool concurrentDelayedReads);
     ~RootTree();
 
     RootTree(RootTree const&) = delete; // Disallow copying and moving
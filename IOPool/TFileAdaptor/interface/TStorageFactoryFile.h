@@ -10,6 +10,7 @@
 #include "FWCore/Utilities/interface/get_underlying_safe.h"
 
 
+class ClusterPrefetcher;
 class Storage;
 
 /** TFile wrapper around #StorageFactory and #Storage.  */
@@ -55,9 +56,12 @@ private:
 
   void                  releaseStorage() {get_underlying_safe(storage_).release();}
 
+  void                  startPrefetcher(const char *path, int openFlags);
+
   TStorageFactoryFile(void);
 
   edm::propagate_const<std::unique_ptr<Storage>> storage_; //< Real underlying storage
+  edm::propagate_const<std::unique_ptr<ClusterPrefetcher>> prefetcher_; //< Background read-ahead, if enabled
 };
 
 #endif // TFILE_ADAPTOR_TSTORAGE_FACTORY_FILE_H
@@ -0,0 +1,218 @@
+
+#include <algorithm>
+#include <cassert>
+#include <string.h>
+
+#include "ClusterPrefetcher.h"
+#include "Utilities/StorageFactory/interface/Storage.h"
+#include "Utilities/StorageFactory/interface/StorageAccount.h"
+
+static StorageAccount::Counter &
+prefetchCounter(StorageAccount::Operation operation)
+{
+  static const auto token = StorageAccount::tokenForStorageClassName("tstoragefile");
+  return StorageAccount::counter(token, operation);
+}
+
+ClusterPrefetcher::ClusterPrefetcher(std::unique_ptr<Storage> storage, unsigned int clusters, IOSize poolSize)
+  : m_storage(std::move(storage)),
+    m_clusters(clusters),
+    m_pool_size(poolSize),
+    m_file_size(m_storage->size()),
+    m_pool_used(0),
+    m_blocks(),
+    m_stop(false),
+    m_thread([this]() { run(); })
+{
+}
+
+ClusterPrefetcher::~ClusterPrefetcher()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_cond.notify_all();
+  m_thread.join();
+  for (auto &block : m_blocks) {
+    release(block);
+  }
+  m_blocks.clear();
+  m_storage->close();
+}
+
+ClusterPrefetcher::Block *
+ClusterPrefetcher::findBlock(IOOffset pos)
+{
+  for (auto &block : m_blocks) {
+    if (! block.discard && block.offset <= pos && pos < block.end()) {
+      return &block;
+    }
+  }
+  return nullptr;
+}
+
+void
+ClusterPrefetcher::release(Block &block)
+{
+  if (block.state == State::Ready && block.used < block.size) {
+    StorageAccount::Stamp wstats(prefetchCounter(StorageAccount::Operation::readAheadWasted));
+    wstats.tick(block.size - block.used);
+  }
+  m_pool_used -= block.size;
+}
+
+/**
+   Copy the requested byte ranges out of the prefetched blocks.
+   A range may straddle consecutive blocks.  Blocks that are still being
+   read are waited for; this is cheaper than issuing the same read again.
+   If any range is not covered, nothing is copied and the caller must read
+   everything from the storage.
+ */
+bool
+ClusterPrefetcher::read(char *buf, long long int *pos, int *len, int nbuf)
+{
+  StorageAccount::Stamp hstats(prefetchCounter(StorageAccount::Operation::readAheadHit));
+  std::unique_lock<std::mutex> lock(m_mutex);
+
+  std::vector<Segment> segments;
+  segments.reserve(nbuf);
+  for (int i = 0; i < nbuf; ++i) {
+    IOOffset from = pos[i];
+    IOOffset to = pos[i] + len[i];
+    while (from < to) {
+      Block *block = findBlock(from);
+      if (block == nullptr) {
+        StorageAccount::Stamp mstats(prefetchCounter(StorageAccount::Operation::readAheadMiss));
+        mstats.tick();
+        return false;
+      }
+      IOOffset next = std::min(to, block->end());
+      segments.push_back(Segment{block, from, IOSized(next - from)});
+      from = next;
+    }
+  }
+
+  for (auto const &segment : segments) {
+    Block *block = segment.block;
+    m_cond.wait(lock, [this, block]() {
+      return m_stop || block->state == State::Ready || block->state == State::Failed;
+    });
+    if (block->state != State::Ready) {
+      StorageAccount::Stamp mstats(prefetchCounter(StorageAccount::Operation::readAheadMiss));
+      mstats.tick();
+      return false;
+    }
+  }
+
+  // The blocks are not released while the lock is held.
+  IOSize total = 0;
+  for (auto const &segment : segments) {
+    Block &block = *segment.block;
+    memcpy(buf, &block.data[segment.pos - block.offset], segment.len);
+    block.used += segment.len;
+    buf += segment.len;
+    total += segment.len;
+  }
+  hstats.tick(total);
+  return true;
+}
+
+void
+ClusterPrefetcher::schedule(IOOffset begin, IOOffset end)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    IOOffset span = end - begin;
+    IOOffset limit = std::min(m_file_size, end + std::max(span, IOOffset(0)) * static_cast<IOOffset>(m_clusters));
+
+    // Only the blocks overlapping the read-ahead window [begin, limit) can
+    // be asked for: those before it will not be read again, those after it
+    // are left over from before a backward seek.  The blocks in flight are
+    // erased by the background thread once read.
+    for (auto it = m_blocks.begin(); it != m_blocks.end(); ) {
+      if (! it->discard && (it->end() <= begin || it->offset >= limit)) {
+        if (it->state == State::InFlight) {
+          it->discard = true;
+          ++it;
+        } else {
+          release(*it);
+          it = m_blocks.erase(it);
+        }
+      } else {
+        ++it;
+      }
+    }
+
+    if (span <= 0) {
+      return;
+    }
+
+    // Continue after whatever has already been scheduled in the window.
+    IOOffset next = end;
+    for (auto const &block : m_blocks) {
+      if (! block.discard) {
+        next = std::max(next, block.end());
+      }
+    }
+    while (next < limit) {
+      IOSize size = IOSized(std::min(span, limit - next));
+      if (m_pool_used + size > m_pool_size) {
+        break;
+      }
+      m_blocks.push_back(Block{next, size, std::vector<char>(), 0, State::Pending, false});
+      m_pool_used += size;
+      next += size;
+    }
+  }
+  m_cond.notify_all();
+}
+
+void
+ClusterPrefetcher::run()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (true) {
+    auto pending = m_blocks.end();
+    m_cond.wait(lock, [this, &pending]() {
+      pending = std::find_if(m_blocks.begin(), m_blocks.end(),
+                             [](Block const &block) { return block.state == State::Pending; });
+      return m_stop || pending != m_blocks.end();
+    });
+    if (m_stop) {
+      return;
+    }
+
+    // Nobody else touches the data of a block while it is in flight,
+    // and in-flight blocks are never erased by the other threads.
+    Block &block = *pending;
+    block.state = State::InFlight;
+    lock.unlock();
+
+    IOSize got = 0;
+    try {
+      StorageAccount::Stamp stats(prefetchCounter(StorageAccount::Operation::readAhead));
+      block.data.resize(block.size);
+      while (got < block.size) {
+        IOSize n = m_storage->read(&block.data[got], block.size - got, block.offset + got);
+        if (n == 0) {
+          break;
+        }
+        got += n;
+      }
+      stats.tick(got);
+    } catch (...) {
+      // The reading thread will issue the read itself and report the error.
+      got = 0;
+    }
+
+    lock.lock();
+    block.state = (got == block.size) ? State::Ready : State::Failed;
+    if (block.discard) {
+      release(block);
+      m_blocks.erase(pending);
+    }
+    m_cond.notify_all();
+  }
+}
@@ -0,0 +1,100 @@
+#ifndef TFILE_ADAPTOR_CLUSTER_PREFETCHER_H
+# define TFILE_ADAPTOR_CLUSTER_PREFETCHER_H
+
+/**
+ * Read ahead of the TTreeCache on a background thread.
+ *
+ * When the TTreeCache fills itself, it issues one vectored read covering
+ * all the baskets of the current cluster.  The clusters of a TTree are
+ * written one after the other, so the next clusters usually follow the
+ * byte range of the current one in the file.  After each such read, the
+ * prefetcher schedules the next N ranges of the same span and fetches them
+ * into a bounded pool of memory on its own thread.  The following cache
+ * fill is then served by a copy from memory, or waits for a read that is
+ * already in flight, instead of going to the storage.  A request may span
+ * several consecutive blocks.
+ *
+ * The background thread reads through its own Storage, opened on the same
+ * file, so that it never blocks the accesses of the owning file.  Blocks
+ * outside of the read-ahead window of the last cache fill (before it, or
+ * after it following a backward seek) are released.
+ *
+ * Statistics are recorded under the "tstoragefile" class: readAhead for the
+ * bytes fetched, readAheadHit and readAheadMiss for the cache fills served or
+ * not from the pool, and readAheadWasted for bytes fetched but never used.
+ */
+
+# include <condition_variable>
+# include <list>
+# include <memory>
+# include <mutex>
+# include <thread>
+# include <vector>
+
+# include "Utilities/StorageFactory/interface/IOTypes.h"
+
+class Storage;
+
+class ClusterPrefetcher {
+
+public:
+
+// The prefetcher reads from "storage", a handle of its own on the file.
+ClusterPrefetcher(std::unique_ptr<Storage> storage, unsigned int clusters, IOSize poolSize);
+~ClusterPrefetcher();
+
+ClusterPrefetcher(ClusterPrefetcher const&) = delete; // Disallow copying and moving
+ClusterPrefetcher& operator=(ClusterPrefetcher const&) = delete; // Disallow copying and moving
+
+// Tries to serve a vectored read from the prefetched blocks.  Returns true
+// only if all nbuf requests were copied into buf, packed one after the other.
+bool
+read(char          *buf,   // Destination, as for TFile::ReadBuffers.
+     long long int *pos,   // An array of file offsets to read.
+     int           *len,   // An array of lengths to read.
+     int            nbuf); // Size of the pos and len array.
+
+// Informs the prefetcher that [begin, end) was just read, so that it can
+// release the blocks outside of the read-ahead window and schedule the next
+// clusters after it.
+void schedule(IOOffset begin, IOOffset end);
+
+private:
+
+enum class State { Pending, InFlight, Ready, Failed };
+
+struct Block {
+  IOOffset          offset;
+  IOSize            size;
+  std::vector<char> data;    // Allocated and filled by the background thread.
+  IOSize            used;    // Bytes copied out so far, for the wasted bytes statistics.
+  State             state;
+  bool              discard; // Released while in flight, erased once read.
+  IOOffset end() const { return offset + static_cast<IOOffset>(size); }
+};
+
+// A part of a request, copied from one block.
+struct Segment {
+  Block   *block;
+  IOOffset pos;
+  IOSize   len;
+};
+
+void run(); // Body of the background thread.
+Block *findBlock(IOOffset pos); // Requires m_mutex.
+void release(Block &block); // Requires m_mutex.
+
+std::unique_ptr<Storage>  m_storage;       // Only used by the background thread.
+unsigned int const        m_clusters;      // Number of clusters to read ahead.
+IOSize const              m_pool_size;     // Maximum number of bytes held in m_blocks.
+IOOffset const            m_file_size;
+IOSize                    m_pool_used;     // Number of bytes currently held in m_blocks.
+std::list<Block>          m_blocks;        // List so that references stay valid.
+bool                      m_stop;
+std::mutex                m_mutex;         // Protects all the members above.
+std::condition_variable   m_cond;
+std::thread               m_thread;
+
+};
+
+#endif // TFILE_ADAPTOR_CLUSTER_PREFETCHER_H
@@ -87,6 +87,8 @@
       minFree_(0),
       timeout_(0U),
       debugLevel_(0U),
+      prefetchClusters_(0U),
+      prefetchPoolSize_(64U),
       native_() {
     if (!(enabled_ = pset.getUntrackedParameter<bool> ("enable", enabled_)))
       return;
@@ -103,6 +105,8 @@
     tempDir_ = pset.getUntrackedParameter<std::string> ("tempDir", f->tempPath());
     minFree_ = pset.getUntrackedParameter<double> ("tempMinFree", f->tempMinFree());
     native_ = pset.getUntrackedParameter<std::vector<std::string> >("native", native_);
+    prefetchClusters_ = pset.getUntrackedParameter<unsigned int> ("prefetchClusters", prefetchClusters_);
+    prefetchPoolSize_ = pset.getUntrackedParameter<unsigned int> ("prefetchPoolSize", prefetchPoolSize_);
 
     ar.watchPostEndJob(this, &TFileAdaptor::termination);
 
@@ -157,15 +161,20 @@
       f->setReadHint(StorageFactory::READ_HINT_READAHEAD);
     else if (readHint_ == "auto-detect")
       f->setReadHint(StorageFactory::READ_HINT_AUTO);
+    else if (readHint_ == "memory-mapped")
+      f->setReadHint(StorageFactory::READ_HINT_MMAP);
     else
       throw cms::Exception("TFileAdaptor")
         << "Unrecognised 'readHint' value '" << readHint_
         << "', recognised values are 'direct-unbuffered',"
-        << " 'read-ahead-buffered', 'auto-detect'";
+        << " 'read-ahead-buffered', 'auto-detect', 'memory-mapped'";
 
     f->setTimeout(timeout_);
     f->setDebugLevel(debugLevel_);
 
+    // read-ahead of the next TTree clusters on a background thread; pool size is in MB
+    f->setPrefetchClusters(prefetchClusters_, static_cast<IOSize>(prefetchPoolSize_) * 1024 * 1024);
+
     // enable file access stats accounting if requested
     f->enableAccounting(doStats_);
 
@@ -207,6 +216,8 @@
     desc.addOptionalUntracked<std::string>("tempDir");
     desc.addOptionalUntracked<double>("tempMinFree");
     desc.addOptionalUntracked<std::vector<std::string> >("native");
+    desc.addOptionalUntracked<unsigned int>("prefetchClusters");
+    desc.addOptionalUntracked<unsigned int>("prefetchPoolSize");
     descriptions.add("AdaptorConfig", desc);
   }
 
@@ -232,6 +243,7 @@
       << " Prefetching:" << (enablePrefetching_ ? "true" : "false") << '\n'
       << " Cache hint:" << cacheHint_ << '\n'
       << " Read hint:" << readHint_ << '\n'
+      << " Prefetch clusters:" << prefetchClusters_ << '\n'
       << "Storage statistics: "
       << StorageAccount::summaryText()
       << "; tfile/read=?/?/" << (TFile::GetFileBytesRead() / oneMeg) << "MB/?ms/?ms/?ms"
@@ -249,6 +261,7 @@
     data.insert(std::make_pair("Parameter-untracked-bool-prefetching", (enablePrefetching_ ? "true" : "false")));
     data.insert(std::make_pair("Parameter-untracked-string-cacheHint", cacheHint_));
     data.insert(std::make_pair("Parameter-untracked-string-readHint", readHint_));
+    data.insert(std::make_pair("Parameter-untracked-uint32-prefetchClusters", std::to_string(prefetchClusters_)));
     StorageAccount::fillSummary(data);
     std::ostringstream r;
     std::ostringstream w;
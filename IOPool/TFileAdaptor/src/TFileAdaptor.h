@@ -45,6 +45,8 @@ private:
   double minFree_;
   unsigned int timeout_;
   unsigned int debugLevel_;
+  unsigned int prefetchClusters_;
+  unsigned int prefetchPoolSize_;
   std::vector<std::string> native_;
 
 };
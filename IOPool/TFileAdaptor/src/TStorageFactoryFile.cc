@@ -7,6 +7,7 @@
 #include "FWCore/Utilities/interface/EDMException.h"
 #include "FWCore/Utilities/interface/ExceptionPropagate.h"
 #include "ReadRepacker.h"
+#include "ClusterPrefetcher.h"
 #include "TFileCacheRead.h"
 #include "TSystem.h"
 #include "TROOT.h"
@@ -16,6 +17,7 @@
 #include <unistd.h>
 #include <fcntl.h>
 #include <iostream>
+#include <algorithm>
 #include <cassert>
 
 #if 0
@@ -95,7 +97,8 @@ storageCounter(StorageAccount::Counter *&c, StorageAccount::Operation operation)
 }
 
 TStorageFactoryFile::TStorageFactoryFile(void)
-  : storage_()
+  : storage_(),
+    prefetcher_()
 {
   StorageAccount::Stamp stats(storageCounter(s_statsCtor, StorageAccount::Operation::construct));
   stats.tick(0);
@@ -112,7 +115,8 @@ TStorageFactoryFile::TStorageFactoryFile(const char *path,
                                          Int_t netopt,
                                          Bool_t parallelopen /* = kFALSE */)
   : TFile(path, "NET", ftitle, compress), // Pass "NET" to prevent local access in base class
-    storage_()
+    storage_(),
+    prefetcher_()
 {
   try {
     Initialize(path, option);
@@ -126,7 +130,8 @@ TStorageFactoryFile::TStorageFactoryFile(const char *path,
                                          const char *ftitle /* = "" */,
                                          Int_t compress /* = 1 */)
   : TFile(path, "NET", ftitle, compress), // Pass "NET" to prevent local access in base class
-    storage_()
+    storage_(),
+    prefetcher_()
 {
   try {
     Initialize(path, option);
@@ -213,6 +218,8 @@ TStorageFactoryFile::Initialize(const char *path,
     }
   }
 
+  startPrefetcher(path, openFlags);
+
   fRealName = path;
   fD = 0; // sorry, meaningless
   fWritable = read ? kFALSE : kTRUE;
@@ -227,6 +234,27 @@ TStorageFactoryFile::~TStorageFactoryFile(void)
   Close();
 }
 
+void
+TStorageFactoryFile::startPrefetcher(const char *path, int openFlags)
+{
+  // Only read-only files can be read ahead; the prefetched data would
+  // otherwise go stale on writes.  The prefetcher reads through a storage
+  // of its own, as the Storage interface is not thread safe.  Without it,
+  // the file is simply read without read-ahead.
+  const StorageFactory *f = StorageFactory::get();
+  if (f->prefetchClusters() > 0 && f->prefetchPoolSize() > 0
+      && ! (openFlags & IOFlags::OpenWrite))
+  {
+    std::unique_ptr<Storage> storage;
+    try {
+      storage = f->open(path, IOFlags::OpenRead);
+    } catch (cms::Exception const &) {
+    }
+    if (storage)
+      prefetcher_ = std::make_unique<ClusterPrefetcher>(std::move(storage), f->prefetchClusters(), f->prefetchPoolSize());
+  }
+}
+
 //////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////
@@ -392,6 +420,25 @@ TStorageFactoryFile::ReadBuffersSync(char *buf, Long64_t *pos, Int_t *len, Int_t
   // the size of the various requests.
   for (Int_t i=0; i<nbuf; i++) remaining_buffer_size+=len[i];
 
+  /** A vectored read is how the TTreeCache fills itself with a cluster.
+   *  If read-ahead is enabled, serve it from the prefetched blocks when
+   *  possible, and in any case let the prefetcher fetch the clusters that
+   *  follow this one.
+   */
+  if (prefetcher_ && nbuf > 0) {
+    Long64_t begin = pos[0];
+    Long64_t end = pos[0] + len[0];
+    for (Int_t i=1; i<nbuf; i++) {
+      begin = std::min(begin, pos[i]);
+      end = std::max(end, pos[i] + len[i]);
+    }
+    bool hit = prefetcher_->read(buf, static_cast<long long int *>(pos), len, nbuf);
+    prefetcher_->schedule(begin, end);
+    if (hit) {
+      return kFALSE;
+    }
+  }
+
   char     *current_buffer = buf;
   Long64_t *current_pos    = pos;
   Int_t    *current_len    = len;
@@ -544,6 +591,7 @@ TStorageFactoryFile::SysOpen(const char *pathname, Int_t flags, UInt_t /* mode *
 {
   StorageAccount::Stamp stats(storageCounter(s_statsOpen, StorageAccount::Operation::open));
 
+  prefetcher_ = nullptr; // propagate_const<T> has no reset() function
   if (storage_)
   {
     storage_->close();
@@ -566,6 +614,8 @@ TStorageFactoryFile::SysOpen(const char *pathname, Int_t flags, UInt_t /* mode *
        << "Cannot open file '" << pathname << "'";
   }
 
+  startPrefetcher(pathname, openFlags);
+
   stats.tick();
   return 0;
 }
@@ -575,6 +625,7 @@ TStorageFactoryFile::SysClose(Int_t /* fd */)
 {
   StorageAccount::Stamp stats(storageCounter(s_statsClose, StorageAccount::Operation::close));
 
+  prefetcher_ = nullptr; // propagate_const<T> has no reset() function
   if (storage_)
   {
     storage_->close();
@@ -0,0 +1,117 @@
+#include "IOPool/TFileAdaptor/src/ClusterPrefetcher.h"
+#include "Utilities/StorageFactory/interface/Storage.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+namespace {
+  // A read-only file in memory.
+  class MemoryStorage : public Storage {
+  public:
+    MemoryStorage(std::vector<char> const& data) : data_(data), position_(0) {}
+
+    using Storage::read;
+    using Storage::write;
+    using Storage::position;
+
+    IOSize read(void* into, IOSize n, IOOffset pos) override {
+      if (pos >= size()) return 0;
+      IOSize got = std::min<IOOffset>(n, size() - pos);
+      std::memcpy(into, &data_[pos], got);
+      return got;
+    }
+    IOSize read(void* into, IOSize n) override {
+      IOSize got = read(into, n, position_);
+      position_ += got;
+      return got;
+    }
+    IOSize write(const void*, IOSize) override { return 0; }
+    IOOffset size() const override { return data_.size(); }
+    IOOffset position(IOOffset offset, Relative whence) override {
+      position_ = offset + (whence == SET ? 0 : whence == CURRENT ? position_ : size());
+      return position_;
+    }
+    void resize(IOOffset) override {}
+    void close() override {}
+
+  private:
+    std::vector<char> const& data_;
+    IOOffset position_;
+  };
+
+  int failures = 0;
+
+  // Reads [begin, end) as one request, then tells the prefetcher about it as
+  // TStorageFactoryFile::ReadBuffersSync does.
+  bool readCluster(ClusterPrefetcher& prefetcher, std::vector<char> const& data,
+                   long long begin, long long end) {
+    std::vector<char> buf(end - begin);
+    long long pos[1] = {begin};
+    int len[1] = {int(end - begin)};
+    bool hit = prefetcher.read(&buf[0], pos, len, 1);
+    prefetcher.schedule(begin, end);
+    if (hit && std::memcmp(&buf[0], &data[begin], buf.size()) != 0) {
+      std::cout << "wrong data for [" << begin << ", " << end << ")" << std::endl;
+      ++failures;
+    }
+    return hit;
+  }
+
+  void check(bool ok, char const* what) {
+    if (!ok) {
+      std::cout << "failed: " << what << std::endl;
+      ++failures;
+    }
+  }
+}
+
+int main() {
+  std::vector<char> data(1000000);
+  for (unsigned int i = 0; i < data.size(); ++i) data[i] = char(i * 7 % 251);
+
+  // Two clusters ahead, and room for exactly two of them: the pool is full
+  // as long as the blocks that are no longer needed are not released.
+  ClusterPrefetcher prefetcher(std::make_unique<MemoryStorage>(data), 2, 2000);
+
+  // Sequential clusters: only the first one misses.
+  check(!readCluster(prefetcher, data, 0, 1000), "first cluster is a miss");
+  check(readCluster(prefetcher, data, 1000, 2000), "second cluster is prefetched");
+  check(readCluster(prefetcher, data, 2000, 3000), "third cluster is prefetched");
+
+  // A request straddling two blocks, [2000, 3000) and [3000, 4000).
+  check(readCluster(prefetcher, data, 2500, 3500), "straddling request is served from two blocks");
+
+  // A vectored request over the same two blocks.
+  {
+    std::vector<char> buf(1200);
+    long long pos[3] = {2100, 2900, 3600};
+    int len[3] = {300, 600, 300};
+    check(prefetcher.read(&buf[0], pos, len, 3), "vectored request is prefetched");
+    check(std::memcmp(&buf[0], &data[2100], 300) == 0 &&
+          std::memcmp(&buf[300], &data[2900], 600) == 0 &&
+          std::memcmp(&buf[900], &data[3600], 300) == 0, "vectored request data");
+    prefetcher.schedule(2100, 3900);
+  }
+
+  // Forward seek, then backward seek: the blocks left over from the far
+  // position must be released for the new ones to fit in the pool.
+  check(!readCluster(prefetcher, data, 500000, 501000), "forward seek is a miss");
+  check(readCluster(prefetcher, data, 501000, 502000), "cluster after the forward seek is prefetched");
+  check(!readCluster(prefetcher, data, 10000, 11000), "backward seek is a miss");
+  check(readCluster(prefetcher, data, 11000, 12000), "cluster after the backward seek is prefetched");
+  check(readCluster(prefetcher, data, 12000, 13000), "second cluster after the backward seek is prefetched");
+
+  // The end of the file.
+  check(!readCluster(prefetcher, data, 998000, 999000), "seek to the end is a miss");
+  check(readCluster(prefetcher, data, 999000, 1000000), "last cluster is prefetched");
+  check(!readCluster(prefetcher, data, 999500, 1000500), "request past the end is a miss");
+
+  if (failures) {
+    std::cout << failures << " failures" << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -30,6 +30,11 @@ class MagneticField
   /// Field value ad specified global point, in Tesla
   virtual GlobalVector inTesla (const GlobalPoint& gp) const = 0;
 
+  /// Field values at the n points gp[0..n-1], in Tesla, stored in b[0..n-1].
+  /// Same as inTesla for each point: engines that can compute several
+  /// points faster than one at a time override it.
+  virtual void inTeslaBatch(const GlobalPoint* gp, GlobalVector* b, unsigned int n) const;
+
   /// Field value ad specified global point, in KGauss
   GlobalVector inKGauss(const GlobalPoint& gp) const  {
     return inTesla(gp) * 10.F;
@@ -0,0 +1,26 @@
+#
+# Accuracy of the field grid (RZPhiFieldGrid) against the field of the volumes,
+# at random points in the region of the grid. The parameters of the grid are
+# those of useFieldGrid in the VolumeBasedMagneticFieldESProducer.
+
+import FWCore.ParameterSet.Config as cms
+
+process = cms.Process("MAGNETICFIELDTEST")
+
+process.source = cms.Source("EmptySource")
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(1)
+)
+
+process.load("Configuration.StandardSequences.MagneticField_38T_cff")
+
+process.testField  = cms.EDAnalyzer("testMagneticField",
+    gridPoints = cms.untracked.int32(100000),
+    gridRMax = cms.untracked.double(129.),
+    gridZMax = cms.untracked.double(300.),
+    gridRStep = cms.untracked.double(1.),
+    gridZStep = cms.untracked.double(1.),
+    gridNPhi = cms.untracked.uint32(60),
+    gridResolution = cms.untracked.double(0.001)
+)
+process.p1 = cms.Path(process.testField)
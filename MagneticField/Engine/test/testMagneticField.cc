@@ -12,6 +12,9 @@
  *  TOSCA = input test tables, searches for the corresponding volume/sector determined from the file name and path.
  *  TOSCAFileList = file with a list of TOSCA tables
  *  TOSCASecorComparison: compare each if the listed TOSCA txt tables with those of the other sectors
+ *
+ *  gridPoints: number of random points where the field of a RZPhiFieldGrid (built with gridRMax, gridZMax,
+ *  gridRStep, gridZStep, gridNPhi) is compared to the one of the volumes; differences above gridResolution are reported.
  * 
  *  \author N. Amapane - CERN
  */
@@ -38,6 +41,7 @@
 #include "MagneticField/VolumeBasedEngine/interface/MagGeometry.h"
 #include "MagneticField/VolumeGeometry/interface/MagVolume6Faces.h"
 
+#include <chrono>
 #include <iostream>
 #include <string>
 #include <sstream>
@@ -71,7 +75,15 @@ class testMagneticField : public edm::EDAnalyzer {
     OuterRadius = pset.getUntrackedParameter<double>("OuterRadius",900);
     //    half length of test cylinder
     HalfLength = pset.getUntrackedParameter<double>("HalfLength",1600);
-    
+
+    //    accuracy of the field grid
+    gridPoints = pset.getUntrackedParameter<int>("gridPoints", 0);
+    gridRMax = pset.getUntrackedParameter<double>("gridRMax", 129.);
+    gridZMax = pset.getUntrackedParameter<double>("gridZMax", 300.);
+    gridRStep = pset.getUntrackedParameter<double>("gridRStep", 1.);
+    gridZStep = pset.getUntrackedParameter<double>("gridZStep", 1.);
+    gridNPhi = pset.getUntrackedParameter<unsigned int>("gridNPhi", 60);
+    gridResolution = pset.getUntrackedParameter<double>("gridResolution", 0.001);
   }
 
   ~testMagneticField(){}
@@ -116,6 +128,10 @@ class testMagneticField : public edm::EDAnalyzer {
      validate (inputFile, inputFileType);
    }
 
+   if (gridPoints>0) {
+     validateGrid();
+   }
+
    // Some ad-hoc test
 //    for (float phi = 0; phi<Geom::twoPi(); phi+=Geom::pi()/48.) {
 //      go(GlobalPoint(Cylindrical2Cartesian<float>(89.,phi,145.892)), magfield.product());
@@ -125,6 +141,7 @@ class testMagneticField : public edm::EDAnalyzer {
   void writeValidationTable(int npoints, string filename);
   void validate(string filename, string type="xyz");
   void validateVsTOSCATable(string filename);
+  void validateGrid();
 
   const MagVolume6Faces* findVolume(GlobalPoint& gp);
   const MagVolume6Faces* findMasterVolume(int volume, int sector);
@@ -143,6 +160,13 @@ class testMagneticField : public edm::EDAnalyzer {
   double OuterRadius;
   double InnerRadius;
   double HalfLength;
+  int gridPoints;
+  double gridRMax;
+  double gridZMax;
+  double gridRStep;
+  double gridZStep;
+  unsigned int gridNPhi;
+  double gridResolution;
 };
 
 
@@ -467,6 +491,7 @@ void testMagneticField::fillFromTable(string inputFile, vector<GlobalPoint>& p,
 
 
 #include "MagneticField/VolumeBasedEngine/interface/VolumeBasedMagneticField.h"
+#include "MagneticField/VolumeBasedEngine/interface/RZPhiFieldGrid.h"
 
 // Get the pointer of the volume containing a point
 const MagVolume6Faces* testMagneticField::findVolume(GlobalPoint& gp) {
@@ -504,6 +529,45 @@ const MagVolume6Faces* testMagneticField::findMasterVolume(int volume, int secto
 }
 
 
+// Compare the interpolation of a RZPhiFieldGrid with the field of the volumes it is filled from
+void testMagneticField::validateGrid() {
+  const VolumeBasedMagneticField* vbffield = dynamic_cast<const VolumeBasedMagneticField*>(field);
+  if (vbffield==0) {
+    cout << "testMagneticField::validateGrid: not a VolumeBasedMagneticField" << endl;
+    return;
+  }
+  const MagGeometry* geometry = vbffield->field;
+
+  auto start = std::chrono::steady_clock::now();
+  RZPhiFieldGrid grid(*geometry, gridRMax, gridZMax, gridRStep, gridZStep, gridNPhi);
+  std::chrono::duration<double> buildTime = std::chrono::steady_clock::now() - start;
+
+  GlobalPointProvider p(0., gridRMax, -Geom::pi(), Geom::pi(), -gridZMax, gridZMax);
+  int fail = 0;
+  int count = 0;
+  float maxdelta = 0.;
+  double sumdelta = 0.;
+  while (count < gridPoints) {
+    GlobalPoint gp = p.getPoint();
+    if (!grid.isDefined(gp)) continue;
+    GlobalVector volumeB = geometry->fieldInTesla(gp);
+    GlobalVector gridB = grid.inTesla(gp);
+    float delta = (gridB-volumeB).mag();
+    if (delta > gridResolution) {
+      ++fail;
+      cout << " Grid discrepancy at: " << gp << " R " << gp.perp() << " Phi " << gp.phi()
+	   << " volumes: " << volumeB << " grid: " << gridB << " " << delta << endl;
+    }
+    if (delta > maxdelta) maxdelta = delta;
+    sumdelta += delta;
+    ++count;
+  }
+  cout << endl << " testMagneticField::validateGrid: " << grid.size() << " nodes built in " << buildTime.count()
+       << " s; tested " << count << " points " << fail << " failures; max delta = " << maxdelta
+       << " mean delta = " << sumdelta/count << endl << endl;
+}
+
+
  
 
 DEFINE_FWK_MODULE(testMagneticField);
@@ -65,7 +65,15 @@ std::unique_ptr<MagneticField> VolumeBasedMagneticFieldESProducer::produce(const
   if (pset.getParameter<bool>("useParametrizedTrackerField")) {;
     iRecord.get(pset.getParameter<string>("paramLabel"),paramField);
   }
-  return std::make_unique<VolumeBasedMagneticField>(conf.geometryVersion,builder.barrelLayers(), builder.endcapSectors(), builder.barrelVolumes(), builder.endcapVolumes(), builder.maxR(), builder.maxZ(), paramField.product(), false);
+  auto field = std::make_unique<VolumeBasedMagneticField>(conf.geometryVersion,builder.barrelLayers(), builder.endcapSectors(), builder.barrelVolumes(), builder.endcapVolumes(), builder.maxR(), builder.maxZ(), paramField.product(), false);
+
+  // Optionally precompute the field on a grid (see RZPhiFieldGrid)
+  if (pset.existsAs<bool>("useFieldGrid") && pset.getParameter<bool>("useFieldGrid")) {
+    field->useGrid(pset.getParameter<double>("fieldGridRMax"), pset.getParameter<double>("fieldGridZMax"),
+		   pset.getParameter<double>("fieldGridRStep"), pset.getParameter<double>("fieldGridZStep"),
+		   pset.getParameter<unsigned int>("fieldGridNPhi"));
+  }
+  return field;
 }
 
 
@@ -148,7 +148,15 @@ std::unique_ptr<MagneticField> VolumeBasedMagneticFieldESProducerFromDB::produce
     builder.build(*cpv);
 
     // Build the VB map. Ownership of the parametrization is transferred to it
-    return std::make_unique<VolumeBasedMagneticField>(conf->geometryVersion,builder.barrelLayers(), builder.endcapSectors(), builder.barrelVolumes(), builder.endcapVolumes(), builder.maxR(), builder.maxZ(), paramField.release(), true);
+    auto field = std::make_unique<VolumeBasedMagneticField>(conf->geometryVersion,builder.barrelLayers(), builder.endcapSectors(), builder.barrelVolumes(), builder.endcapVolumes(), builder.maxR(), builder.maxZ(), paramField.release(), true);
+
+    // Optionally precompute the field on a grid (see RZPhiFieldGrid)
+    if (pset.existsAs<bool>("useFieldGrid") && pset.getParameter<bool>("useFieldGrid")) {
+      field->useGrid(pset.getParameter<double>("fieldGridRMax"), pset.getParameter<double>("fieldGridZMax"),
+		     pset.getParameter<double>("fieldGridRStep"), pset.getParameter<double>("fieldGridZStep"),
+		     pset.getParameter<unsigned int>("fieldGridNPhi"));
+    }
+    return field;
   }
 }
 
@@ -43,22 +43,30 @@ namespace magfieldparam {
   namespace bcylDetails{
     
     template<typename T>
-    inline void ffunkti(T u, T * __restrict__ ff) __attribute__((always_inline));
+    inline void ffunkti(T u, T a, T b, T * __restrict__ ff) __attribute__((always_inline));
     
+    // same as below, given a=1/(1+u*u) and b=sqrt(a)
     template<typename T>
-    inline void ffunkti(T u, T * __restrict__ ff) {
-      // Function and its 3 derivatives
-      T a,b,a2,u2;
+    inline void ffunkti(T u, T a, T b, T * __restrict__ ff) {
+      T a2,u2;
       u2=u*u; 
-      a=T(1)/(T(1)+u2);
       a2=-T(3)*a*a;
-      b=std::sqrt(a);
       ff[0]=u*b;
       ff[1]=a*b;
       ff[2]=a2*ff[0];
       ff[3]=a2*ff[1]*(T(1)-4*u2);
     }
     
+    template<typename T>
+    inline void ffunkti(T u, T * __restrict__ ff) __attribute__((always_inline));
+    
+    template<typename T>
+    inline void ffunkti(T u, T * __restrict__ ff) {
+      // Function and its 3 derivatives
+      T a=T(1)/(T(1)+u*u);
+      ffunkti(u,a,std::sqrt(a),ff);
+    }
+    
     inline double myExp(double x) { return std::exp(x);}
     inline float myExp(float x) { return unsafe_expf<3>(x);}
     
@@ -75,18 +83,60 @@ namespace magfieldparam {
     }
     
     
+    // n points at once, in blocks of loops that the compiler can vectorize
+    void operator()(unsigned int n, T const * __restrict__ r2, T const * __restrict__ z,
+                    T * __restrict__ Br, T * __restrict__ Bz) const {
+      for (unsigned int first=0; first<n; first+=blockSize)
+        block(n-first<blockSize ? n-first : blockSize, r2+first, z+first, Br+first, Bz+first);
+    }
+
   // in meters and T  (Br needs to be multiplied by r)
-    void compute(T r2, T z, T& Br, T& Bz) const {
+    inline void compute(T r2, T z, T& Br, T& Bz) const __attribute__((always_inline)) {
       using namespace  bcylDetails;
       //  if (r<1.15&&fabs(z)<2.8) // NOTE: check omitted, is done already by the wrapper! (NA)
+      T fu[4],gv[4];
+      ffunkti(uOf(z),fu);
+      ffunkti(vOf(z),gv);
+      combine(r2,z,fu,gv,Br,Bz);
+    }
+    
+    // number of points evaluated together by the batch call
+    static constexpr unsigned int blockSize = 32;
+
+  private:
+
+    // same as compute for m<=blockSize points.  The square roots, that may set
+    // errno, are taken in a loop of their own, so that the other ones vectorize
+    // without -fno-math-errno.
+    void block(unsigned int m, T const * __restrict__ r2, T const * __restrict__ z,
+               T * __restrict__ Br, T * __restrict__ Bz) const {
+      using namespace  bcylDetails;
+      T au[blockSize], av[blockSize], bu[blockSize], bv[blockSize];
+      for (unsigned int i=0; i<m; ++i) {
+        T u=uOf(z[i]), v=vOf(z[i]);
+        au[i]=T(1)/(T(1)+u*u);
+        av[i]=T(1)/(T(1)+v*v);
+      }
+      for (unsigned int i=0; i<m; ++i) {
+        bu[i]=std::sqrt(au[i]);
+        bv[i]=std::sqrt(av[i]);
+      }
+      for (unsigned int i=0; i<m; ++i) {
+        T fu[4],gv[4];
+        ffunkti(uOf(z[i]),au[i],bu[i],fu);
+        ffunkti(vOf(z[i]),av[i],bv[i],gv);
+        combine(r2[i],z[i],fu,gv,Br[i],Bz[i]);
+      }
+    }
+
+    // max Bz point is shifted in z
+    T uOf(T z) const { return pars.hlova-(z-pars.prm[3])*pars.ainv; }
+    T vOf(T z) const { return pars.hlova+(z-pars.prm[3])*pars.ainv; }
+
+    inline void combine(T r2, T z, T const * fu, T const * gv, T& Br, T& Bz) const __attribute__((always_inline)) {
+      using namespace  bcylDetails;
       z-=pars.prm[3];                    // max Bz point is shifted in z
       T az=std::abs(z);
-      T zainv=z*pars.ainv;
-      T u=pars.hlova-zainv;
-      T v=pars.hlova+zainv;
-      T fu[4],gv[4];
-      ffunkti(u,fu);
-      ffunkti(v,gv);
       T rat=T(0.5)*pars.ainv;
       T rat2=rat*rat*r2;
       Br=pars.hb0*rat*(fu[1]-gv[1]-(fu[3]-gv[3])*rat2*T(0.5));
@@ -101,7 +151,6 @@ namespace magfieldparam {
       Bz+=corBz;
     }
     
-  private:
     BCylParam<T> pars;
     
   };
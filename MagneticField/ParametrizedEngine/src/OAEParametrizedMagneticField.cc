@@ -9,6 +9,8 @@
 
 #include "TkBfield.h"
 
+#include <algorithm>
+
 using namespace std;
 using namespace magfieldparam;
 
@@ -49,6 +51,28 @@ OAEParametrizedMagneticField::inTeslaUnchecked(const GlobalPoint& gp) const {
 }
 
 
+void
+OAEParametrizedMagneticField::inTeslaBatch(const GlobalPoint* gp, GlobalVector* b, unsigned int n) const {
+  // the points are evaluated in blocks, stored by component for TkBfield
+  constexpr unsigned int blockSize = 32;
+  float x[blockSize], y[blockSize], z[blockSize];
+  float Bx[blockSize], By[blockSize], Bz[blockSize];
+  for (unsigned int first=0; first<n; first+=blockSize) {
+    const unsigned int m = std::min(blockSize, n-first);
+    for (unsigned int i=0; i<m; ++i) {
+      x[i] = gp[first+i].x()*ooh;
+      y[i] = gp[first+i].y()*ooh;
+      z[i] = gp[first+i].z()*ooh;
+    }
+    theParam.getBxyz(m, x, y, z, Bx, By, Bz);
+    for (unsigned int i=0; i<m; ++i) {
+      // outside of the validity region, same as inTesla
+      b[first+i] = isDefined(gp[first+i]) ? GlobalVector(Bx[i], By[i], Bz[i]) : inTesla(gp[first+i]);
+    }
+  }
+}
+
+
 bool
 OAEParametrizedMagneticField::isDefined(const GlobalPoint& gp) const {
   return (gp.perp2()<(115.f*115.f) && fabs(gp.z())<280.f);
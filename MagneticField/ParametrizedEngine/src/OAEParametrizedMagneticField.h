@@ -36,6 +36,8 @@ class OAEParametrizedMagneticField : public MagneticField {
 
   GlobalVector inTeslaUnchecked (const GlobalPoint& gp) const;
 
+  void inTeslaBatch(const GlobalPoint* gp, GlobalVector* b, unsigned int n) const;
+
   bool isDefined(const GlobalPoint& gp) const;
 
  private:
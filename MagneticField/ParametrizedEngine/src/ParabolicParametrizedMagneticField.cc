@@ -44,6 +44,12 @@ GlobalVector ParabolicParametrizedMagneticField::inTeslaUnchecked(const GlobalPo
   return GlobalVector(0, 0, B0Z(gp.z())*Kr(gp.perp2()));
 }
 
+void ParabolicParametrizedMagneticField::inTeslaBatch(const GlobalPoint* gp, GlobalVector* b, unsigned int n) const {
+  for (unsigned int i=0; i<n; ++i) {
+    b[i] = isDefined(gp[i]) ? GlobalVector(0, 0, B0Z(gp[i].z())*Kr(gp[i].perp2())) : GlobalVector();
+  }
+}
+
 inline float ParabolicParametrizedMagneticField::B0Z(const float z) const {
   return b0*z*z + b1*z + c1;
 }
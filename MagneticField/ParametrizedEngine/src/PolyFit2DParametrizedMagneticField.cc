@@ -55,6 +55,12 @@ PolyFit2DParametrizedMagneticField::inTeslaUnchecked(const GlobalPoint& gp) cons
 		      Bz);  
 }
 
+void
+PolyFit2DParametrizedMagneticField::inTeslaBatch(const GlobalPoint* gp, GlobalVector* b, unsigned int n) const {
+  // no virtual call per point
+  for (unsigned int i=0; i<n; ++i) b[i] = PolyFit2DParametrizedMagneticField::inTesla(gp[i]);
+}
+
 bool
 PolyFit2DParametrizedMagneticField::isDefined(const GlobalPoint& gp) const {
   double z = fabs(gp.z());
@@ -31,6 +31,8 @@ class PolyFit2DParametrizedMagneticField : public MagneticField {
 
   GlobalVector inTeslaUnchecked (const GlobalPoint& gp) const;
 
+  void inTeslaBatch(const GlobalPoint* gp, GlobalVector* b, unsigned int n) const;
+
   bool isDefined(const GlobalPoint& gp) const;
 
  private:
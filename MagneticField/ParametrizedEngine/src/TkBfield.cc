@@ -65,3 +65,19 @@ void TkBfield::getBxyz(float const  * __restrict__ x, float * __restrict__ Bxyz)
   Bxyz[2]=bz;
 }
 
+void TkBfield::getBxyz(unsigned int n, float const * __restrict__ x, float const * __restrict__ y, float const * __restrict__ z,
+		       float * __restrict__ Bx, float * __restrict__ By, float * __restrict__ Bz) const {
+  // in blocks, as BCycl evaluates them
+  constexpr unsigned int blockSize = BCycl<float>::blockSize;
+  float r2[blockSize];
+  for (unsigned int first=0; first<n; first+=blockSize) {
+    const unsigned int m = std::min(blockSize, n-first);
+    for (unsigned int i=0; i<m; ++i) r2[i]=x[first+i]*x[first+i]+y[first+i]*y[first+i];
+    // Bx is used for Br
+    bcyl(m, r2, z+first, Bx+first, Bz+first);
+    for (unsigned int i=first; i<first+m; ++i) {
+      By[i]=Bx[i]*y[i];
+      Bx[i]*=x[i];
+    }
+  }
+}
@@ -37,6 +37,10 @@ namespace magfieldparam {
     /// B out in cylindrical
     void getBrfz(float const  * __restrict__ x, float * __restrict__ Brfz) const;
 
+    /// B out in cartesian for n points, coordinates and field stored by component
+    void getBxyz(unsigned int n, float const * __restrict__ x, float const * __restrict__ y, float const * __restrict__ z,
+		 float * __restrict__ Bx, float * __restrict__ By, float * __restrict__ Bz) const;
+
   private:
 
     BCycl<float> bcyl;
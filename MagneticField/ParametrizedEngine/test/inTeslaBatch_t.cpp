@@ -0,0 +1,52 @@
+// compare (and time) the batched and the point by point field evaluation
+
+#include "MagneticField/ParametrizedEngine/src/OAEParametrizedMagneticField.h"
+#include "MagneticField/ParametrizedEngine/src/ParabolicParametrizedMagneticField.h"
+
+#include "FWCore/Utilities/interface/HRRealTime.h"
+#include<iostream>
+#include<vector>
+#include<random>
+#include<cmath>
+
+namespace {
+
+  int compare(const MagneticField & field, const char * name, const std::vector<GlobalPoint> & points) {
+    std::vector<GlobalVector> scalar(points.size()), batch(points.size());
+
+    edm::HRTimeType s= edm::hrRealTime();
+    for (unsigned int i=0; i<points.size(); ++i) scalar[i] = field.inTesla(points[i]);
+    edm::HRTimeType e = edm::hrRealTime();
+    std::cout << name << " inTesla      " << e-s << std::endl;
+
+    s= edm::hrRealTime();
+    field.inTeslaBatch(points.data(), batch.data(), points.size());
+    e = edm::hrRealTime();
+    std::cout << name << " inTeslaBatch " << e-s << std::endl;
+
+    float maxDiff=0;
+    for (unsigned int i=0; i<points.size(); ++i) maxDiff = std::max(maxDiff, (batch[i]-scalar[i]).mag());
+    std::cout << name << " max difference " << maxDiff << std::endl;
+    return maxDiff < 1.e-5f ? 0 : 1;
+  }
+
+}
+
+int main() {
+  std::mt19937 eng;
+  std::uniform_real_distribution<float> rgen(0.f,120.f);
+  std::uniform_real_distribution<float> phigen(-M_PI,M_PI);
+  std::uniform_real_distribution<float> zgen(-290.f,290.f);
+
+  // a few points are outside of the validity region
+  std::vector<GlobalPoint> points;
+  for (int i=0; i<100003; ++i) {
+    float r = rgen(eng), phi = phigen(eng);
+    points.emplace_back(r*std::cos(phi), r*std::sin(phi), zgen(eng));
+  }
+
+  int ret = 0;
+  ret += compare(OAEParametrizedMagneticField(3.8f), "OAE", points);
+  ret += compare(ParabolicParametrizedMagneticField(), "Parabolic", points);
+  return ret;
+}
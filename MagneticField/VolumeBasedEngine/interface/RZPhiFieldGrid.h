@@ -0,0 +1,66 @@
+#ifndef MagneticField_RZPhiFieldGrid_h
+#define MagneticField_RZPhiFieldGrid_h
+
+/** \class RZPhiFieldGrid
+ *
+ *  Field values precomputed on a regular grid in r, phi and z, with
+ *  trilinear interpolation between the nodes. This is faster than the
+ *  volume search and the interpolation of the field map, but smooths the
+ *  field across the volume boundaries: it should only cover a region where
+ *  the field has no discontinuities, such as the inside of the solenoid.
+ *
+ *  The grid is filled in the constructor, i.e. synchronously in the
+ *  ESProducer, with one volume search and map interpolation per node, at
+ *  each change of the field IOV: r<129 cm, |z|<300 cm with 1 cm steps and
+ *  60 bins in phi is 4.7M nodes (56 MB). The field inside the solenoid is
+ *  close to phi-symmetric, so a few phi bins and steps of a few cm are
+ *  usually enough; testMagneticField (gridPoints) reports the build time
+ *  and the accuracy of a given binning against the volumes. The number of
+ *  nodes is limited to maxNodes.
+ *
+ */
+
+#include "DataFormats/GeometryVector/interface/GlobalVector.h"
+#include "DataFormats/GeometryVector/interface/GlobalPoint.h"
+
+#include <cmath>
+#include <vector>
+
+class MagGeometry;
+
+class RZPhiFieldGrid {
+ public:
+  /// Fill the grid with the field of "geometry" for r<rMax and |z|<zMax,
+  /// with steps of (at most) rStep and zStep, and nPhi bins in phi.
+  /// Throws if rMax, zMax or a step is not positive, or if the grid would
+  /// have more than maxNodes nodes.
+  RZPhiFieldGrid(const MagGeometry& geometry,
+		 float rMax, float zMax, float rStep, float zStep, unsigned int nPhi);
+
+  static constexpr unsigned int maxNodes = 8000000;
+
+  /// Number of nodes of the grid
+  unsigned int size() const { return theBx.size(); }
+
+  /// True if the point is in the region covered by the grid
+  bool isDefined(const GlobalPoint& gp) const {
+    return std::abs(gp.z()) < theZMax && gp.perp2() < theRMax*theRMax;
+  }
+
+  /// Interpolated field, in Tesla (gp must be inside the grid)
+  GlobalVector inTesla(const GlobalPoint& gp) const;
+
+ private:
+  unsigned int index(unsigned int ir, unsigned int iphi, unsigned int iz) const {
+    return (ir*theNPhi + iphi)*theNZ + iz;
+  }
+
+  float theRMax, theZMax;
+  float theInvRStep, theInvPhiStep, theInvZStep;
+  unsigned int theNR, theNPhi, theNZ;
+
+  // Global cartesian components of the field at the nodes
+  std::vector<float> theBx, theBy, theBz;
+};
+
+#endif
@@ -10,6 +10,9 @@
 
 #include "MagneticField/Engine/interface/MagneticField.h"
 #include "MagneticField/VolumeBasedEngine/interface/MagGeometry.h"
+#include "MagneticField/VolumeBasedEngine/interface/RZPhiFieldGrid.h"
+
+#include <memory>
 
 // Class for testing VolumeBasedMagneticField
 class testMagneticField;
@@ -48,6 +51,10 @@ class VolumeBasedMagneticField : public MagneticField {
 
   bool isZSymmetric() const;
 
+  /// Precompute the field on a grid for r<rMax, |z|<zMax (see RZPhiFieldGrid),
+  /// and use it there instead of the volumes (but not of the parametrization).
+  void useGrid(float rMax, float zMax, float rStep, float zStep, unsigned int nPhi);
+
 
  private:
   const MagGeometry* field;
@@ -56,6 +63,7 @@ class VolumeBasedMagneticField : public MagneticField {
   const MagneticField* paramField;
   bool magGeomOwned;
   bool paramFieldOwned;
+  std::shared_ptr<const RZPhiFieldGrid> grid;
 };
 
 #endif
@@ -0,0 +1,86 @@
+#include "MagneticField/VolumeBasedEngine/interface/RZPhiFieldGrid.h"
+#include "MagneticField/VolumeBasedEngine/interface/MagGeometry.h"
+
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include <algorithm>
+#include <cmath>
+
+constexpr unsigned int RZPhiFieldGrid::maxNodes;
+
+namespace {
+  // number of nodes for a range and a step, checked before the conversion
+  // (a range <= 0 would give a single node, and an infinite inverse step)
+  unsigned int nNodes(float range, float step) {
+    if (!(range>0) || !(step>0) || range/step>RZPhiFieldGrid::maxNodes)
+      throw cms::Exception("InvalidParameter") << "RZPhiFieldGrid: invalid step " << step << " cm for a range of " << range << " cm";
+    return std::ceil(range/step)+1;
+  }
+}
+
+RZPhiFieldGrid::RZPhiFieldGrid(const MagGeometry& geometry,
+			       float rMax, float zMax, float rStep, float zStep, unsigned int nPhi) :
+  theRMax(rMax),
+  theZMax(zMax),
+  theNR(nNodes(rMax,rStep)),
+  theNPhi(std::max(nPhi,1U)),
+  theNZ(nNodes(2.f*zMax,zStep))
+{
+  theInvRStep = (theNR-1)/rMax;
+  theInvPhiStep = theNPhi/(2.f*float(M_PI));
+  theInvZStep = (theNZ-1)/(2.f*zMax);
+
+  if (double(theNR)*theNPhi*theNZ>maxNodes)
+    throw cms::Exception("InvalidParameter") << "RZPhiFieldGrid: " << theNR << "x" << theNPhi << "x" << theNZ
+					     << " nodes, at most " << maxNodes << " are allowed";
+  const unsigned int size = theNR*theNPhi*theNZ;
+  edm::LogInfo("MagneticField|RZPhiFieldGrid") << "Filling the field grid, " << theNR << "x" << theNPhi << "x" << theNZ
+					      << " nodes for r<" << rMax << " |z|<" << zMax;
+
+  theBx.resize(size);
+  theBy.resize(size);
+  theBz.resize(size);
+  for (unsigned int ir=0; ir<theNR; ++ir) {
+    const float r = ir/theInvRStep;
+    for (unsigned int iphi=0; iphi<theNPhi; ++iphi) {
+      const float phi = iphi/theInvPhiStep;
+      for (unsigned int iz=0; iz<theNZ; ++iz) {
+	const float z = iz/theInvZStep - zMax;
+	const GlobalVector b = geometry.fieldInTesla(GlobalPoint(r*std::cos(phi), r*std::sin(phi), z));
+	const unsigned int i = index(ir,iphi,iz);
+	theBx[i] = b.x();
+	theBy[i] = b.y();
+	theBz[i] = b.z();
+      }
+    }
+  }
+}
+
+
+GlobalVector RZPhiFieldGrid::inTesla(const GlobalPoint& gp) const {
+  // position in units of steps, and weight of the upper node in each direction
+  const float ur = gp.perp()*theInvRStep;
+  float uphi = gp.barePhi()*theInvPhiStep;
+  if (uphi<0) uphi += theNPhi;
+  const float uz = (gp.z()+theZMax)*theInvZStep;
+
+  const unsigned int ir = std::min(unsigned(ur), theNR-2);
+  const unsigned int iphi = std::min(unsigned(uphi), theNPhi-1);
+  const unsigned int iz = std::min(unsigned(uz), theNZ-2);
+  const unsigned int iphi1 = iphi+1==theNPhi ? 0 : iphi+1;
+  const float fr = ur-ir, fphi = uphi-iphi, fz = uz-iz;
+
+  float b[3] = {0,0,0};
+  const std::vector<float>* comp[3] = {&theBx, &theBy, &theBz};
+  for (unsigned int dr=0; dr<2; ++dr) {
+    const float wr = dr ? fr : 1.f-fr;
+    for (unsigned int dphi=0; dphi<2; ++dphi) {
+      const float w = wr*(dphi ? fphi : 1.f-fphi);
+      const unsigned int i = index(ir+dr, dphi ? iphi1 : iphi, iz);
+      for (unsigned int c=0; c<3; ++c)
+	b[c] += w*((1.f-fz)*(*comp[c])[i] + fz*(*comp[c])[i+1]);
+    }
+  }
+  return GlobalVector(b[0],b[1],b[2]);
+}
@@ -1,6 +1,8 @@
 #include "MagneticField/VolumeBasedEngine/interface/VolumeBasedMagneticField.h"
 #include "DataFormats/GeometryVector/interface/GlobalVector.h"
 
+#include <algorithm>
+
 VolumeBasedMagneticField::VolumeBasedMagneticField( int geomVersion,
 						    const std::vector<MagBLayer *>& theBLayers,
 						    const std::vector<MagESector *>& theESectors,
@@ -24,7 +26,8 @@ VolumeBasedMagneticField::VolumeBasedMagneticField(const VolumeBasedMagneticFiel
   maxZ(vbf.maxZ),
   paramField(vbf.paramField),
   magGeomOwned(false),
-  paramFieldOwned(false) {
+  paramFieldOwned(false),
+  grid(vbf.grid) {
   // std::cout << "VolumeBasedMagneticField::clone() (shallow copy)" << std::endl;
 }
 
@@ -47,12 +50,15 @@ GlobalVector VolumeBasedMagneticField::inTesla (const GlobalPoint& gp) const {
   // If point is outside magfield map, return 0 field (not an error)
   if (!isDefined(gp))  return GlobalVector();
 
+  if (grid && grid->isDefined(gp)) return grid->inTesla(gp);
+
   return field->fieldInTesla(gp);
 }
 
 GlobalVector VolumeBasedMagneticField::inTeslaUnchecked(const GlobalPoint& gp) const{
   //same as above, but do not check range
   if (paramField && paramField->isDefined(gp)) return paramField->inTeslaUnchecked(gp);
+  if (grid && grid->isDefined(gp)) return grid->inTesla(gp);
   return field->fieldInTesla(gp);
 }
 
@@ -68,6 +74,11 @@ bool VolumeBasedMagneticField::isDefined(const GlobalPoint& gp) const {
 }
 
 
+void VolumeBasedMagneticField::useGrid(float rMax, float zMax, float rStep, float zStep, unsigned int nPhi) {
+  grid = std::make_shared<const RZPhiFieldGrid>(*field, std::min(rMax,maxR), std::min(zMax,maxZ), rStep, zStep, nPhi);
+}
+
+
 bool VolumeBasedMagneticField::isZSymmetric() const {
   return field->isZSymmetric();
 }
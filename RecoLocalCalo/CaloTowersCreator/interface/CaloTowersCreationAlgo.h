@@ -327,15 +327,23 @@ private:
   void convert(const CaloTowerDetId& id, const MetaTower& mt, CaloTowerCollection & collection);
   
 
-  // internal map
+  /// converts the towers listed in theTowerIndices, in parallel, in dense index order
+  void convertTowers(CaloTowerCollection & collection);
+
+  /// resets the towers filled in the current event, keeping the dense array allocated
+  void clearTowers();
+
+  // internal map, indexed by the dense index of the tower
   typedef std::vector<MetaTower> MetaTowerMap;
   MetaTowerMap theTowerMap;
   unsigned int theTowerMapSize=0;
+  // dense indices of the towers of theTowerMap filled in the current event
+  std::vector<unsigned int> theTowerIndices;
 
   // Number of channels in the tower that were not used in RecHit production (dead/off,...).
   // These channels are added to the other "bad" channels found in the recHit collection. 
-  typedef std::map<CaloTowerDetId, int> HcalDropChMap;
-  HcalDropChMap hcalDropChMap;
+  // Indexed by the dense index of the tower
+  std::vector<unsigned short> hcalDropChs;
 
   // Number of bad Ecal channel in each tower
   //unsigned short ecalBadChs[CaloTowerDetId::kSizeForDenseIndexing];
@@ -7,6 +7,9 @@
 #include "Geometry/CaloGeometry/interface/CaloGeometry.h"
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
 #include "Math/Interpolator.h"
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+#include <algorithm>
 #include <cmath>
 
 //#define EDM_ML_DEBUG
@@ -309,8 +312,15 @@ void CaloTowersCreationAlgo::setGeometry(const CaloTowerTopology* cttopo, const
   theGeometry = geo;
   theTowerGeometry=geo->getSubdetectorGeometry(DetId::Calo,CaloTowerDetId::SubdetId);
   
-  //initialize ecal bad channel map
+  //initialize ecal and hcal bad channel maps
   ecalBadChs.resize(theTowerTopology->sizeForDenseIndexing(),0);
+  hcalDropChs.resize(theTowerTopology->sizeForDenseIndexing(),0);
+
+  //the tower map stays allocated across events: follow the topology if its size changed
+  if (theTowerMap.size()!=theTowerTopology->sizeForDenseIndexing()) {
+    clearTowers();
+    theTowerMap.resize(theTowerTopology->sizeForDenseIndexing());
+  }
   
   //store some specific geom info
   
@@ -372,9 +382,7 @@ void CaloTowersCreationAlgo::setGeometry(const CaloTowerTopology* cttopo, const
 }
 
 void CaloTowersCreationAlgo::begin() {
-  theTowerMap.clear();
-  theTowerMapSize=0;
-  //hcalDropChMap.clear();
+  clearTowers();
 }
 
 void CaloTowersCreationAlgo::process(const HBHERecHitCollection& hbhe) { 
@@ -416,21 +424,58 @@ void CaloTowersCreationAlgo::process(const CaloTowerCollection& ctc) {
 
 void CaloTowersCreationAlgo::finish(CaloTowerCollection& result) {
   // now copy this map into the final collection
-  result.reserve(theTowerMapSize);
-  // auto k=0U;
+  result.reserve(result.size()+theTowerMapSize);
   //  if (!theEbHandle.isValid()) std::cout << "VI ebHandle not valid" << std::endl;
   // if (!theEeHandle.isValid()) std::cout << "VI eeHandle not valid" << std::endl;
 
-  for(auto const & mt : theTowerMap ) { 
-    // Convert only if there is at least one constituent in the metatower. 
-    // The check of constituents size in the coverted tower is still needed!
-    if (!mt.empty() ) { convert(mt.id, mt, result); } // ++k;}	
-  }
+  // Convert only if there is at least one constituent in the metatower. 
+  // The check of constituents size in the coverted tower is still needed!
+  convertTowers(result);
   
-  // assert(k==theTowerMapSize);
-  // std::cout << "VI TowerMap " << theTowerMapSize << " " << k << std::endl;
-  
-  theTowerMap.clear(); // save the memory
+  clearTowers();
+}
+
+
+void CaloTowersCreationAlgo::convertTowers(CaloTowerCollection& result) {
+  // same order as a scan of the dense array
+  std::sort(theTowerIndices.begin(), theTowerIndices.end());
+
+  // the towers are converted by chunks, each into its own collection, the chunks
+  // are then appended in order so that the result does not depend on the scheduling
+  constexpr unsigned int chunkSize = 256;
+  const unsigned int nChunks = (theTowerIndices.size()+chunkSize-1)/chunkSize;
+  if (nChunks<=1) {
+    for (auto ind : theTowerIndices) {
+      auto const & mt = theTowerMap[ind];
+      if (!mt.empty()) convert(mt.id, mt, result);
+    }
+    return;
+  }
+
+  std::vector<CaloTowerCollection> chunks(nChunks);
+  tbb::parallel_for(tbb::blocked_range<unsigned int>(0,nChunks),
+		    [&](const tbb::blocked_range<unsigned int>& r) {
+		      for (auto ichunk=r.begin(); ichunk!=r.end(); ++ichunk) {
+			auto & chunk = chunks[ichunk];
+			auto first = ichunk*chunkSize;
+			auto last = std::min<unsigned int>(first+chunkSize, theTowerIndices.size());
+			chunk.reserve(last-first);
+			for (auto i=first; i!=last; ++i) {
+			  auto const & mt = theTowerMap[theTowerIndices[i]];
+			  if (!mt.empty()) convert(mt.id, mt, chunk);
+			}
+		      }
+		    });
+
+  for (auto & chunk : chunks) {
+    for (auto & ct : chunk) result.push_back(std::move(ct));
+  }
+}
+
+
+void CaloTowersCreationAlgo::clearTowers() {
+  for (auto ind : theTowerIndices) theTowerMap[ind] = MetaTower();
+  theTowerIndices.clear();
   theTowerMapSize=0;
 }
 
@@ -926,15 +971,15 @@ void CaloTowersCreationAlgo::rescale(const CaloTower * ct) {
 
 
 CaloTowersCreationAlgo::MetaTower & CaloTowersCreationAlgo::find(const CaloTowerDetId & detId) {
-  if (theTowerMap.empty()) {
-    theTowerMap.resize(theTowerTopology->sizeForDenseIndexing());
-  }
-  
-  auto & mt = theTowerMap[theTowerTopology->denseIndex(detId)]; 
+  auto ind = theTowerTopology->denseIndex(detId);
+  auto & mt = theTowerMap[ind]; 
   
-  if (mt.empty()) {
+  // a tower can be found without receiving constituents (bad channels):
+  // list it only the first time
+  if (mt.id.rawId()==0) {
     mt.id=detId;
     mt.metaConstituents.reserve(detId.ietaAbs()<theTowerTopology->firstHFRing() ? 12 : 2);
+    theTowerIndices.push_back(ind);
     ++theTowerMapSize;
   }
   
@@ -1153,8 +1198,7 @@ void CaloTowersCreationAlgo::convert(const CaloTowerDetId& id, const MetaTower&
     unsigned int numProbEcalChan = mt.numProbEcalCells;
 
     // now add dead/off/... channels not used in RecHit reconstruction for HCAL 
-    HcalDropChMap::iterator dropChItr = hcalDropChMap.find(id);
-    if (dropChItr != hcalDropChMap.end()) numBadHcalChan += dropChItr->second;
+    numBadHcalChan += hcalDropChs[theTowerTopology->denseIndex(id)];
     
 
     // for ECAL the number of all bad channels is obtained here -----------------------
@@ -1647,9 +1691,9 @@ int CaloTowersCreationAlgo::compactTime(float time) {
 void CaloTowersCreationAlgo::makeHcalDropChMap() {
 
   // This method fills the map of number of dead channels for the calotower,
-  // The key of the map is CaloTowerDetId.
+  // indexed by the dense index of the CaloTowerDetId.
   // By definition these channels are not going to be in the RecHit collections.
-  hcalDropChMap.clear();
+  std::fill(hcalDropChs.begin(), hcalDropChs.end(), 0);
   std::vector<DetId> allChanInStatusCont = theHcalChStatus->getAllChannels();
 
 #ifdef EDM_ML_DEBUG
@@ -1663,8 +1707,9 @@ void CaloTowersCreationAlgo::makeHcalDropChMap() {
       DetId id = theHcalTopology->mergedDepthDetId(HcalDetId(*it));
       
       CaloTowerDetId twrId = theTowerConstituentsMap->towerOf(id);
+      if (twrId.null()) continue;
       
-      hcalDropChMap[twrId] +=1;
+      hcalDropChs[theTowerTopology->denseIndex(twrId)] +=1;
       
       HcalDetId hid(*it);
 	  
@@ -1680,7 +1725,7 @@ void CaloTowersCreationAlgo::makeHcalDropChMap() {
 	}
 	if (merge) {
           CaloTowerDetId twrId29(twrId.ieta()+twrId.zside(), twrId.iphi());
-          hcalDropChMap[twrId29] +=1;
+          hcalDropChs[theTowerTopology->denseIndex(twrId29)] +=1;
 	}
       }
     }
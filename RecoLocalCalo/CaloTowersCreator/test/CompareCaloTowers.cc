@@ -0,0 +1,60 @@
+// File: CompareCaloTowers.cc
+// Description: check that two collections of CaloTowers are the same, tower
+// by tower and in the same order: constituents, energies, direction,
+// reference positions, timing and status word.
+// Throws at the first difference.
+//--------------------------------------------
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/Utilities/interface/InputTag.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+
+#include "DataFormats/CaloTowers/interface/CaloTowerCollection.h"
+
+class CompareCaloTowers : public edm::global::EDAnalyzer<> {
+public:
+  explicit CompareCaloTowers(const edm::ParameterSet& conf) :
+    refToken_(consumes<CaloTowerCollection>(conf.getParameter<edm::InputTag>("reference"))),
+    testToken_(consumes<CaloTowerCollection>(conf.getParameter<edm::InputTag>("test"))) {}
+
+  void analyze(edm::StreamID, const edm::Event& ev, const edm::EventSetup&) const override;
+
+private:
+  const edm::EDGetTokenT<CaloTowerCollection> refToken_;
+  const edm::EDGetTokenT<CaloTowerCollection> testToken_;
+};
+
+void CompareCaloTowers::analyze(edm::StreamID, const edm::Event& ev, const edm::EventSetup&) const {
+  edm::Handle<CaloTowerCollection> ref, test;
+  ev.getByToken(refToken_, ref);
+  ev.getByToken(testToken_, test);
+
+  if (ref->size() != test->size())
+    throw cms::Exception("CompareCaloTowers") << "different number of towers: " << ref->size() << ' ' << test->size();
+  unsigned int nConstituents = 0;
+  for (auto ia = ref->begin(), ib = test->begin(); ia != ref->end(); ++ia, ++ib) {
+    if (ia->id() != ib->id())
+      throw cms::Exception("CompareCaloTowers") << "different towers " << ia->id() << ' ' << ib->id();
+    if (ia->constituents() != ib->constituents())
+      throw cms::Exception("CompareCaloTowers") << "different constituents in " << ia->id();
+    if (ia->emEnergy() != ib->emEnergy() || ia->hadEnergy() != ib->hadEnergy() ||
+	ia->outerEnergy() != ib->outerEnergy() || ia->hottestCellE() != ib->hottestCellE())
+      throw cms::Exception("CompareCaloTowers") << "different energies in " << ia->id();
+    if (ia->p4() != ib->p4() || ia->p4_HO() != ib->p4_HO())
+      throw cms::Exception("CompareCaloTowers") << "different momentum in " << ia->id();
+    if (!(ia->emPosition() == ib->emPosition()) || !(ia->hadPosition() == ib->hadPosition()))
+      throw cms::Exception("CompareCaloTowers") << "different positions in " << ia->id();
+    if (ia->ecalTime() != ib->ecalTime() || ia->hcalTime() != ib->hcalTime())
+      throw cms::Exception("CompareCaloTowers") << "different times in " << ia->id();
+    if (ia->towerStatusWord() != ib->towerStatusWord())
+      throw cms::Exception("CompareCaloTowers") << "different status in " << ia->id();
+    nConstituents += ia->constituentsSize();
+  }
+
+  LogDebug("CompareCaloTowers") << ref->size() << " towers, " << nConstituents << " constituents";
+}
+
+DEFINE_FWK_MODULE(CompareCaloTowers);
@@ -0,0 +1,53 @@
+# check that the towers made by CaloTowersCreator from the rechits of a RECO
+# file are the same as the towerMaker towers stored in that file
+# (CompareCaloTowers throws at the first difference)
+#
+# the input has to be made by the release without the change to test, with
+# the same conditions, e.g. the step3.root of a runTheMatrix.py TTbar workflow:
+#   cmsRun testTowersRecreation_cfg.py inputFiles=file:step3.root globalTag=<GT of step3>
+##############################################################################
+
+import FWCore.ParameterSet.Config as cms
+from FWCore.ParameterSet.VarParsing import VarParsing
+
+options = VarParsing('analysis')
+options.register('globalTag', '', VarParsing.multiplicity.singleton, VarParsing.varType.string,
+                 "global tag used to make the input")
+options.parseArguments()
+
+process = cms.Process("TowersTest")
+
+process.load("FWCore.MessageLogger.MessageLogger_cfi")
+process.load("Configuration.StandardSequences.GeometryRecoDB_cff")
+process.load("Configuration.StandardSequences.FrontierConditions_GlobalTag_cff")
+process.load("Configuration.StandardSequences.Services_cff")
+
+process.load("RecoJets.JetProducers.CaloTowerSchemeB_cfi")
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(options.maxEvents)
+)
+
+# several threads, so that the towers are converted in parallel, and many
+# events in each stream, so that the towers left from the previous event
+# would show up
+process.options = cms.untracked.PSet(
+    numberOfThreads = cms.untracked.uint32(4),
+    numberOfStreams = cms.untracked.uint32(2)
+)
+
+process.source = cms.Source("PoolSource",
+  fileNames = cms.untracked.vstring(options.inputFiles)
+)
+
+process.GlobalTag.globaltag = options.globalTag
+
+# same parameters as the towerMaker of the input
+process.towerMakerTest = process.towerMaker.clone()
+
+process.compareTowers = cms.EDAnalyzer("CompareCaloTowers",
+    reference = cms.InputTag("towerMaker","","RECO"),
+    test = cms.InputTag("towerMakerTest")
+)
+
+process.p = cms.Path(process.towerMakerTest*process.compareTowers)
@@ -13,6 +13,9 @@
 #include "CondFormats/EcalObjects/interface/EcalPedestals.h"
 #include "CondFormats/EcalObjects/interface/EcalGainRatios.h"
 #include "RecoLocalCalo/EcalRecAlgos/interface/PulseChiSqSNNLS.h"
+#include "RecoLocalCalo/EcalRecAlgos/interface/PulseChiSqSNNLSBatch.h"
+
+#include <vector>
 
 
 #include "TMatrixDSym.h"
@@ -23,9 +26,23 @@ class EcalUncalibRecHitMultiFitAlgo
   
  public:
   
+  //inputs of one channel for makeRecHits
+  struct Input {
+    EcalDataFrame dataFrame;
+    const EcalPedestals::Item * aped;
+    const EcalMGPAGainRatio * aGain;
+    const SampleMatrixGainArray * noisecors;
+    const SampleMatrixGainArray * noisecorLs;
+    FullSampleVector fullpulse;
+    FullSampleMatrix fullpulsecov;
+  };
+
   EcalUncalibRecHitMultiFitAlgo();
   ~EcalUncalibRecHitMultiFitAlgo() { };
-  EcalUncalibratedRecHit makeRecHit(const EcalDataFrame& dataFrame, const EcalPedestals::Item * aped, const EcalMGPAGainRatio * aGain, const SampleMatrixGainArray &noisecors, const FullSampleVector &fullpulse, const FullSampleMatrix &fullpulsecov, const BXVector &activeBX);
+  //noisecorLs, if given, are the Cholesky factors of noisecors, computed once per IOV by the caller
+  EcalUncalibratedRecHit makeRecHit(const EcalDataFrame& dataFrame, const EcalPedestals::Item * aped, const EcalMGPAGainRatio * aGain, const SampleMatrixGainArray &noisecors, const FullSampleVector &fullpulse, const FullSampleMatrix &fullpulsecov, const BXVector &activeBX, const SampleMatrixGainArray *noisecorLs = nullptr);
+  //same as makeRecHit for a block of channels, with the one-pulse prefits of the block done together
+  void makeRecHits(const std::vector<Input> &inputs, const BXVector &activeBX, std::vector<EcalUncalibratedRecHit> &rechits);
   void disableErrorCalculation() { _computeErrors = false; }
   void setDoPrefit(bool b) { _doPrefit = b; }
   void setPrefitMaxChiSq(double x) { _prefitMaxChiSq = x; }
@@ -37,6 +54,30 @@ class EcalUncalibRecHitMultiFitAlgo
   void setGainSwitchUseMaxSample(bool b) { _gainSwitchUseMaxSample = b; }
   
  private:
+   //fit inputs derived from the digi and the conditions
+   struct Channel {
+     SampleVector amplitudes;
+     SampleGainVector gainsNoise;
+     SampleGainVector gainsPedestal;
+     SampleGainVector badSamples;
+     SampleMatrix noisecov;
+     SampleMatrix noisecovL; //Cholesky factor of noisecov, if hasNoisecovL
+     bool hasNoisecovL;
+     double maxamplitude;
+     double pedval;
+     bool hasGainSwitch;
+     EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+   };
+   //result of a prefit done outside of fit
+   struct Prefit {
+     double amplitude;
+     double chisq;
+   };
+
+   void prepare(const EcalDataFrame& dataFrame, const EcalPedestals::Item * aped, const EcalMGPAGainRatio * aGain, const SampleMatrixGainArray &noisecors, const SampleMatrixGainArray *noisecorLs, Channel &channel) const;
+   EcalUncalibratedRecHit fit(const EcalDataFrame& dataFrame, const Channel &channel, const FullSampleVector &fullpulse, const FullSampleMatrix &fullpulsecov, const BXVector &activeBX, const Prefit *prefit);
+   bool useMaxSample(const Channel &channel) const { return channel.hasGainSwitch && _gainSwitchUseMaxSample; }
+
    PulseChiSqSNNLS _pulsefunc;
    PulseChiSqSNNLS _pulsefuncSingle;
    bool _computeErrors;
@@ -49,6 +90,10 @@ class EcalUncalibRecHitMultiFitAlgo
    bool _simplifiedNoiseModelForGainSwitch;
    bool _gainSwitchUseMaxSample;
    BXVector _singlebx;
+   PulseChiSqSNNLSBatch _prefitBatch;
+   std::vector<Channel, Eigen::aligned_allocator<Channel> > _channels;
+   std::vector<Prefit> _prefits;
+   std::vector<int> _prefitIndex;
 
 };
 
@@ -16,7 +16,9 @@ class PulseChiSqSNNLS {
     ~PulseChiSqSNNLS();
     
     
-    bool DoFit(const SampleVector &samples, const SampleMatrix &samplecov, const BXVector &bxs, const FullSampleVector &fullpulse, const FullSampleMatrix &fullpulsecov, const SampleGainVector &gains = -1*SampleGainVector::Ones(), const SampleGainVector &badSamples = SampleGainVector::Zero());
+    //samplecovL, if given, is the Cholesky factor (lower triangle) of samplecov, used
+    //instead of decomposing it again whenever the pulse shape uncertainty does not contribute
+    bool DoFit(const SampleVector &samples, const SampleMatrix &samplecov, const BXVector &bxs, const FullSampleVector &fullpulse, const FullSampleMatrix &fullpulsecov, const SampleGainVector &gains = -1*SampleGainVector::Ones(), const SampleGainVector &badSamples = SampleGainVector::Zero(), const SampleMatrix *samplecovL = nullptr);
     
     const SamplePulseMatrix &pulsemat() const { return _pulsemat; }
     const SampleMatrix &invcov() const { return _invcov; }
@@ -38,6 +40,7 @@ class PulseChiSqSNNLS {
     void NNLSConstrainParameter(Index minratioidx);
     bool OnePulseMinimize();
     bool updateCov(const SampleMatrix &samplecov, const FullSampleMatrix &fullpulsecov);
+    Eigen::TriangularView<const SampleMatrix,Eigen::Lower> covL() const { return _covL->triangularView<Eigen::Lower>(); }
     double ComputeChiSq();
     double ComputeApproxUncertainty(unsigned int ipulse);
     
@@ -50,6 +53,8 @@ class PulseChiSqSNNLS {
     PulseVector _ampvecmin;
     
     SampleDecompLLT _covdecomp;
+    const SampleMatrix *_samplecovL;
+    const SampleMatrix *_covL; //lower triangle is the Cholesky factor of the current covariance
     SampleMatrix _covdecompLinv;
     PulseMatrix _topleft_work;
     PulseDecompLDLT _pulsedecomp;
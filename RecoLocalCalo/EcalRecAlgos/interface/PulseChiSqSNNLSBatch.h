@@ -0,0 +1,50 @@
+#ifndef PulseChiSqSNNLSBatch_h
+#define PulseChiSqSNNLSBatch_h
+
+/** \class PulseChiSqSNNLSBatch
+  *  One-pulse fit of a block of channels, run in lockstep.
+  *
+  *  Equivalent to PulseChiSqSNNLS::DoFit with a single in-time BX, one
+  *  iteration and no error computation, as used for the multifit prefit,
+  *  for channels without dynamic pedestals nor bad sample corrections.
+  *  The covariance decomposition and the triangular solves are done for
+  *  all the channels of the block together, with the channel index as the
+  *  innermost dimension, so that they vectorize across channels.
+  */
+
+#include "RecoLocalCalo/EcalRecAlgos/interface/EigenMatrixTypes.h"
+
+class PulseChiSqSNNLSBatch {
+  public:
+
+    static constexpr unsigned int MaxChannels = 16;
+
+    PulseChiSqSNNLSBatch() : _n(0) {}
+
+    void clear() { _n = 0; }
+    bool full() const { return _n == MaxChannels; }
+    unsigned int size() const { return _n; }
+
+    //add a channel to the block, returns its index
+    unsigned int add(const SampleVector &samples, const SampleMatrix &samplecov, const FullSampleVector &fullpulse, const FullSampleMatrix &fullpulsecov);
+
+    //fit all the channels of the block
+    void DoFits();
+
+    double X(unsigned int i) const { return _amp[i]; }
+    double ChiSq(unsigned int i) const { return _chisq[i]; }
+
+  private:
+
+    static constexpr unsigned int nsample = SampleVectorSize;
+
+    //covariance (lower triangle), replaced by its Cholesky factor by DoFits
+    double _cov[nsample][nsample][MaxChannels];
+    double _pulse[nsample][MaxChannels];
+    double _samples[nsample][MaxChannels];
+    double _amp[MaxChannels];
+    double _chisq[MaxChannels];
+    unsigned int _n;
+};
+
+#endif
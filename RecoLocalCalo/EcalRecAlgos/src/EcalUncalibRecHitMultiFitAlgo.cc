@@ -26,22 +26,73 @@ EcalUncalibRecHitMultiFitAlgo::EcalUncalibRecHitMultiFitAlgo() :
 }
 
 /// compute rechits
-EcalUncalibratedRecHit EcalUncalibRecHitMultiFitAlgo::makeRecHit(const EcalDataFrame& dataFrame, const EcalPedestals::Item * aped, const EcalMGPAGainRatio * aGain, const SampleMatrixGainArray &noisecors, const FullSampleVector &fullpulse, const FullSampleMatrix &fullpulsecov, const BXVector &activeBX) {
+EcalUncalibratedRecHit EcalUncalibRecHitMultiFitAlgo::makeRecHit(const EcalDataFrame& dataFrame, const EcalPedestals::Item * aped, const EcalMGPAGainRatio * aGain, const SampleMatrixGainArray &noisecors, const FullSampleVector &fullpulse, const FullSampleMatrix &fullpulsecov, const BXVector &activeBX, const SampleMatrixGainArray *noisecorLs) {
+
+  Channel channel;
+  prepare(dataFrame, aped, aGain, noisecors, noisecorLs, channel);
+  return fit(dataFrame, channel, fullpulse, fullpulsecov, activeBX, nullptr);
+}
+
+/// compute rechits for a block of channels
+void EcalUncalibRecHitMultiFitAlgo::makeRecHits(const std::vector<Input> &inputs, const BXVector &activeBX, std::vector<EcalUncalibratedRecHit> &rechits) {
+
+  const unsigned int ninputs = inputs.size();
+  _channels.resize(ninputs);
+  _prefits.resize(ninputs);
+  _prefitIndex.assign(ninputs, -1);
+
+  for (unsigned int i=0; i<ninputs; ++i) {
+    const Input &input = inputs[i];
+    prepare(input.dataFrame, input.aped, input.aGain, *input.noisecors, input.noisecorLs, _channels[i]);
+  }
+
+  //run the one-pulse prefits in lockstep, for the channels where it is
+  //equivalent to the PulseChiSqSNNLS one (no dynamic pedestal nor bad
+  //sample correction)
+  if (_doPrefit) {
+    unsigned int first = 0;
+    _prefitBatch.clear();
+    for (unsigned int i=0; i<=ninputs; ++i) {
+      if (_prefitBatch.full() || (i==ninputs && _prefitBatch.size())) {
+        _prefitBatch.DoFits();
+        for (unsigned int j=first; j<i; ++j) {
+          if (_prefitIndex[j]<0) continue;
+          _prefits[j].amplitude = _prefitBatch.X(_prefitIndex[j]);
+          _prefits[j].chisq = _prefitBatch.ChiSq(_prefitIndex[j]);
+        }
+        _prefitBatch.clear();
+        first = i;
+      }
+      if (i==ninputs) break;
+
+      const Channel &channel = _channels[i];
+      if (useMaxSample(channel) || channel.gainsPedestal.maxCoeff()>=0 || channel.badSamples.maxCoeff()>0) continue;
+      _prefitIndex[i] = _prefitBatch.add(channel.amplitudes, channel.noisecov, inputs[i].fullpulse, inputs[i].fullpulsecov);
+    }
+  }
+
+  rechits.reserve(rechits.size() + ninputs);
+  for (unsigned int i=0; i<ninputs; ++i) {
+    const Input &input = inputs[i];
+    rechits.push_back(fit(input.dataFrame, _channels[i], input.fullpulse, input.fullpulsecov, activeBX, _prefitIndex[i]<0 ? nullptr : &_prefits[i]));
+  }
+}
+
+/// compute the fit inputs
+void EcalUncalibRecHitMultiFitAlgo::prepare(const EcalDataFrame& dataFrame, const EcalPedestals::Item * aped, const EcalMGPAGainRatio * aGain, const SampleMatrixGainArray &noisecors, const SampleMatrixGainArray *noisecorLs, Channel &channel) const {
 
-  uint32_t flags = 0;
-  
   const unsigned int nsample = EcalDataFrame::MAXSAMPLES;
   
   double maxamplitude = -std::numeric_limits<double>::max();
   const unsigned int iSampleMax = 5;
-  const unsigned int iFullPulseMax = 9;
   
   double pedval = 0.;
     
-  SampleVector amplitudes;
-  SampleGainVector gainsNoise;
-  SampleGainVector gainsPedestal;
-  SampleGainVector badSamples = SampleGainVector::Zero();
+  SampleVector &amplitudes = channel.amplitudes;
+  SampleGainVector &gainsNoise = channel.gainsNoise;
+  SampleGainVector &gainsPedestal = channel.gainsPedestal;
+  SampleGainVector &badSamples = channel.badSamples;
+  badSamples = SampleGainVector::Zero();
   bool hasSaturation = dataFrame.isSaturated();
   bool hasGainSwitch = hasSaturation || dataFrame.hasSwitchToGain6() || dataFrame.hasSwitchToGain1();
   
@@ -104,23 +155,16 @@ EcalUncalibratedRecHit EcalUncalibRecHitMultiFitAlgo::makeRecHit(const EcalDataF
         
   }
 
-  double amplitude, amperr, chisq;
-  bool status = false;
-    
+  channel.maxamplitude = maxamplitude;
+  channel.pedval = pedval;
+  channel.hasGainSwitch = hasGainSwitch;
+  channel.hasNoisecovL = false;
+
   //special handling for gain switch, where sample before maximum is potentially affected by slew rate limitation
   //optionally apply a stricter criteria, assuming slew rate limit is only reached in case where maximum sample has gain switched but previous sample has not
-  //option 1: use simple max-sample algorithm
-  if (hasGainSwitch && _gainSwitchUseMaxSample) {
-    double maxpulseamplitude = maxamplitude / fullpulse[iFullPulseMax];
-    EcalUncalibratedRecHit rh( dataFrame.id(), maxpulseamplitude, pedval, 0., 0., flags );
-    rh.setAmplitudeError(0.);
-    for (unsigned int ipulse=0; ipulse<_pulsefunc.BXs().rows(); ++ipulse) {
-      int bx = _pulsefunc.BXs().coeff(ipulse);
-      if (bx!=0) {
-        rh.setOutOfTimeAmplitude(bx+5, 0.0);
-      }
-    }
-    return rh;
+  //option 1: use simple max-sample algorithm, see fit
+  if (useMaxSample(channel)) {
+    return;
   }
 
   //option2: A floating negative single-sample offset is added to the fit
@@ -132,13 +176,20 @@ EcalUncalibratedRecHit EcalUncalibRecHitMultiFitAlgo::makeRecHit(const EcalDataF
   }
   
   //compute noise covariance matrix, which depends on the sample gains
-  SampleMatrix noisecov;
+  //when it is a single correlation matrix scaled by the noise, its decomposition is
+  //the precomputed one scaled the same way
+  SampleMatrix &noisecov = channel.noisecov;
+  const bool scaledNoisecorL = noisecorLs && (dynamicPedestal || _addPedestalUncertainty<=0.);
   if (hasGainSwitch) {
     std::array<double,3> pedrmss = {{aped->rms_x12, aped->rms_x6, aped->rms_x1}};
     std::array<double,3> gainratios = {{ 1., aGain->gain12Over6(), aGain->gain6Over1()*aGain->gain12Over6()}};
     if (_simplifiedNoiseModelForGainSwitch) {
       int gainidxmax = gainsNoise[iSampleMax];
       noisecov = gainratios[gainidxmax]*gainratios[gainidxmax]*pedrmss[gainidxmax]*pedrmss[gainidxmax]*noisecors[gainidxmax];
+      if (scaledNoisecorL) {
+        channel.noisecovL = gainratios[gainidxmax]*pedrmss[gainidxmax]*(*noisecorLs)[gainidxmax];
+        channel.hasNoisecovL = true;
+      }
       if (!dynamicPedestal && _addPedestalUncertainty>0.) {
         //add fully correlated component to noise covariance to inflate pedestal uncertainty
         noisecov += _addPedestalUncertainty*_addPedestalUncertainty*SampleMatrix::Ones();
@@ -163,19 +214,66 @@ EcalUncalibratedRecHit EcalUncalibRecHitMultiFitAlgo::makeRecHit(const EcalDataF
   }
   else {
     noisecov = aped->rms_x12*aped->rms_x12*noisecors[0];
+    if (scaledNoisecorL) {
+      channel.noisecovL = aped->rms_x12*(*noisecorLs)[0];
+      channel.hasNoisecovL = true;
+    }
     if (!dynamicPedestal && _addPedestalUncertainty>0.) {
       //add fully correlated component to noise covariance to inflate pedestal uncertainty
       noisecov += _addPedestalUncertainty*_addPedestalUncertainty*SampleMatrix::Ones();
     }
   }
   
+}
+
+/// fit a channel
+EcalUncalibratedRecHit EcalUncalibRecHitMultiFitAlgo::fit(const EcalDataFrame& dataFrame, const Channel &channel, const FullSampleVector &fullpulse, const FullSampleMatrix &fullpulsecov, const BXVector &activeBX, const Prefit *prefit) {
+
+  uint32_t flags = 0;
+
+  const unsigned int iSampleMax = 5;
+  const unsigned int iFullPulseMax = 9;
+
+  const SampleVector &amplitudes = channel.amplitudes;
+  const SampleGainVector &gainsPedestal = channel.gainsPedestal;
+  const SampleGainVector &badSamples = channel.badSamples;
+  const SampleMatrix &noisecov = channel.noisecov;
+  const SampleMatrix *noisecovL = channel.hasNoisecovL ? &channel.noisecovL : nullptr;
+  const double pedval = channel.pedval;
+
+  double amplitude, amperr, chisq;
+  bool status = false;
+
+  //option 1 for gain switch: use simple max-sample algorithm
+  if (useMaxSample(channel)) {
+    double maxpulseamplitude = channel.maxamplitude / fullpulse[iFullPulseMax];
+    EcalUncalibratedRecHit rh( dataFrame.id(), maxpulseamplitude, pedval, 0., 0., flags );
+    rh.setAmplitudeError(0.);
+    for (unsigned int ipulse=0; ipulse<_pulsefunc.BXs().rows(); ++ipulse) {
+      int bx = _pulsefunc.BXs().coeff(ipulse);
+      if (bx!=0) {
+        rh.setOutOfTimeAmplitude(bx+5, 0.0);
+      }
+    }
+    return rh;
+  }
+
   //optimized one-pulse fit for hlt
   bool usePrefit = false;
   if (_doPrefit) {
-    status = _pulsefuncSingle.DoFit(amplitudes,noisecov,_singlebx,fullpulse,fullpulsecov,gainsPedestal,badSamples);
-    amplitude = status ? _pulsefuncSingle.X()[0] : 0.;
-    amperr = status ? _pulsefuncSingle.Errors()[0] : 0.;
-    chisq = _pulsefuncSingle.ChiSq();
+    if (prefit) {
+      //already done by makeRecHits
+      status = true;
+      amplitude = prefit->amplitude;
+      amperr = 0.;
+      chisq = prefit->chisq;
+    }
+    else {
+      status = _pulsefuncSingle.DoFit(amplitudes,noisecov,_singlebx,fullpulse,fullpulsecov,gainsPedestal,badSamples,noisecovL);
+      amplitude = status ? _pulsefuncSingle.X()[0] : 0.;
+      amperr = status ? _pulsefuncSingle.Errors()[0] : 0.;
+      chisq = _pulsefuncSingle.ChiSq();
+    }
     
     if (chisq < _prefitMaxChiSq) {
       usePrefit = true;
@@ -185,7 +283,7 @@ EcalUncalibratedRecHit EcalUncalibRecHitMultiFitAlgo::makeRecHit(const EcalDataF
   if (!usePrefit) {
   
     if(!_computeErrors) _pulsefunc.disableErrorCalculation();
-    status = _pulsefunc.DoFit(amplitudes,noisecov,activeBX,fullpulse,fullpulsecov,gainsPedestal,badSamples);
+    status = _pulsefunc.DoFit(amplitudes,noisecov,activeBX,fullpulse,fullpulsecov,gainsPedestal,badSamples,noisecovL);
     chisq = _pulsefunc.ChiSq();
     
     if (!status) {
@@ -73,6 +73,8 @@ void eigen_solve_submatrix(PulseMatrix& mat, PulseVector& invec, PulseVector& ou
 }
 
 PulseChiSqSNNLS::PulseChiSqSNNLS() :
+  _samplecovL(nullptr),
+  _covL(nullptr),
   _chisq(0.),
   _computeErrors(true),
   _maxiters(50),
@@ -85,11 +87,12 @@ PulseChiSqSNNLS::~PulseChiSqSNNLS() {
   
 }
 
-bool PulseChiSqSNNLS::DoFit(const SampleVector &samples, const SampleMatrix &samplecov, const BXVector &bxs, const FullSampleVector &fullpulse, const FullSampleMatrix &fullpulsecov, const SampleGainVector &gains, const SampleGainVector &badSamples) {
+bool PulseChiSqSNNLS::DoFit(const SampleVector &samples, const SampleMatrix &samplecov, const BXVector &bxs, const FullSampleVector &fullpulse, const FullSampleMatrix &fullpulsecov, const SampleGainVector &gains, const SampleGainVector &badSamples, const SampleMatrix *samplecovL) {
  
   int npulse = bxs.rows();
   
   _sampvec = samples;
+  _samplecovL = samplecovL;
   _bxs = bxs;
   _pulsemat.resize(Eigen::NoChange,npulse);
 
@@ -279,6 +282,7 @@ bool PulseChiSqSNNLS::updateCov(const SampleMatrix &samplecov, const FullSampleM
 
   _invcov = samplecov; //
   
+  bool pulsecov = false;
   for (unsigned int ipulse=0; ipulse<npulse; ++ipulse) {
     if (_ampvec.coeff(ipulse)==0.) continue;
     int bx = _bxs.coeff(ipulse);
@@ -293,9 +297,17 @@ bool PulseChiSqSNNLS::updateCov(const SampleMatrix &samplecov, const FullSampleM
     const unsigned int nsamplepulse = nsample-firstsamplet;    
     _invcov.block(firstsamplet,firstsamplet,nsamplepulse,nsamplepulse) += 
       ampsq*fullpulsecov.block(firstsamplet+offset,firstsamplet+offset,nsamplepulse,nsamplepulse);   
+    pulsecov = true;
+  }
+  
+  //noise only covariance (e.g. first iteration of the multipulse fit), use the precomputed decomposition
+  if (!pulsecov && _samplecovL) {
+    _covL = _samplecovL;
+    return true;
   }
   
   _covdecomp.compute(_invcov);
+  _covL = &_covdecomp.matrixLLT();
   
   bool status = true;
   return status;
@@ -307,7 +319,7 @@ double PulseChiSqSNNLS::ComputeChiSq() {
 //   SampleVector resvec = _pulsemat*_ampvec - _sampvec;
 //   return resvec.transpose()*_covdecomp.solve(resvec);
   
-  return _covdecomp.matrixL().solve(_pulsemat*_ampvec - _sampvec).squaredNorm();
+  return covL().solve(_pulsemat*_ampvec - _sampvec).squaredNorm();
   
 }
 
@@ -316,7 +328,7 @@ double PulseChiSqSNNLS::ComputeApproxUncertainty(unsigned int ipulse) {
   //(using 1/second derivative since full Hessian is not meaningful in
   //presence of positive amplitude boundaries.)
       
-  return 1./_covdecomp.matrixL().solve(_pulsemat.col(ipulse)).norm();
+  return 1./covL().solve(_pulsemat.col(ipulse)).norm();
   
 }
 
@@ -327,9 +339,9 @@ bool PulseChiSqSNNLS::NNLS() {
   const unsigned int npulse = _bxs.rows();
   constexpr unsigned int nsamples = SampleVector::RowsAtCompileTime;
 
-  invcovp = _covdecomp.matrixL().solve(_pulsemat);
+  invcovp = covL().solve(_pulsemat);
   aTamat.noalias() = invcovp.transpose().lazyProduct(invcovp);
-  aTbvec.noalias() = invcovp.transpose().lazyProduct(_covdecomp.matrixL().solve(_sampvec));
+  aTbvec.noalias() = invcovp.transpose().lazyProduct(covL().solve(_sampvec));
   
   int iter = 0;
   Index idxwmax = 0;
@@ -449,12 +461,12 @@ bool PulseChiSqSNNLS::OnePulseMinimize() {
   
 //   const unsigned int npulse = 1;
 
-  invcovp = _covdecomp.matrixL().solve(_pulsemat);
+  invcovp = covL().solve(_pulsemat);
 //   aTamat = invcovp.transpose()*invcovp;
 //   aTbvec = invcovp.transpose()*_covdecomp.matrixL().solve(_sampvec);
 
   SingleMatrix aTamatval = invcovp.transpose()*invcovp;
-  SingleVector aTbvecval = invcovp.transpose()*_covdecomp.matrixL().solve(_sampvec);
+  SingleVector aTbvecval = invcovp.transpose()*covL().solve(_sampvec);
   _ampvec.coeffRef(0) = std::max(0.,aTbvecval.coeff(0)/aTamatval.coeff(0));
   
   return true;
@@ -0,0 +1,119 @@
+#include "RecoLocalCalo/EcalRecAlgos/interface/PulseChiSqSNNLSBatch.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+unsigned int PulseChiSqSNNLSBatch::add(const SampleVector &samples, const SampleMatrix &samplecov, const FullSampleVector &fullpulse, const FullSampleMatrix &fullpulsecov) {
+
+  assert(_n < MaxChannels);
+  const unsigned int ich = _n++;
+
+  //same initial amplitude and pulse template as PulseChiSqSNNLS::DoFit for a single in-time BX
+  const int bx = 0;
+  const int firstsamplet = bx + 3;
+  const int offset = 7-3-bx;
+  const double amp = samples.coeff(bx + 5);
+
+  for (unsigned int i=0; i<nsample; ++i) {
+    _samples[i][ich] = samples.coeff(i);
+    _pulse[i][ich] = fullpulse.coeff(i+offset);
+    for (unsigned int j=0; j<=i; ++j) {
+      _cov[i][j][ich] = samplecov.coeff(i,j);
+    }
+  }
+
+  //contribution of the pulse shape uncertainty, as in PulseChiSqSNNLS::updateCov
+  if (amp!=0.) {
+    const double ampsq = amp*amp;
+    for (unsigned int i=firstsamplet; i<nsample; ++i) {
+      for (unsigned int j=firstsamplet; j<=i; ++j) {
+        _cov[i][j][ich] += ampsq*fullpulsecov.coeff(i+offset,j+offset);
+      }
+    }
+  }
+
+  return ich;
+}
+
+void PulseChiSqSNNLSBatch::DoFits() {
+
+  //fill the unused channels with a trivial problem, so that all the loops
+  //below run over the full block
+  for (unsigned int ich=_n; ich<MaxChannels; ++ich) {
+    for (unsigned int i=0; i<nsample; ++i) {
+      _samples[i][ich] = 0.;
+      _pulse[i][ich] = 1.;
+      for (unsigned int j=0; j<=i; ++j) {
+        _cov[i][j][ich] = i==j ? 1. : 0.;
+      }
+    }
+  }
+
+  //Cholesky decomposition, cov = L L^T, done in place
+  double invdiag[nsample][MaxChannels];
+  for (unsigned int j=0; j<nsample; ++j) {
+    double d[MaxChannels];
+    for (unsigned int ich=0; ich<MaxChannels; ++ich) d[ich] = _cov[j][j][ich];
+    for (unsigned int k=0; k<j; ++k) {
+      for (unsigned int ich=0; ich<MaxChannels; ++ich) d[ich] -= _cov[j][k][ich]*_cov[j][k][ich];
+    }
+    for (unsigned int ich=0; ich<MaxChannels; ++ich) {
+      _cov[j][j][ich] = std::sqrt(d[ich]);
+      invdiag[j][ich] = 1./_cov[j][j][ich];
+    }
+    for (unsigned int i=j+1; i<nsample; ++i) {
+      double s[MaxChannels];
+      for (unsigned int ich=0; ich<MaxChannels; ++ich) s[ich] = _cov[i][j][ich];
+      for (unsigned int k=0; k<j; ++k) {
+        for (unsigned int ich=0; ich<MaxChannels; ++ich) s[ich] -= _cov[i][k][ich]*_cov[j][k][ich];
+      }
+      for (unsigned int ich=0; ich<MaxChannels; ++ich) _cov[i][j][ich] = s[ich]*invdiag[j][ich];
+    }
+  }
+
+  //forward substitution for L^-1 pulse and L^-1 samples
+  double invcovp[nsample][MaxChannels];
+  double invcovs[nsample][MaxChannels];
+  for (unsigned int i=0; i<nsample; ++i) {
+    double p[MaxChannels], s[MaxChannels];
+    for (unsigned int ich=0; ich<MaxChannels; ++ich) {
+      p[ich] = _pulse[i][ich];
+      s[ich] = _samples[i][ich];
+    }
+    for (unsigned int k=0; k<i; ++k) {
+      for (unsigned int ich=0; ich<MaxChannels; ++ich) {
+        p[ich] -= _cov[i][k][ich]*invcovp[k][ich];
+        s[ich] -= _cov[i][k][ich]*invcovs[k][ich];
+      }
+    }
+    for (unsigned int ich=0; ich<MaxChannels; ++ich) {
+      invcovp[i][ich] = p[ich]*invdiag[i][ich];
+      invcovs[i][ich] = s[ich]*invdiag[i][ich];
+    }
+  }
+
+  //non-negative least squares amplitude and chi2, as in PulseChiSqSNNLS::OnePulseMinimize
+  //and PulseChiSqSNNLS::ComputeChiSq
+  double aTa[MaxChannels], aTb[MaxChannels];
+  for (unsigned int ich=0; ich<MaxChannels; ++ich) {
+    aTa[ich] = 0.;
+    aTb[ich] = 0.;
+  }
+  for (unsigned int i=0; i<nsample; ++i) {
+    for (unsigned int ich=0; ich<MaxChannels; ++ich) {
+      aTa[ich] += invcovp[i][ich]*invcovp[i][ich];
+      aTb[ich] += invcovp[i][ich]*invcovs[i][ich];
+    }
+  }
+  for (unsigned int ich=0; ich<MaxChannels; ++ich) {
+    _amp[ich] = std::max(0.,aTb[ich]/aTa[ich]);
+    _chisq[ich] = 0.;
+  }
+  for (unsigned int i=0; i<nsample; ++i) {
+    for (unsigned int ich=0; ich<MaxChannels; ++ich) {
+      const double res = _amp[ich]*invcovp[i][ich] - invcovs[i][ich];
+      _chisq[ich] += res*res;
+    }
+  }
+
+}
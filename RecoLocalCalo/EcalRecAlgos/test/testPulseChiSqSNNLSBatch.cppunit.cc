@@ -0,0 +1,130 @@
+/* Unit test for PulseChiSqSNNLSBatch: the prefit amplitudes and chi2 of a
+   block of channels, against the per-channel PulseChiSqSNNLS prefit as
+   configured in EcalUncalibRecHitMultiFitAlgo
+
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include "RecoLocalCalo/EcalRecAlgos/interface/PulseChiSqSNNLS.h"
+#include "RecoLocalCalo/EcalRecAlgos/interface/PulseChiSqSNNLSBatch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+class testPulseChiSqSNNLSBatch: public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE(testPulseChiSqSNNLSBatch);
+  CPPUNIT_TEST(testPrefit);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void setUp();
+  void tearDown(){}
+
+  void testPrefit();
+
+private:
+  //random channel with a pulse of the given amplitude on top of correlated noise
+  void makeChannel(double amplitude, SampleVector &samples, SampleMatrix &noisecov,
+                   FullSampleVector &fullpulse, FullSampleMatrix &fullpulsecov);
+
+  std::mt19937 rng_;
+};
+
+///registration of the test so that the runner can find it
+CPPUNIT_TEST_SUITE_REGISTRATION(testPulseChiSqSNNLSBatch);
+
+void testPulseChiSqSNNLSBatch::setUp(){
+  rng_.seed(31);
+}
+
+void testPulseChiSqSNNLSBatch::makeChannel(double amplitude, SampleVector &samples, SampleMatrix &noisecov,
+                                           FullSampleVector &fullpulse, FullSampleMatrix &fullpulsecov) {
+  std::uniform_real_distribution<double> flat(0.,1.);
+  std::normal_distribution<double> gauss(0.,1.);
+
+  //alpha-beta like template, peaking at 1 in sample 9 of the full pulse
+  const double alpha = 1.2 + 0.4*flat(rng_);
+  fullpulse = FullSampleVector::Zero();
+  for (int i=7; i<FullSampleVectorSize; ++i) {
+    const double t = (i-6)/3.;
+    fullpulse(i) = std::pow(t,alpha)*std::exp(-alpha*(t-1.));
+  }
+
+  //template uncertainty, correlated between the samples
+  fullpulsecov = FullSampleMatrix::Zero();
+  const double pulseerr = 1e-3*(1.+flat(rng_));
+  for (int i=7; i<FullSampleVectorSize; ++i) {
+    for (int j=7; j<FullSampleVectorSize; ++j) {
+      fullpulsecov(i,j) = pulseerr*pulseerr*fullpulse(i)*fullpulse(j)*(i==j ? 1. : 0.5);
+    }
+  }
+
+  //pedestal noise, correlated between neighbour samples
+  const double rms = 0.8 + 0.6*flat(rng_);
+  const double rho = 0.3 + 0.4*flat(rng_);
+  for (int i=0; i<SampleVectorSize; ++i) {
+    for (int j=0; j<SampleVectorSize; ++j) {
+      noisecov(i,j) = rms*rms*std::pow(rho,std::abs(i-j));
+    }
+  }
+
+  const int offset = 7-3;
+  for (int i=0; i<SampleVectorSize; ++i) {
+    samples(i) = amplitude*fullpulse(i+offset) + rms*gauss(rng_);
+  }
+}
+
+void testPulseChiSqSNNLSBatch::testPrefit(){
+
+  //as _pulsefuncSingle in EcalUncalibRecHitMultiFitAlgo
+  PulseChiSqSNNLS single;
+  single.disableErrorCalculation();
+  single.setMaxIters(1);
+  single.setMaxIterWarnings(false);
+  BXVector singlebx;
+  singlebx.resize(1);
+  singlebx << 0;
+  const SampleGainVector gainsPedestal = -1*SampleGainVector::Ones();
+  const SampleGainVector badSamples = SampleGainVector::Zero();
+
+  PulseChiSqSNNLSBatch batch;
+
+  std::uniform_real_distribution<double> flat(0.,1.);
+
+  //blocks of all the sizes, with noise only channels (negative amplitudes
+  //from the fit, clamped to 0), small and large pulses
+  for (unsigned int nchannels=1; nchannels<=PulseChiSqSNNLSBatch::MaxChannels; ++nchannels) {
+    for (int trial=0; trial<20; ++trial) {
+      std::vector<double> amps, chisqs;
+      batch.clear();
+      for (unsigned int ich=0; ich<nchannels; ++ich) {
+        const double amplitude = ich%4==0 ? 0. : ich%4==1 ? 5.*flat(rng_) : 2000.*flat(rng_);
+        SampleVector samples;
+        SampleMatrix noisecov;
+        FullSampleVector fullpulse;
+        FullSampleMatrix fullpulsecov;
+        makeChannel(amplitude, samples, noisecov, fullpulse, fullpulsecov);
+
+        CPPUNIT_ASSERT(single.DoFit(samples,noisecov,singlebx,fullpulse,fullpulsecov,gainsPedestal,badSamples));
+        amps.push_back(single.X()[0]);
+        chisqs.push_back(single.ChiSq());
+
+        CPPUNIT_ASSERT_EQUAL(ich, batch.add(samples,noisecov,fullpulse,fullpulsecov));
+      }
+      batch.DoFits();
+
+      //same decomposition and solves in another order: rounding differences only
+      for (unsigned int ich=0; ich<nchannels; ++ich) {
+        const std::string what = "block of " + std::to_string(nchannels) + " channel " + std::to_string(ich);
+        CPPUNIT_ASSERT_MESSAGE(what + " amplitude " + std::to_string(batch.X(ich)) + " " + std::to_string(amps[ich]),
+                               std::abs(batch.X(ich)-amps[ich]) <= 1e-9*std::max(1.,amps[ich]));
+        CPPUNIT_ASSERT_MESSAGE(what + " chi2 " + std::to_string(batch.ChiSq(ich)) + " " + std::to_string(chisqs[ich]),
+                               std::abs(batch.ChiSq(ich)-chisqs[ich]) <= 1e-9*std::max(1.,chisqs[ich]));
+      }
+    }
+  }
+}
@@ -23,7 +23,8 @@
 #include <FWCore/ParameterSet/interface/EmptyGroupDescription.h>
 
 EcalUncalibRecHitWorkerMultiFit::EcalUncalibRecHitWorkerMultiFit(const edm::ParameterSet&ps,edm::ConsumesCollector& c) :
-  EcalUncalibRecHitWorkerBaseClass(ps,c)
+  EcalUncalibRecHitWorkerBaseClass(ps,c),
+  noisecovariancesCacheId_(0)
 {
 
   // get the BX for the pulses to be activated
@@ -137,6 +138,11 @@ EcalUncalibRecHitWorkerMultiFit::set(const edm::EventSetup& es)
         // for the time correction methods
         es.get<EcalTimeBiasCorrectionsRcd>().get(timeCorrBias_);
 
+        // the noise correlations and their decompositions only change with the IOV
+        unsigned long long noisecovariancesCacheId = es.get<EcalSamplesCorrelationRcd>().cacheIdentifier();
+        if (noisecovariancesCacheId == noisecovariancesCacheId_) return;
+        noisecovariancesCacheId_ = noisecovariancesCacheId;
+
         int nnoise = SampleVector::RowsAtCompileTime;
         SampleMatrix &noisecorEBg12 = noisecors_[1][0];
         SampleMatrix &noisecorEBg6 = noisecors_[1][1];
@@ -156,6 +162,12 @@ EcalUncalibRecHitWorkerMultiFit::set(const edm::EventSetup& es)
             noisecorEEg1(i,j)  = noisecovariances->EEG1SamplesCorrelation[vidx];
           }
 	}
+
+        for (unsigned int isub=0; isub<noisecors_.size(); ++isub) {
+          for (unsigned int igain=0; igain<noisecors_[isub].size(); ++igain) {
+            noisecorLs_[isub][igain] = SampleDecompLLT(noisecors_[isub][igain]).matrixL();
+          }
+        }
 }
 
 void
@@ -284,8 +296,58 @@ EcalUncalibRecHitWorkerMultiFit::run( const edm::Event & evt,
     FullSampleVector fullpulse(FullSampleVector::Zero());
     FullSampleMatrix fullpulsecov(FullSampleMatrix::Zero());
 
+    // with the one-pulse prefit, the digis are processed by blocks: the multifit
+    // of all the channels of a block is done first, so that their prefits run
+    // together, then the rechits are filled in the order of the digis.
+    // Without it, the blocks would bring nothing and each channel is fitted in turn.
+    const bool doPrefit = barrel ? doPrefitEB_ : doPrefitEE_;
+    const unsigned int blockSize = 64;
+
     result.reserve(result.size() + digis.size());
-    for (auto itdg = digis.begin(); itdg != digis.end(); ++itdg)
+    for (auto blockbegin = digis.begin(); blockbegin != digis.end(); )
+    {
+    auto blockend = blockbegin;
+    fitInputs_.clear();
+    fitted_.clear();
+    if (!doPrefit) blockend = digis.end();
+    else {
+    for (unsigned int n = 0; blockend != digis.end() && n < blockSize; ++blockend, ++n)
+    {
+        if (((EcalDataFrame)(*blockend)).lastUnsaturatedSample() >= 0) continue;
+
+        DetId detid(blockend->id());
+        fitInputs_.emplace_back(EcalUncalibRecHitMultiFitAlgo::Input{*blockend, nullptr, nullptr, &noisecor(barrel), &noisecorL(barrel), fullpulse, fullpulsecov});
+        auto & input = fitInputs_.back();
+
+        const EcalPulseShapes::Item * aPulse = 0;
+        const EcalPulseCovariances::Item * aPulseCov = 0;
+        if (barrel) {
+            unsigned int hashedIndex = EBDetId(detid).hashedIndex();
+            input.aped  = &peds->barrel(hashedIndex);
+            input.aGain = &gains->barrel(hashedIndex);
+            aPulse      = &pulseshapes->barrel(hashedIndex);
+            aPulseCov   = &pulsecovariances->barrel(hashedIndex);
+        } else {
+            unsigned int hashedIndex = EEDetId(detid).hashedIndex();
+            input.aped  = &peds->endcap(hashedIndex);
+            input.aGain = &gains->endcap(hashedIndex);
+            aPulse      = &pulseshapes->endcap(hashedIndex);
+            aPulseCov   = &pulsecovariances->endcap(hashedIndex);
+        }
+
+        for (int i=0; i<EcalPulseShape::TEMPLATESAMPLES; ++i)
+            input.fullpulse(i+7) = aPulse->pdfval[i];
+
+        for(int i=0; i<EcalPulseShape::TEMPLATESAMPLES;i++)
+        for(int j=0; j<EcalPulseShape::TEMPLATESAMPLES;j++)
+            input.fullpulsecov(i+7,j+7) = aPulseCov->covval[i][j];
+    }
+
+    multiFitMethod_.makeRecHits(fitInputs_, activeBX, fitted_);
+    }
+    unsigned int ifit = 0;
+
+    for (auto itdg = blockbegin; itdg != blockend; ++itdg)
     {
         DetId detid(itdg->id());
 
@@ -322,12 +384,17 @@ EcalUncalibRecHitWorkerMultiFit::run( const edm::Event & evt,
         double pedRMSVec[3]  = { aped->rms_x12,  aped->rms_x6,  aped->rms_x1 };
         double gainRatios[3] = { 1., aGain->gain12Over6(), aGain->gain6Over1()*aGain->gain12Over6()};
 
+        // the pulse of the channels fitted in the block is already in their input
+        const bool inBlock = doPrefit && ((EcalDataFrame)(*itdg)).lastUnsaturatedSample() < 0;
+        const FullSampleVector & pulse = inBlock ? fitInputs_[ifit].fullpulse : fullpulse;
+        if (!inBlock) {
         for (int i=0; i<EcalPulseShape::TEMPLATESAMPLES; ++i)
             fullpulse(i+7) = aPulse->pdfval[i];
     
         for(int i=0; i<EcalPulseShape::TEMPLATESAMPLES;i++)
         for(int j=0; j<EcalPulseShape::TEMPLATESAMPLES;j++)
             fullpulsecov(i+7,j+7) = aPulseCov->covval[i][j];
+        }
         
 	// compute the right bin of the pulse shape using time calibration constants
 	EcalTimeCalibConstantMap::const_iterator it = itime->find( detid );
@@ -361,10 +428,9 @@ EcalUncalibRecHitWorkerMultiFit::run( const edm::Event & evt,
             // do not propagate the default chi2 = -1 value to the calib rechit (mapped to 64), set it to 0 when saturation
             uncalibRecHit.setChi2(0);
         } else {
-            // multifit
-            const SampleMatrixGainArray &noisecors = noisecor(barrel);
-            
-            result.push_back(multiFitMethod_.makeRecHit(*itdg, aped, aGain, noisecors, fullpulse, fullpulsecov, activeBX));
+            // multifit, already done for the block with the prefit
+            if (inBlock) result.push_back(fitted_[ifit++]);
+            else result.push_back(multiFitMethod_.makeRecHit(*itdg, aped, aGain, noisecor(barrel), fullpulse, fullpulsecov, activeBX, &noisecorL(barrel)));
             auto & uncalibRecHit = result.back();
             
             // === time computation ===
@@ -476,9 +542,9 @@ EcalUncalibRecHitWorkerMultiFit::run( const edm::Event & evt,
                 
                 double timerh;
                 if (detid.subdetId()==EcalEndcap) { 
-                    timerh = weightsMethod_endcap_.time( *itdg, amplitudes, aped, aGain, fullpulse, weights);
+                    timerh = weightsMethod_endcap_.time( *itdg, amplitudes, aped, aGain, pulse, weights);
                 } else {
-                    timerh = weightsMethod_barrel_.time( *itdg, amplitudes, aped, aGain, fullpulse, weights);
+                    timerh = weightsMethod_barrel_.time( *itdg, amplitudes, aped, aGain, pulse, weights);
                 }
                 uncalibRecHit.setJitter( timerh );
                 uncalibRecHit.setJitterError( 0. ); // not computed with weights
@@ -494,6 +560,8 @@ EcalUncalibRecHitWorkerMultiFit::run( const edm::Event & evt,
 	if( ((EcalDataFrame)(*itdg)).hasSwitchToGain1()  ) uncalibRecHit.setFlagBit( EcalUncalibratedRecHit::kHasSwitchToGain1 );
 
     }
+    blockbegin = blockend;
+    }
 }
 
 edm::ParameterSetDescription 
@@ -62,13 +62,20 @@ class EcalUncalibRecHitWorkerMultiFit final : public EcalUncalibRecHitWorkerBase
 
                 const SampleMatrix & noisecor(bool barrel, int gain) const { return noisecors_[barrel?1:0][gain];}
                 const SampleMatrixGainArray &noisecor(bool barrel) const { return noisecors_[barrel?1:0]; }
+                const SampleMatrixGainArray &noisecorL(bool barrel) const { return noisecorLs_[barrel?1:0]; }
                 
                 // multifit method
                 std::array<SampleMatrixGainArray, 2> noisecors_;
+                // Cholesky factors of the noise correlations, rebuilt only when their IOV changes
+                std::array<SampleMatrixGainArray, 2> noisecorLs_;
+                unsigned long long noisecovariancesCacheId_;
                 BXVector activeBX;
                 bool ampErrorCalculation_;
                 bool useLumiInfoRunHeader_;
                 EcalUncalibRecHitMultiFitAlgo multiFitMethod_;
+                // inputs and results of the multifit for a block of digis
+                std::vector<EcalUncalibRecHitMultiFitAlgo::Input> fitInputs_;
+                std::vector<EcalUncalibratedRecHit> fitted_;
                 
 		int bunchSpacingManual_;
                 edm::EDGetTokenT<unsigned int> bunchSpacing_; 
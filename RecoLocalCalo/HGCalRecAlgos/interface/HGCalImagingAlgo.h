@@ -23,6 +23,7 @@
 #include <numeric>
 
 #include "KDTreeLinkerAlgoT.h"
+#include "HGCalLayerTiles.h"
 
 
 template <typename T>
@@ -257,7 +258,6 @@ struct Hexel {
 
 };
 
-typedef KDTreeLinkerAlgo<Hexel,2> KDTree;
 typedef KDTreeNodeInfoT<Hexel,2> KDNode;
 
 
@@ -290,9 +290,16 @@ inline double distance2(const Hexel &pt1, const Hexel &pt2) {   //distance squar
 inline double distance(const Hexel &pt1, const Hexel &pt2) {   //2-d distance on the layer (x-y)
         return std::sqrt(distance2(pt1,pt2));
 }
-double calculateLocalDensity(std::vector<KDNode> &, KDTree &, const unsigned int);   //return max density
+inline float criticalDistance(const unsigned int layer) const {   //delta_c, the search distance in a layer
+        if( layer <= lastLayerEE ) return vecDeltas[0];
+        else if( layer <= lastLayerFH ) return vecDeltas[1];
+        else return vecDeltas[2];
+}
+double calculateLocalDensity(std::vector<KDNode> &, const HGCalLayerTiles &, const unsigned int);   //return max density
 double calculateDistanceToHigher(std::vector<KDNode> &);
-int findAndAssignClusters(std::vector<KDNode> &, KDTree &, double, KDTreeBox &, const unsigned int);
+int findAndAssignClusters(std::vector<KDNode> &, const HGCalLayerTiles &, double, const unsigned int);
+void clusterLayer(const unsigned int, std::vector<unsigned int> &);   //layer index as in points
+void fillClusters(const unsigned int, const unsigned int);   //appends the clusters of a layer to current_v
 math::XYZPoint calculatePosition(std::vector<KDNode> &);
 
 // attempt to find subclusters within a given set of hexels
@@ -0,0 +1,96 @@
+#ifndef RecoLocalCalo_HGCalRecAlgos_HGCalLayerTiles_h
+#define RecoLocalCalo_HGCalRecAlgos_HGCalLayerTiles_h
+
+#include "KDTreeLinkerToolsT.h"
+
+#include <algorithm>
+#include <vector>
+
+// Uniform 2D tile index of the hits of one layer, used in place of a KDTree
+// for the fixed radius searches of the imaging algorithm. The tiles are at
+// least as large as the search radius, so that a search visits at most 3x3
+// tiles. The hit coordinates are stored contiguously in tile order, and a
+// search returns the indices of the hits in the vector used to fill the tiles.
+class HGCalLayerTiles
+{
+ public:
+  HGCalLayerTiles() : n1_(0), n2_(0), min1_(0.f), min2_(0.f), invSize_(0.f) {}
+
+  // fill the tiles with the points "nodes" contained in "bounds",
+  // with tiles of size at least "tileSize"
+  template<typename NODE>
+  void fill(const std::vector<NODE> &nodes, const KDTreeBox &bounds, float tileSize) {
+    clear();
+    if( nodes.empty() ) return;
+    min1_ = bounds.dimmin[0];
+    min2_ = bounds.dimmin[1];
+    const float size1 = bounds.dimmax[0] - bounds.dimmin[0];
+    const float size2 = bounds.dimmax[1] - bounds.dimmin[1];
+    tileSize = std::max(tileSize,std::max(size1,size2)/maxTilesPerDim);
+    invSize_ = 1.f/tileSize;
+    n1_ = int(size1*invSize_) + 1;
+    n2_ = int(size2*invSize_) + 1;
+
+    // counting sort of the points by tile
+    std::vector<unsigned int> tiles(nodes.size());
+    tileStart_.assign(n1_*n2_+1,0);
+    for( unsigned int i = 0; i < nodes.size(); ++i ) {
+      tiles[i] = tile1(nodes[i].dims[0])*n2_ + tile2(nodes[i].dims[1]);
+      ++tileStart_[tiles[i]+1];
+    }
+    for( unsigned int t = 1; t < tileStart_.size(); ++t ) tileStart_[t] += tileStart_[t-1];
+
+    std::vector<unsigned int> pos(tileStart_.begin(),tileStart_.end()-1);
+    index_.resize(nodes.size());
+    dim1_.resize(nodes.size());
+    dim2_.resize(nodes.size());
+    for( unsigned int i = 0; i < nodes.size(); ++i ) {
+      const unsigned int ip = pos[tiles[i]]++;
+      index_[ip] = i;
+      dim1_[ip] = nodes[i].dims[0];
+      dim2_[ip] = nodes[i].dims[1];
+    }
+  }
+
+  // indices of all the points inside "searchBox", bounds included
+  void search(const KDTreeBox &searchBox, std::vector<unsigned int> &found) const {
+    found.clear();
+    if( index_.empty() ) return;
+    const int min1 = tile1(searchBox.dimmin[0]), max1 = tile1(searchBox.dimmax[0]);
+    const int min2 = tile2(searchBox.dimmin[1]), max2 = tile2(searchBox.dimmax[1]);
+    for( int i1 = min1; i1 <= max1; ++i1 ) {
+      for( int i2 = min2; i2 <= max2; ++i2 ) {
+        const unsigned int t = i1*n2_ + i2;
+        for( unsigned int i = tileStart_[t]; i < tileStart_[t+1]; ++i ) {
+          if( dim1_[i] >= searchBox.dimmin[0] && dim1_[i] <= searchBox.dimmax[0] &&
+              dim2_[i] >= searchBox.dimmin[1] && dim2_[i] <= searchBox.dimmax[1] )
+            found.push_back(index_[i]);
+        }
+      }
+    }
+  }
+
+  void clear() {
+    n1_ = n2_ = 0;
+    tileStart_.clear();
+    index_.clear();
+    dim1_.clear();
+    dim2_.clear();
+  }
+
+ private:
+  static constexpr float maxTilesPerDim = 512.f;
+
+  int tile1(float dim1) const { return std::min(std::max(int((dim1-min1_)*invSize_),0),n1_-1); }
+  int tile2(float dim2) const { return std::min(std::max(int((dim2-min2_)*invSize_),0),n2_-1); }
+
+  int n1_, n2_;
+  float min1_, min2_, invSize_;
+  // first point of each tile, in the arrays below
+  std::vector<unsigned int> tileStart_;
+  // index and coordinates of the points, in tile order
+  std::vector<unsigned int> index_;
+  std::vector<float> dim1_, dim2_;
+};
+
+#endif
@@ -10,6 +10,9 @@
 //
 #include "DataFormats/CaloRecHit/interface/CaloID.h"
 
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+
 void HGCalImagingAlgo::populate(const HGCRecHitCollection& hits){
   //loop over all hits and create the Hexel structure, skip energies below ecut
 
@@ -66,25 +69,80 @@ void HGCalImagingAlgo::populate(const HGCRecHitCollection& hits){
 // with different input (reset should be called between events)
 void HGCalImagingAlgo::makeClusters()
 {
+  const unsigned int nlayers = 2*(maxlayer+1);
+  std::vector<unsigned int> nClusters(nlayers,0);
+
+  //assign all hits in each layer to a cluster core or halo
+  if (verbosity < pINFO) {
+    // keep the printouts of the layers in order
+    for (unsigned int i = 0; i < nlayers; ++i) {
+      clusterLayer(i,nClusters);
+      fillClusters(i,nClusters[i]);
+    }
+    return;
+  }
+  // the layers are independent, cluster them concurrently and then
+  // make the cluster vector in the order of the layers
+  tbb::parallel_for(tbb::blocked_range<unsigned int>(0,nlayers,1),
+		    [&](const tbb::blocked_range<unsigned int>& r) {
+		      for (unsigned int i = r.begin(); i < r.end(); ++i)
+			clusterLayer(i,nClusters);
+		    });
+  for (unsigned int i = 0; i < nlayers; ++i) {
+    fillClusters(i,nClusters[i]);
+  }
+}
+
+void HGCalImagingAlgo::clusterLayer(const unsigned int i, std::vector<unsigned int> &nClusters)
+{
+  KDTreeBox bounds(minpos[i][0],maxpos[i][0],
+		   minpos[i][1],maxpos[i][1]);
+
+  unsigned int actualLayer = i > maxlayer ? (i-(maxlayer+1)) : i; // maps back from index used for tiles to actual layer
 
   // used for speedy search
-  std::vector<KDTree> hit_kdtree(2*(maxlayer+1));
+  HGCalLayerTiles tiles;
+  tiles.fill(points[i],bounds,criticalDistance(actualLayer));
 
-  //assign all hits in each layer to a cluster core or halo
-  for (unsigned int i = 0; i <= 2*maxlayer+1; ++i) {
-    KDTreeBox bounds(minpos[i][0],maxpos[i][0],
-		     minpos[i][1],maxpos[i][1]);
+  double maxdensity = calculateLocalDensity(points[i],tiles,actualLayer); // also stores rho (energy density) for each point (node)
+  // calculate distance to nearest point with higher density storing distance (delta) and point's index
+  calculateDistanceToHigher(points[i]);
+  nClusters[i] = findAndAssignClusters(points[i],tiles,maxdensity,actualLayer);
+}
 
-    hit_kdtree[i].build(points[i],bounds);
+void HGCalImagingAlgo::fillClusters(const unsigned int i, const unsigned int clusterIndex)
+{
+  //at this point clusterIndex is equal to the number of cluster centers - if it is zero we are
+  //done
+  if(clusterIndex==0) return;
 
-    unsigned int actualLayer = i > maxlayer ? (i-(maxlayer+1)) : i; // maps back from index used for KD trees to actual layer
+  //make room in the temporary cluster vector for the additional clusterIndex clusters
+  // from this layer
+  if (verbosity < pINFO)
+    {
+      std::cout << "resizing cluster vector by "<< clusterIndex << std::endl;
+    }
+  current_v.resize(cluster_offset+clusterIndex);
 
-    double maxdensity = calculateLocalDensity(points[i],hit_kdtree[i], actualLayer); // also stores rho (energy density) for each point (node)
-    // calculate distance to nearest point with higher density storing distance (delta) and point's index
-    calculateDistanceToHigher(points[i]);
-    findAndAssignClusters(points[i],hit_kdtree[i],maxdensity,bounds,actualLayer);
+  std::vector<KDNode> &nd = points[i];
+  for(unsigned int j = 0; j < nd.size(); ++j){
+    int ci = nd[j].data.clusterIndex;
+    if(ci!=-1){
+      current_v[ci+cluster_offset].push_back(nd[j]);
+      if (verbosity < pINFO)
+	  {
+	    std::cout << "Pushing hit " << j << " into cluster with index " << ci+cluster_offset << std::endl;
+	    std::cout << "Size now " << current_v[ci+cluster_offset].size() << std::endl;
+	  }
+    }
   }
-  //make the cluster vector
+
+  //prepare the offset for the next layer if there is one
+  if (verbosity < pINFO)
+    {
+      std::cout << "moving cluster offset by " << clusterIndex << std::endl;
+    }
+  cluster_offset += clusterIndex;
 }
 
 std::vector<reco::BasicCluster> HGCalImagingAlgo::getClusters(bool doSharing){
@@ -185,25 +243,22 @@ math::XYZPoint HGCalImagingAlgo::calculatePosition(std::vector<KDNode> &v){
   return math::XYZPoint(0, 0, 0);
 }
 
-double HGCalImagingAlgo::calculateLocalDensity(std::vector<KDNode> &nd, KDTree &lp, const unsigned int layer){
+double HGCalImagingAlgo::calculateLocalDensity(std::vector<KDNode> &nd, const HGCalLayerTiles &lp, const unsigned int layer){
 
   double maxdensity = 0.;
-  float delta_c; // maximum search distance (critical distance) for local density calculation
-  if( layer<= lastLayerEE ) delta_c = vecDeltas[0];
-  else if( layer <= lastLayerFH) delta_c = vecDeltas[1];
-  else delta_c = vecDeltas[2];
+  // maximum search distance (critical distance) for local density calculation
+  const float delta_c = criticalDistance(layer);
 
   // for each node calculate local density rho and store it
+  std::vector<unsigned int> found;
   for(unsigned int i = 0; i < nd.size(); ++i){
     // speec up search by looking within +/- delta_c window only
     KDTreeBox search_box(nd[i].dims[0]-delta_c,nd[i].dims[0]+delta_c,
 			 nd[i].dims[1]-delta_c,nd[i].dims[1]+delta_c);
-    std::vector<KDNode> found;
     lp.search(search_box,found);
-    const unsigned int found_size = found.size();
-    for(unsigned int j = 0; j < found_size; j++){
-      if(distance(nd[i].data,found[j].data) < delta_c){
-	    nd[i].data.rho += found[j].data.weight;
+    for(unsigned int j : found){
+      if(distance(nd[i].data,nd[j].data) < delta_c){
+	    nd[i].data.rho += nd[j].data.weight;
 	    if(nd[i].data.rho > maxdensity) maxdensity = nd[i].data.rho;
       }
     } // end loop found
@@ -262,17 +317,15 @@ double HGCalImagingAlgo::calculateDistanceToHigher(std::vector<KDNode> &nd){
   return maxdensity;
 }
 
-int HGCalImagingAlgo::findAndAssignClusters(std::vector<KDNode> &nd,KDTree &lp, double maxdensity, KDTreeBox &bounds, const unsigned int layer){
+int HGCalImagingAlgo::findAndAssignClusters(std::vector<KDNode> &nd, const HGCalLayerTiles &lp, double maxdensity, const unsigned int layer){
 
   //this is called once per layer and endcap...
-  //so when filling the cluster temporary vector of Hexels we resize each time by the number
-  //of clusters found. This is always equal to the number of cluster centers...
+  //the hits are assigned a clusterIndex local to the layer, the clusters are then
+  //added to the temporary vector of Hexels by fillClusters. The number of clusters
+  //found is always equal to the number of cluster centers...
 
   unsigned int clusterIndex = 0;
-  float delta_c; // critical distance
-  if( layer<=lastLayerEE ) delta_c = vecDeltas[0];
-  else if( layer<=lastLayerFH ) delta_c = vecDeltas[1];
-  else delta_c = vecDeltas[2];
+  const float delta_c = criticalDistance(layer); // critical distance
 
   std::vector<size_t> rs = sorted_indices(nd); // indices sorted by decreasing rho
   std::vector<size_t> ds = sort_by_delta(nd); // sort in decreasing distance to higher
@@ -314,19 +367,10 @@ int HGCalImagingAlgo::findAndAssignClusters(std::vector<KDNode> &nd,KDTree &lp,
     }
   }
 
-  //make room in the temporary cluster vector for the additional clusterIndex clusters
-  // from this layer
-  if (verbosity < pINFO)
-    {
-      std::cout << "resizing cluster vector by "<< clusterIndex << std::endl;
-    }
-  current_v.resize(cluster_offset+clusterIndex);
-
   //assign points closer than dc to other clusters to border region
   //and find critical border density
   std::vector<double> rho_b(clusterIndex,0.);
-  lp.clear();
-  lp.build(nd,bounds);
+  std::vector<unsigned int> found;
   //now loop on all hits again :( and check: if there are hits from another cluster within d_c -> flag as border hit
   for(unsigned int i = 0; i < nd_size; ++i){
     int ci = nd[i].data.clusterIndex;
@@ -334,22 +378,20 @@ int HGCalImagingAlgo::findAndAssignClusters(std::vector<KDNode> &nd,KDTree &lp,
     if(ci != -1){
       KDTreeBox search_box(nd[i].dims[0]-delta_c,nd[i].dims[0]+delta_c,
 			   nd[i].dims[1]-delta_c,nd[i].dims[1]+delta_c);
-      std::vector<KDNode> found;
       lp.search(search_box,found);
 
-      const unsigned int found_size = found.size();
-      for(unsigned int j = 0; j < found_size; j++){ // start from 0 here instead of 1
+      for(unsigned int j : found){ // start from 0 here instead of 1
 	    //check if the hit is not within d_c of another cluster
-	    if(found[j].data.clusterIndex!=-1){
-	      float dist = distance(found[j].data,nd[i].data);
-	      if(dist < delta_c && found[j].data.clusterIndex!=ci){
+	    if(nd[j].data.clusterIndex!=-1){
+	      float dist = distance(nd[j].data,nd[i].data);
+	      if(dist < delta_c && nd[j].data.clusterIndex!=ci){
 	        //in which case we assign it to the border
 	        nd[i].data.isBorder = true;
 	        break;
 	      }
 	      //because we are using two different containers, we have to make sure that we don't unflag the
 	      // hit when it finds *itself* closer than delta_c
-	      if(dist < delta_c && dist != 0. && found[j].data.clusterIndex==ci){
+	      if(dist < delta_c && dist != 0. && nd[j].data.clusterIndex==ci){
 	        // in this case it is not an isolated hit
             // the dist!=0 is because the hit being looked at is also inside the search box and at dist==0
 	        flag_isolated = false;
@@ -363,27 +405,13 @@ int HGCalImagingAlgo::findAndAssignClusters(std::vector<KDNode> &nd,KDTree &lp,
       rho_b[ci] = nd[i].data.rho;
   } // end loop all hits
 
-  //flag points in cluster with density < rho_b as halo points, then fill the cluster vector
+  //flag points in cluster with density < rho_b as halo points
   for(unsigned int i = 0; i < nd_size; ++i){
     int ci = nd[i].data.clusterIndex;
     if(ci!=-1 && nd[i].data.rho < rho_b[ci])
       nd[i].data.isHalo = true;
-    if(nd[i].data.clusterIndex!=-1){
-      current_v[ci+cluster_offset].push_back(nd[i]);
-      if (verbosity < pINFO)
-	  {
-	    std::cout << "Pushing hit " << i << " into cluster with index " << ci+cluster_offset << std::endl;
-	    std::cout << "Size now " << current_v[ci+cluster_offset].size() << std::endl;
-	  }
-    }
   }
 
-  //prepare the offset for the next layer if there is one
-  if (verbosity < pINFO)
-    {
-      std::cout << "moving cluster offset by " << clusterIndex << std::endl;
-    }
-  cluster_offset += clusterIndex;
   return clusterIndex;
 }
 
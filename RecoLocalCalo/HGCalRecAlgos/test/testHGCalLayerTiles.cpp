@@ -0,0 +1,132 @@
+// HGCalLayerTiles against the KDTree it replaced in HGCalImagingAlgo: for
+// each hit of a layer, the same neighbours closer than delta_c, which are
+// all that the density, border and halo computations use
+
+#include "RecoLocalCalo/HGCalRecAlgos/interface/HGCalLayerTiles.h"
+#include "RecoLocalCalo/HGCalRecAlgos/interface/KDTreeLinkerAlgoT.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+  std::mt19937 rng(36);
+
+  double flat(double a, double b) { return std::uniform_real_distribution<double>(a,b)(rng); }
+  double gauss(double mean, double sigma) { return std::normal_distribution<double>(mean,sigma)(rng); }
+
+  // as the Hexel: the position is that of the cell, the node coordinates are its float copy
+  struct Hit {
+    unsigned int index;
+    double x, y;
+  };
+  typedef KDTreeNodeInfoT<Hit,2> Node;
+
+  // cell centres of a hexagonal grid of the given pitch
+  void addCell(std::vector<Node> & nodes, int i, int j, float pitch) {
+    const float x = (i + 0.5f*(j&1))*pitch;
+    const float y = j*pitch*0.8660254f;
+    nodes.emplace_back(Hit{(unsigned int)nodes.size(),x,y},x,y);
+  }
+
+  // showers on the cell grid, and isolated noise cells spread over the layer
+  std::vector<Node> makeLayer(unsigned int nShowers, unsigned int nNoise, float pitch, float halfSize) {
+    std::vector<Node> nodes;
+    const int n = halfSize/pitch;
+    for (unsigned int is = 0; is < nShowers; ++is) {
+      const double x0 = flat(-halfSize,halfSize), y0 = flat(-halfSize,halfSize);
+      const int nCells = 5 + flat(0.,60.);
+      for (int ic = 0; ic < nCells; ++ic) {
+	const int j = std::lround(gauss(y0,2.)/(pitch*0.8660254));
+	const int i = std::lround(gauss(x0,2.)/pitch - 0.5*(j&1));
+	addCell(nodes,i,j,pitch);
+      }
+    }
+    for (unsigned int in = 0; in < nNoise; ++in) addCell(nodes,int(flat(-n,n)),int(flat(-n,n)),pitch);
+    return nodes;
+  }
+
+  int failures = 0;
+
+  void check(std::vector<Node> nodes, float delta_c) {
+    if (nodes.empty()) {
+      HGCalLayerTiles tiles;
+      tiles.fill(nodes,KDTreeBox(0.f,0.f,0.f,0.f),delta_c);
+      std::vector<unsigned int> found(1,0);
+      tiles.search(KDTreeBox(-1.f,1.f,-1.f,1.f),found);
+      if (!found.empty()) {
+	std::cout << "points found in an empty layer" << std::endl;
+	++failures;
+      }
+      return;
+    }
+
+    // the layer bounds, as in HGCalImagingAlgo::populate
+    float min1 = nodes[0].dims[0], max1 = min1, min2 = nodes[0].dims[1], max2 = min2;
+    for (auto const & node : nodes) {
+      min1 = std::min(min1,node.dims[0]); max1 = std::max(max1,node.dims[0]);
+      min2 = std::min(min2,node.dims[1]); max2 = std::max(max2,node.dims[1]);
+    }
+    KDTreeBox bounds(min1,max1,min2,max2);
+
+    HGCalLayerTiles tiles;
+    tiles.fill(nodes,bounds,delta_c);
+    // the KDTree reorders its list
+    const std::vector<Node> hits = nodes;
+    KDTreeLinkerAlgo<Hit,2> tree;
+    tree.build(nodes,bounds);
+
+    std::vector<unsigned int> found, fromTiles, fromTree;
+    std::vector<Node> foundNodes;
+    for (auto const & hit : hits) {
+      KDTreeBox searchBox(hit.dims[0]-delta_c,hit.dims[0]+delta_c,
+			  hit.dims[1]-delta_c,hit.dims[1]+delta_c);
+      auto close = [&](Hit const & other) {
+	return std::hypot(hit.data.x-other.x,hit.data.y-other.y) < delta_c;
+      };
+
+      tiles.search(searchBox,found);
+      fromTiles.clear();
+      for (unsigned int j : found) if (close(hits[j].data)) fromTiles.push_back(j);
+
+      foundNodes.clear();
+      tree.search(searchBox,foundNodes);
+      fromTree.clear();
+      for (auto const & node : foundNodes) if (close(node.data)) fromTree.push_back(node.data.index);
+
+      // the order of the neighbours only changes the order of the sums
+      std::sort(fromTiles.begin(),fromTiles.end());
+      std::sort(fromTree.begin(),fromTree.end());
+      if (fromTiles != fromTree) {
+	std::cout << hits.size() << " hits, delta_c " << delta_c << ", hit " << hit.data.index << ": "
+		  << fromTree.size() << " neighbours from the tree, " << fromTiles.size() << " from the tiles" << std::endl;
+	++failures;
+      }
+    }
+  }
+
+}
+
+
+int main() {
+  check(std::vector<Node>(),2.f);
+  // one hit, one shower, and full layers: silicon cells, and scintillator
+  // tiles with the search radius smaller than the tiles of a large layer
+  check(makeLayer(0,1,0.95f,50.f),2.f);
+  for (int trial = 0; trial < 5; ++trial) {
+    check(makeLayer(1,0,0.95f,20.f),2.f);
+    check(makeLayer(10,200,0.95f,150.f),2.f);
+    check(makeLayer(30,2000,0.95f,150.f),2.f);
+    check(makeLayer(5,500,3.f,250.f),5.f);
+    check(makeLayer(5,2000,0.95f,250.f),0.5f);
+  }
+
+  if (failures) {
+    std::cout << failures << " failures" << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,90 @@
+// File: CompareHGCalLayerClusters.cc
+// Description: check that two collections of HGCal layer clusters hold the
+// same clusters, in any order: the same hits with the same fractions, and
+// the same energy and position up to the rounding of sums made in another
+// order.
+// Throws at the first difference.
+//--------------------------------------------
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/Utilities/interface/InputTag.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+
+#include "DataFormats/EgammaReco/interface/BasicCluster.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+class CompareHGCalLayerClusters : public edm::global::EDAnalyzer<> {
+public:
+  explicit CompareHGCalLayerClusters(const edm::ParameterSet& conf) :
+    refToken_(consumes<std::vector<reco::BasicCluster> >(conf.getParameter<edm::InputTag>("reference"))),
+    testToken_(consumes<std::vector<reco::BasicCluster> >(conf.getParameter<edm::InputTag>("test"))) {}
+
+  void analyze(edm::StreamID, const edm::Event& ev, const edm::EventSetup&) const override;
+
+private:
+  typedef std::vector<std::pair<uint32_t,float> > Hits;
+
+  // the hits of each cluster, sorted, with the clusters sorted by their hits
+  static std::vector<std::pair<Hits,const reco::BasicCluster*> > sorted(const std::vector<reco::BasicCluster>&);
+
+  const edm::EDGetTokenT<std::vector<reco::BasicCluster> > refToken_;
+  const edm::EDGetTokenT<std::vector<reco::BasicCluster> > testToken_;
+};
+
+std::vector<std::pair<CompareHGCalLayerClusters::Hits,const reco::BasicCluster*> >
+CompareHGCalLayerClusters::sorted(const std::vector<reco::BasicCluster>& clusters) {
+  std::vector<std::pair<Hits,const reco::BasicCluster*> > result;
+  result.reserve(clusters.size());
+  for (auto const& cluster : clusters) {
+    Hits hits;
+    hits.reserve(cluster.hitsAndFractions().size());
+    for (auto const& hf : cluster.hitsAndFractions()) hits.emplace_back(hf.first.rawId(), hf.second);
+    std::sort(hits.begin(), hits.end());
+    result.emplace_back(std::move(hits), &cluster);
+  }
+  std::sort(result.begin(), result.end(),
+	    [](std::pair<Hits,const reco::BasicCluster*> const& a, std::pair<Hits,const reco::BasicCluster*> const& b) {
+	      return a.first < b.first;
+	    });
+  return result;
+}
+
+void CompareHGCalLayerClusters::analyze(edm::StreamID, const edm::Event& ev, const edm::EventSetup&) const {
+  edm::Handle<std::vector<reco::BasicCluster> > ref, test;
+  ev.getByToken(refToken_, ref);
+  ev.getByToken(testToken_, test);
+
+  if (ref->size() != test->size())
+    throw cms::Exception("CompareHGCalLayerClusters") << "different number of clusters: " << ref->size() << ' ' << test->size();
+
+  // the energies and positions are sums over the hits of a cluster
+  constexpr double tolerance = 1.e-5;
+  auto close = [&](double a, double b) { return std::abs(a-b) <= tolerance*std::max(1.,std::abs(a)); };
+
+  const auto a = sorted(*ref);
+  const auto b = sorted(*test);
+  unsigned int nHits = 0;
+  for (unsigned int i = 0; i < a.size(); ++i) {
+    const reco::BasicCluster& ca = *a[i].second;
+    const reco::BasicCluster& cb = *b[i].second;
+    if (a[i].first != b[i].first)
+      throw cms::Exception("CompareHGCalLayerClusters") << "different hits in the cluster of seed " << ca.seed().rawId();
+    if (!close(ca.energy(), cb.energy()))
+      throw cms::Exception("CompareHGCalLayerClusters") << "different energies for the cluster of seed " << ca.seed().rawId()
+							<< ": " << ca.energy() << ' ' << cb.energy();
+    if (!close(ca.x(), cb.x()) || !close(ca.y(), cb.y()) || !close(ca.z(), cb.z()))
+      throw cms::Exception("CompareHGCalLayerClusters") << "different positions for the cluster of seed " << ca.seed().rawId();
+    nHits += a[i].first.size();
+  }
+
+  LogDebug("CompareHGCalLayerClusters") << ref->size() << " clusters, " << nHits << " hits";
+}
+
+DEFINE_FWK_MODULE(CompareHGCalLayerClusters);
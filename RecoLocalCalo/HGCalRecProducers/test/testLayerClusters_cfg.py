@@ -0,0 +1,50 @@
+# check that the HGCal layer clusters made with the tiles are the same as the
+# hgcalLayerClusters of the input, made with the KDTree by the release before
+# the change, in any order (CompareHGCalLayerClusters throws at the first difference)
+#
+#   cmsRun testLayerClusters_cfg.py inputFiles=file:step3.root globalTag=<GT of step3>
+# with the step3.root of a runTheMatrix.py workflow of the HGCal geometry
+##############################################################################
+
+import FWCore.ParameterSet.Config as cms
+from FWCore.ParameterSet.VarParsing import VarParsing
+
+options = VarParsing('analysis')
+options.register('globalTag', '', VarParsing.multiplicity.singleton, VarParsing.varType.string,
+                 "global tag used to make the input")
+options.parseArguments()
+
+process = cms.Process("LayerClustersTest")
+
+process.load("FWCore.MessageLogger.MessageLogger_cfi")
+process.load("Configuration.Geometry.GeometryExtended2023D17Reco_cff")
+process.load("Configuration.StandardSequences.FrontierConditions_GlobalTag_cff")
+process.load("Configuration.StandardSequences.Services_cff")
+
+process.load("RecoLocalCalo.HGCalRecProducers.hgcalLayerClusters_cfi")
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(options.maxEvents)
+)
+
+# several threads, so that the layers are clustered concurrently
+process.options = cms.untracked.PSet(
+    numberOfThreads = cms.untracked.uint32(4),
+    numberOfStreams = cms.untracked.uint32(0)
+)
+
+process.source = cms.Source("PoolSource",
+  fileNames = cms.untracked.vstring(options.inputFiles)
+)
+
+process.GlobalTag.globaltag = options.globalTag
+
+# same parameters as the hgcalLayerClusters of the input
+process.hgcalLayerClustersTest = process.hgcalLayerClusters.clone()
+
+process.compareLayerClusters = cms.EDAnalyzer("CompareHGCalLayerClusters",
+    reference = cms.InputTag("hgcalLayerClusters","","RECO"),
+    test = cms.InputTag("hgcalLayerClustersTest")
+)
+
+process.p = cms.Path(process.hgcalLayerClustersTest*process.compareLayerClusters)
@@ -81,6 +81,7 @@ class dso_hidden PixelThresholdClusterizer final : public PixelClusterizerBase {
   SiPixelArrayBuffer               theBuffer;         // internal nrow * ncol matrix
   bool                             bufferAlreadySet;  // status of the buffer array
   std::vector<SiPixelCluster::PixelPos>  theSeeds;          // cached seed pixels
+  std::vector<int>                       theElectrons;      // calibrated charges of the digis, reused from module to module
   std::vector<SiPixelCluster>            theClusters;       // resulting clusters  
   
   //! Clustering-related quantities:
@@ -53,7 +53,8 @@
     clusterizer_(0),          // the default, in case we fail to make one
     readyToCluster_(false),   // since we obviously aren't
     maxTotalClusters_( conf.getParameter<int32_t>( "maxNumberOfClusters" ) ),
-    payloadType_( conf.getParameter<std::string>( "payloadType" ) )
+    payloadType_( conf.getParameter<std::string>( "payloadType" ) ),
+    lastNumberOfClusters_(0)
   {
     if ( clusterMode_ == "PixelThresholdReclusterizer" )
       tPixelClusters = consumes<SiPixelClusterCollectionNew>( conf.getParameter<edm::InputTag>("src") );
@@ -105,7 +106,6 @@
 
     // Step B: create the final output collection
     auto output = std::make_unique< SiPixelClusterCollectionNew>();
-    //FIXME: put a reserve() here
 
     // Step C: Iterate over DetIds and invoke the pixel clusterizer algorithm
     // on each DetUnit
@@ -158,6 +158,10 @@
 
     int numberOfDetUnits = 0;
     int numberOfClusters = 0;
+
+    // Size the output from the previous event of this stream, to save most of
+    // the reallocations while the collection grows.
+    output.reserve(input.size(), lastNumberOfClusters_ + lastNumberOfClusters_/4);
  
     // Iterate on detector units
     typename T::const_iterator DSViter = input.begin();
@@ -199,6 +203,7 @@
         break;
       }
     } // end of DetUnit loop
+    lastNumberOfClusters_ = numberOfClusters;
     
     //LogDebug ("SiPixelClusterProducer") << " Executing " 
     //      << clusterMode_ << " resulted in " << numberOfClusters
@@ -79,6 +79,9 @@
     const int32_t maxTotalClusters_;
 
     const std::string payloadType_;
+
+    //! Number of clusters in the previous event, to size the output
+    unsigned int lastNumberOfClusters_;
   };
 
 
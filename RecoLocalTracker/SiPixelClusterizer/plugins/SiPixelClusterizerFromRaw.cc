@@ -0,0 +1,357 @@
+/*
+ * Pixel clusters directly from the raw data.
+ * In the onDemand mode a module is unpacked and clusterized only when its
+ * DetSet is first accessed, and a FED is unpacked at most once per event,
+ * by the first of its modules to be accessed.
+ */
+#include "PixelThresholdClusterizer.h"
+
+#include "DataFormats/Common/interface/DetSetVector.h"
+#include "DataFormats/Common/interface/DetSetVectorNew.h"
+#include "DataFormats/SiPixelCluster/interface/SiPixelCluster.h"
+#include "DataFormats/SiPixelDigi/interface/PixelDigi.h"
+#include "DataFormats/DetId/interface/DetId.h"
+#include "DataFormats/FEDRawData/interface/FEDRawDataCollection.h"
+
+#include "CondFormats/DataRecord/interface/SiPixelFedCablingMapRcd.h"
+#include "CondFormats/SiPixelObjects/interface/SiPixelFedCablingMap.h"
+#include "CondFormats/SiPixelObjects/interface/SiPixelFedCablingTree.h"
+#include "EventFilter/SiPixelRawToDigi/interface/PixelDataFormatter.h"
+
+#include "Geometry/Records/interface/TrackerDigiGeometryRecord.h"
+#include "Geometry/TrackerGeometryBuilder/interface/TrackerGeometry.h"
+#include "Geometry/TrackerGeometryBuilder/interface/PixelGeomDetUnit.h"
+
+#include "CalibTracker/SiPixelESProducers/interface/SiPixelGainCalibrationService.h"
+#include "CalibTracker/SiPixelESProducers/interface/SiPixelGainCalibrationOfflineService.h"
+#include "CalibTracker/SiPixelESProducers/interface/SiPixelGainCalibrationForHLTService.h"
+
+#include "FWCore/Framework/interface/stream/EDProducer.h"
+#include "FWCore/Framework/interface/ESWatcher.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/Utilities/interface/InputTag.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/EventSetup.h"
+#include "FWCore/Framework/interface/ESHandle.h"
+#include "FWCore/Framework/interface/ESTransientHandle.h"
+
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+
+#include <tbb/enumerable_thread_specific.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+
+namespace {
+
+  // the digis of one FED, sorted by module;
+  // within a module they are in the order of the data words, as in the digi collection
+  struct FedDigis {
+    std::vector<cms_uint32_t> rawIds;
+    std::vector<PixelDigi> digis;
+  };
+
+
+  // One clusterizer per thread, so that the modules accessed on demand by
+  // different threads are clusterized concurrently. Each clusterizer has its own
+  // copy of the gain calibration service, as both keep per module caches; the
+  // copy is refreshed from the prototype at the first use in each event.
+  class ClusterizerPool {
+  public:
+    ClusterizerPool(const edm::ParameterSet& conf, const std::string& payloadType) :
+      conf_(conf), payloadType_(payloadType), generation_(0) {}
+
+    // the prototype has been set up for a new event
+    void newEvent(const SiPixelGainCalibrationServiceBase& prototype) { prototype_ = &prototype; ++generation_; }
+
+    PixelClusterizerBase & local() {
+      Slot & slot = slots_.local();
+      if (!slot.clusterizer) slot.clusterizer.reset(new PixelThresholdClusterizer(conf_));
+      if (slot.generation != generation_) {
+	slot.gain.reset(clone(*prototype_));
+	slot.clusterizer->setSiPixelGainCalibrationService(slot.gain.get());
+	slot.generation = generation_;
+      }
+      return *slot.clusterizer;
+    }
+
+  private:
+
+    struct Slot {
+      unsigned long long generation = 0;
+      std::unique_ptr<SiPixelGainCalibrationServiceBase> gain;
+      std::unique_ptr<PixelThresholdClusterizer> clusterizer;
+    };
+
+    SiPixelGainCalibrationServiceBase * clone(const SiPixelGainCalibrationServiceBase& prototype) const {
+      if (payloadType_ == "HLT")
+	return new SiPixelGainCalibrationForHLTService(static_cast<const SiPixelGainCalibrationForHLTService&>(prototype));
+      if (payloadType_ == "Offline")
+	return new SiPixelGainCalibrationOfflineService(static_cast<const SiPixelGainCalibrationOfflineService&>(prototype));
+      return new SiPixelGainCalibrationService(static_cast<const SiPixelGainCalibrationService&>(prototype));
+    }
+
+    const edm::ParameterSet conf_;
+    const std::string payloadType_;
+    const SiPixelGainCalibrationServiceBase * prototype_ = nullptr;
+    unsigned long long generation_;
+    tbb::enumerable_thread_specific<Slot> slots_;
+  };
+
+
+  class ClusterFiller final : public edmNew::DetSetVector<SiPixelCluster>::Getter {
+  public:
+    ClusterFiller(const FEDRawDataCollection& irawColl,
+		  const PixelDataFormatter& iformatter,
+		  const std::vector<unsigned int>& ifedIds,
+		  const std::vector<unsigned int>& idetIds,
+		  const std::vector<unsigned int>& idetFeds,
+		  const TrackerGeometry& igeom,
+		  ClusterizerPool& iclusterizers) :
+      rawColl(irawColl),
+      formatter(iformatter),
+      fedIds(ifedIds),
+      detIds(idetIds),
+      detFeds(idetFeds),
+      geom(igeom),
+      clusterizers(iclusterizers),
+      buffers(ifedIds.size()),
+      done(new std::atomic<FedDigis*>[ifedIds.size()]) {
+	for (unsigned int i = 0; i < ifedIds.size(); ++i) done[i] = nullptr;
+      }
+
+    void fill(edmNew::DetSetVector<SiPixelCluster>::TSFastFiller & record) override;
+
+  private:
+
+    // the digis of the iFed-th FED, unpacked at the first call
+    const FedDigis & unpack(unsigned int iFed);
+
+    const FEDRawDataCollection& rawColl;
+    // copied for each FED, as the formatter keeps counters
+    const PixelDataFormatter formatter;
+    const std::vector<unsigned int>& fedIds;
+    const std::vector<unsigned int>& detIds;
+    const std::vector<unsigned int>& detFeds;
+    const TrackerGeometry& geom;
+
+    // each clusterizer works in its own buffers, one module at a time
+    ClusterizerPool& clusterizers;
+
+    std::vector<std::unique_ptr<FedDigis> > buffers;
+    std::unique_ptr<std::atomic<FedDigis*>[]> done;
+  };
+
+} // namespace
+
+
+
+class SiPixelClusterizerFromRaw final : public edm::stream::EDProducer<>  {
+
+ public:
+
+  explicit SiPixelClusterizerFromRaw(const edm::ParameterSet& conf) :
+    onDemand(conf.getParameter<bool>("onDemand")),
+    usePilotBlade(conf.existsAs<bool>("UsePilotBlade") ? conf.getParameter<bool>("UsePilotBlade") : false),
+    usePhase1(conf.existsAs<bool>("UsePhase1") ? conf.getParameter<bool>("UsePhase1") : false),
+    cablingMapLabel(conf.existsAs<std::string>("CablingMapLabel") ? conf.getParameter<std::string>("CablingMapLabel") : ""),
+    payloadType(conf.getParameter<std::string>("payloadType")),
+    clusterizers_(conf, payloadType)
+      {
+	productToken_ = consumes<FEDRawDataCollection>(conf.getParameter<edm::InputTag>("InputLabel"));
+	produces< edmNew::DetSetVector<SiPixelCluster> > ();
+
+	if (payloadType == "HLT")
+	  theSiPixelGainCalibration_.reset(new SiPixelGainCalibrationForHLTService(conf));
+	else if (payloadType == "Offline")
+	  theSiPixelGainCalibration_.reset(new SiPixelGainCalibrationOfflineService(conf));
+	else if (payloadType == "Full")
+	  theSiPixelGainCalibration_.reset(new SiPixelGainCalibrationService(conf));
+	assert(theSiPixelGainCalibration_.get());
+      }
+
+
+  void produce(edm::Event& ev, const edm::EventSetup& es) override {
+
+    initialize(es);
+
+    // get raw data
+    edm::Handle<FEDRawDataCollection> rawData;
+    ev.getByToken( productToken_, rawData);
+
+    edm::ESHandle<TrackerGeometry> geom;
+    es.get<TrackerDigiGeometryRecord>().get( geom );
+
+    PixelDataFormatter formatter(cabling_.get(), usePhase1);
+    formatter.setErrorStatus(false);
+
+    auto filler = std::make_shared<ClusterFiller>(*rawData, formatter, fedIds_, detIds_, detFeds_, *geom, clusterizers_);
+
+    std::unique_ptr< edmNew::DetSetVector<SiPixelCluster> >
+      output( onDemand ?
+	      new edmNew::DetSetVector<SiPixelCluster>(std::shared_ptr<edmNew::DetSetVector<SiPixelCluster>::Getter>(filler), detIds_)
+	      : new edmNew::DetSetVector<SiPixelCluster>());
+
+    if(onDemand) assert(output->onDemand());
+
+    // the clusters filled on demand cannot be moved: reserve for the busiest events
+    output->reserve(detIds_.size(), 64*1024);
+
+    if (!onDemand) {
+      run(*filler, *output);
+      output->shrink_to_fit();
+    }
+
+    ev.put(std::move(output));
+
+  }
+
+private:
+
+  void initialize(const edm::EventSetup& es);
+
+  void run(ClusterFiller & filler, edmNew::DetSetVector<SiPixelCluster> & output);
+
+
+ private:
+
+  const bool onDemand;
+  const bool usePilotBlade;
+  const bool usePhase1;
+  const std::string cablingMapLabel;
+  const std::string payloadType;
+
+  edm::EDGetTokenT<FEDRawDataCollection> productToken_;
+
+  edm::ESWatcher<SiPixelFedCablingMapRcd> recordWatcher;
+  std::unique_ptr<SiPixelFedCablingTree> cabling_;
+  std::vector<unsigned int> fedIds_;
+  // the modules in the cabling, sorted, and the index in fedIds_ of the FED of each
+  std::vector<unsigned int> detIds_;
+  std::vector<unsigned int> detFeds_;
+
+  // the prototype of the gain calibration services of the clusterizers
+  std::unique_ptr<SiPixelGainCalibrationServiceBase> theSiPixelGainCalibration_;
+  ClusterizerPool clusterizers_;
+
+};
+
+#include "FWCore/Framework/interface/MakerMacros.h"
+DEFINE_FWK_MODULE(SiPixelClusterizerFromRaw);
+
+
+
+void SiPixelClusterizerFromRaw::initialize(const edm::EventSetup& es) {
+
+  theSiPixelGainCalibration_->setESObjects( es );
+  clusterizers_.newEvent(*theSiPixelGainCalibration_);
+
+  if (!recordWatcher.check( es )) return;
+
+  edm::ESTransientHandle<SiPixelFedCablingMap> cablingMap;
+  es.get<SiPixelFedCablingMapRcd>().get( cablingMapLabel, cablingMap );
+  cabling_ = cablingMap->cablingTree();
+
+  fedIds_.clear();
+  for (auto fedId : cablingMap->fedIds())
+    if (usePilotBlade || fedId!=40) fedIds_.push_back(fedId); // skip pilot blade data
+
+  std::vector<std::pair<unsigned int, unsigned int> > detFeds;
+  for (auto const & det2fed : cablingMap->det2fedMap()) {
+    auto fed = std::find(fedIds_.begin(), fedIds_.end(), det2fed.second);
+    if (fed != fedIds_.end()) detFeds.emplace_back(det2fed.first, fed-fedIds_.begin());
+  }
+  std::sort(detFeds.begin(), detFeds.end());
+
+  detIds_.clear();
+  detFeds_.clear();
+  for (auto const & detFed : detFeds) {
+    detIds_.push_back(detFed.first);
+    detFeds_.push_back(detFed.second);
+  }
+
+}
+
+void SiPixelClusterizerFromRaw::run(ClusterFiller & filler, edmNew::DetSetVector<SiPixelCluster> & output) {
+
+  // loop over the modules in the cabling
+  for ( auto idet : detIds_) {
+
+    edmNew::DetSetVector<SiPixelCluster>::TSFastFiller record(output, idet);
+
+    filler.fill(record);
+
+    if(record.empty()) record.abort();
+
+  } // end loop over dets
+}
+
+
+const FedDigis & ClusterFiller::unpack(unsigned int iFed) {
+
+  FedDigis * fedDigis = done[iFed];
+  if (fedDigis) return *fedDigis;
+
+  const int fedId = fedIds[iFed];
+  PixelDataFormatter::DigiBuffer buffer;
+  PixelDataFormatter::Errors errors;  // the errors are not stored in this mode
+  bool errorsInFed = false;
+  PixelDataFormatter fedFormatter(formatter);
+  fedFormatter.interpretRawData(errorsInFed, fedId, rawColl.FEDData(fedId), buffer, errors);
+
+  // stable sort by module
+  std::vector<unsigned int> order(buffer.rawIds.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+		   [&](unsigned int i, unsigned int j) { return buffer.rawIds[i] < buffer.rawIds[j]; });
+  fedDigis = new FedDigis;
+  fedDigis->rawIds.reserve(order.size());
+  fedDigis->digis.reserve(order.size());
+  for (auto i : order) {
+    fedDigis->rawIds.push_back(buffer.rawIds[i]);
+    fedDigis->digis.push_back(buffer.digis[i]);
+  }
+
+  // another module of the same FED may have been faster
+  FedDigis * exp = nullptr;
+  if (done[iFed].compare_exchange_strong(exp, fedDigis)) buffers[iFed].reset(fedDigis);
+  else { delete fedDigis; fedDigis = done[iFed]; }
+  return *fedDigis;
+}
+
+void ClusterFiller::fill(edmNew::DetSetVector<SiPixelCluster>::TSFastFiller & record) {
+
+  auto idet = record.id();
+
+  auto det = std::lower_bound(detIds.begin(), detIds.end(), idet);
+  if (det == detIds.end() || *det != idet) return;
+  const FedDigis & fedDigis = unpack(detFeds[det-detIds.begin()]);
+
+  auto range = std::equal_range(fedDigis.rawIds.begin(), fedDigis.rawIds.end(), idet);
+  if (range.first == range.second) return;
+
+  const PixelGeomDetUnit * pixDet = dynamic_cast<const PixelGeomDetUnit*>(geom.idToDetUnit( DetId(idet) ));
+  if (!pixDet) return;
+
+  edm::DetSet<PixelDigi> digis(idet);
+  digis.data.assign(fedDigis.digis.begin() + (range.first - fedDigis.rawIds.begin()),
+		    fedDigis.digis.begin() + (range.second - fedDigis.rawIds.begin()));
+
+  std::vector<short> badChannels;
+  edmNew::DetSetVector<SiPixelCluster> clusters;
+  {
+    edmNew::DetSetVector<SiPixelCluster>::FastFiller spc(clusters, idet);
+    clusterizers.local().clusterizeDetUnit(digis, pixDet, badChannels, spc);
+  }
+  for (auto const & cluster : clusters.data()) record.push_back(cluster);
+
+  if (record.full()) {
+    edm::LogError("TooManyClusters") << "too many pixel clusters to fit space allocated for OnDemand for " << record.id() << ' ' << record.size();
+    record.abort();
+  }
+
+}
@@ -0,0 +1,20 @@
+import FWCore.ParameterSet.Config as cms
+
+# pixel clusters from the raw data, each module is unpacked and clusterized at its first use
+from CondTools.SiPixel.SiPixelGainCalibrationService_cfi import *
+siPixelClusters = cms.EDProducer("SiPixelClusterizerFromRaw",
+    SiPixelGainCalibrationServiceParameters,
+    onDemand = cms.bool(True),
+    InputLabel = cms.InputTag("rawDataCollector"),
+    UsePilotBlade = cms.bool(False),
+    UsePhase1 = cms.bool(False),
+    CablingMapLabel = cms.string(""),
+    ChannelThreshold = cms.int32(1000),
+    MissCalibrate = cms.untracked.bool(True),
+    SplitClusters = cms.bool(False),
+    VCaltoElectronGain = cms.int32(65),
+    VCaltoElectronOffset = cms.int32(-414),
+    payloadType = cms.string('HLT'),
+    SeedThreshold = cms.int32(1000),
+    ClusterThreshold = cms.double(4000.0),
+)
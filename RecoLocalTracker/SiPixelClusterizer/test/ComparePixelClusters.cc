@@ -0,0 +1,69 @@
+// File: ComparePixelClusters.cc
+// Description: check that two collections of pixel clusters are the same,
+// module by module and pixel by pixel; the modules that are empty in one
+// collection may be absent from the other one (as in the onDemand mode).
+// Throws at the first difference.
+//--------------------------------------------
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/Utilities/interface/InputTag.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+
+#include "DataFormats/Common/interface/DetSetVectorNew.h"
+#include "DataFormats/SiPixelCluster/interface/SiPixelCluster.h"
+
+class ComparePixelClusters : public edm::global::EDAnalyzer<> {
+public:
+  explicit ComparePixelClusters(const edm::ParameterSet& conf) :
+    refToken_(consumes<edmNew::DetSetVector<SiPixelCluster> >(conf.getParameter<edm::InputTag>("reference"))),
+    testToken_(consumes<edmNew::DetSetVector<SiPixelCluster> >(conf.getParameter<edm::InputTag>("test"))) {}
+
+  void analyze(edm::StreamID, const edm::Event& ev, const edm::EventSetup&) const override;
+
+private:
+  // number of clusters, after checking that the DetSets of "a" are in "b" with the same clusters
+  static unsigned int compare(const edmNew::DetSetVector<SiPixelCluster>& a,
+			      const edmNew::DetSetVector<SiPixelCluster>& b,
+			      const char* what);
+
+  const edm::EDGetTokenT<edmNew::DetSetVector<SiPixelCluster> > refToken_;
+  const edm::EDGetTokenT<edmNew::DetSetVector<SiPixelCluster> > testToken_;
+};
+
+unsigned int ComparePixelClusters::compare(const edmNew::DetSetVector<SiPixelCluster>& a,
+					   const edmNew::DetSetVector<SiPixelCluster>& b,
+					   const char* what) {
+  unsigned int n = 0;
+  for (auto const & dsa : a) {
+    if (dsa.empty()) continue;
+    auto idb = b.find(dsa.detId());
+    if (idb == b.end() || (*idb).size() != dsa.size())
+      throw cms::Exception("ComparePixelClusters") << "different number of clusters in " << dsa.detId() << ' ' << what;
+    auto const & dsb = *idb;
+    for (unsigned int i = 0; i < dsa.size(); ++i) {
+      auto const & ca = dsa[i];
+      auto const & cb = dsb[i];
+      if (ca.pixelADC() != cb.pixelADC() || ca.pixelOffset() != cb.pixelOffset() ||
+	  ca.minPixelRow() != cb.minPixelRow() || ca.minPixelCol() != cb.minPixelCol())
+	throw cms::Exception("ComparePixelClusters") << "different cluster " << i << " in " << dsa.detId() << ' ' << what;
+    }
+    n += dsa.size();
+  }
+  return n;
+}
+
+void ComparePixelClusters::analyze(edm::StreamID, const edm::Event& ev, const edm::EventSetup&) const {
+  edm::Handle<edmNew::DetSetVector<SiPixelCluster> > ref, test;
+  ev.getByToken(refToken_, ref);
+  ev.getByToken(testToken_, test);
+
+  // both ways, as the empty modules are skipped
+  unsigned int nRef = compare(*ref, *test, "(missing in the test collection)");
+  unsigned int nTest = compare(*test, *ref, "(missing in the reference collection)");
+  LogDebug("ComparePixelClusters") << nRef << " clusters in the reference, " << nTest << " in the test collection";
+}
+
+DEFINE_FWK_MODULE(ComparePixelClusters);
@@ -0,0 +1,62 @@
+# check that SiPixelClusterizerFromRaw, in onDemand mode and not,
+# gives the same clusters as SiPixelRawToDigi + SiPixelClusterProducer
+# (ComparePixelClusters throws at the first difference)
+#
+##############################################################################
+
+import FWCore.ParameterSet.Config as cms
+
+process = cms.Process("ClusFromRawTest")
+
+process.load("FWCore.MessageLogger.MessageLogger_cfi")
+process.load("Configuration.Geometry.GeometryIdeal_cff")
+process.load("Configuration.StandardSequences.MagneticField_38T_cff")
+process.load("Configuration.StandardSequences.FrontierConditions_GlobalTag_cff")
+process.load("Configuration.StandardSequences.Services_cff")
+
+process.load("EventFilter.SiPixelRawToDigi.SiPixelRawToDigi_cfi")
+process.load("RecoLocalTracker.SiPixelClusterizer.SiPixelClusterizer_cfi")
+import RecoLocalTracker.SiPixelClusterizer.SiPixelClusterizerOnDemand_cfi as onDemand_cfi
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(100)
+)
+
+# several threads, so that the modules are clusterized concurrently in the onDemand mode
+process.options = cms.untracked.PSet(
+    numberOfThreads = cms.untracked.uint32(4),
+    numberOfStreams = cms.untracked.uint32(0)
+)
+
+process.source = cms.Source("PoolSource",
+  fileNames = cms.untracked.vstring(
+  '/store/relval/CMSSW_7_1_0_pre8/RelValTTbar/GEN-SIM-DIGI-RAW-HLTDEBUG/PU_PRE_STA71_V4-v1/00000/06397C95-91E2-E311-963D-02163E00B776.root',
+  )
+)
+
+process.GlobalTag.globaltag = "START71_V1::All"
+
+# reference
+process.siPixelDigis.InputLabel = 'rawDataCollector'
+
+# the same clusterizer parameters as the reference
+process.siPixelClustersOnDemand = onDemand_cfi.siPixelClusters.clone(
+    payloadType = process.siPixelClusters.payloadType,
+    InputLabel = process.siPixelDigis.InputLabel,
+    UsePilotBlade = process.siPixelDigis.UsePilotBlade,
+    UsePhase1 = process.siPixelDigis.UsePhase1,
+    onDemand = True
+)
+process.siPixelClustersFromRaw = process.siPixelClustersOnDemand.clone(onDemand = False)
+
+process.compareOnDemand = cms.EDAnalyzer("ComparePixelClusters",
+    reference = cms.InputTag("siPixelClusters"),
+    test = cms.InputTag("siPixelClustersOnDemand")
+)
+process.compareFromRaw = process.compareOnDemand.clone(
+    test = cms.InputTag("siPixelClustersFromRaw")
+)
+
+process.p = cms.Path(process.siPixelDigis*process.siPixelClusters
+                     *process.siPixelClustersOnDemand*process.siPixelClustersFromRaw
+                     *process.compareOnDemand*process.compareFromRaw)
@@ -27,6 +27,7 @@ class StripClusterizerAlgorithm {
     float noise(const uint16_t& strip) const { return SiStripNoises::getNoise( strip, noiseRange ); }
     float gain(const uint16_t& strip)  const { return SiStripGain::getStripGain( strip, gainRange ); }
     bool bad(const uint16_t& strip)    const { return quality->IsStripBad( qualityRange, strip ); }
+    bool anyBad() const { return qualityRange.first != qualityRange.second; }
     bool allBadBetween(uint16_t L, const uint16_t& R) const { while( ++L < R  &&  bad(L) ); return L == R; }
     SiStripQuality const * quality;
     SiStripApvGain::Range gainRange;
@@ -20,20 +20,10 @@ class ThreeThresholdAlgorithm final : public StripClusterizerAlgorithm {
   void stripByStripAdd(State & state, uint16_t strip, uint8_t adc, std::vector<SiStripCluster>& out) const override;
   void stripByStripEnd(State & state, std::vector<SiStripCluster>& out) const override;
 
-  void addFed(State & state, sistrip::FEDZSChannelUnpacker & unpacker, uint16_t ipair, std::vector<SiStripCluster>& out) const {
-    while (unpacker.hasData()) {
-      stripByStripAdd(state,unpacker.sampleNumber()+ipair*256,unpacker.adc(),out);
-      unpacker++;
-    }
-  }
+  void addFed(State & state, sistrip::FEDZSChannelUnpacker & unpacker, uint16_t ipair, std::vector<SiStripCluster>& out) const;
 
   // detset interface
-  void addFed(State & state, sistrip::FEDZSChannelUnpacker & unpacker, uint16_t ipair, output_t::TSFastFiller & out) const override {
-    while (unpacker.hasData()) {
-      stripByStripAdd(state, unpacker.sampleNumber()+ipair*256,unpacker.adc(),out);
-      unpacker++;
-    }
-  }
+  void addFed(State & state, sistrip::FEDZSChannelUnpacker & unpacker, uint16_t ipair, output_t::TSFastFiller & out) const override;
 
   void stripByStripAdd(State & state, uint16_t strip, uint8_t adc, output_t::TSFastFiller & out) const override {
     if(candidateEnded(state, strip)) endCandidate(state, out);
@@ -46,6 +36,13 @@ class ThreeThresholdAlgorithm final : public StripClusterizerAlgorithm {
  private:
 
   template<class T> void clusterizeDetUnit_(const T&, output_t::TSFastFiller&) const;
+  template<class T> void addFed_(State &, sistrip::FEDZSChannelUnpacker &, uint16_t, T&) const;
+
+  // The digis are processed in blocks of up to one APV: the thresholds of all the
+  // digis of a block are evaluated at once, into bit masks of the strips to be
+  // added, and only these strips are then passed to the candidate logic.
+  static constexpr unsigned int blockSize = 128;
+  template<class T> void addBlock(State &, const uint16_t * strips, const uint8_t * adcs, unsigned int n, T&) const;
 
   ThreeThresholdAlgorithm(float, float, float, unsigned, unsigned, unsigned, std::string qualityLabel,
 			  bool removeApvShots, float minGoodCharge);
@@ -61,6 +58,7 @@ class ThreeThresholdAlgorithm final : public StripClusterizerAlgorithm {
     void clearCandidate(State & state) const { state.candidateLacksSeed = true;  state.noiseSquared = 0;  state.ADCs.clear();}
     void addToCandidate(State & state, const SiStripDigi& digi) const { addToCandidate(state, digi.strip(),digi.adc());}
     void addToCandidate(State & state, uint16_t strip, uint8_t adc) const;
+    void appendToCandidate(State & state, uint16_t strip, uint8_t adc, float noise, bool seed) const;
     void appendBadNeighbors(State & state) const;
     void applyGains(State & state) const;
 
@@ -2,16 +2,20 @@ import FWCore.ParameterSet.Config as cms
 
 from RecoLocalTracker.SiStripClusterizer.test.ClusterizerUnitTestFunctions_cff import *
 
+defaultParameters = cms.PSet( Algorithm = cms.string("ThreeThresholdAlgorithm"),
+                               ChannelThreshold = cms.double(2),
+                               SeedThreshold    = cms.double(3),
+                               ClusterThreshold = cms.double(5),
+                               MaxSequentialHoles = cms.uint32(0),
+                               MaxSequentialBad   = cms.uint32(1),
+                               MaxAdjacentBad     = cms.uint32(0),
+                               QualityLabel = cms.string(""),
+                               RemoveApvShots = cms.bool(False),
+                               clusterChargeCut = cms.PSet( value = cms.double(-1.0) )
+                               )
+
 clusterizerTests = ClusterizerTest( "Default Clusterizer Settings",
-                                    cms.PSet( Algorithm = cms.string("ThreeThresholdAlgorithm"),
-                                              ChannelThreshold = cms.double(2),
-                                              SeedThreshold    = cms.double(3),
-                                              ClusterThreshold = cms.double(5),
-                                              MaxSequentialHoles = cms.uint32(0),
-                                              MaxSequentialBad   = cms.uint32(1),
-                                    MaxAdjacentBad     = cms.uint32(0),
-                                              QualityLabel = cms.string("")
-                                    ),
+                                    defaultParameters,
                                     [
     DetUnit( "[] = []",
              [  ],
@@ -238,6 +242,104 @@ clusterizerTests = ClusterizerTest( "Default Clusterizer Settings",
                digi(  12, 100,  noise1, gain1, good) ],
              [ cluster(  10, [110]),
                cluster(  12, [100])
+               ] ),
+    DetUnit( "(110/1)XX(100/1) = [110],[100]",
+             [ digi(  10, 110,  noise1, gain1, good),
+               digi(  11, 110,  noise1, gain1,  bad),
+               digi(  12, 110,  noise1, gain1,  bad),
+               digi(  13, 100,  noise1, gain1, good) ],
+             [ cluster(  10, [110]),
+               cluster(  13, [100])
+               ] ),
+    # the digis are processed in blocks of 128 digis (not strips)
+    DetUnit( "Cluster across the 128 digi block boundary",
+             [ digi(  s, 100,  noise1, gain1, good) for s in range(10,151) ],
+             [ cluster(  10, [100]*141)
+               ] ),
+    DetUnit( "Cluster ending at the 128 digi block boundary",
+             [ digi(  s, 100,  noise1, gain1, good) for s in range(0,128) ] +
+             [ digi( 129, 100,  noise1, gain1, good) ],
+             [ cluster(   0, [100]*128),
+               cluster( 129, [100])
+               ] ),
+    DetUnit( "Digis below threshold across the 128 digi block boundary",
+             [ digi(  s, 100 if s<126 or s>129 else 1,  noise1, gain1, good) for s in range(0,140) ],
+             [ cluster(   0, [100]*126),
+               cluster( 130, [100]*10)
+               ] ),
+    DetUnit( "Bad strip at the 128 digi block boundary",
+             [ digi(  s, 100,  noise1, gain1, good if s!=127 else bad) for s in range(0,129) ],
+             [ cluster(   0, [100]*127 + [0, 100])
+               ] ),
+    DetUnit( "Clusters in the three APV pairs",
+             [ digi(  255, 100,  noise1, gain1, good),
+               digi(  256, 100,  noise1, gain1, good),
+               digi(  511, 100,  noise1, gain1, good),
+               digi(  600, 100,  noise1, gain1, good) ],
+             [ cluster(  255, [100,100]),
+               cluster(  511, [100]),
+               cluster(  600, [100])
+               ] )
+    ]
+                                           )
+
+clusterizerTestsWithHoles = ClusterizerTest( "One hole allowed",
+                                             defaultParameters.clone( MaxSequentialHoles = 1 ),
+                                             [
+    DetUnit( "(110/1)_(100/1) = [110,0,100]",
+             [ digi(  10, 110,  noise1, gain1, good),
+               digi(  11,   0,  noise1, gain1, good),
+               digi(  12, 100,  noise1, gain1, good) ],
+             [ cluster(  10, [110,0,100])
+               ] ),
+    DetUnit( "(110/1) (100/1) = [110,0,100]  (no digi in the hole)",
+             [ digi(  10, 110,  noise1, gain1, good),
+               digi(  12, 100,  noise1, gain1, good) ],
+             [ cluster(  10, [110,0,100])
+               ] ),
+    DetUnit( "(110/1)(1/1)(100/1) = [110,0,100]  (below threshold)",
+             [ digi(  10, 110,  noise1, gain1, good),
+               digi(  11,   1,  noise1, gain1, good),
+               digi(  12, 100,  noise1, gain1, good) ],
+             [ cluster(  10, [110,0,100])
+               ] ),
+    DetUnit( "(110/1)__(100/1) = [110],[100]",
+             [ digi(  10, 110,  noise1, gain1, good),
+               digi(  11,   0,  noise1, gain1, good),
+               digi(  12,   0,  noise1, gain1, good),
+               digi(  13, 100,  noise1, gain1, good) ],
+             [ cluster(  10, [110]),
+               cluster(  13, [100])
+               ] ),
+    DetUnit( "(110/1)_X(100/1) = [110],[100]",
+             [ digi(  10, 110,  noise1, gain1, good),
+               digi(  11,   0,  noise1, gain1, good),
+               digi(  12, 110,  noise1, gain1,  bad),
+               digi(  13, 100,  noise1, gain1, good) ],
+             [ cluster(  10, [110]),
+               cluster(  13, [100])
+               ] ),
+    DetUnit( "Hole at the 128 digi block boundary",
+             [ digi(  s, 100 if s!=127 else 1,  noise1, gain1, good) for s in range(0,129) ],
+             [ cluster(   0, [100]*127 + [0, 100])
+               ] )
+    ]
+                                           )
+
+clusterizerTestsAdjacentBad = ClusterizerTest( "Adjacent bad strips appended",
+                                               defaultParameters.clone( MaxAdjacentBad = 1 ),
+                                               [
+    DetUnit( "X(110/1)X = [0,110,0]",
+             [ digi(   9, 110,  noise1, gain1, bad),
+               digi(  10, 110,  noise1, gain1, good),
+               digi(  11, 110,  noise1, gain1, bad) ],
+             [ cluster(   9, [0,110,0])
+               ] ),
+    DetUnit( "XX(110/1) = [0,110]",
+             [ digi(   8, 110,  noise1, gain1, bad),
+               digi(   9, 110,  noise1, gain1, bad),
+               digi(  10, 110,  noise1, gain1, good) ],
+             [ cluster(   9, [0,110])
                ] )
     ]
                                            )
@@ -1,6 +1,7 @@
 #include "RecoLocalTracker/SiStripClusterizer/interface/ThreeThresholdAlgorithm.h"
 #include "DataFormats/SiStripDigi/interface/SiStripDigi.h"
 #include "DataFormats/SiStripCluster/interface/SiStripCluster.h"
+#include <cassert>
 #include <cmath>
 #include <numeric>
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
@@ -40,10 +41,38 @@ clusterizeDetUnit_(const digiDetSet& digis, output_t::TSFastFiller& output) cons
   }
 
   State state(det);
+  uint16_t strips[blockSize];
+  uint8_t adcs[blockSize];
   while( scan != end ) {
-    while( scan != end  && !candidateEnded(state, scan->strip() ) ) 
-      addToCandidate( state, *scan++);
-    endCandidate(state, output);
+    unsigned int n = 0;
+    for( ; scan != end && n < blockSize; ++scan, ++n) {
+      strips[n] = scan->strip();
+      adcs[n] = scan->adc();
+    }
+    addBlock(state, strips, adcs, n, output);
+  }
+  endCandidate(state, output);
+}
+
+template<class T>
+inline
+void ThreeThresholdAlgorithm::
+addFed_(State & state, sistrip::FEDZSChannelUnpacker & unpacker, uint16_t ipair, T& out) const {
+  uint16_t strips[blockSize];
+  uint8_t adcs[blockSize];
+  while (unpacker.hasData()) {
+    unsigned int n = 0;
+    try {
+      for( ; unpacker.hasData() && n < blockSize; unpacker++) {
+	strips[n] = unpacker.sampleNumber()+ipair*256;
+	adcs[n++] = unpacker.adc();
+      }
+    } catch (...) {
+      // the strips unpacked before bad data are kept, as when adding them one by one
+      addBlock(state, strips, adcs, n, out);
+      throw;
+    }
+    addBlock(state, strips, adcs, n, out);
   }
 }
 
@@ -75,6 +104,50 @@ addToCandidate(State & state, uint16_t strip, uint8_t adc) const {
   state.noiseSquared += Noise*Noise;
 }
 
+inline
+void ThreeThresholdAlgorithm::
+appendToCandidate(State & state, uint16_t strip, uint8_t adc, float noise, bool seed) const {
+  if(state.candidateLacksSeed) state.candidateLacksSeed = !seed;
+  if(state.ADCs.empty()) state.lastStrip = strip - 1; // begin candidate
+  while( ++state.lastStrip < strip ) state.ADCs.push_back(0); // pad holes
+
+  state.ADCs.push_back( adc );
+  state.noiseSquared += noise*noise;
+}
+
+template <class T>
+inline
+void ThreeThresholdAlgorithm::
+addBlock(State & state, const uint16_t * strips, const uint8_t * adcs, unsigned int n, T& out) const {
+  assert(n <= blockSize);
+  constexpr unsigned int nWords = blockSize/64;
+  float noises[blockSize];
+  uint8_t channel[blockSize], seeds[blockSize];
+  uint64_t added[nWords] = {0};
+
+  for( unsigned int i = 0; i < n; ++i ) noises[i] = state.det().noise( strips[i] );
+  // same comparisons as in addToCandidate, vectorized over the block
+  for( unsigned int i = 0; i < n; ++i ) {
+    channel[i] = adcs[i] >= static_cast<uint8_t>( noises[i] * ChannelThreshold);
+    seeds[i] = adcs[i] >= static_cast<uint8_t>( noises[i] * SeedThreshold);
+  }
+  if( state.det().anyBad() ) {
+    for( unsigned int i = 0; i < n; ++i ) 
+      if( channel[i] && state.det().bad( strips[i] ) ) channel[i] = 0;
+  }
+  for( unsigned int i = 0; i < n; ++i ) added[i/64] |= uint64_t(channel[i]) << (i%64);
+
+  // A strip below threshold changes neither the candidate nor the end of it:
+  // if the candidate ends at such a strip, it also ends at the next strip added.
+  for( unsigned int w = 0; w < nWords; ++w ) {
+    for( uint64_t bits = added[w]; bits; bits &= bits - 1 ) {
+      const unsigned int i = w*64 + __builtin_ctzll(bits);
+      if(candidateEnded(state, strips[i])) endCandidate(state, out);
+      appendToCandidate(state, strips[i], adcs[i], noises[i], seeds[i]);
+    }
+  }
+}
+
 template <class T>
 inline
 void ThreeThresholdAlgorithm::
@@ -125,6 +198,9 @@ appendBadNeighbors(State & state) const {
 void ThreeThresholdAlgorithm::clusterizeDetUnit(const    edm::DetSet<SiStripDigi>& digis, output_t::TSFastFiller& output) const {clusterizeDetUnit_(digis,output);}
 void ThreeThresholdAlgorithm::clusterizeDetUnit(const edmNew::DetSet<SiStripDigi>& digis, output_t::TSFastFiller& output) const {clusterizeDetUnit_(digis,output);}
 
+void ThreeThresholdAlgorithm::addFed(State & state, sistrip::FEDZSChannelUnpacker & unpacker, uint16_t ipair, std::vector<SiStripCluster>& out) const {addFed_(state,unpacker,ipair,out);}
+void ThreeThresholdAlgorithm::addFed(State & state, sistrip::FEDZSChannelUnpacker & unpacker, uint16_t ipair, output_t::TSFastFiller& out) const {addFed_(state,unpacker,ipair,out);}
+
 StripClusterizerAlgorithm::Det
 ThreeThresholdAlgorithm::
 stripByStripBegin(uint32_t id) const {
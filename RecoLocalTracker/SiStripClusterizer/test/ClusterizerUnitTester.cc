@@ -2,6 +2,7 @@
 
 #include "DataFormats/SiStripDigi/interface/SiStripDigi.h"
 #include "DataFormats/SiStripCluster/interface/SiStripCluster.h"
+#include "EventFilter/SiStripRawToDigi/interface/SiStripFEDBuffer.h"
 #include <functional>
 #include <numeric>
 #include <vector>
@@ -50,6 +51,13 @@ runTheTest(const PSet& test) {
   try { 
     clusterizer->clusterize(digis, result); 
     assertIdentical(expected, result);
+    // the same digis, as unpacked from zero suppressed lite FED channels (adc>255 cannot be packed)
+    if(!test.getParameter<bool>("InvalidCharge")) {
+      output_t fedResult;
+      clusterizeFromFed(digiset, fedResult);
+      try { assertIdentical(expected, fedResult); }
+      catch(cms::Exception& e) { throw e << "From the FED channels.\n"; }
+    }
     if(test.getParameter<bool>("InvalidCharge")) throw cms::Exception("Failed") << "Charges are valid, contrary to expectation.\n";
   }
   catch(StripClusterizerAlgorithm::InvalidChargeException e) {
@@ -82,6 +90,52 @@ constructClusters(const VPSet& clusterset, output_t& clusters) {
   if(clustersFF.empty()) clustersFF.abort();
 }
 
+void ClusterizerUnitTester::
+clusterizeFromFed(const VPSet& stripset, output_t& clusters) {
+  output_t::TSFastFiller clustersFF(clusters, detId);
+  auto const & det = clusterizer->stripByStripBegin(detId);
+  if(det.valid()) {
+    StripClusterizerAlgorithm::State state(det);
+    for(uint16_t ipair = 0; ipair < 3; ipair++) {
+      std::vector<uint8_t> buffer = fedChannel(stripset, ipair);
+      sistrip::FEDChannel channel(&buffer[0], 0);
+      sistrip::FEDZSChannelUnpacker unpacker = sistrip::FEDZSChannelUnpacker::zeroSuppressedLiteModeUnpacker(channel);
+      clusterizer->addFed(state, unpacker, ipair, clustersFF);
+    }
+    clusterizer->stripByStripEnd(state, clustersFF);
+  }
+  if(clustersFF.empty()) clustersFF.abort();
+}
+
+// Zero suppressed lite channel of the strips of the APV pair "ipair": the length, then
+// for each run of consecutive strips the first strip, the width and the adcs,
+// with the bytes swapped within 64 bit words as in the FED buffer.
+std::vector<uint8_t> ClusterizerUnitTester::
+fedChannel(const VPSet& stripset, uint16_t ipair) {
+  std::vector<uint8_t> payload(2,0);
+  unsigned width = 0;
+  int last = -2;
+  for(iter_t strip = stripset.begin(); strip < stripset.end(); strip++) {
+    unsigned s = strip->getParameter<unsigned>("Strip");
+    if(s/256 != ipair) continue;
+    int sample = s%256;
+    if(sample != last+1 || payload[width] == 255) {
+      payload.push_back(sample);
+      width = payload.size();
+      payload.push_back(0);
+    }
+    payload.push_back(strip->getParameter<unsigned>("ADC"));
+    payload[width]++;
+    last = sample;
+  }
+  payload[0] = payload.size() & 0xFF;
+  payload[1] = payload.size() >> 8;
+
+  std::vector<uint8_t> buffer((payload.size()+7)/8*8, 0);
+  for(unsigned i = 0; i < payload.size(); i++) buffer[i^7] = payload[i];
+  return buffer;
+}
+
 std::string ClusterizerUnitTester::
 printDigis(const VPSet& stripset){
   std::stringstream s;
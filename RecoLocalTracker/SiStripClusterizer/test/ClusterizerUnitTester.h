@@ -32,6 +32,9 @@ class ClusterizerUnitTester : public edm::EDAnalyzer {
   
   void constructClusters(const VPSet&, output_t&);
   void constructDigis(const VPSet&, edmNew::DetSetVector<SiStripDigi>&);
+  void clusterizeFromFed(const VPSet&, output_t&);
+
+  static std::vector<uint8_t> fedChannel(const VPSet&, uint16_t);
 
   static std::string printDigis(const VPSet&);
   static void assertIdentical(const output_t&, const output_t&);
@@ -14,6 +14,7 @@ class PercentileCMNSubtractor : public SiStripCommonModeNoiseSubtractor {
  private:
   
   template<typename T> float percentile(std::vector<T>&, double);
+  float percentile(std::vector<int16_t>&, double);
   template<typename T> void subtract_(const uint32_t&,const uint16_t& firstAPV, std::vector<T>&);
   PercentileCMNSubtractor(double in) : 
     percentile_(in) {};  
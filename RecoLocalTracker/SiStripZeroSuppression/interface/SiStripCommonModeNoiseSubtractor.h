@@ -5,10 +5,12 @@
 #include <vector>
 #include <algorithm>
 #include <stdint.h>
+#include <cstring>
 
 class SiStripCommonModeNoiseSubtractor {
 
   friend class SiStripRawProcessingFactory;
+  friend class TestSiStripCommonModeNoiseSubtractor;
 
  public:
   
@@ -23,6 +25,8 @@ class SiStripCommonModeNoiseSubtractor {
 
   SiStripCommonModeNoiseSubtractor(){};
   template<typename T> float median(std::vector<T>&);
+  float median(std::vector<int16_t>&);
+  static int16_t nthElement(const int16_t*, unsigned int size, unsigned int k);
 
   std::vector< std::pair<short,float> > _vmedians;
 };
@@ -40,5 +44,40 @@ median( std::vector<T>& sample) {
     return *mid;
   return ( *std::max_element(sample.begin(), mid) + *mid ) / 2.;
 }
+
+// same as above, without reordering the sample
+inline
+float SiStripCommonModeNoiseSubtractor::
+median( std::vector<int16_t>& sample) {
+  const unsigned int mid = sample.size()/2;
+  const int16_t upper = nthElement(sample.data(), sample.size(), mid);
+  if( sample.size() & 1 ) //odd size
+    return upper;
+  return ( nthElement(sample.data(), sample.size(), mid-1) + upper ) / 2.;
+}
+
+// k-th smallest element (from 0) of the sample: the elements are counted by
+// their high, then by their low byte, with no branch on their values
+// (a faster alternative to std::nth_element for the 128 strips of an APV)
+inline
+int16_t SiStripCommonModeNoiseSubtractor::
+nthElement( const int16_t* sample, unsigned int size, unsigned int k) {
+  uint16_t count[256];
+  std::memset(count, 0, sizeof(count));
+  for( unsigned int i = 0; i < size; ++i )
+    ++count[ (uint16_t(sample[i]) ^ 0x8000) >> 8 ];  // flip the sign bit to order the keys
+  unsigned int high = 0, below = 0;
+  while( below + count[high] <= k ) below += count[high++];
+
+  std::memset(count, 0, sizeof(count));
+  for( unsigned int i = 0; i < size; ++i ) {
+    const uint16_t key = uint16_t(sample[i]) ^ 0x8000;
+    count[ key & 0xff ] += ( (key >> 8) == high );
+  }
+  unsigned int low = 0;
+  while( below + count[low] <= k ) below += count[low++];
+
+  return int16_t( uint16_t( (high << 8) | low ) ^ 0x8000 );
+}
   
 #endif
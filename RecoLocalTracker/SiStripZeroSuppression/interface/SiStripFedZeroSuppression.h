@@ -17,6 +17,7 @@ class SiStripThreshold;
 class SiStripFedZeroSuppression {
   
   friend class SiStripRawProcessingFactory;
+  friend class TestSiStripFedZeroSuppression;
   
  public:
   
@@ -76,6 +77,11 @@ class SiStripFedZeroSuppression {
   std::vector<float>     noises_;
   
   void fillThresholds_(const uint32_t detID, size_t size) ;
+
+  // flags the strips of one APV to be kept; the arrays start two strips before the APV
+  template<uint16_t FEDalgorithm>
+  void acceptAPV_(const int16_t* adcs, const int16_t* lowThrs, const int16_t* highThrs,
+		  unsigned int n, bool* accepted) const;
   
 };
 #endif
@@ -41,3 +41,9 @@ percentile( std::vector<T>& sample, double pct) {
   return *mid;
 } 
 
+inline
+float PercentileCMNSubtractor::
+percentile( std::vector<int16_t>& sample, double pct) {
+  return nthElement(sample.data(), sample.size(), int(sample.size()*pct/100.0));
+}
+
@@ -5,6 +5,8 @@
 #include "CondFormats/DataRecord/interface/SiStripThresholdRcd.h"
 #include "CondFormats/SiStripObjects/interface/SiStripThreshold.h"
 
+#include <algorithm>
+
 //#define DEBUG_SiStripZeroSuppression_
 //#define ML_DEBUG 
 using namespace std;
@@ -255,99 +257,107 @@ void SiStripFedZeroSuppression::suppress(const std::vector<int16_t>& in, const u
 
   fillThresholds_(detID, size+firstAPV*128); // want to decouple this from the other cost
 
-
-  std::vector<int16_t>::const_iterator in_iter=in.begin();
-  uint16_t strip = firstAPV*128;
-  for (; strip < size+firstAPV*128; ++strip, ++in_iter){
-
-    size_t strip_mod_128 = strip & 127;
-#ifdef DEBUG_SiStripZeroSuppression_
-    if (edm::isDebugEnabled())
-      LogTrace("SiStripZeroSuppression") << "[SiStripFedZeroSuppression::suppress]  detID= " << detID << " strip= " <<  strip << "  adc= " << *in_iter;
-#endif    
-    adc   = *in_iter;
-
-    theFEDlowThresh  = lowThr_[strip];
-    theFEDhighThresh = highThr_[strip];
-
-    //Find adc values for neighbouring strips
-
-     /*
-      If a strip is the last one on the chip
-      set its next neighbor's thresholds to infinity
-      because the FED does not merge clusters across
-      chip boundaries right now
-    */
-
-    //adcPrev = -9999;  // useless, they are set
-    //adcNext = -9999;  // in the next lines in any case
-    if ( strip_mod_128 == 127 ) {
-      adcNext = 0;      
-      theNextFEDlowThresh  = 9999;
-      theNextFEDhighThresh = 9999;
-    } else {
-      adcNext = *(in_iter+1);
-      theNextFEDlowThresh  = lowThr_[strip+1];
-      theNextFEDhighThresh = highThr_[strip+1];
+  /*
+    The strips are processed one APV at a time: the adc and thresholds of the
+    APV are copied with two strips on each side, set as the FED does not merge
+    clusters across chip boundaries (adc 0, thresholds 9999). The decision for
+    all the strips is then taken in a loop without branches (see IsAValidDigi),
+    and only the selected strips are stored.
+  */
+  int16_t adcs[128+4], lowThrs[128+4], highThrs[128+4];
+  bool accepted[128];
+  adcs[0] = adcs[1] = 0;
+  lowThrs[0] = lowThrs[1] = highThrs[0] = highThrs[1] = 9999;
+
+  for (size_t first = 0; first < size; first += 128) {
+    const uint16_t firstStrip = first+firstAPV*128;
+    const unsigned int n = std::min(size-first, size_t(128));
+    for (unsigned int i = 0; i < n; ++i) {
+      adcs[i+2]     = in[first+i];
+      lowThrs[i+2]  = lowThr_[firstStrip+i];
+      highThrs[i+2] = highThr_[firstStrip+i];
     }
-    
-    /*
-      Similarily, for the first strip 
-      on a chip
-    */
-    if ( strip_mod_128 == 0 ) {
-      adcPrev = 0;
-      thePrevFEDlowThresh  = 9999;
-      thePrevFEDhighThresh = 9999;   
-    } else {
-      adcPrev = *(in_iter-1);
-      thePrevFEDlowThresh  = lowThr_[strip-1];
-      thePrevFEDhighThresh = highThr_[strip-1];
+    for (unsigned int i = n+2; i < n+4; ++i) {
+      adcs[i] = 0;
+      lowThrs[i] = highThrs[i] = 9999;
     }
 
-    if ( adcNext < adcPrev){
-      adcMaxNeigh = adcPrev;
-      theNeighFEDlowThresh  = thePrevFEDlowThresh;
-      theNeighFEDhighThresh = thePrevFEDhighThresh;
-    } else {
-      adcMaxNeigh = adcNext;
-      theNeighFEDlowThresh  = theNextFEDlowThresh;
-      theNeighFEDhighThresh = theNextFEDhighThresh;
+    switch (theFEDalgorithm) {
+    case 1: acceptAPV_<1>(adcs, lowThrs, highThrs, n, accepted); break;
+    case 2: acceptAPV_<2>(adcs, lowThrs, highThrs, n, accepted); break;
+    case 3: acceptAPV_<3>(adcs, lowThrs, highThrs, n, accepted); break;
+    case 4: acceptAPV_<4>(adcs, lowThrs, highThrs, n, accepted); break;
+    case 5: acceptAPV_<5>(adcs, lowThrs, highThrs, n, accepted); break;
+    default: std::fill(accepted, accepted+n, false);
     }
-    
-    //Find adc values for next neighbouring strips
-    //adcPrev2 = -9999;           //
-    //adcNext2 = -9999;           // useless to set them here
-    //thePrev2FEDlowThresh  = 1;  // they are overwritten always in the next 8 lines
-    //theNext2FEDlowThresh  = 1;  //
-    if ( strip_mod_128 >=126 ) {
-      adcNext2 = 0;
-      theNext2FEDlowThresh  = 9999;
-    //} else if ( strip_mod_128 < 126 ) { // if it's not >= then is <, no need to "if" again
-    } else {
-      adcNext2 = *(in_iter+2);
-      theNext2FEDlowThresh  = lowThr_[strip+2];
-    }
-    if ( strip_mod_128 <= 1 ) {
-      adcPrev2 = 0; 
-      thePrev2FEDlowThresh  = 9999;
-    //} else if ( strip_mod_128 > 1 ) { // same as above
-    } else {
-      adcPrev2 = *(in_iter-2);
-      thePrev2FEDlowThresh  = lowThr_[strip-2];;
-    }
-    
-    if (IsAValidDigi()){
+
+    for (unsigned int i = 0; i < n; ++i) {
+      if (accepted[i]) {
+        const int16_t adc = adcs[i+2];
 #ifdef DEBUG_SiStripZeroSuppression_
-      if (edm::isDebugEnabled())
-	LogTrace("SiStripZeroSuppression") << "[SiStripFedZeroSuppression::suppress] DetId " << out.id << " strip " << strip << " adc " << *in_iter << " digiCollection size " << out.data.size() ;
-#endif            
-      //GB 23/6/08: truncation should be done at the very beginning
-      out.push_back(SiStripDigi(strip, (*in_iter<0 ? 0 : truncate( *in_iter ) )));
+	if (edm::isDebugEnabled())
+	  LogTrace("SiStripZeroSuppression") << "[SiStripFedZeroSuppression::suppress] DetId " << out.id << " strip " << firstStrip+i << " adc " << adc << " digiCollection size " << out.data.size() ;
+#endif
+	//GB 23/6/08: truncation should be done at the very beginning
+	out.push_back(SiStripDigi(firstStrip+i, (adc<0 ? 0 : truncate( adc ) )));
+      }
     }
   }
 }
 
+template<uint16_t FEDalgorithm>
+void SiStripFedZeroSuppression::acceptAPV_(const int16_t* adcs, const int16_t* lowThrs, const int16_t* highThrs,
+					   unsigned int n, bool* accepted) const
+{
+  // same decision as IsAValidDigi, with & and | in place of && and ||
+  for (unsigned int i = 0; i < n; ++i) {
+    const int16_t* adc = adcs+i+2;
+    const int16_t* lowThr = lowThrs+i+2;
+    const int16_t* highThr = highThrs+i+2;
+
+    const bool next = !(adc[1] < adc[-1]);
+    const int16_t adcMaxNeigh           = next ? adc[1]     : adc[-1];
+    const int16_t theNeighFEDlowThresh  = next ? lowThr[1]  : lowThr[-1];
+    const int16_t theNeighFEDhighThresh = next ? highThr[1] : highThr[-1];
+
+    const bool high = adc[0] >= highThr[0];
+    const bool low  = adc[0] >= lowThr[0];
+    switch (FEDalgorithm) {
+    case 1:
+      accepted[i] = low;
+      break;
+    case 2:
+      accepted[i] = high | (low & (adcMaxNeigh >= theNeighFEDlowThresh));
+      break;
+    case 3:
+      accepted[i] = high | (low & (adcMaxNeigh >= theNeighFEDhighThresh));
+      break;
+    case 4:
+      {
+	const bool prevHigh = adc[-1] >= highThr[-1], prevLow = adc[-1] >= lowThr[-1];
+	const bool nextHigh = adc[1]  >= highThr[1],  nextLow = adc[1]  >= lowThr[1];
+	const bool prev2Low = adc[-2] >= lowThr[-2],  next2Low = adc[2] >= lowThr[2];
+	const bool belowLow = adc[0] < lowThr[0];
+	accepted[i] = high | (low & (adcMaxNeigh >= theNeighFEDlowThresh)) |
+	  (belowLow & ( (prevHigh & nextHigh) |
+		    (prevHigh & nextLow & next2Low) |
+		    (nextHigh & prevLow & prev2Low) |
+		    (nextLow & next2Low & prevLow & prev2Low) ));
+      }
+      break;
+    case 5:
+      accepted[i] = adc[0] > 0;
+      break;
+    }
+  }
+}
+
+template void SiStripFedZeroSuppression::acceptAPV_<1>(const int16_t*, const int16_t*, const int16_t*, unsigned int, bool*) const;
+template void SiStripFedZeroSuppression::acceptAPV_<2>(const int16_t*, const int16_t*, const int16_t*, unsigned int, bool*) const;
+template void SiStripFedZeroSuppression::acceptAPV_<3>(const int16_t*, const int16_t*, const int16_t*, unsigned int, bool*) const;
+template void SiStripFedZeroSuppression::acceptAPV_<4>(const int16_t*, const int16_t*, const int16_t*, unsigned int, bool*) const;
+template void SiStripFedZeroSuppression::acceptAPV_<5>(const int16_t*, const int16_t*, const int16_t*, unsigned int, bool*) const;
+
 
 bool SiStripFedZeroSuppression::IsAValidDigi()
 {
@@ -3,6 +3,9 @@
 #include "CondFormats/DataRecord/interface/SiStripPedestalsRcd.h"
 #include "FWCore/Utilities/interface/Exception.h"
 
+#include <algorithm>
+#include <limits>
+
 void SiStripPedestalsSubtractor::init(const edm::EventSetup& es){
   uint32_t p_cache_id = es.get<SiStripPedestalsRcd>().cacheIdentifier();
   if(p_cache_id != peds_cache_id) {
@@ -24,22 +27,16 @@ subtract_(const uint32_t& id, const uint16_t& firstStrip, const input_t& input,
     SiStripPedestals::Range pedestalsRange = pedestalsHandle->getRange(id);
     pedestalsHandle->allPeds(pedestals, pedestalsRange);
 
+    // branch-free, so that the loop is vectorized
     typename input_t::const_iterator inDigi = input.begin();
-    std::vector<int>::const_iterator ped = pedestals.begin() + firstStrip;  
-    std::vector<int16_t>::iterator   outDigi = output.begin();
-
-    while( inDigi != input.end() ) {
-      
-      *outDigi = ( *ped > 895 )        
-	? eval(*inDigi) - *ped + 1024
-	: eval(*inDigi) - *ped;
-      
-      if(fedmode_ && *outDigi < 0) //FED bottoms out at 0
-	*outDigi=0;
-      
-      ++inDigi; 
-      ++ped; 
-      ++outDigi;
+    const int* ped = &pedestals[firstStrip];
+    int16_t* outDigi = output.data();
+    const int16_t floor = fedmode_ ? 0 : std::numeric_limits<int16_t>::min(); //FED bottoms out at 0
+    const unsigned int size = input.size();
+
+    for( unsigned int i = 0; i < size; ++i ) {
+      const int16_t digi = eval(inDigi[i]) - ped[i] + ( ped[i] > 895 ? 1024 : 0 );
+      outDigi[i] = std::max(digi, floor);
     }
 
 
@@ -0,0 +1,69 @@
+/*
+ *  SiStripCommonModeNoiseSubtractor_t.cppunit.cc
+ */
+
+#include "cppunit/extensions/HelperMacros.h"
+
+#include "RecoLocalTracker/SiStripZeroSuppression/interface/SiStripCommonModeNoiseSubtractor.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+class TestSiStripCommonModeNoiseSubtractor : public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(TestSiStripCommonModeNoiseSubtractor);
+  CPPUNIT_TEST(testNthElement);
+  CPPUNIT_TEST(testNthElementLimits);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void setUp() {}
+  void tearDown() {}
+
+  void testNthElement();
+  void testNthElementLimits();
+
+private:
+  // every k of the sample, against std::nth_element
+  static void checkAllK(const std::vector<int16_t>& sample);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestSiStripCommonModeNoiseSubtractor);
+
+void TestSiStripCommonModeNoiseSubtractor::checkAllK(const std::vector<int16_t>& sample) {
+  for (unsigned int k = 0; k < sample.size(); ++k) {
+    std::vector<int16_t> sorted(sample);
+    std::nth_element(sorted.begin(), sorted.begin() + k, sorted.end());
+    CPPUNIT_ASSERT_EQUAL(sorted[k], SiStripCommonModeNoiseSubtractor::nthElement(sample.data(), sample.size(), k));
+  }
+}
+
+void TestSiStripCommonModeNoiseSubtractor::testNthElement() {
+  std::mt19937 rng(12345);
+  // odd and even sizes, with the 128 strips of an APV
+  for (unsigned int size : {1, 2, 3, 127, 128, 129, 256}) {
+    // values around the common mode, negative ones included
+    std::uniform_int_distribution<int> wide(-300, 300);
+    // few distinct values, so many duplicates
+    std::uniform_int_distribution<int> narrow(-2, 2);
+    // values differing in the low byte only, and in the high byte only
+    std::uniform_int_distribution<int> lowByte(0, 255), highByte(-128, 127);
+    std::vector<int16_t> sample(size);
+    for (int trial = 0; trial < 10; ++trial) {
+      for (auto& s : sample) s = wide(rng);
+      checkAllK(sample);
+      for (auto& s : sample) s = narrow(rng);
+      checkAllK(sample);
+      for (auto& s : sample) s = lowByte(rng);
+      checkAllK(sample);
+      for (auto& s : sample) s = highByte(rng) * 256;
+      checkAllK(sample);
+    }
+  }
+}
+
+void TestSiStripCommonModeNoiseSubtractor::testNthElementLimits() {
+  checkAllK({0, -1, 1, 255, 256, -255, -256, 32767, -32768, -32767, 32766});
+  checkAllK({-32768, -32768, -32768, 32767, 32767});
+  checkAllK(std::vector<int16_t>(128, -7));
+}
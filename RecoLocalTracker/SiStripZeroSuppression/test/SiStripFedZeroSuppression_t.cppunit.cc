@@ -0,0 +1,148 @@
+/*
+ *  SiStripFedZeroSuppression_t.cppunit.cc
+ */
+
+#include "cppunit/extensions/HelperMacros.h"
+
+#include "RecoLocalTracker/SiStripZeroSuppression/interface/SiStripFedZeroSuppression.h"
+
+#include <random>
+#include <string>
+#include <vector>
+
+class TestSiStripFedZeroSuppression : public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(TestSiStripFedZeroSuppression);
+  CPPUNIT_TEST(testAcceptAPV);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void setUp() {}
+  void tearDown() {}
+
+  void testAcceptAPV();
+
+private:
+  static constexpr unsigned int nStrips = 3*128;
+
+  // the decision of IsAValidDigi for each strip, with the neighbours set as in
+  // SiStripFedZeroSuppression::suppress(const edm::DetSet<SiStripRawDigi>&, ...)
+  static std::vector<bool> perStrip(SiStripFedZeroSuppression& zs, const std::vector<int16_t>& adcs,
+                                    const std::vector<int16_t>& lowThrs, const std::vector<int16_t>& highThrs);
+
+  // the decision of acceptAPV_, with the arrays padded as in
+  // SiStripFedZeroSuppression::suppress(const std::vector<int16_t>&, ...)
+  static std::vector<bool> perAPV(SiStripFedZeroSuppression& zs, uint16_t algorithm, const std::vector<int16_t>& adcs,
+                                  const std::vector<int16_t>& lowThrs, const std::vector<int16_t>& highThrs);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestSiStripFedZeroSuppression);
+
+std::vector<bool> TestSiStripFedZeroSuppression::perStrip(SiStripFedZeroSuppression& zs, const std::vector<int16_t>& adcs,
+                                                         const std::vector<int16_t>& lowThrs, const std::vector<int16_t>& highThrs) {
+  std::vector<bool> accepted(adcs.size());
+  for (unsigned int strip = 0; strip < adcs.size(); ++strip) {
+    zs.adc = adcs[strip];
+    zs.theFEDlowThresh = lowThrs[strip];
+    zs.theFEDhighThresh = highThrs[strip];
+
+    if (strip%128 == 127) {
+      zs.adcNext = 0;
+      zs.theNextFEDlowThresh = 9999;
+      zs.theNextFEDhighThresh = 9999;
+    } else {
+      zs.adcNext = adcs[strip+1];
+      zs.theNextFEDlowThresh = lowThrs[strip+1];
+      zs.theNextFEDhighThresh = highThrs[strip+1];
+    }
+    if (strip%128 == 0) {
+      zs.adcPrev = 0;
+      zs.thePrevFEDlowThresh = 9999;
+      zs.thePrevFEDhighThresh = 9999;
+    } else {
+      zs.adcPrev = adcs[strip-1];
+      zs.thePrevFEDlowThresh = lowThrs[strip-1];
+      zs.thePrevFEDhighThresh = highThrs[strip-1];
+    }
+    if (zs.adcNext < zs.adcPrev) {
+      zs.adcMaxNeigh = zs.adcPrev;
+      zs.theNeighFEDlowThresh = zs.thePrevFEDlowThresh;
+      zs.theNeighFEDhighThresh = zs.thePrevFEDhighThresh;
+    } else {
+      zs.adcMaxNeigh = zs.adcNext;
+      zs.theNeighFEDlowThresh = zs.theNextFEDlowThresh;
+      zs.theNeighFEDhighThresh = zs.theNextFEDhighThresh;
+    }
+    if (strip%128 >= 126) {
+      zs.adcNext2 = 0;
+      zs.theNext2FEDlowThresh = 9999;
+    } else {
+      zs.adcNext2 = adcs[strip+2];
+      zs.theNext2FEDlowThresh = lowThrs[strip+2];
+    }
+    if (strip%128 <= 1) {
+      zs.adcPrev2 = 0;
+      zs.thePrev2FEDlowThresh = 9999;
+    } else {
+      zs.adcPrev2 = adcs[strip-2];
+      zs.thePrev2FEDlowThresh = lowThrs[strip-2];
+    }
+    accepted[strip] = zs.IsAValidDigi();
+  }
+  return accepted;
+}
+
+std::vector<bool> TestSiStripFedZeroSuppression::perAPV(SiStripFedZeroSuppression& zs, uint16_t algorithm, const std::vector<int16_t>& adcs,
+                                                       const std::vector<int16_t>& lowThrs, const std::vector<int16_t>& highThrs) {
+  std::vector<bool> accepted;
+  int16_t a[128+4], l[128+4], h[128+4];
+  bool flags[128];
+  for (unsigned int first = 0; first < adcs.size(); first += 128) {
+    a[0] = a[1] = a[128+2] = a[128+3] = 0;
+    l[0] = l[1] = l[128+2] = l[128+3] = 9999;
+    h[0] = h[1] = h[128+2] = h[128+3] = 9999;
+    for (unsigned int i = 0; i < 128; ++i) {
+      a[i+2] = adcs[first+i];
+      l[i+2] = lowThrs[first+i];
+      h[i+2] = highThrs[first+i];
+    }
+    switch (algorithm) {
+    case 1: zs.acceptAPV_<1>(a, l, h, 128, flags); break;
+    case 2: zs.acceptAPV_<2>(a, l, h, 128, flags); break;
+    case 3: zs.acceptAPV_<3>(a, l, h, 128, flags); break;
+    case 4: zs.acceptAPV_<4>(a, l, h, 128, flags); break;
+    case 5: zs.acceptAPV_<5>(a, l, h, 128, flags); break;
+    }
+    accepted.insert(accepted.end(), flags, flags+128);
+  }
+  return accepted;
+}
+
+void TestSiStripFedZeroSuppression::testAcceptAPV() {
+  std::mt19937 rng(4321);
+  // adc after the common mode subtraction, negative ones included, around
+  // thresholds of a few adc counts, so that all the branches are taken
+  std::uniform_int_distribution<int> adcDist(-5, 20), lowDist(1, 6), highDist(0, 8);
+  std::vector<int16_t> adcs(nStrips), lowThrs(nStrips), highThrs(nStrips);
+
+  for (uint16_t algorithm = 1; algorithm <= 5; ++algorithm) {
+    SiStripFedZeroSuppression zs(algorithm);
+    for (int trial = 0; trial < 200; ++trial) {
+      for (unsigned int i = 0; i < nStrips; ++i) {
+        adcs[i] = adcDist(rng);
+        lowThrs[i] = lowDist(rng);
+        highThrs[i] = lowThrs[i] + highDist(rng);
+      }
+      // signals on both sides of the APV boundaries
+      for (unsigned int boundary = 128; boundary < nStrips; boundary += 128)
+        for (unsigned int i = boundary-2; i < boundary+2; ++i)
+          if (trial%2) adcs[i] = 30;
+
+      std::vector<bool> reference = perStrip(zs, adcs, lowThrs, highThrs);
+      std::vector<bool> batch = perAPV(zs, algorithm, adcs, lowThrs, highThrs);
+      for (unsigned int i = 0; i < nStrips; ++i) {
+        CPPUNIT_ASSERT_MESSAGE("algorithm " + std::to_string(algorithm) + " strip " + std::to_string(i),
+                               reference[i] == batch[i]);
+      }
+    }
+  }
+}
@@ -29,6 +29,9 @@ class PFCPositionCalculatorBase {
   // here you call a loop inside to transform the whole vector
   virtual void calculateAndSetPositions(reco::PFClusterCollection&) = 0;
 
+  // true if the positions of different clusters can be computed concurrently
+  virtual bool isThreadSafe() const { return false; }
+
   const std::string& name() const { return _algoName; }
   
  protected:  
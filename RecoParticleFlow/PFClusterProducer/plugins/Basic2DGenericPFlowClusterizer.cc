@@ -7,6 +7,9 @@
 
 #include "vdt/vdtMath.h"
 
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+
 #include <iterator>
 
 #ifdef PFLOW_DEBUG
@@ -75,40 +78,75 @@ Basic2DGenericPFlowClusterizer(const edm::ParameterSet& conf) :
       PFCPositionCalculatorFactory::get()->create(algoconv, convConf);
     _convergencePosCalc.reset(convcalc);
   }
+  // the topo clusters are independent, they can be processed in parallel
+  // as long as all the position calculators are stateless
+  // (the optional parallelTopos = False forces the serial loop)
+  _parallelTopos = 
+    ( !conf.exists("parallelTopos") || conf.getParameter<bool>("parallelTopos") ) &&
+    ( !_positionCalc || _positionCalc->isThreadSafe() ) &&
+    ( !_allCellsPosCalc || _allCellsPosCalc->isThreadSafe() ) &&
+    ( !_convergencePosCalc || _convergencePosCalc->isThreadSafe() );
 }
 
 void Basic2DGenericPFlowClusterizer::
 buildClusters(const reco::PFClusterCollection& input,
 	      const std::vector<bool>& seedable,
 	      reco::PFClusterCollection& output) {
-  reco::PFClusterCollection clustersInTopo;
-  for( const auto& topocluster : input ) {
-    clustersInTopo.clear();
-    seedPFClustersFromTopo(topocluster,seedable,clustersInTopo);
-    const unsigned tolScal = 
-      std::pow(std::max(1.0,clustersInTopo.size()-1.0),2.0);
-    growPFClusters(topocluster,seedable,tolScal,0,tolScal,clustersInTopo);
-    // step added by Josh Bendavid, removes low-fraction clusters
-    // did not impact position resolution with fraction cut of 1e-7
-    // decreases the size of each pf cluster considerably
-    prunePFClusters(clustersInTopo);
-    // recalculate the positions of the pruned clusters
-    if( _convergencePosCalc ) { 
-      // if defined, use the special position calculation for convergence tests
-      _convergencePosCalc->calculateAndSetPositions(clustersInTopo);
-    } else {
-      if( clustersInTopo.size() == 1 && _allCellsPosCalc ) {
-	_allCellsPosCalc->calculateAndSetPosition(clustersInTopo.back());
-      } else {
-	_positionCalc->calculateAndSetPositions(clustersInTopo);
-      }   
+  if( !_parallelTopos ) {
+    Scratch scratch;
+    for( const auto& topocluster : input ) {
+      clusterTopo(topocluster,seedable,scratch,output);
     }
-    for( auto& clusterout : clustersInTopo ) {
+    return;
+  }
+  // each topo cluster is clustered into its own collection, the collections
+  // are then appended in the order of the topo clusters
+  std::vector<reco::PFClusterCollection> outputs(input.size());
+  tbb::parallel_for(tbb::blocked_range<unsigned>(0,input.size()),
+		    [&](const tbb::blocked_range<unsigned>& r) {
+		      Scratch scratch;
+		      for( unsigned i = r.begin(); i < r.end(); ++i ) {
+			clusterTopo(input[i],seedable,scratch,outputs[i]);
+		      }
+		    });
+  for( auto& clusters : outputs ) {
+    for( auto& clusterout : clusters ) {
       output.insert(output.end(),std::move(clusterout));
     }
   }
 }
 
+void Basic2DGenericPFlowClusterizer::
+clusterTopo(const reco::PFCluster& topocluster,
+	    const std::vector<bool>& seedable,
+	    Scratch& scratch,
+	    reco::PFClusterCollection& output) const {
+  reco::PFClusterCollection& clustersInTopo = scratch.clusters;
+  clustersInTopo.clear();
+  seedPFClustersFromTopo(topocluster,seedable,clustersInTopo);
+  const unsigned tolScal = 
+    std::pow(std::max(1.0,clustersInTopo.size()-1.0),2.0);
+  growPFClusters(topocluster,seedable,tolScal,0,tolScal,scratch);
+  // step added by Josh Bendavid, removes low-fraction clusters
+  // did not impact position resolution with fraction cut of 1e-7
+  // decreases the size of each pf cluster considerably
+  prunePFClusters(clustersInTopo);
+  // recalculate the positions of the pruned clusters
+  if( _convergencePosCalc ) { 
+    // if defined, use the special position calculation for convergence tests
+    _convergencePosCalc->calculateAndSetPositions(clustersInTopo);
+  } else {
+    if( clustersInTopo.size() == 1 && _allCellsPosCalc ) {
+      _allCellsPosCalc->calculateAndSetPosition(clustersInTopo.back());
+    } else {
+      _positionCalc->calculateAndSetPositions(clustersInTopo);
+    }   
+  }
+  for( auto& clusterout : clustersInTopo ) {
+    output.insert(output.end(),std::move(clusterout));
+  }
+}
+
 void Basic2DGenericPFlowClusterizer::
 seedPFClustersFromTopo(const reco::PFCluster& topo,
 		       const std::vector<bool>& seedable,
@@ -134,7 +172,7 @@ growPFClusters(const reco::PFCluster& topo,
 	       const unsigned toleranceScaling,
 	       const unsigned iter,
 	       double diff,
-	       reco::PFClusterCollection& clusters) const {
+	       Scratch& scratch) const {
   if( iter >= _maxIterations ) {
     LOGDRESSED("Basic2DGenericPFlowClusterizer:growAndStabilizePFClusters")
       <<"reached " << _maxIterations << " iterations, terminated position "
@@ -142,8 +180,11 @@ growPFClusters(const reco::PFCluster& topo,
   }      
   if( iter >= _maxIterations || 
       diff <= _stoppingTolerance*toleranceScaling) return;
+  reco::PFClusterCollection& clusters = scratch.clusters;
+  const unsigned nclusters = clusters.size();
   // reset the rechits in this cluster, keeping the previous position    
-  std::vector<reco::PFCluster::REPPoint> clus_prev_pos;  
+  std::vector<reco::PFCluster::REPPoint>& clus_prev_pos = scratch.prevPos;
+  clus_prev_pos.clear();
   for( auto& cluster : clusters) {
     const reco::PFCluster::REPPoint& repp = cluster.positionREP();
     clus_prev_pos.emplace_back(repp.rho(),repp.eta(),repp.phi());
@@ -156,9 +197,30 @@ growPFClusters(const reco::PFCluster& topo,
     }
     cluster.resetHitsAndFractions();
   }
+  // the cluster positions and energies do not change while growing,
+  // copy them in contiguous arrays for the fraction computation
+  scratch.x.resize(nclusters); scratch.y.resize(nclusters); 
+  scratch.z.resize(nclusters); scratch.energy.resize(nclusters);
+  scratch.seeds.resize(nclusters);
+  for( unsigned i = 0; i < nclusters; ++i ) {
+    const math::XYZPoint& clusterpos_xyz = clusters[i].position();
+    scratch.x[i] = clusterpos_xyz.x();
+    scratch.y[i] = clusterpos_xyz.y();
+    scratch.z[i] = clusterpos_xyz.z();
+    scratch.energy[i] = clusters[i].energy();
+    scratch.seeds[i] = clusters[i].seed();
+  }
+  const double* __restrict__ clusx = scratch.x.data();
+  const double* __restrict__ clusy = scratch.y.data();
+  const double* __restrict__ clusz = scratch.z.data();
+  const double* __restrict__ clusenergy = scratch.energy.data();
   // loop over topo cluster and grow current PFCluster hypothesis 
-  std::vector<double> dist2, frac;
-  double fractot = 0, fraction = 0;
+  std::vector<double>& dist2 = scratch.dist2;
+  std::vector<double>& frac = scratch.frac;
+  dist2.resize(nclusters); frac.resize(nclusters);
+  double* __restrict__ d2s = dist2.data();
+  double* __restrict__ fracs = frac.data();
+  double fractot = 0;
   for( const reco::PFRecHitFraction& rhf : topo.recHitFractions() ) {
     const reco::PFRecHitRef& refhit = rhf.recHitRef();
     int cell_layer = (int)refhit->layer();
@@ -168,35 +230,43 @@ growPFClusters(const reco::PFCluster& topo,
     }  
     const double recHitEnergyNorm = 
       _recHitEnergyNorms.find(cell_layer)->second; 
-    math::XYZPoint topocellpos_xyz(refhit->position());
-    dist2.clear(); frac.clear(); fractot = 0;
+    const math::XYZPoint& topocellpos_xyz(refhit->position());
+    const double cellx = topocellpos_xyz.x();
+    const double celly = topocellpos_xyz.y();
+    const double cellz = topocellpos_xyz.z();
     // add rechits to clusters, calculating fraction based on distance
-    for( auto& cluster : clusters ) {      
-      const math::XYZPoint& clusterpos_xyz = cluster.position();
-      fraction = 0.0;
-      const math::XYZVector deltav = clusterpos_xyz - topocellpos_xyz;
-      const double d2 = deltav.Mag2()/_showerSigma2;
-      dist2.emplace_back( d2 );
-      if( d2 > 100 ) {
+    for( unsigned i = 0; i < nclusters; ++i ) {
+      const double dx = clusx[i] - cellx;
+      const double dy = clusy[i] - celly;
+      const double dz = clusz[i] - cellz;
+      const double d2 = (dx*dx + dy*dy + dz*dz)/_showerSigma2;
+      d2s[i] = d2;
+      fracs[i] = clusenergy[i]/recHitEnergyNorm * vdt::fast_expf( -0.5*d2 );
+    }
+    // fraction assignment logic
+    if( _excludeOtherSeeds ) {
+      const bool isSeedable = seedable[refhit.key()];
+      for( unsigned i = 0; i < nclusters; ++i ) {
+	if( refhit->detId() == scratch.seeds[i] ) {
+	  fracs[i] = 1.0;
+	} else if( isSeedable ) {
+	  fracs[i] = 0.0;
+	}
+      }
+    }
+    fractot = 0;
+    for( unsigned i = 0; i < nclusters; ++i ) {
+      if( d2s[i] > 100 ) {
 	LOGDRESSED("Basic2DGenericPFlowClusterizer:growAndStabilizePFClusters")
 	  << "Warning! :: pfcluster-topocell distance is too large! d= "
-	  << d2;
+	  << d2s[i];
       }
-      // fraction assignment logic
-      if( refhit->detId() == cluster.seed() && _excludeOtherSeeds ) {
-	fraction = 1.0;	
-      } else if ( seedable[refhit.key()] && _excludeOtherSeeds ) {
-	fraction = 0.0;
-      } else {
-	fraction = cluster.energy()/recHitEnergyNorm * vdt::fast_expf( -0.5*d2 );
-      }      
-      fractot += fraction;
-      frac.emplace_back(fraction);
+      fractot += fracs[i];
     }
-    for( unsigned i = 0; i < clusters.size(); ++i ) {      
+    for( unsigned i = 0; i < nclusters; ++i ) {      
       if( fractot > _minFracTot || 
-	  ( refhit->detId() == clusters[i].seed() && fractot > 0.0 ) ) {
-	frac[i]/=fractot;
+	  ( refhit->detId() == scratch.seeds[i] && fractot > 0.0 ) ) {
+	fracs[i]/=fractot;
       } else {
 	continue;
       }
@@ -211,14 +281,14 @@ growPFClusters(const reco::PFCluster& topo,
       // (about 1% of the clusters) need to be studied, as 
       // they create fake photons, in general.
       // (PJ, 16/09/08) 
-      if( dist2[i] < 100.0 || frac[i] > 0.9999 ) {	
-	clusters[i].addRecHitFraction(reco::PFRecHitFraction(refhit,frac[i]));
+      if( d2s[i] < 100.0 || fracs[i] > 0.9999 ) {	
+	clusters[i].addRecHitFraction(reco::PFRecHitFraction(refhit,fracs[i]));
       }
     }
   }
   // recalculate positions and calculate convergence parameter
   double diff2 = 0.0;  
-  for( unsigned i = 0; i < clusters.size(); ++i ) {
+  for( unsigned i = 0; i < nclusters; ++i ) {
     if( _convergencePosCalc ) {
       _convergencePosCalc->calculateAndSetPosition(clusters[i]);
     } else {
@@ -233,8 +303,7 @@ growPFClusters(const reco::PFCluster& topo,
     if( delta2 > diff2 ) diff2 = delta2;
   }
   diff = std::sqrt(diff2);
-  dist2.clear(); frac.clear(); clus_prev_pos.clear();// avoid badness
-  growPFClusters(topo,seedable,toleranceScaling,iter+1,diff,clusters);
+  growPFClusters(topo,seedable,toleranceScaling,iter+1,diff,scratch);
 }
 
 void Basic2DGenericPFlowClusterizer::
@@ -5,6 +5,7 @@
 #include "DataFormats/ParticleFlowReco/interface/PFRecHitFraction.h"
 
 #include <unordered_map>
+#include <vector>
 
 class Basic2DGenericPFlowClusterizer : public PFClusterBuilderBase {
   typedef Basic2DGenericPFlowClusterizer B2DGPF;
@@ -35,7 +36,24 @@ class Basic2DGenericPFlowClusterizer : public PFClusterBuilderBase {
   std::unordered_map<int,double> _recHitEnergyNorms;
   std::unique_ptr<PFCPositionCalculatorBase> _allCellsPosCalc;
   std::unique_ptr<PFCPositionCalculatorBase> _convergencePosCalc;
-  
+  // true if the topo clusters can be clustered concurrently
+  bool _parallelTopos;
+
+  // working space of the clustering of one topo cluster, one per task
+  struct Scratch {
+    reco::PFClusterCollection clusters;
+    std::vector<reco::PFCluster::REPPoint> prevPos;
+    // positions, energies and seeds of the clusters, as contiguous arrays
+    std::vector<double> x, y, z, energy;
+    std::vector<DetId> seeds;
+    std::vector<double> dist2, frac;
+  };
+
+  void clusterTopo(const reco::PFCluster&,
+		   const std::vector<bool>&,
+		   Scratch&,
+		   reco::PFClusterCollection&) const;
+
   void seedPFClustersFromTopo(const reco::PFCluster&,
 			      const std::vector<bool>&,
 			      reco::PFClusterCollection&) const;
@@ -45,7 +63,7 @@ class Basic2DGenericPFlowClusterizer : public PFClusterBuilderBase {
 		      const unsigned toleranceScaling,
 		      const unsigned iter,
 		      double dist,
-		      reco::PFClusterCollection&) const;
+		      Scratch&) const;
   
   void prunePFClusters(reco::PFClusterCollection&) const;
 };
@@ -50,6 +50,8 @@ class Basic2DGenericPFlowPositionCalc : public PFCPositionCalculatorBase {
   void calculateAndSetPosition(reco::PFCluster&);
   void calculateAndSetPositions(reco::PFClusterCollection&);
 
+  bool isThreadSafe() const { return true; }
+
  private:
   const int _posCalcNCrystals;
   const float _logWeightDenom;
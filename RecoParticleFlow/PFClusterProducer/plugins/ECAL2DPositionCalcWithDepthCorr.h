@@ -44,6 +44,8 @@ class ECAL2DPositionCalcWithDepthCorr : public PFCPositionCalculatorBase {
   void calculateAndSetPosition(reco::PFCluster&);
   void calculateAndSetPositions(reco::PFClusterCollection&);
 
+  bool isThreadSafe() const { return true; }
+
  private:  
   const double _param_T0_EB;
   const double _param_T0_EE;
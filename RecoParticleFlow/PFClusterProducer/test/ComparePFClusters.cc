@@ -0,0 +1,64 @@
+// File: ComparePFClusters.cc
+// Description: check that two collections of PFClusters are the same,
+// cluster by cluster and in the same order: seed, layer, energies, time,
+// position and rechit fractions, bit for bit.
+// Throws at the first difference.
+//--------------------------------------------
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/Utilities/interface/InputTag.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+
+#include "DataFormats/ParticleFlowReco/interface/PFCluster.h"
+#include "DataFormats/ParticleFlowReco/interface/PFClusterFwd.h"
+
+class ComparePFClusters : public edm::global::EDAnalyzer<> {
+public:
+  explicit ComparePFClusters(const edm::ParameterSet& conf) :
+    refToken_(consumes<reco::PFClusterCollection>(conf.getParameter<edm::InputTag>("reference"))),
+    testToken_(consumes<reco::PFClusterCollection>(conf.getParameter<edm::InputTag>("test"))) {}
+
+  void analyze(edm::StreamID, const edm::Event& ev, const edm::EventSetup&) const override;
+
+private:
+  const edm::EDGetTokenT<reco::PFClusterCollection> refToken_;
+  const edm::EDGetTokenT<reco::PFClusterCollection> testToken_;
+};
+
+void ComparePFClusters::analyze(edm::StreamID, const edm::Event& ev, const edm::EventSetup&) const {
+  edm::Handle<reco::PFClusterCollection> ref, test;
+  ev.getByToken(refToken_, ref);
+  ev.getByToken(testToken_, test);
+
+  if (ref->size() != test->size())
+    throw cms::Exception("ComparePFClusters") << "different number of clusters: " << ref->size() << ' ' << test->size();
+  unsigned int nFractions = 0;
+  for (unsigned int i = 0; i < ref->size(); ++i) {
+    const reco::PFCluster& a = (*ref)[i];
+    const reco::PFCluster& b = (*test)[i];
+    if (a.seed() != b.seed() || a.layer() != b.layer())
+      throw cms::Exception("ComparePFClusters") << "different seeds for cluster " << i << ": "
+						<< a.seed().rawId() << ' ' << b.seed().rawId();
+    if (a.energy() != b.energy() || a.correctedEnergy() != b.correctedEnergy() || a.time() != b.time())
+      throw cms::Exception("ComparePFClusters") << "different energies for cluster " << i << ": "
+						<< a.energy() << ' ' << b.energy();
+    if (a.position() != b.position())
+      throw cms::Exception("ComparePFClusters") << "different positions for cluster " << i;
+    const auto& fa = a.recHitFractions();
+    const auto& fb = b.recHitFractions();
+    if (fa.size() != fb.size())
+      throw cms::Exception("ComparePFClusters") << "different number of rechits in cluster " << i;
+    for (unsigned int j = 0; j < fa.size(); ++j) {
+      if (fa[j].recHitRef().key() != fb[j].recHitRef().key() || fa[j].fraction() != fb[j].fraction())
+	throw cms::Exception("ComparePFClusters") << "different rechit fraction " << j << " in cluster " << i;
+    }
+    nFractions += fa.size();
+  }
+
+  LogDebug("ComparePFClusters") << ref->size() << " clusters, " << nFractions << " rechit fractions";
+}
+
+DEFINE_FWK_MODULE(ComparePFClusters);
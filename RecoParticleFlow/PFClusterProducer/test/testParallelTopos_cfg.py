@@ -0,0 +1,63 @@
+# check that Basic2DGenericPFlowClusterizer gives the same ECAL and HBHE
+# PFClusters when the topo clusters are clustered in parallel and in the
+# serial loop (ComparePFClusters throws at the first difference)
+#
+#   cmsRun testParallelTopos_cfg.py inputFiles=file:step3.root globalTag=<GT of step3>
+##############################################################################
+
+import FWCore.ParameterSet.Config as cms
+from FWCore.ParameterSet.VarParsing import VarParsing
+
+options = VarParsing('analysis')
+options.register('globalTag', '', VarParsing.multiplicity.singleton, VarParsing.varType.string,
+                 "global tag used to make the input")
+options.parseArguments()
+
+process = cms.Process("ParallelToposTest")
+
+process.load("FWCore.MessageLogger.MessageLogger_cfi")
+process.load("Configuration.StandardSequences.GeometryRecoDB_cff")
+process.load("Configuration.StandardSequences.MagneticField_cff")
+process.load("Configuration.StandardSequences.FrontierConditions_GlobalTag_cff")
+process.load("Configuration.StandardSequences.Services_cff")
+
+process.load("RecoParticleFlow.PFClusterProducer.particleFlowRecHitECAL_cfi")
+process.load("RecoParticleFlow.PFClusterProducer.particleFlowRecHitHBHE_cfi")
+process.load("RecoParticleFlow.PFClusterProducer.particleFlowClusterECALUncorrected_cfi")
+process.load("RecoParticleFlow.PFClusterProducer.particleFlowClusterHBHE_cfi")
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(options.maxEvents)
+)
+
+# several threads, so that the topo clusters are clustered concurrently
+process.options = cms.untracked.PSet(
+    numberOfThreads = cms.untracked.uint32(4),
+    numberOfStreams = cms.untracked.uint32(0)
+)
+
+process.source = cms.Source("PoolSource",
+  fileNames = cms.untracked.vstring(options.inputFiles)
+)
+
+process.GlobalTag.globaltag = options.globalTag
+
+# reference: the serial loop over the topo clusters
+process.particleFlowClusterECALSerial = process.particleFlowClusterECALUncorrected.clone()
+process.particleFlowClusterECALSerial.pfClusterBuilder.parallelTopos = cms.bool(False)
+process.particleFlowClusterHBHESerial = process.particleFlowClusterHBHE.clone()
+process.particleFlowClusterHBHESerial.pfClusterBuilder.parallelTopos = cms.bool(False)
+
+process.compareECAL = cms.EDAnalyzer("ComparePFClusters",
+    reference = cms.InputTag("particleFlowClusterECALSerial"),
+    test = cms.InputTag("particleFlowClusterECALUncorrected")
+)
+process.compareHBHE = cms.EDAnalyzer("ComparePFClusters",
+    reference = cms.InputTag("particleFlowClusterHBHESerial"),
+    test = cms.InputTag("particleFlowClusterHBHE")
+)
+
+process.p = cms.Path(process.particleFlowRecHitECAL*process.particleFlowRecHitHBHE
+                     *process.particleFlowClusterECALUncorrected*process.particleFlowClusterECALSerial
+                     *process.particleFlowClusterHBHE*process.particleFlowClusterHBHESerial
+                     *process.compareECAL*process.compareHBHE)
@@ -29,6 +29,12 @@ class KDTreeLinkerBase
     return _fieldType; 
   }
 
+  // Type of the elements whose PFmultilinks are filled by updatePFBlockEltWithLinks().
+  // Linkers updating different element types can be processed concurrently.
+  virtual reco::PFBlockElement::Type linkedType() const {
+    return _targetType;
+  }
+
   // Get/Set of the maximal size of the cristal (ECAL, HCAL,...) in phi/eta and
   // X/Y. By default, thus value are set for the ECAL cristal.
   void setCristalPhiEtaMaxSize(float size);
@@ -44,6 +50,9 @@ class KDTreeLinkerBase
   // Debug flag. 
   void setDebug(bool isDebug);
 
+  // Use a uniform grid instead of a KDTree as spatial index.
+  void setUseGrid(bool useGrid);
+
   // With this method, we create the list of elements that we want to link.
   virtual void insertTargetElt(reco::PFBlockElement		*target) = 0;
 
@@ -86,6 +95,9 @@ class KDTreeLinkerBase
 
   // Debug boolean. Not used until now.
   bool			debug_;
+
+  // Grid index flag, passed to the KDTreeLinkerIndex of the derived classes by buildTree().
+  bool			useGrid_;
 };
 
 
@@ -0,0 +1,77 @@
+#ifndef KDTreeLinkerGridAlgo_h
+#define KDTreeLinkerGridAlgo_h
+
+#include "RecoParticleFlow/PFProducer/interface/KDTreeLinkerTools.h"
+#include "RecoParticleFlow/PFProducer/interface/KDTreeLinkerAlgo.h"
+
+#include <vector>
+
+// Class that implements a uniform grid partition of 2D space, with the same
+// interface as KDTreeLinkerAlgo. The points are sorted by cell once, a search
+// then only visits the cells overlapping the search box. The cell size is
+// chosen from the number of points so that each cell holds a few of them.
+class KDTreeLinkerGridAlgo
+{
+ public:
+  KDTreeLinkerGridAlgo();
+
+  // Here we build the grid from the "eltList" in the space define by "region".
+  // Points outside of the region are put in the border cells.
+  void build(std::vector<KDTreeNodeInfo>	&eltList,
+	     const KDTreeBox			&region);
+
+  // Here we search in the grid for all points that would be
+  // contained in the given searchbox. The founded points are stored in resRecHitList.
+  void search(const KDTreeBox			&searchBox,
+	      std::vector<KDTreeNodeInfo>	&resRecHitList) const;
+
+  // This method clears all allocated structures.
+  void clear();
+
+ private:
+  int cell1(double dim1) const;
+  int cell2(double dim2) const;
+
+  KDTreeBox				region_;
+  int					n1_, n2_;
+  double				invSize1_, invSize2_;
+
+  // The points, sorted by cell, and the index of the first point of each cell
+  // (cell (i1,i2) is cellStart_[i1*n2_+i2]..cellStart_[i1*n2_+i2+1]).
+  std::vector<KDTreeNodeInfo>		points_;
+  std::vector<unsigned int>		cellStart_;
+};
+
+
+// Spatial index used by the KDTree linkers: a KDTree by default, or the uniform grid.
+class KDTreeLinkerIndex
+{
+ public:
+  KDTreeLinkerIndex() : useGrid_(false) {}
+
+  void setUseGrid(bool useGrid) { useGrid_ = useGrid; }
+
+  void build(std::vector<KDTreeNodeInfo>	&eltList,
+	     const KDTreeBox			&region) {
+    if (useGrid_) grid_.build(eltList, region);
+    else tree_.build(eltList, region);
+  }
+
+  void search(const KDTreeBox			&searchBox,
+	      std::vector<KDTreeNodeInfo>	&resRecHitList) {
+    if (useGrid_) grid_.search(searchBox, resRecHitList);
+    else tree_.search(searchBox, resRecHitList);
+  }
+
+  void clear() {
+    tree_.clear();
+    grid_.clear();
+  }
+
+ private:
+  bool			useGrid_;
+  KDTreeLinkerAlgo	tree_;
+  KDTreeLinkerGridAlgo	grid_;
+};
+
+#endif
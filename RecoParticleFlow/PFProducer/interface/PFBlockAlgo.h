@@ -173,6 +173,12 @@ class PFBlockAlgo {
   unsigned int linkTestSquare_[reco::PFBlockElement::kNBETypes][reco::PFBlockElement::kNBETypes];
   
   std::vector<KDTreePtr> kdtrees_;
+  /// true if the kdtrees fill the multilinks of different element types,
+  /// and can then be processed concurrently
+  bool parallelKDTrees_;
+
+  /// for each element, the indices of the elements it is linked to
+  std::vector<std::vector<unsigned> > elementLinks_;
 };
 
 #include "DataFormats/ParticleFlowReco/interface/PFBlockElementGsfTrack.h"
@@ -79,7 +79,7 @@ KDTreeLinkerPSEcal::buildTree()
 
 void 
 KDTreeLinkerPSEcal::buildTree(const RecHitSet	&rechitsSet,
-			      KDTreeLinkerAlgo	&tree)
+			      KDTreeLinkerIndex	&tree)
 {
   // List of pseudo-rechits that will be used to create the KDTree
   std::vector<KDTreeNodeInfo> eltList;
@@ -99,6 +99,7 @@ KDTreeLinkerPSEcal::buildTree(const RecHitSet	&rechitsSet,
   KDTreeBox region(-150., 150., -150., 150.);
 
   // We may now build the KDTree
+  tree.setUseGrid(useGrid_);
   tree.build(eltList, region);
 }
 
@@ -97,6 +97,7 @@ KDTreeLinkerTrackEcal::buildTree()
   KDTreeBox region(-3.0, 3.0, phimin, phimax);
 
   // We may now build the KDTree
+  tree_.setUseGrid(useGrid_);
   tree_.build(eltList, region);
 }
 
@@ -3,7 +3,7 @@
 
 #include "RecoParticleFlow/PFProducer/interface/KDTreeLinkerBase.h"
 #include "RecoParticleFlow/PFProducer/interface/KDTreeLinkerTools.h"
-#include "RecoParticleFlow/PFProducer/interface/KDTreeLinkerAlgo.h"
+#include "RecoParticleFlow/PFProducer/interface/KDTreeLinkerGridAlgo.h"
 
 
 // This class is used to find all links between Tracks and ECAL clusters
@@ -54,7 +54,7 @@ class KDTreeLinkerTrackEcal : public KDTreeLinkerBase
   RecHit2BlockEltMap	rechit2ClusterLinks_;
     
   // KD trees
-  KDTreeLinkerAlgo	tree_;
+  KDTreeLinkerIndex	tree_;
 
 };
 
@@ -100,6 +100,7 @@ KDTreeLinkerTrackHcal::buildTree()
   KDTreeBox region(-3.0, 3.0, phimin, phimax);
 
   // We may now build the KDTree
+  tree_.setUseGrid(useGrid_);
   tree_.build(eltList, region);
 }
 
@@ -3,7 +3,7 @@
 
 #include "RecoParticleFlow/PFProducer/interface/KDTreeLinkerBase.h"
 #include "RecoParticleFlow/PFProducer/interface/KDTreeLinkerTools.h"
-#include "RecoParticleFlow/PFProducer/interface/KDTreeLinkerAlgo.h"
+#include "RecoParticleFlow/PFProducer/interface/KDTreeLinkerGridAlgo.h"
 
 
 // This class is used to find all links between Tracks and HCAL clusters
@@ -14,6 +14,9 @@ class KDTreeLinkerTrackHcal : public KDTreeLinkerBase
  public:
   KDTreeLinkerTrackHcal();
   ~KDTreeLinkerTrackHcal();
+
+  // The links are stored in the HCAL clusters.
+  reco::PFBlockElement::Type linkedType() const { return _fieldType; }
   
   // With this method, we create the list of psCluster that we want to link.
   void insertTargetElt(reco::PFBlockElement		*track);
@@ -54,7 +57,7 @@ class KDTreeLinkerTrackHcal : public KDTreeLinkerBase
   RecHit2BlockEltMap	rechit2ClusterLinks_;
     
   // KD trees
-  KDTreeLinkerAlgo	tree_;
+  KDTreeLinkerIndex	tree_;
 
 };
 
@@ -75,6 +75,7 @@ particleFlowBlock = cms.EDProducer(
     # see : plugins/kdtrees for available KDTree Types
     # to enable a KDTree for a linking pair, write a KDTree linker
     # and set useKDTree = True in the linker PSet
+    # the optional useGrid = True replaces the KDTree by a uniform grid
     #order does not matter here since we are defining a lookup table
     linkDefinitions = cms.VPSet(
         cms.PSet( linkerName = cms.string("PreshowerAndECALLinker"),
@@ -179,11 +179,11 @@ KDTreeLinkerAlgo::recSearch(const KDTreeNode		*current,
       addSubtree(current->left, recHits);
     
     else { //if region( v->left ) intersects the rectangle
-      
-      if (!((current->left->region.dim1min >= trackBox.dim1max) || 
-	    (current->left->region.dim1max <= trackBox.dim1min) ||
-	    (current->left->region.dim2min >= trackBox.dim2max) || 
-	    (current->left->region.dim2max <= trackBox.dim2min)))
+      // (or touches it: its points on the edge are in the rectangle)
+      if (!((current->left->region.dim1min > trackBox.dim1max) || 
+	    (current->left->region.dim1max < trackBox.dim1min) ||
+	    (current->left->region.dim2min > trackBox.dim2max) || 
+	    (current->left->region.dim2max < trackBox.dim2min)))
 	recSearch(current->left, trackBox, recHits);
     }
     
@@ -196,10 +196,10 @@ KDTreeLinkerAlgo::recSearch(const KDTreeNode		*current,
 
     else { //if region( v->right ) intersects the rectangle
      
-      if (!((current->right->region.dim1min >= trackBox.dim1max) || 
-	    (current->right->region.dim1max <= trackBox.dim1min) ||
-	    (current->right->region.dim2min >= trackBox.dim2max) || 
-	    (current->right->region.dim2max <= trackBox.dim2min)))
+      if (!((current->right->region.dim1min > trackBox.dim1max) || 
+	    (current->right->region.dim1max < trackBox.dim1min) ||
+	    (current->right->region.dim2min > trackBox.dim2max) || 
+	    (current->right->region.dim2max < trackBox.dim2min)))
 	recSearch(current->right, trackBox, recHits);
     } 
   }
@@ -6,7 +6,8 @@ KDTreeLinkerBase::KDTreeLinkerBase()
   : cristalPhiEtaMaxSize_ (0.04),
     cristalXYMaxSize_ (3.),
     phiOffset_ (0.25),
-    debug_ (false)
+    debug_ (false),
+    useGrid_ (false)
 {
 }
 
@@ -38,6 +39,12 @@ KDTreeLinkerBase::setDebug(bool debug)
   debug_ = debug;
 }
 
+void
+KDTreeLinkerBase::setUseGrid(bool useGrid)
+{
+  useGrid_ = useGrid;
+}
+
 float
 KDTreeLinkerBase::getCristalPhiEtaMaxSize() const
 {
@@ -0,0 +1,95 @@
+#include "RecoParticleFlow/PFProducer/interface/KDTreeLinkerGridAlgo.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+  // Average number of points per cell.
+  constexpr double pointsPerCell = 4.;
+  constexpr int maxCellsPerDim = 1024;
+}
+
+KDTreeLinkerGridAlgo::KDTreeLinkerGridAlgo()
+  : n1_(0), n2_(0),
+    invSize1_(0.), invSize2_(0.)
+{
+}
+
+int
+KDTreeLinkerGridAlgo::cell1(double dim1) const
+{
+  int i = (dim1 - region_.dim1min) * invSize1_;
+  return std::min(std::max(i, 0), n1_ - 1);
+}
+
+int
+KDTreeLinkerGridAlgo::cell2(double dim2) const
+{
+  int i = (dim2 - region_.dim2min) * invSize2_;
+  return std::min(std::max(i, 0), n2_ - 1);
+}
+
+void
+KDTreeLinkerGridAlgo::build(std::vector<KDTreeNodeInfo>	&eltList,
+			    const KDTreeBox		&region)
+{
+  clear();
+  if (eltList.empty())
+    return;
+
+  // Square cells in the units of the region, sized for the number of points.
+  region_ = region;
+  const double size1 = region.dim1max - region.dim1min;
+  const double size2 = region.dim2max - region.dim2min;
+  const double cellSize = std::sqrt(size1 * size2 * pointsPerCell / eltList.size());
+  n1_ = std::min(std::max(int(size1 / cellSize), 1), maxCellsPerDim);
+  n2_ = std::min(std::max(int(size2 / cellSize), 1), maxCellsPerDim);
+  invSize1_ = n1_ / size1;
+  invSize2_ = n2_ / size2;
+
+  // Counting sort of the points by cell.
+  std::vector<unsigned int> cells(eltList.size());
+  cellStart_.assign(n1_ * n2_ + 1, 0);
+  for (unsigned int i = 0; i < eltList.size(); ++i) {
+    cells[i] = cell1(eltList[i].dim1) * n2_ + cell2(eltList[i].dim2);
+    ++cellStart_[cells[i] + 1];
+  }
+  for (unsigned int c = 1; c < cellStart_.size(); ++c)
+    cellStart_[c] += cellStart_[c - 1];
+
+  std::vector<unsigned int> pos(cellStart_.begin(), cellStart_.end() - 1);
+  points_.resize(eltList.size());
+  for (unsigned int i = 0; i < eltList.size(); ++i)
+    points_[pos[cells[i]]++] = eltList[i];
+}
+
+void
+KDTreeLinkerGridAlgo::search(const KDTreeBox		&searchBox,
+			     std::vector<KDTreeNodeInfo>	&recHits) const
+{
+  if (points_.empty())
+    return;
+
+  const int min1 = cell1(searchBox.dim1min), max1 = cell1(searchBox.dim1max);
+  const int min2 = cell2(searchBox.dim2min), max2 = cell2(searchBox.dim2max);
+  for (int i1 = min1; i1 <= max1; ++i1) {
+    for (int i2 = min2; i2 <= max2; ++i2) {
+      const unsigned int c = i1 * n2_ + i2;
+      for (unsigned int i = cellStart_[c]; i < cellStart_[c + 1]; ++i) {
+	const KDTreeNodeInfo &rh = points_[i];
+	// If point inside the rectangle/area
+	if ((rh.dim1 >= searchBox.dim1min) && (rh.dim1 <= searchBox.dim1max) &&
+	    (rh.dim2 >= searchBox.dim2min) && (rh.dim2 <= searchBox.dim2max))
+	  recHits.push_back(rh);
+      }
+    }
+  }
+}
+
+void
+KDTreeLinkerGridAlgo::clear()
+{
+  points_.clear();
+  cellStart_.clear();
+  n1_ = n2_ = 0;
+}
@@ -11,6 +11,9 @@
 #include <algorithm>
 #include "TMath.h"
 
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+
 using namespace std;
 using namespace reco;
 
@@ -80,7 +83,8 @@ PFBlockAlgo::PFBlockAlgo() :
 	INIT_ENTRY(PFBlockElement::SC),
 	INIT_ENTRY(PFBlockElement::HO),
 	INIT_ENTRY(PFBlockElement::HGCAL)  
-	  } ) {}
+	  } ),
+  parallelKDTrees_(true) {}
 
 void PFBlockAlgo::setLinkers(const std::vector<edm::ParameterSet>& confs) {
    constexpr unsigned rowsize = reco::PFBlockElement::kNBETypes;
@@ -126,6 +130,17 @@ void PFBlockAlgo::setLinkers(const std::vector<edm::ParameterSet>& confs) {
 								linkerName) );
       kdtrees_.back()->setTargetType(std::min(type1,type2));
       kdtrees_.back()->setFieldType(std::max(type1,type2));
+      if( conf.exists("useGrid") ) {
+        kdtrees_.back()->setUseGrid(conf.getParameter<bool>("useGrid"));
+      }
+    }
+  }
+  // the kdtrees can only run concurrently if each of them writes the
+  // multilinks of its own element type
+  std::set<PFBlockElement::Type> linkedTypes;
+  for( const auto& kdtree : kdtrees_ ) {
+    if( !linkedTypes.insert(kdtree->linkedType()).second ) {
+      parallelKDTrees_ = false;
     }
   }
 }
@@ -153,36 +168,64 @@ PFBlockAlgo::~PFBlockAlgo() {
 
 void PFBlockAlgo::findBlocks() {
   // Glowinski & Gouzevitch
-  for( const auto& kdtree : kdtrees_ ) {
-    kdtree->process();
-  }  
+  if( parallelKDTrees_ ) {
+    tbb::parallel_for(tbb::blocked_range<unsigned>(0,kdtrees_.size(),1),
+                      [this](const tbb::blocked_range<unsigned>& r) {
+                        for( unsigned i = r.begin(); i < r.end(); ++i ) {
+                          kdtrees_[i]->process();
+                        }
+                      });
+  } else {
+    for( const auto& kdtree : kdtrees_ ) {
+      kdtree->process();
+    }
+  }
   // !Glowinski & Gouzevitch
   // the blocks have not been passed to the event, and need to be cleared
   if( blocks_.get() ) blocks_->clear();
   else                blocks_.reset( new reco::PFBlockCollection );
   blocks_->reserve(elements_.size());
 
-  QuickUnion qu(bare_elements_.size());
+  // the link tests of all element pairs are independent: run them
+  // concurrently, each element collecting the list of the following
+  // elements it is linked to.  The link tests do not depend on the order
+  // of the two elements, so each pair is tested once and the link is only
+  // recorded for the first element, which is all the union needs.
   const auto elem_size = bare_elements_.size();
-  for( unsigned i = 0; i < elem_size; ++i ) {
-    for( unsigned j = 0; j < elem_size; ++j ) {
-      if( qu.connected(i,j) || j == i ) continue;
-      if( !linkTests_[linkTestSquare_[bare_elements_[i]->type()][bare_elements_[j]->type()]] ) {
-        j = ranges_[bare_elements_[j]->type()].second;
-        continue;
-      }
-      auto p1(bare_elements_[i]), p2(bare_elements_[j]);
-      const PFBlockElement::Type type1 = p1->type();
-      const PFBlockElement::Type type2 = p2->type();
-      const unsigned index = linkTestSquare_[type1][type2];
-      if( linkTests_[index]->linkPrefilter(p1,p2) ) {
-        const double dist = linkTests_[index]->testLink(p1,p2);
-        // compute linking info if it is possible
-        if( dist > -0.5 ) {
-          qu.unite(i,j);
+  if( elementLinks_.size() < elem_size ) elementLinks_.resize(elem_size);
+  tbb::parallel_for(tbb::blocked_range<unsigned>(0,elem_size),
+                    [&](const tbb::blocked_range<unsigned>& r) {
+    for( unsigned i = r.begin(); i < r.end(); ++i ) {
+      auto& linked = elementLinks_[i];
+      linked.clear();
+      for( unsigned j = i+1; j < elem_size; ++j ) {
+        if( !linkTests_[linkTestSquare_[bare_elements_[i]->type()][bare_elements_[j]->type()]] ) {
+          j = ranges_[bare_elements_[j]->type()].second;
+          continue;
+        }
+        auto p1(bare_elements_[i]), p2(bare_elements_[j]);
+        const PFBlockElement::Type type1 = p1->type();
+        const PFBlockElement::Type type2 = p2->type();
+        const unsigned index = linkTestSquare_[type1][type2];
+        if( linkTests_[index]->linkPrefilter(p1,p2) ) {
+          const double dist = linkTests_[index]->testLink(p1,p2);
+          // compute linking info if it is possible
+          if( dist > -0.5 ) {
+            linked.push_back(j);
+          }
         }
       }
     }
+  });
+
+  // the union is done serially, in the same order as the links were
+  // tested, so that the blocks and their ordering do not depend on the
+  // scheduling of the link tests
+  QuickUnion qu(elem_size);
+  for( unsigned i = 0; i < elem_size; ++i ) {
+    for( unsigned j : elementLinks_[i] ) {
+      if( !qu.connected(i,j) ) qu.unite(i,j);
+    }
   }
   
   std::unordered_multimap<unsigned,unsigned> blocksmap(elements_.size());
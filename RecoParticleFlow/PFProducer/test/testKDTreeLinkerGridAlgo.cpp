@@ -0,0 +1,140 @@
+// KDTreeLinkerGridAlgo against KDTreeLinkerAlgo: the same points found for
+// the same search boxes, with points and box edges on the cell edges and
+// boxes across the phi wrap-around, as in the KDTree linkers
+
+#include "RecoParticleFlow/PFProducer/interface/KDTreeLinkerAlgo.h"
+#include "RecoParticleFlow/PFProducer/interface/KDTreeLinkerGridAlgo.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+  std::mt19937 rng(34);
+
+  double flat(double a, double b) { return std::uniform_real_distribution<double>(a,b)(rng); }
+  int uniform(int a, int b) { return std::uniform_int_distribution<int>(a,b)(rng); }
+
+  // as KDTreeLinkerTrackEcal
+  constexpr double phiOffset = 0.25;
+  const KDTreeBox region(-3.0, 3.0, -M_PI-phiOffset, M_PI+phiOffset);
+
+  // a value on the edge k/n of [min,max], for all the cell numbers n the grid
+  // may choose here: the points and the box edges then fall on the cell edges
+  double onEdge(double min, double max) {
+    int n = uniform(1,64);
+    return min + (max-min)*uniform(0,n)/n;
+  }
+
+  // random points of the region, a third of them on the cell edges, and the
+  // points close to -Pi or Pi duplicated with phi -+ 2 Pi
+  std::vector<KDTreeNodeInfo> makePoints(std::vector<reco::PFRecHit> const & hits) {
+    std::vector<KDTreeNodeInfo> points;
+    for (auto const & hit : hits) {
+      double eta, phi;
+      switch (uniform(0,2)) {
+      case 0:
+	eta = onEdge(region.dim1min, region.dim1max);
+	phi = onEdge(region.dim2min, region.dim2max);
+	phi = std::max(-M_PI, std::min(M_PI, phi));
+	break;
+      case 1:
+	eta = flat(-3., 3.);
+	phi = flat(-M_PI, M_PI);
+	break;
+      default:
+	// close to the wrap-around
+	eta = flat(-3., 3.);
+	phi = uniform(0,1) ? flat(M_PI-0.3, M_PI) : flat(-M_PI, -M_PI+0.3);
+      }
+      points.emplace_back(&hit, eta, phi);
+      if (phi > M_PI - phiOffset) points.emplace_back(&hit, eta, phi - 2*M_PI);
+      if (phi < -M_PI + phiOffset) points.emplace_back(&hit, eta, phi + 2*M_PI);
+    }
+    return points;
+  }
+
+  KDTreeBox makeBox(std::vector<KDTreeNodeInfo> const & points) {
+    double eta, phi;
+    int kind = uniform(0,3);
+    if (kind == 1 && points.empty()) kind = 3;
+    switch (kind) {
+    case 0:
+      // edges on the cell edges
+      eta = onEdge(region.dim1min, region.dim1max);
+      phi = onEdge(region.dim2min, region.dim2max);
+      break;
+    case 1: {
+      // edges on a point
+      auto const & point = points[uniform(0,points.size()-1)];
+      return uniform(0,1) ? KDTreeBox(point.dim1, point.dim1+flat(0.,0.5), point.dim2-flat(0.,0.5), point.dim2)
+	: KDTreeBox(point.dim1-flat(0.,0.5), point.dim1, point.dim2, point.dim2+flat(0.,0.5));
+    }
+    case 2:
+      // around a track close to the wrap-around, the box goes past -Pi or Pi
+      eta = flat(-3., 3.);
+      phi = uniform(0,1) ? flat(M_PI-0.2, M_PI) : flat(-M_PI, -M_PI+0.2);
+      break;
+    default:
+      eta = flat(-3.5, 3.5);
+      phi = flat(-M_PI, M_PI);
+    }
+    double range = flat(0., 0.4);
+    return KDTreeBox(eta-range, eta+range, phi-range, phi+range);
+  }
+
+  bool before(KDTreeNodeInfo const & a, KDTreeNodeInfo const & b) {
+    return std::tie(a.ptr, a.dim1, a.dim2) < std::tie(b.ptr, b.dim1, b.dim2);
+  }
+
+  bool same(KDTreeNodeInfo const & a, KDTreeNodeInfo const & b) {
+    return a.ptr == b.ptr && a.dim1 == b.dim1 && a.dim2 == b.dim2;
+  }
+
+  int failures = 0;
+
+  void check(unsigned int nHits, unsigned int nBoxes) {
+    std::vector<reco::PFRecHit> hits(nHits);
+    auto points = makePoints(hits);
+
+    // the KDTree reorders its list
+    KDTreeLinkerAlgo tree;
+    KDTreeLinkerGridAlgo grid;
+    auto treePoints = points;
+    tree.build(treePoints, region);
+    grid.build(points, region);
+
+    for (unsigned int ibox = 0; ibox < nBoxes; ++ibox) {
+      auto box = makeBox(points);
+      std::vector<KDTreeNodeInfo> fromTree, fromGrid;
+      tree.search(box, fromTree);
+      grid.search(box, fromGrid);
+      // the order of the points found is not part of the interface
+      std::sort(fromTree.begin(), fromTree.end(), before);
+      std::sort(fromGrid.begin(), fromGrid.end(), before);
+      if (fromTree.size() != fromGrid.size() || !std::equal(fromTree.begin(), fromTree.end(), fromGrid.begin(), same)) {
+	std::cout << nHits << " hits, box " << box.dim1min << ' ' << box.dim1max << ' ' << box.dim2min << ' ' << box.dim2max
+		  << ": " << fromTree.size() << " points from the tree, " << fromGrid.size() << " from the grid" << std::endl;
+	++failures;
+      }
+    }
+  }
+
+}
+
+
+int main() {
+  for (unsigned int nHits : {0, 1, 2, 10, 100, 1000, 5000}) {
+    for (int trial = 0; trial < 5; ++trial) check(nHits, 500);
+  }
+
+  if (failures) {
+    std::cout << failures << " failures" << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -50,6 +50,10 @@ public:
 
    
   
+  int getInnerHitId() const {
+    return theDoublets->innerHitId(theDoubletId);
+  }
+  
   Hit const & getInnerHit() const {
     return theDoublets->hit(theDoubletId, HitDoublets::inner);
   }
@@ -117,9 +121,11 @@ public:
   }
   
 
-  void checkAlignmentAndAct(CAColl& allCells, CAntuple & innerCells, const float ptmin, const float region_origin_x,
+  // act(innerCellId, cellId) is called for each compatible inner cell, in the order of innerCells
+  template<typename Act>
+  void checkAlignmentAndAct(const CAColl& allCells, const CAntuple & innerCells, const float ptmin, const float region_origin_x,
 			    const float region_origin_y, const float region_origin_radius, const float thetaCut,
-			    const float phiCut, const float hardPtCut, std::vector<CACell::CAntuplet> * foundTriplets) {
+			    const float phiCut, const float hardPtCut, Act && act) const {
     int ncells = innerCells.size();
     int constexpr VSIZE = 16;
     int ok[VSIZE];
@@ -142,10 +148,7 @@ public:
 	auto & oc =  allCells[koc]; 
 	if (ok[j]&&haveSimilarCurvature(oc,ptmin, region_origin_x, region_origin_y,
 					region_origin_radius, phiCut, hardPtCut)) {
-	  if (foundTriplets) foundTriplets->emplace_back(CACell::CAntuplet{koc,cellId});
-	  else {
-	    oc.tagAsOuterNeighbor(cellId);
-	  }
+	  act(koc,cellId);
 	}
       }
     };
@@ -159,7 +162,7 @@ public:
 			    const float region_origin_y, const float region_origin_radius, const float thetaCut,
 			    const float phiCut, const float hardPtCut) {
     checkAlignmentAndAct(allCells, innerCells, ptmin, region_origin_x, region_origin_y, region_origin_radius, thetaCut,
-			 phiCut, hardPtCut, nullptr);
+			 phiCut, hardPtCut, [&](unsigned int koc, unsigned int cellId) { allCells[koc].tagAsOuterNeighbor(cellId); });
     
   }
   void checkAlignmentAndPushTriplet(CAColl& allCells, CAntuple & innerCells, std::vector<CACell::CAntuplet>& foundTriplets,
@@ -167,7 +170,7 @@ public:
 				    const float region_origin_radius, const float thetaCut, const float phiCut,
 				    const float hardPtCut) {
     checkAlignmentAndAct(allCells, innerCells, ptmin, region_origin_x, region_origin_y, region_origin_radius, thetaCut,
-			 phiCut, hardPtCut, &foundTriplets);
+			 phiCut, hardPtCut, [&](unsigned int koc, unsigned int cellId) { foundTriplets.emplace_back(CACell::CAntuplet{koc,cellId}); });
   }
   
   
@@ -188,6 +191,10 @@ public:
     theOuterNeighbors.push_back(otherCell);
   }
   
+  CAntuple const & getOuterNeighbors() const {
+    return theOuterNeighbors;
+  }
+  
   
   bool haveSimilarCurvature(const CACell & otherCell, const float ptmin,
 			    const float region_origin_x, const float region_origin_y, const float region_origin_radius, const float phiCut, const float hardPtCut) const
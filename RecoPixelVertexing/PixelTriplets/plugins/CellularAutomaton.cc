@@ -1,26 +1,25 @@
 #include "CellularAutomaton.h"
 
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+
 #include<queue>
+#include<algorithm>
 
+namespace {
+  // cells connected (or evolved) by a task
+  constexpr unsigned int cellBlockSize = 512;
+}
 
-void CellularAutomaton::createAndConnectCells(const std::vector<const HitDoublets *>& hitDoublets, const TrackingRegion& region,
-		const float thetaCut, const float phiCut, const float hardPtCut)
+void CellularAutomaton::createCells(const std::vector<const HitDoublets *>& hitDoublets)
 {
         int tsize=0;
         for ( auto hd :  hitDoublets) tsize+=hd->size();
         allCells.reserve(tsize);
         unsigned int cellId = 0;
-	float ptmin = region.ptMin();
-	float region_origin_x = region.origin().x();
-	float region_origin_y = region.origin().y();
-	float region_origin_radius = region.originRBound();
 
 	std::vector<bool> alreadyVisitedLayerPairs;
 	alreadyVisitedLayerPairs.resize(theLayerGraph.theLayerPairs.size());
-	for (auto visited : alreadyVisitedLayerPairs)
-	{
-		visited = false;
-	}
 	for (int rootVertex : theLayerGraph.theRootLayers)
 	{
 
@@ -64,19 +63,9 @@ void CellularAutomaton::createAndConnectCells(const std::vector<const HitDoublet
 							doubletLayerPairId->innerHitId(i),
 							doubletLayerPairId->outerHitId(i));
 				  
-										  
 				  currentOuterLayerRef.isOuterHitOfCell[doubletLayerPairId->outerHitId(i)].push_back(cellId);
-														     
-				  cellId++;
-
-				  auto & neigCells = currentInnerLayerRef.isOuterHitOfCell[doubletLayerPairId->innerHitId(i)];
-				  allCells.back().checkAlignmentAndTag(allCells,
-								       neigCells, ptmin, region_origin_x,
-								       region_origin_y, region_origin_radius, thetaCut,
-								       phiCut, hardPtCut
-								       );
 				  
-
+				  cellId++;
 				}
 				assert(cellId==currentLayerPairRef.theFoundCells[1]);
 				for (auto outerLayerPair : currentOuterLayerRef.theOuterLayerPairs)
@@ -99,31 +88,82 @@ void CellularAutomaton::createAndConnectCells(const std::vector<const HitDoublet
 
 }
 
+// All the cells are created before they are connected: a layer pair is visited only after all
+// the layer pairs ending on its inner layer, so the candidate inner cells of a cell are the same
+// as if the cells were connected while being created.
+// The compatible pairs of cells found by each block are stored apart and acted on in the order
+// of the blocks, so that the neighbours (or the triplets) come out as in a sequential connection.
+template<typename Act>
+void CellularAutomaton::connectCells(const TrackingRegion& region,
+		const float thetaCut, const float phiCut, const float hardPtCut, Act && act)
+{
+	float ptmin = region.ptMin();
+	float region_origin_x = region.origin().x();
+	float region_origin_y = region.origin().y();
+	float region_origin_radius = region.originRBound();
+
+	// inner layer of the layer pair of each cell
+	std::vector<int> innerLayerOfCell(allCells.size());
+	for (auto const & layerPair : theLayerGraph.theLayerPairs)
+	{
+		for (auto i = layerPair.theFoundCells[0]; i < layerPair.theFoundCells[1]; ++i)
+			innerLayerOfCell[i] = layerPair.theLayers[0];
+	}
+
+	const unsigned int nCells = allCells.size();
+	const unsigned int nBlocks = (nCells+cellBlockSize-1)/cellBlockSize;
+	std::vector<std::vector<std::pair<unsigned int, unsigned int> > > found(nBlocks);
+	tbb::parallel_for(0U, nBlocks, [&](unsigned int ib) {
+		auto & blockFound = found[ib];
+		auto end = std::min(nCells, (ib+1)*cellBlockSize);
+		for (auto i = ib*cellBlockSize; i < end; ++i)
+		{
+			auto const & cell = allCells[i];
+			auto const & neigCells = theLayerGraph.theLayers[innerLayerOfCell[i]].isOuterHitOfCell[cell.getInnerHitId()];
+			cell.checkAlignmentAndAct(allCells, neigCells, ptmin, region_origin_x,
+						  region_origin_y, region_origin_radius, thetaCut, phiCut, hardPtCut,
+						  [&](unsigned int koc, unsigned int cellId) { blockFound.emplace_back(koc, cellId); });
+		}
+	});
+
+	for (auto const & blockFound : found)
+		for (auto const & p : blockFound) act(p.first, p.second);
+}
+
+void CellularAutomaton::createAndConnectCells(const std::vector<const HitDoublets *>& hitDoublets, const TrackingRegion& region,
+		const float thetaCut, const float phiCut, const float hardPtCut)
+{
+	createCells(hitDoublets);
+	connectCells(region, thetaCut, phiCut, hardPtCut,
+		     [&](unsigned int koc, unsigned int cellId) { allCells[koc].tagAsOuterNeighbor(cellId); });
+}
+
 void CellularAutomaton::evolve(const unsigned int minHitsPerNtuplet)
 {
   allStatus.resize(allCells.size());
   
+  // the cells are evolved looking at the states of the previous iteration only
+  // (hasSameStateNeighbors is updated first, then theCAState), so each step can run in parallel
+  const tbb::blocked_range<unsigned int> cells(0, allCells.size(), cellBlockSize);
   
   unsigned int numberOfIterations = minHitsPerNtuplet - 2;
   // keeping the last iteration for later
   for (unsigned int iteration = 0; iteration < numberOfIterations - 1;
        ++iteration)
     {
-      for (auto& layerPair : theLayerGraph.theLayerPairs)
-	{
-	  for (auto i =layerPair.theFoundCells[0]; i<layerPair.theFoundCells[1]; ++i)
+      tbb::parallel_for(cells, [&](const tbb::blocked_range<unsigned int>& r) {
+	  for (auto i = r.begin(); i < r.end(); ++i)
 	    {
 	      allCells[i].evolve(i,allStatus);
 	    }
-	}
+	});
       
-      for (auto& layerPair : theLayerGraph.theLayerPairs)
-	{
-	  for (auto i =layerPair.theFoundCells[0]; i<layerPair.theFoundCells[1]; ++i)
+      tbb::parallel_for(cells, [&](const tbb::blocked_range<unsigned int>& r) {
+	  for (auto i = r.begin(); i < r.end(); ++i)
 	    {
 	      allStatus[i].updateState();
 	    }
-	}
+	});
       
     }
 
@@ -170,96 +210,7 @@ void CellularAutomaton::findNtuplets(
 void CellularAutomaton::findTriplets(const std::vector<const HitDoublets*>& hitDoublets,std::vector<CACell::CAntuplet>& foundTriplets, const TrackingRegion& region,
 		const float thetaCut, const float phiCut, const float hardPtCut)
 {
-        int tsize=0;
-        for ( auto hd :  hitDoublets) tsize+=hd->size();
-        allCells.reserve(tsize);
-
-        unsigned int cellId = 0;
-	float ptmin = region.ptMin();
-	float region_origin_x = region.origin().x();
-	float region_origin_y = region.origin().y();
-	float region_origin_radius = region.originRBound();
-
-	std::vector<bool> alreadyVisitedLayerPairs;
-	alreadyVisitedLayerPairs.resize(theLayerGraph.theLayerPairs.size());
-	for (auto visited : alreadyVisitedLayerPairs)
-	{
-		visited = false;
-	}
-	for (int rootVertex : theLayerGraph.theRootLayers)
-	{
-
-		std::queue<int> LayerPairsToVisit;
-
-		for (int LayerPair : theLayerGraph.theLayers[rootVertex].theOuterLayerPairs)
-		{
-			LayerPairsToVisit.push(LayerPair);
-
-		}
-
-		unsigned int numberOfLayerPairsToVisitAtThisDepth =
-				LayerPairsToVisit.size();
-
-		while (!LayerPairsToVisit.empty())
-		{
-			auto currentLayerPair = LayerPairsToVisit.front();
-			auto & currentLayerPairRef = theLayerGraph.theLayerPairs[currentLayerPair];
-			auto & currentInnerLayerRef = theLayerGraph.theLayers[currentLayerPairRef.theLayers[0]];
-			auto & currentOuterLayerRef = theLayerGraph.theLayers[currentLayerPairRef.theLayers[1]];
-			bool allInnerLayerPairsAlreadyVisited	{ true };
-
-			for (auto innerLayerPair : currentInnerLayerRef.theInnerLayerPairs)
-			{
-				allInnerLayerPairsAlreadyVisited &=
-						alreadyVisitedLayerPairs[innerLayerPair];
-			}
-
-			if (alreadyVisitedLayerPairs[currentLayerPair] == false
-					&& allInnerLayerPairsAlreadyVisited)
-			{
-
-				const HitDoublets* doubletLayerPairId =
-						hitDoublets[currentLayerPair];
-				auto numberOfDoublets = doubletLayerPairId->size();
-				currentLayerPairRef.theFoundCells[0] = cellId;
-				currentLayerPairRef.theFoundCells[1] = cellId+numberOfDoublets;
-				for (unsigned int i = 0; i < numberOfDoublets; ++i)
-				{
-				  allCells.emplace_back(doubletLayerPairId, i,
-							doubletLayerPairId->innerHitId(i),
-							doubletLayerPairId->outerHitId(i));
-				  
-										  
-				  currentOuterLayerRef.isOuterHitOfCell[doubletLayerPairId->outerHitId(i)].push_back(cellId);
-														     
-				  cellId++;
-
-				  auto & neigCells = currentInnerLayerRef.isOuterHitOfCell[doubletLayerPairId->innerHitId(i)];
-				  allCells.back().checkAlignmentAndPushTriplet(allCells,
-									       neigCells, foundTriplets, ptmin, region_origin_x,
-									       region_origin_y, region_origin_radius, thetaCut,
-									       phiCut, hardPtCut
-									       );
-				}
-				assert(cellId==currentLayerPairRef.theFoundCells[1]);
-
-
-				for (auto outerLayerPair : currentOuterLayerRef.theOuterLayerPairs)
-				{
-					LayerPairsToVisit.push(outerLayerPair);
-				}
-
-				alreadyVisitedLayerPairs[currentLayerPair] = true;
-			}
-			LayerPairsToVisit.pop();
-			numberOfLayerPairsToVisitAtThisDepth--;
-			if (numberOfLayerPairsToVisitAtThisDepth == 0)
-			{
-				numberOfLayerPairsToVisitAtThisDepth = LayerPairsToVisit.size();
-			}
-
-		}
-
-	}
-
+	createCells(hitDoublets);
+	connectCells(region, thetaCut, phiCut, hardPtCut,
+		     [&](unsigned int koc, unsigned int cellId) { foundTriplets.emplace_back(CACell::CAntuplet{koc,cellId}); });
 }
@@ -15,6 +15,7 @@ public:
   }
   
   std::vector<CACell> & getAllCells() { return allCells;}
+  std::vector<unsigned int> const & getRootCells() const { return theRootCells;}
   
   void createAndConnectCells(const std::vector<const HitDoublets *>&,
 			     const TrackingRegion&, const float, const float, const float);
@@ -25,6 +26,14 @@ public:
 		    const float thetaCut, const float phiCut, const float hardPtCut);
   
 private:
+  // creates the cells of the layer pairs, visited from the root layers outwards,
+  // and registers them at their outer hit
+  void createCells(const std::vector<const HitDoublets *>&);
+  // finds the compatible inner cells of all the cells, in parallel blocks of cells;
+  // act(innerCellId, cellId) is then called serially, in order of cellId
+  template<typename Act>
+  void connectCells(const TrackingRegion&, const float, const float, const float, Act &&);
+
   CAGraph & theLayerGraph;
 
   std::vector<CACell> allCells;
@@ -0,0 +1,327 @@
+// CellularAutomaton, that connects and evolves its cells in parallel, against
+// the sequential algorithm it replaced: same neighbour lists, triplets, root
+// cells and quadruplets, on random events of a graph of four barrel layers
+
+// the CellularAutomaton is built in the plugin library, so it is compiled in
+#include "RecoPixelVertexing/PixelTriplets/plugins/CellularAutomaton.cc"
+
+#include "RecoTracker/TkTrackingRegions/interface/GlobalTrackingRegion.h"
+#include "TrackingTools/DetLayers/interface/DetLayer.h"
+
+#include "tbb/task_scheduler_init.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+  // only isBarrel is used by RecHitsSortedInPhi
+  class FakeDetLayer final : public DetLayer {
+  public:
+    explicit FakeDetLayer(bool barrel) : DetLayer(false,barrel) {}
+    const BoundSurface& surface() const override { return *theSurface; }
+    const std::vector<const GeometricSearchDet*>& components() const override { return theComponents; }
+    const std::vector<const GeomDet*>& basicComponents() const override { return theBasicComponents; }
+    std::pair<bool, TrajectoryStateOnSurface>
+    compatible(const TrajectoryStateOnSurface& ts, const Propagator&, const MeasurementEstimator&) const override {
+      return std::make_pair(false,ts);
+    }
+    SubDetector subDetector() const override { return isBarrel() ? GeomDetEnumerators::PixelBarrel : GeomDetEnumerators::PixelEndcap; }
+    Location location() const override { return isBarrel() ? GeomDetEnumerators::barrel : GeomDetEnumerators::endcap; }
+  private:
+    BoundSurface const * theSurface = nullptr;
+    std::vector<const GeometricSearchDet*> theComponents;
+    std::vector<const GeomDet*> theBasicComponents;
+  };
+
+  // the sequential algorithm, as before the cells were connected and evolved in parallel:
+  // each cell is connected when it is created (foundTriplets==nullptr for createAndConnectCells,
+  // the triplets are pushed instead for findTriplets)
+  class SequentialCellularAutomaton {
+  public:
+    explicit SequentialCellularAutomaton(CAGraph & graph) : theLayerGraph(graph) {}
+
+    std::vector<CACell> & getAllCells() { return allCells; }
+    std::vector<unsigned int> const & getRootCells() const { return theRootCells; }
+
+    void createAndConnectCells(const std::vector<const HitDoublets *>& hitDoublets, const TrackingRegion& region,
+			       const float thetaCut, const float phiCut, const float hardPtCut,
+			       std::vector<CACell::CAntuplet> * foundTriplets = nullptr) {
+      int tsize=0;
+      for ( auto hd :  hitDoublets) tsize+=hd->size();
+      allCells.reserve(tsize);
+      unsigned int cellId = 0;
+      float ptmin = region.ptMin();
+      float region_origin_x = region.origin().x();
+      float region_origin_y = region.origin().y();
+      float region_origin_radius = region.originRBound();
+
+      std::vector<bool> alreadyVisitedLayerPairs(theLayerGraph.theLayerPairs.size(), false);
+      for (int rootVertex : theLayerGraph.theRootLayers) {
+	std::queue<int> LayerPairsToVisit;
+	for (int LayerPair : theLayerGraph.theLayers[rootVertex].theOuterLayerPairs) LayerPairsToVisit.push(LayerPair);
+
+	while (!LayerPairsToVisit.empty()) {
+	  auto currentLayerPair = LayerPairsToVisit.front();
+	  auto & currentLayerPairRef = theLayerGraph.theLayerPairs[currentLayerPair];
+	  auto & currentInnerLayerRef = theLayerGraph.theLayers[currentLayerPairRef.theLayers[0]];
+	  auto & currentOuterLayerRef = theLayerGraph.theLayers[currentLayerPairRef.theLayers[1]];
+	  bool allInnerLayerPairsAlreadyVisited { true };
+	  for (auto innerLayerPair : currentInnerLayerRef.theInnerLayerPairs)
+	    allInnerLayerPairsAlreadyVisited &= alreadyVisitedLayerPairs[innerLayerPair];
+
+	  if (alreadyVisitedLayerPairs[currentLayerPair] == false && allInnerLayerPairsAlreadyVisited) {
+	    const HitDoublets* doubletLayerPairId = hitDoublets[currentLayerPair];
+	    auto numberOfDoublets = doubletLayerPairId->size();
+	    currentLayerPairRef.theFoundCells[0] = cellId;
+	    currentLayerPairRef.theFoundCells[1] = cellId+numberOfDoublets;
+	    for (unsigned int i = 0; i < numberOfDoublets; ++i) {
+	      allCells.emplace_back(doubletLayerPairId, i,
+				    doubletLayerPairId->innerHitId(i),
+				    doubletLayerPairId->outerHitId(i));
+	      currentOuterLayerRef.isOuterHitOfCell[doubletLayerPairId->outerHitId(i)].push_back(cellId);
+	      cellId++;
+
+	      auto & neigCells = currentInnerLayerRef.isOuterHitOfCell[doubletLayerPairId->innerHitId(i)];
+	      if (foundTriplets)
+		allCells.back().checkAlignmentAndPushTriplet(allCells, neigCells, *foundTriplets, ptmin, region_origin_x,
+							     region_origin_y, region_origin_radius, thetaCut, phiCut, hardPtCut);
+	      else
+		allCells.back().checkAlignmentAndTag(allCells, neigCells, ptmin, region_origin_x,
+						     region_origin_y, region_origin_radius, thetaCut, phiCut, hardPtCut);
+	    }
+	    for (auto outerLayerPair : currentOuterLayerRef.theOuterLayerPairs) LayerPairsToVisit.push(outerLayerPair);
+	    alreadyVisitedLayerPairs[currentLayerPair] = true;
+	  }
+	  LayerPairsToVisit.pop();
+	}
+      }
+    }
+
+    void evolve(const unsigned int minHitsPerNtuplet) {
+      allStatus.resize(allCells.size());
+      unsigned int numberOfIterations = minHitsPerNtuplet - 2;
+      for (unsigned int iteration = 0; iteration < numberOfIterations - 1; ++iteration) {
+	for (auto& layerPair : theLayerGraph.theLayerPairs)
+	  for (auto i =layerPair.theFoundCells[0]; i<layerPair.theFoundCells[1]; ++i) allCells[i].evolve(i,allStatus);
+	for (auto& layerPair : theLayerGraph.theLayerPairs)
+	  for (auto i =layerPair.theFoundCells[0]; i<layerPair.theFoundCells[1]; ++i) allStatus[i].updateState();
+      }
+      for (int rootLayerId : theLayerGraph.theRootLayers) {
+	for (int rootLayerPair: theLayerGraph.theLayers[rootLayerId].theOuterLayerPairs) {
+	  auto foundCells = theLayerGraph.theLayerPairs[rootLayerPair].theFoundCells;
+	  for (auto i =foundCells[0]; i<foundCells[1]; ++i) {
+	    auto & cell =  allStatus[i];
+	    allCells[i].evolve(i,allStatus);
+	    cell.updateState();
+	    if (cell.isRootCell(minHitsPerNtuplet - 2)) theRootCells.push_back(i);
+	  }
+	}
+      }
+    }
+
+    void findNtuplets(std::vector<CACell::CAntuplet>& foundNtuplets, const unsigned int minHitsPerNtuplet) {
+      CACell::CAntuple tmpNtuplet;
+      for (auto root_cell : theRootCells) {
+	tmpNtuplet.clear();
+	tmpNtuplet.push_back(root_cell);
+	allCells[root_cell].findNtuplets(allCells,foundNtuplets, tmpNtuplet, minHitsPerNtuplet);
+      }
+    }
+
+  private:
+    CAGraph & theLayerGraph;
+    std::vector<CACell> allCells;
+    std::vector<CACellStatus> allStatus;
+    std::vector<unsigned int> theRootCells;
+  };
+
+  std::mt19937 rng(46);
+
+  float flat(float a, float b) { return std::uniform_real_distribution<float>(a,b)(rng); }
+  float gauss(float sigma) { return std::normal_distribution<float>(0.f,sigma)(rng); }
+
+  // the four pixel barrel layers (radius, half length)
+  constexpr float layerR[4] = {2.9f, 6.8f, 10.9f, 16.0f};
+  constexpr float layerHalfZ[4] = {26.7f, 26.7f, 26.7f, 33.f};
+  // all the consecutive layers, and a layer set without the third one
+  const std::vector<std::pair<int,int> > layerPairs = {{0,1}, {1,2}, {2,3}, {0,2}};
+
+  struct Event {
+    std::vector<RecHitsSortedInPhi> layers;
+    std::vector<HitDoublets> doublets;
+    std::vector<const HitDoublets *> hitDoublets;
+  };
+
+  // helices from the luminous region, with pixel resolution, and random hits in each layer
+  void makeEvent(int nTracks, int nNoise, DetLayer const & barrel, Event & event) {
+    std::vector<std::vector<GlobalPoint> > points(4);
+    for (int it=0; it<nTracks; ++it) {
+      float vx = gauss(0.002f), vy = gauss(0.002f), vz = gauss(5.f);
+      float phi0 = flat(-M_PI,M_PI), cotTheta = std::sinh(flat(-2.5f,2.5f));
+      float radius = flat(0.4f,5.f)*87.f*(it%2 ? 1.f : -1.f);  // signed radius of curvature (3.8 T)
+      for (int l=0; l<4; ++l) {
+	float c = layerR[l];
+	if (c >= 2.f*std::abs(radius)) break;
+	float alpha = std::asin(c/(2.f*radius));
+	float phi = phi0 + alpha + gauss(0.001f/c);
+	float z = vz + 2.f*radius*alpha*cotTheta + gauss(0.002f);
+	if (std::abs(z) > layerHalfZ[l]) break;
+	points[l].emplace_back(vx+c*std::cos(phi), vy+c*std::sin(phi), z);
+      }
+    }
+    for (int l=0; l<4; ++l) {
+      for (int i=0; i<nNoise; ++i) {
+	float phi = flat(-M_PI,M_PI);
+	points[l].emplace_back(layerR[l]*std::cos(phi), layerR[l]*std::sin(phi), flat(-layerHalfZ[l],layerHalfZ[l]));
+      }
+      std::sort(points[l].begin(), points[l].end(),
+		[](GlobalPoint const & a, GlobalPoint const & b) { return a.barePhi() < b.barePhi(); });
+    }
+
+    event.layers.clear();
+    event.layers.reserve(4);
+    for (int l=0; l<4; ++l) {
+      event.layers.emplace_back(std::vector<RecHitsSortedInPhi::Hit>(), GlobalPoint(0,0,0), &barrel);
+      auto & hits = event.layers.back();
+      for (auto const & p : points[l]) {
+	hits.theHits.emplace_back(p.barePhi());
+	hits.x.push_back(p.x());
+	hits.y.push_back(p.y());
+	hits.z.push_back(p.z());
+	hits.u.push_back(p.perp());
+	hits.v.push_back(p.z());
+	hits.du.push_back(0.001f);
+	hits.dv.push_back(0.002f);
+	hits.drphi.push_back(0.001f);
+	hits.lphi.push_back(p.barePhi());
+      }
+    }
+
+    // the doublets pointing to the luminous region, in order of outer hit
+    event.doublets.clear();
+    event.doublets.reserve(layerPairs.size());
+    event.hitDoublets.clear();
+    for (auto const & lp : layerPairs) {
+      auto const & inner = event.layers[lp.first];
+      auto const & outer = event.layers[lp.second];
+      event.doublets.emplace_back(inner, outer);
+      auto & doublets = event.doublets.back();
+      for (unsigned int o=0; o<outer.size(); ++o) {
+	for (unsigned int i=0; i<inner.size(); ++i) {
+	  if (std::abs(reco::deltaPhi(inner.phi(i),outer.phi(o))) > 0.1f) continue;
+	  float z0 = inner.z[i] - inner.u[i]*(outer.z[o]-inner.z[i])/(outer.u[o]-inner.u[i]);
+	  if (std::abs(z0) < 20.f) doublets.add(i,o);
+	}
+      }
+      event.hitDoublets.push_back(&doublets);
+    }
+  }
+
+  CAGraph makeGraph(Event const & event) {
+    CAGraph g;
+    for (unsigned int l=0; l<event.layers.size(); ++l)
+      g.theLayers.emplace_back("BPix"+std::to_string(l+1), event.layers[l].size());
+    g.theRootLayers.push_back(0);
+    for (auto const & lp : layerPairs) {
+      g.theLayerPairs.emplace_back(lp.first, lp.second);
+      int ip = g.theLayerPairs.size()-1;
+      g.theLayers[lp.second].theInnerLayers.push_back(lp.first);
+      g.theLayers[lp.first].theOuterLayers.push_back(lp.second);
+      g.theLayers[lp.second].theInnerLayerPairs.push_back(ip);
+      g.theLayers[lp.first].theOuterLayerPairs.push_back(ip);
+    }
+    return g;
+  }
+
+  int failures = 0;
+  unsigned int nCells = 0, nNeighbours = 0, nRootCells = 0, nQuadruplets = 0, nTriplets = 0;
+
+  void check(bool same, std::string const & what) {
+    if (!same) {
+      std::cout << what << " differ" << std::endl;
+      ++failures;
+    }
+  }
+
+  // as CAHitQuadrupletGenerator and CAHitTripletGenerator with the cuts of the initial step
+  void compare(Event const & event, TrackingRegion const & region) {
+    constexpr float thetaCut = 0.0012f, phiCut = 0.2f, hardPtCut = 0.f;
+    constexpr unsigned int numberOfHitsInNtuplet = 4;
+
+    CAGraph g = makeGraph(event), gRef = makeGraph(event);
+    CellularAutomaton ca(g);
+    SequentialCellularAutomaton reference(gRef);
+    ca.createAndConnectCells(event.hitDoublets, region, thetaCut, phiCut, hardPtCut);
+    reference.createAndConnectCells(event.hitDoublets, region, thetaCut, phiCut, hardPtCut);
+
+    const int failuresBefore = failures;
+    auto const & cells = ca.getAllCells();
+    auto const & refCells = reference.getAllCells();
+    check(cells.size() == refCells.size(), "numbers of cells");
+    for (unsigned int p=0; p<g.theLayerPairs.size(); ++p)
+      check(g.theLayerPairs[p].theFoundCells == gRef.theLayerPairs[p].theFoundCells, "cells of layer pair " + std::to_string(p));
+    if (failures != failuresBefore) return;
+    for (unsigned int i=0; i<cells.size(); ++i) {
+      check(cells[i].getOuterNeighbors() == refCells[i].getOuterNeighbors(), "neighbours of cell " + std::to_string(i));
+      nNeighbours += refCells[i].getOuterNeighbors().size();
+    }
+    nCells += cells.size();
+
+    ca.evolve(numberOfHitsInNtuplet);
+    reference.evolve(numberOfHitsInNtuplet);
+    check(ca.getRootCells() == reference.getRootCells(), "root cells");
+    nRootCells += reference.getRootCells().size();
+
+    std::vector<CACell::CAntuplet> quadruplets, refQuadruplets;
+    ca.findNtuplets(quadruplets, numberOfHitsInNtuplet);
+    reference.findNtuplets(refQuadruplets, numberOfHitsInNtuplet);
+    check(quadruplets == refQuadruplets, "quadruplets");
+    nQuadruplets += refQuadruplets.size();
+
+    CAGraph gTriplets = makeGraph(event), gRefTriplets = makeGraph(event);
+    CellularAutomaton caTriplets(gTriplets);
+    SequentialCellularAutomaton refTriplets(gRefTriplets);
+    std::vector<CACell::CAntuplet> triplets, refTripletsFound;
+    caTriplets.findTriplets(event.hitDoublets, triplets, region, thetaCut, phiCut, hardPtCut);
+    refTriplets.createAndConnectCells(event.hitDoublets, region, thetaCut, phiCut, hardPtCut, &refTripletsFound);
+    check(triplets == refTripletsFound, "triplets");
+    nTriplets += refTripletsFound.size();
+  }
+
+}
+
+
+int main() {
+  tbb::task_scheduler_init init(4);
+
+  FakeDetLayer barrel(true);
+  GlobalTrackingRegion region(0.5f, GlobalPoint(0,0,0), 0.02f, 15.f, true);
+
+  // from a few cells to several blocks of cells per layer pair
+  Event event;
+  for (int k=0; k<10; ++k) {
+    makeEvent(20*(k+1), 30*k, barrel, event);
+    compare(event, region);
+  }
+  // no cell at all
+  makeEvent(0, 0, barrel, event);
+  compare(event, region);
+
+  std::cout << nCells << " cells, " << nNeighbours << " neighbours, " << nRootCells << " root cells, "
+	    << nQuadruplets << " quadruplets, " << nTriplets << " triplets" << std::endl;
+  if (nNeighbours == 0 || nRootCells == 0 || nQuadruplets == 0 || nTriplets == 0) {
+    std::cout << "nothing found" << std::endl;
+    ++failures;
+  }
+  if (failures) {
+    std::cout << failures << " failures" << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -149,6 +149,8 @@ GroupedCkfTrajectoryBuilder::GroupedCkfTrajectoryBuilder(const edm::ParameterSet
   maxPt2ForLooperReconstruction *=maxPt2ForLooperReconstruction;
   maxDPhiForLooperReconstruction     = conf.existsAs<double>("maxDPhiForLooperReconstruction") ? 
     conf.getParameter<double>("maxDPhiForLooperReconstruction") : 2.0;
+  theUseBatchUpdator = conf.existsAs<bool>("useBatchUpdator") && conf.getParameter<bool>("useBatchUpdator");
+  theBatchUpdatorInUse = nullptr;
 
 
   /* ======= B.M. to be ported layer ===========
@@ -172,6 +174,8 @@ GroupedCkfTrajectoryBuilder::GroupedCkfTrajectoryBuilder(const edm::ParameterSet
 */
 
 void GroupedCkfTrajectoryBuilder::setEvent_(const edm::Event& event, const edm::EventSetup& iSetup) {
+  // the batched update reproduces KFUpdator only
+  theBatchUpdatorInUse = (theUseBatchUpdator && dynamic_cast<const KFUpdator*>(theUpdator)) ? &theBatchUpdator : nullptr;
 }
 
 GroupedCkfTrajectoryBuilder::TrajectoryContainer 
@@ -563,7 +567,8 @@ GroupedCkfTrajectoryBuilder::advanceOneLayer (const TrajectorySeed& seed,
     TrajectorySegmentBuilder layerBuilder(&layerMeasurements,
 					  **il,*propagator,
 					  *theUpdator,*theEstimator,
-					  theLockHits,theBestHitOnly,theMaxCand);
+					  theLockHits,theBestHitOnly,theMaxCand,
+					  theBatchUpdatorInUse);
 
 #ifdef EDM_ML_DEBUG
     LogDebug("CkfPattern")<<whatIsTheStateToUse(stateAndLayers.first,stateToUse,*il);
@@ -9,6 +9,7 @@
 #include "DataFormats/TrajectorySeed/interface/PropagationDirection.h"
 
 #include "TrackingTools/PatternTools/interface/TempTrajectory.h"
+#include "TrackingTools/KalmanUpdators/interface/KFBatchUpdator.h"
 
 #include <vector>
 
@@ -203,6 +204,11 @@ private:
 
   float maxDPhiForLooperReconstruction;
 
+  bool theUseBatchUpdator;      /**< Update the candidates with all the hits of a layer at once
+                                     (only with a KFUpdator) */
+  KFBatchUpdator theBatchUpdator;
+  const KFBatchUpdator* theBatchUpdatorInUse; /**< &theBatchUpdator if in use for this event, else nullptr */
+
 //  mutable TempTrajectoryContainer work_; // Better here than alloc every time
   enum work_MaxSize_Size_ { work_MaxSize_ = 50 };  // if it grows above this number, it is forced to resize to half this amount when cleared
 };
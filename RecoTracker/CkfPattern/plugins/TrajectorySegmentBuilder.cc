@@ -6,6 +6,7 @@
 
 #include "DataFormats/TrajectorySeed/interface/TrajectorySeed.h"
 #include "TrackingTools/KalmanUpdators/interface/KFUpdator.h"
+#include "TrackingTools/KalmanUpdators/interface/KFBatchUpdator.h"
 #include "TrackingTools/DetLayers/interface/MeasurementEstimator.h"
 #include "TrackingTools/PatternTools/interface/Trajectory.h"
 #include "TrackingTools/PatternTools/interface/TrajectoryMeasurement.h"
@@ -225,6 +226,14 @@ void TrajectorySegmentBuilder::updateTrajectory (TempTrajectory& traj, TM tm) co
   }
 }
 
+void TrajectorySegmentBuilder::updateTrajectory (TempTrajectory& traj, TM tm, TSOS upState) const
+{
+  auto &&  predictedState = tm.predictedState();
+  auto &&  hit = tm.recHit();
+  traj.emplace(std::move(predictedState), std::move(upState),
+	       std::move(hit), tm.estimate(), tm.layer());
+}
+
 
 TrajectorySegmentBuilder::TempTrajectoryContainer
 TrajectorySegmentBuilder::addGroup (TempTrajectory const & traj,
@@ -322,6 +331,33 @@ TrajectorySegmentBuilder::updateCandidates (TempTrajectory const & traj,
   //
   // generate updated candidates with all valid hits
   //
+  if ( theBatchUpdator ) {
+    // update the predicted states with all the valid hits at once
+    std::vector<const TSOS*> states;
+    std::vector<const TrackingRecHit*> hits;
+    states.reserve(measurements.size());
+    hits.reserve(measurements.size());
+    for ( auto const & tm : measurements ) {
+      if ( tm.recHit()->isValid() ) {
+	states.push_back(&tm.predictedState());
+	hits.push_back(&tm.recHitR());
+      }
+    }
+    std::vector<TSOS> upStates;
+    upStates.reserve(states.size());
+    theBatchUpdator->update(states,hits,upStates);
+
+    auto upState = upStates.begin();
+    for ( auto const & tm : measurements ) {
+      if ( tm.recHit()->isValid() ) {
+	candidates.push_back(traj);
+	updateTrajectory(candidates.back(),tm,std::move(*upState++));
+	if ( theLockHits )  lockMeasurement(tm);
+      }
+    }
+    return;
+  }
+
   for ( auto im=measurements.begin();
 	im!=measurements.end(); ++im ) {
     if ( im->recHit()->isValid() ) {
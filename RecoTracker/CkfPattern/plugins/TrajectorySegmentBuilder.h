@@ -16,6 +16,7 @@
 
 
 class TrajectoryStateUpdator;
+class KFBatchUpdator;
 class MeasurementEstimator;
 class Trajectory;
 class TrajectoryMeasurement;
@@ -50,7 +51,8 @@ public:
 			    const Propagator& propagator,
 			    const TrajectoryStateUpdator& updator,
 			    const MeasurementEstimator& estimator,
-			    bool lockHits, bool bestHitOnly, int maxCand) :
+			    bool lockHits, bool bestHitOnly, int maxCand,
+			    const KFBatchUpdator* batchUpdator = nullptr) :
     theLayerMeasurements(theInputLayerMeasurements),
     theLayer(layer),
     theFullPropagator(propagator),
@@ -58,6 +60,7 @@ public:
     theEstimator(estimator),
     theGeomPropagator(propagator),
 //     theGeomPropagator(propagator.propagationDirection()),
+      theBatchUpdator(batchUpdator),
       theLockHits(lockHits),theBestHitOnly(bestHitOnly),theMaxCand(maxCand)
   {}
 
@@ -71,6 +74,9 @@ public:
 private:
   /// update of a trajectory with a hit
   void updateTrajectory (TempTrajectory& traj, TM tm) const;
+
+  /// update of a trajectory with a valid hit, with the already updated state
+  void updateTrajectory (TempTrajectory& traj, TM tm, TSOS upState) const;
  
  /// creation of new candidates from a segment and a collection of hits
   void updateCandidates (TempTrajectory const& traj, const std::vector<TM>& measurements,
@@ -112,6 +118,7 @@ private:
   const MeasurementEstimator&   theEstimator;
 //   AnalyticalPropagator theGeomPropagator;
   const Propagator&             theGeomPropagator;
+  const KFBatchUpdator*         theBatchUpdator;
 
   bool theLockHits;
   bool theBestHitOnly;
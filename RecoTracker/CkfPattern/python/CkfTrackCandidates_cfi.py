@@ -16,6 +16,9 @@ ckfTrackCandidates = cms.EDProducer("CkfTrackCandidateMaker",
 #    SeedLabel = cms.string(''),
     maxNSeeds = cms.uint32(500000),
     maxSeedsBeforeCleaning = cms.uint32(5000),
+# If not 0, build the trajectories of blocks of this many seeds in parallel
+# (the result does not depend on the number of threads)
+    parallelSeedBlockSize = cms.uint32(0),
 # SeedProducer:SeedLabel descoped to src
     src = cms.InputTag('globalMixedSeeds'),                                  
     SimpleMagneticField = cms.string(''),                                    
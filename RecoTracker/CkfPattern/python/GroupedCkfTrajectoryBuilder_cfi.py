@@ -24,6 +24,9 @@ GroupedCkfTrajectoryBuilder = cms.PSet(
     lockHits = cms.bool(True),
     TTRHBuilder = cms.string('WithTrackAngle'),
     updator = cms.string('KFUpdator'),
+    # If true (and the updator is a KFUpdator), update the candidates
+    # with all the compatible hits of a layer at once
+    useBatchUpdator = cms.bool(False),
     # If true, track building will allow for possibility of no hit
     # in a given layer, even if it finds compatible hits there.
     alwaysUseInvalidHits = cms.bool(True),
@@ -41,12 +41,9 @@
 
 // #define VI_SORTSEED
 // #define VI_REPRODUCIBLE
-// #define VI_TBB
 
-#include <thread>
-#ifdef VI_TBB
 #include "tbb/parallel_for.h"
-#endif
+#include "tbb/blocked_range.h"
 
 #include "RecoTracker/CkfPattern/interface/PrintoutHelper.h"
 
@@ -78,6 +75,7 @@ namespace cms{
     theNavigationSchool(0),
     theSeedCleaner(0),
     maxSeedsBeforeCleaning_(0),
+    theParallelSeedBlockSize(conf.existsAs<unsigned int>("parallelSeedBlockSize") ? conf.getParameter<unsigned int>("parallelSeedBlockSize") : 0),
     theMTELabel(iC.consumes<MeasurementTrackerEvent>(conf.getParameter<edm::InputTag>("MeasurementTrackerEvent"))),
     skipClusters_(false),
     phase2skipClusters_(false)
@@ -235,10 +233,6 @@ namespace cms{
       // method for debugging
       countSeedsDebugger();
 
-      // the mutex
-      std::mutex theMutex;
-      using Lock = std::unique_lock<std::mutex>;
-
       // Loop over seeds
       size_t collseed_size = collseed->size();
 
@@ -279,36 +273,19 @@ namespace cms{
       // std::cout << spt(indeces[0]) << ' ' << spt(indeces[collseed_size-1]) << std::endl;
 #endif
 
-      std::atomic<unsigned int> ntseed(0);
-      auto theLoop = [&](size_t ii) {
-        auto j = indeces[ii];
-
-        ntseed++;
-
-        // to be moved inside a par section (how with tbb??)
-        std::vector<Trajectory> theTmpTrajectories;
-
+      // Build the trajectories of seed j into theTmpTrajectories (valid ones only).
+      // It touches nothing but its arguments and the stop reason of seed j,
+      // so it can run concurrently for different seeds.
+      auto buildFromSeed = [&](unsigned int j, std::vector<Trajectory> & theTmpTrajectories) {
 
 	LogDebug("CkfPattern") << "======== Begin to look for trajectories from seed " << j << " ========\n";
 
-        { Lock lock(theMutex);
-	// Check if seed hits already used by another track
-	if (theSeedCleaner && !theSeedCleaner->good( &((*collseed)[j])) ) {
-          LogDebug("CkfTrackCandidateMakerBase")<<" Seed cleaning kills seed "<<j;
-          if(produceSeedStopReasons_) (*outputSeedStopReasons)[j] = SeedStopReason::SEED_CLEANING;
-          return;  // from the lambda!
-        }}
-
-
 	// Build trajectory from seed outwards
         theTmpTrajectories.clear();
 	auto const & startTraj = theTrajectoryBuilder->buildTrajectories( (*collseed)[j], theTmpTrajectories, nullptr );
         if(theTmpTrajectories.empty()) {
-          if(produceSeedStopReasons_) {
-            Lock lock(theMutex);
-            (*outputSeedStopReasons)[j] = SeedStopReason::NO_TRAJECTORY;
-          }
-          return; // from the lambda!
+          if(produceSeedStopReasons_) (*outputSeedStopReasons)[j] = SeedStopReason::NO_TRAJECTORY;
+          return;
         }
 
 	LogDebug("CkfPattern") << "======== In-out trajectory building found " << theTmpTrajectories.size()
@@ -345,26 +322,26 @@ namespace cms{
                                << j << " ========\n"
 			       <<PrintoutHelper::dumpCandidates(theTmpTrajectories);
 
-        { Lock lock(theMutex);
-	for(vector<Trajectory>::iterator it=theTmpTrajectories.begin();
-	    it!=theTmpTrajectories.end(); it++){
-	  if( it->isValid() ) {
-	    it->setSeedRef(collseed->refAt(j));
-            if(produceSeedStopReasons_) (*outputSeedStopReasons)[j] = SeedStopReason::NOT_STOPPED;
-	    // Store trajectory
-	    rawResult.push_back(std::move(*it));
-  	    // Tell seed cleaner which hits this trajectory used.
-            //TO BE FIXED: this cut should be configurable via cfi file
-            if (theSeedCleaner && rawResult.back().foundHits()>3) theSeedCleaner->add( &rawResult.back() );
-            //if (theSeedCleaner ) theSeedCleaner->add( & (*it) );
-	  }
-	}}
+        theTmpTrajectories.erase(std::remove_if(theTmpTrajectories.begin(),theTmpTrajectories.end(),
+                                                std::not1(std::mem_fun_ref(&Trajectory::isValid))),
+                                 theTmpTrajectories.end());
+      };
 
+      // Move the trajectories of seed j to rawResult: always called in seed order.
+      auto storeTrajectories = [&](unsigned int j, std::vector<Trajectory> & theTmpTrajectories) {
+	for (auto & traj : theTmpTrajectories) {
+	  traj.setSeedRef(collseed->refAt(j));
+          if(produceSeedStopReasons_) (*outputSeedStopReasons)[j] = SeedStopReason::NOT_STOPPED;
+	  // Store trajectory
+	  rawResult.push_back(std::move(traj));
+	  // Tell seed cleaner which hits this trajectory used.
+          //TO BE FIXED: this cut should be configurable via cfi file
+          if (theSeedCleaner && rawResult.back().foundHits()>3) theSeedCleaner->add( &rawResult.back() );
+	}
         theTmpTrajectories.clear();
 
 	LogDebug("CkfPattern") << "rawResult trajectories found so far = " << rawResult.size();
 
-        { Lock lock(theMutex);
 	if ( maxSeedsBeforeCleaning_ >0 && rawResult.size() > maxSeedsBeforeCleaning_+lastCleanResult) {
           theTrajectoryCleaner->clean(rawResult);
           rawResult.erase(std::remove_if(rawResult.begin()+lastCleanResult,rawResult.end(),
@@ -372,23 +349,55 @@ namespace cms{
 			  rawResult.end());
           lastCleanResult=rawResult.size();
         }
-        }
-
       };
-      // end of loop over seeds
 
+      // Check if seed hits already used by another track
+      auto seedIsClean = [&](unsigned int j) {
+	if (theSeedCleaner && !theSeedCleaner->good( &((*collseed)[j])) ) {
+          LogDebug("CkfTrackCandidateMakerBase")<<" Seed cleaning kills seed "<<j;
+          if(produceSeedStopReasons_) (*outputSeedStopReasons)[j] = SeedStopReason::SEED_CLEANING;
+          return false;
+        }
+        return true;
+      };
 
-#ifdef VI_TBB
-     tbb::parallel_for(0UL,collseed_size,1UL,theLoop);
-#else
-#ifdef VI_OMP
-#pragma omp parallel for schedule(dynamic,4)
-#endif
-      for (size_t j = 0; j < collseed_size; j++){
-       theLoop(j);
+      if (theParallelSeedBlockSize == 0) {
+        std::vector<Trajectory> theTmpTrajectories;
+        for (size_t ii = 0; ii < collseed_size; ++ii) {
+          auto j = indeces[ii];
+          if (!seedIsClean(j)) continue;
+          buildFromSeed(j, theTmpTrajectories);
+          storeTrajectories(j, theTmpTrajectories);
+        }
+      } else {
+        // The seeds are processed in blocks of fixed size: the seeds of a block
+        // not already killed by the seed cleaner are built in parallel into their
+        // own buffers, then the buffers are stored in seed order, checking the
+        // seeds again against the trajectories found earlier in the same block.
+        // The result is the same as in the serial loop for a seed cleaner that
+        // never forgets a trajectory (as all the caching ones), and does not
+        // depend on the number of threads.
+        std::vector<std::vector<Trajectory>> blockTrajectories(std::min<size_t>(theParallelSeedBlockSize, collseed_size));
+        std::vector<char> blockSeedIsClean(blockTrajectories.size());
+        for (size_t first = 0; first < collseed_size; first += theParallelSeedBlockSize) {
+          const size_t n = std::min<size_t>(theParallelSeedBlockSize, collseed_size - first);
+          for (size_t k = 0; k < n; ++k) blockSeedIsClean[k] = seedIsClean(indeces[first+k]);
+          tbb::parallel_for(tbb::blocked_range<size_t>(0, n, 1),
+                            [&](const tbb::blocked_range<size_t> & r) {
+                              for (size_t k = r.begin(); k != r.end(); ++k)
+                                if (blockSeedIsClean[k]) buildFromSeed(indeces[first+k], blockTrajectories[k]);
+                            });
+          for (size_t k = 0; k < n; ++k) {
+            if (!blockSeedIsClean[k]) continue;
+            auto j = indeces[first+k];
+            if (seedIsClean(j))
+              storeTrajectories(j, blockTrajectories[k]);
+            else
+              blockTrajectories[k].clear();
+          }
+        }
       }
-#endif
-      assert(ntseed==collseed_size);
+      // end of loop over seeds
       if (theSeedCleaner) theSeedCleaner->done();
 
       // std::cout << "VICkfPattern " << "rawResult trajectories found = " << rawResult.size() << " in " << ntseed << " seeds " << collseed_size << std::endl;
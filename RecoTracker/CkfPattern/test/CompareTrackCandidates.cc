@@ -0,0 +1,65 @@
+// File: CompareTrackCandidates.cc
+// Description: check that two collections of track candidates are the same,
+// candidate by candidate: seed, stop reason, final state and hits, in order.
+// Throws at the first difference.
+//--------------------------------------------
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/Utilities/interface/InputTag.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+
+#include "DataFormats/TrackCandidate/interface/TrackCandidateCollection.h"
+
+class CompareTrackCandidates : public edm::global::EDAnalyzer<> {
+public:
+  explicit CompareTrackCandidates(const edm::ParameterSet& conf) :
+    refToken_(consumes<TrackCandidateCollection>(conf.getParameter<edm::InputTag>("reference"))),
+    testToken_(consumes<TrackCandidateCollection>(conf.getParameter<edm::InputTag>("test"))) {}
+
+  void analyze(edm::StreamID, const edm::Event& ev, const edm::EventSetup&) const override;
+
+private:
+  const edm::EDGetTokenT<TrackCandidateCollection> refToken_;
+  const edm::EDGetTokenT<TrackCandidateCollection> testToken_;
+};
+
+void CompareTrackCandidates::analyze(edm::StreamID, const edm::Event& ev, const edm::EventSetup&) const {
+  edm::Handle<TrackCandidateCollection> ref, test;
+  ev.getByToken(refToken_, ref);
+  ev.getByToken(testToken_, test);
+
+  if (ref->size() != test->size())
+    throw cms::Exception("CompareTrackCandidates") << "different number of candidates: " << ref->size() << ' ' << test->size();
+  unsigned int nHits = 0;
+  for (unsigned int i = 0; i < ref->size(); ++i) {
+    auto const & a = (*ref)[i];
+    auto const & b = (*test)[i];
+    if (a.seedRef().key() != b.seedRef().key() || a.nLoops() != b.nLoops() || a.stopReason() != b.stopReason())
+      throw cms::Exception("CompareTrackCandidates") << "different seed or stop reason for candidate " << i;
+
+    auto const & sa = a.trajectoryStateOnDet();
+    auto const & sb = b.trajectoryStateOnDet();
+    bool same = sa.detId() == sb.detId() && sa.surfaceSide() == sb.surfaceSide() && sa.pt() == sb.pt() &&
+                sa.parameters().vector() == sb.parameters().vector() && sa.parameters().pzSign() == sb.parameters().pzSign();
+    for (int k = 0; same && k < 15; ++k) same = sa.error(k) == sb.error(k);
+    if (!same)
+      throw cms::Exception("CompareTrackCandidates") << "different state for candidate " << i;
+
+    auto ha = a.recHits(), hb = b.recHits();
+    if (ha.second - ha.first != hb.second - hb.first)
+      throw cms::Exception("CompareTrackCandidates") << "different number of hits for candidate " << i;
+    for (auto ia = ha.first, ib = hb.first; ia != ha.second; ++ia, ++ib) {
+      if (ia->geographicalId() != ib->geographicalId() || ia->getType() != ib->getType() ||
+	  (ia->isValid() && !ia->sharesInput(&*ib, TrackingRecHit::all)))
+	throw cms::Exception("CompareTrackCandidates") << "different hit " << ia - ha.first << " for candidate " << i;
+    }
+    nHits += ha.second - ha.first;
+  }
+
+  LogDebug("CompareTrackCandidates") << ref->size() << " candidates, " << nHits << " hits";
+}
+
+DEFINE_FWK_MODULE(CompareTrackCandidates);
@@ -0,0 +1,63 @@
+# check that CkfTrackCandidateMaker gives the same track candidates when the
+# seeds are built in parallel blocks and in the serial loop, with the strip
+# clusters unpacked on demand during the trajectory building
+# (CompareTrackCandidates throws at the first difference)
+#
+#   cmsRun testParallelSeedBlocks_cfg.py inputFiles=file:step2.root globalTag=<GT of step2>
+##############################################################################
+
+import FWCore.ParameterSet.Config as cms
+from FWCore.ParameterSet.VarParsing import VarParsing
+
+options = VarParsing('analysis')
+options.register('globalTag', '', VarParsing.multiplicity.singleton, VarParsing.varType.string,
+                 "global tag used to make the input")
+options.parseArguments()
+
+process = cms.Process("ParallelSeedBlocksTest")
+
+process.load("FWCore.MessageLogger.MessageLogger_cfi")
+process.load("Configuration.StandardSequences.GeometryRecoDB_cff")
+process.load("Configuration.StandardSequences.MagneticField_cff")
+process.load("Configuration.StandardSequences.FrontierConditions_GlobalTag_cff")
+process.load("Configuration.StandardSequences.Services_cff")
+process.load("Configuration.StandardSequences.RawToDigi_cff")
+process.load("Configuration.StandardSequences.Reconstruction_cff")
+import RecoLocalTracker.SiStripClusterizer.SiStripClusterizerOnDemand_cfi as onDemand_cfi
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(options.maxEvents)
+)
+
+# several threads, so that the seeds of a block are built concurrently
+process.options = cms.untracked.PSet(
+    numberOfThreads = cms.untracked.uint32(4),
+    numberOfStreams = cms.untracked.uint32(0)
+)
+
+process.source = cms.Source("PoolSource",
+  fileNames = cms.untracked.vstring(options.inputFiles)
+)
+
+process.GlobalTag.globaltag = options.globalTag
+
+# the strip clusters of a module are made at the first access to it
+process.siStripClusters = onDemand_cfi.siStripClusters.clone()
+process.MeasurementTrackerEvent.inactiveStripDetectorLabels = cms.VInputTag()
+
+# the default (reference) is the serial loop over the seeds; the test builds them in blocks
+process.initialStepTrackCandidatesBlocks = process.initialStepTrackCandidates.clone(
+    parallelSeedBlockSize = 16
+)
+
+process.compare = cms.EDAnalyzer("CompareTrackCandidates",
+    reference = cms.InputTag("initialStepTrackCandidates"),
+    test = cms.InputTag("initialStepTrackCandidatesBlocks")
+)
+
+process.p = cms.Path(process.siPixelDigis*process.siPixelClusters*process.siPixelClusterShapeCache*process.siPixelRecHits
+                     *process.siStripClusters*process.offlineBeamSpot*process.MeasurementTrackerEvent
+                     *process.initialStepSeedLayers*process.initialStepTrackingRegions
+                     *process.initialStepHitDoublets*process.initialStepHitTriplets*process.initialStepSeeds
+                     *process.initialStepTrackCandidates*process.initialStepTrackCandidatesBlocks
+                     *process.compare)
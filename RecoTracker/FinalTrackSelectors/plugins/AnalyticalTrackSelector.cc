@@ -301,8 +301,11 @@ void AnalyticalTrackSelector::run( edm::Event& evt, const edm::EventSetup& es )
 
   if (copyTrajectories_) trackRefs_.resize(hSrcTrack->size());
 
+  TrackSelectionSummary summary;
+  fillSummary(hSrcTrack, srcHits, vertexBeamSpot, useVertices_ ? hVtx.product() : nullptr, summary);
+
   std::vector<float>  mvaVals_(hSrcTrack->size(),-99.f);
-  processMVA(evt,es,vertexBeamSpot,*(hVtx.product()),0,mvaVals_,true);
+  processMVA(evt,es,summary,0,mvaVals_,true);
 
   // Loop over tracks
   size_t current = 0;
@@ -314,7 +317,7 @@ void AnalyticalTrackSelector::run( edm::Event& evt, const edm::EventSetup& es )
 
     float mvaVal = 0;
     if(useAnyMVA_)mvaVal = mvaVals_[current];
-    bool ok = select(0,vertexBeamSpot, srcHits, trk, points, vterr, vzerr,mvaVal);
+    bool ok = select(0,vertexBeamSpot, summary, current, trk, points, vterr, vzerr,mvaVal);
     if (!ok) {
 
       LogTrace("TrackSelection") << "track with pt="<< trk.pt() << " NOT selected";
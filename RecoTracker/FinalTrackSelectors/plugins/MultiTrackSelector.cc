@@ -252,9 +252,13 @@ void MultiTrackSelector::run( edm::Event& evt, const edm::EventSetup& es ) const
   std::vector<float> vterr, vzerr;
   if (useVertices_) selectVertices(0,*hVtx, points, vterr, vzerr);
   //auto vtxP = points.empty() ? vertexBeamSpot.position() : points[0]; // rare, very rare, still happens!
+
+  TrackSelectionSummary summary;
+  fillSummary(hSrcTrack, srcHits, vertexBeamSpot, useVertices_ ? hVtx.product() : nullptr, summary);
+
   for (unsigned int i=0; i<qualityToSet_.size(); i++) {  
     std::vector<float> mvaVals_(srcTracks.size(),-99.f);
-    processMVA(evt,es,vertexBeamSpot,*(hVtx.product()), i, mvaVals_, i == 0 ? true : false);
+    processMVA(evt,es,summary, i, mvaVals_, i == 0 ? true : false);
     std::vector<int> selTracks(trkSize,0);
     auto selTracksValueMap = std::make_unique<edm::ValueMap<int>>();
     edm::ValueMap<int>::Filler filler(*selTracksValueMap);
@@ -280,7 +284,7 @@ void MultiTrackSelector::run( edm::Event& evt, const edm::EventSetup& es ) const
       else {
 	float mvaVal = 0;
 	if(useAnyMVA_) mvaVal = mvaVals_[current];
-	ok = select(i,vertexBeamSpot, srcHits, trk, points, vterr, vzerr,mvaVal);
+	ok = select(i,vertexBeamSpot, summary, current, trk, points, vterr, vzerr,mvaVal);
 	if (!ok) { 
 	  LogTrace("TrackSelection") << "track with pt="<< trk.pt() << " NOT selected";
 	  if (!keepAllTracks_[i]) { 
@@ -331,24 +335,50 @@ void MultiTrackSelector::run( edm::Event& evt, const edm::EventSetup& es ) const
 }
 
 
+ void MultiTrackSelector::fillSummary(const edm::Handle<reco::TrackCollection> &hSrcTrack,
+				      const TrackingRecHitCollection & recHits,
+				      const reco::BeamSpot &vertexBeamSpot,
+				      const reco::VertexCollection *vertices,
+				      TrackSelectionSummary &summary) const {
+  const TrackCollection& srcTracks(*hSrcTrack);
+  summary.fill(srcTracks, recHits, vertexBeamSpot);
+  if (!useAnyMVA_) return;
+
+  // the impact parameters w.r.t. the best vertex are only used by the MVA
+  const unsigned int n = srcTracks.size();
+  summary.absd0PV.resize(n);
+  summary.absdzPV.resize(n);
+  const VertexCollection noVertices;
+  edm::RefToBaseProd<Track> rtbpTrackCollection(hSrcTrack);
+  for (unsigned int i = 0; i < n; ++i) {
+    const Track & trk = srcTracks[i];
+    Point bestVertex = getBestVertex(edm::RefToBase<Track>(rtbpTrackCollection,i), vertices ? *vertices : noVertices);
+    summary.absd0PV[i] = fabs(trk.dxy(bestVertex));
+    summary.absdzPV[i] = fabs(trk.dz(bestVertex));
+  }
+}
+
+
  bool MultiTrackSelector::select(unsigned int tsNum, 
 				 const reco::BeamSpot &vertexBeamSpot,
-        	       	       	 const TrackingRecHitCollection & recHits,
+				 const TrackSelectionSummary &summary,
+				 unsigned int iTrack,
 				 const reco::Track &tk, 
 				 const std::vector<Point> &points,
 				 std::vector<float> &vterr,
 				 std::vector<float> &vzerr,
 				 double mvaVal) const {
   // Decide if the given track passes selection cuts.
+  // The track quantities are read from the summary, "tk" is only used for the vertex compatibility.
 
   using namespace std; 
   
   //cuts on number of valid hits
-  auto nhits = tk.numberOfValidHits();
+  auto nhits = summary.nhits[iTrack];
   if(nhits>=min_hits_bypass_[tsNum]) return true;
   if(nhits < min_nhits_[tsNum]) return false;
 
-  if ( tk.ndof() < 1E-5 ) return false;
+  if ( summary.ndof[iTrack] < 1E-5 ) return false;
 
 
   //////////////////////////////////////////////////
@@ -364,10 +394,9 @@ void MultiTrackSelector::run( edm::Event& evt, const edm::EventSetup& es ) const
 
 
   // Cuts on numbers of layers with hits/3D hits/lost hits.
-  uint32_t nlayers     = tk.hitPattern().trackerLayersWithMeasurement();
-  uint32_t nlayers3D   = tk.hitPattern().pixelLayersWithMeasurement() +
-    tk.hitPattern().numberOfValidStripLayersWithMonoAndStereo();
-  uint32_t nlayersLost = tk.hitPattern().trackerLayersWithoutMeasurement(reco::HitPattern::TRACK_HITS);
+  uint32_t nlayers     = summary.nlayers[iTrack];
+  uint32_t nlayers3D   = summary.nlayers3D[iTrack];
+  uint32_t nlayersLost = summary.nlayersLost[iTrack];
   LogDebug("TrackSelection") << "cuts on nlayers: " << nlayers << " " << nlayers3D << " " << nlayersLost << " vs " 
 			     << min_layers_[tsNum] << " " << min_3Dlayers_[tsNum] << " " << max_lostLayers_[tsNum];
   if (nlayers < min_layers_[tsNum]) return false;
@@ -375,48 +404,26 @@ void MultiTrackSelector::run( edm::Event& evt, const edm::EventSetup& es ) const
   if (nlayersLost > max_lostLayers_[tsNum]) return false;
   LogTrace("TrackSelection") << "cuts on nlayers passed";
 
-  float chi2n =  tk.normalizedChi2();
-  float chi2n_no1Dmod = chi2n;
+  if (summary.chi2n[iTrack] > chi2n_par_[tsNum]*nlayers) return false;
 
-  int count1dhits = 0;
-  auto ith = tk.extra()->firstRecHit();
-  auto  edh = ith + tk.recHitsSize();
-  for (; ith<edh; ++ith) {
-    const TrackingRecHit & hit = recHits[ith];
-    if (hit.dimension()==1) ++count1dhits;
-  }
-  if (count1dhits > 0) {
-    float chi2 = tk.chi2();
-    float ndof = tk.ndof();
-    chi2n = (chi2+count1dhits)/float(ndof+count1dhits);
-  }
-  // For each 1D rechit, the chi^2 and ndof is increased by one.  This is a way of retaining approximately
-  // the same normalized chi^2 distribution as with 2D rechits.
-  if (chi2n > chi2n_par_[tsNum]*nlayers) return false;
-
-  if (chi2n_no1Dmod > chi2n_no1Dmod_par_[tsNum]*nlayers) return false;
+  if (summary.chi2n_no1Dmod[iTrack] > chi2n_no1Dmod_par_[tsNum]*nlayers) return false;
 
   // Get track parameters
-  float pt = std::max(float(tk.pt()),0.000001f);
-  float eta = tk.eta();
+  float pt = std::max(summary.pt[iTrack],0.000001f);
+  float eta = summary.eta[iTrack];
   if (eta<min_eta_[tsNum] || eta>max_eta_[tsNum]) return false;
 
   //cuts on relative error on pt
-  float relpterr = float(tk.ptError())/pt;
-  if(relpterr > max_relpterr_[tsNum]) return false;
+  if(summary.relpterr[iTrack] > max_relpterr_[tsNum]) return false;
 
-  int lostIn = tk.hitPattern().numberOfLostTrackerHits(reco::HitPattern::MISSING_INNER_HITS);
-  int lostOut = tk.hitPattern().numberOfLostTrackerHits(reco::HitPattern::MISSING_OUTER_HITS);
-  int minLost = std::min(lostIn,lostOut);
-  if (minLost > max_minMissHitOutOrIn_[tsNum]) return false;
-  float lostMidFrac = tk.numberOfLostHits() / (tk.numberOfValidHits() + tk.numberOfLostHits());
-  if (lostMidFrac > max_lostHitFraction_[tsNum]) return false;
+  if (summary.minLost[iTrack] > max_minMissHitOutOrIn_[tsNum]) return false;
+  if (summary.lostMidFrac[iTrack] > max_lostHitFraction_[tsNum]) return false;
 
 
 
   //other track parameters
-  float d0 = -tk.dxy(vertexBeamSpot.position()), d0E =  tk.d0Error(),
-    dz = tk.dz(vertexBeamSpot.position()), dzE =  tk.dzError();
+  float d0 = summary.d0[iTrack], d0E = summary.d0E[iTrack],
+    dz = summary.dz[iTrack], dzE = summary.dzE[iTrack];
 
   // parametrized d0 resolution for the track pt
   float nomd0E = sqrt(res_par_[tsNum][0]*res_par_[tsNum][0]+(res_par_[tsNum][1]/pt)*(res_par_[tsNum][1]/pt));
@@ -510,7 +517,7 @@ void MultiTrackSelector::run( edm::Event& evt, const edm::EventSetup& es ) const
   }
 }
 
-void MultiTrackSelector::processMVA(edm::Event& evt, const edm::EventSetup& es, const reco::BeamSpot& beamspot,const reco::VertexCollection& vertices, int selIndex, std::vector<float> & mvaVals_, bool writeIt) const
+void MultiTrackSelector::processMVA(edm::Event& evt, const edm::EventSetup& es, const TrackSelectionSummary &summary, int selIndex, std::vector<float> & mvaVals_, bool writeIt) const
 {
 
   using namespace std; 
@@ -520,14 +527,7 @@ void MultiTrackSelector::processMVA(edm::Event& evt, const edm::EventSetup& es,
   // Get tracks 
   Handle<TrackCollection> hSrcTrack;
   evt.getByToken( src_, hSrcTrack );
-  const TrackCollection& srcTracks(*hSrcTrack);
-  RefToBaseProd<Track> rtbpTrackCollection(hSrcTrack);
-  assert(mvaVals_.size()==srcTracks.size());
-
- // get hits in track..
-  Handle<TrackingRecHitCollection> hSrcHits;
-  evt.getByToken( hSrc_, hSrcHits );
-  const TrackingRecHitCollection & srcHits(*hSrcHits);
+  assert(mvaVals_.size()==summary.size());
   
   
   auto mvaValValueMap = std::make_unique<edm::ValueMap<float>>();
@@ -546,82 +546,13 @@ void MultiTrackSelector::processMVA(edm::Event& evt, const edm::EventSetup& es,
 
   if(!useMVA_[selIndex] && !writeIt)return;
 
-
-  size_t current = 0;
-  for (TrackCollection::const_iterator it = srcTracks.begin(), ed = srcTracks.end(); it != ed; ++it, ++current) {
-    const Track & trk = * it;
-    RefToBase<Track> trackRef(rtbpTrackCollection,current);
-    auto tmva_ndof_ = trk.ndof();
-    auto tmva_nlayers_ = trk.hitPattern().trackerLayersWithMeasurement();
-    auto tmva_nlayers3D_ = trk.hitPattern().pixelLayersWithMeasurement()
-        + trk.hitPattern().numberOfValidStripLayersWithMonoAndStereo();
-    auto tmva_nlayerslost_ = trk.hitPattern().trackerLayersWithoutMeasurement(reco::HitPattern::TRACK_HITS);
-    float chi2n =  trk.normalizedChi2();
-    float chi2n_no1Dmod = chi2n;
-    
-    int count1dhits = 0;
-    auto ith = trk.extra()->firstRecHit();
-    auto  edh = ith + trk.recHitsSize();
-    for (; ith<edh; ++ith) {
-      const TrackingRecHit & hit = srcHits[ith];
-      if (hit.dimension()==1) ++count1dhits;
-    }
-    if (count1dhits > 0) {
-      float chi2 = trk.chi2();
-      float ndof = trk.ndof();
-      chi2n = (chi2+count1dhits)/float(ndof+count1dhits);
-    }
-    auto tmva_chi2n_ = chi2n;
-    auto tmva_chi2n_no1dmod_ = chi2n_no1Dmod;
-    auto tmva_eta_ = trk.eta();
-    auto tmva_relpterr_ = float(trk.ptError())/std::max(float(trk.pt()),0.000001f);
-    auto tmva_nhits_ = trk.numberOfValidHits();
-    int lostIn = trk.hitPattern().numberOfLostTrackerHits(reco::HitPattern::MISSING_INNER_HITS);
-    int lostOut = trk.hitPattern().numberOfLostTrackerHits(reco::HitPattern::MISSING_OUTER_HITS);
-    auto tmva_minlost_ = std::min(lostIn,lostOut);
-    auto tmva_lostmidfrac_ = trk.numberOfLostHits() / (trk.numberOfValidHits() + trk.numberOfLostHits());
-    auto tmva_absd0_ = fabs(-trk.dxy(beamspot.position()));
-    auto tmva_absdz_ = fabs(trk.dz(beamspot.position()));
-    Point bestVertex = getBestVertex(trackRef,vertices);
-    auto tmva_absd0PV_ = fabs(trk.dxy(bestVertex));
-    auto tmva_absdzPV_ = fabs(trk.dz(bestVertex));
-    auto tmva_pt_ = trk.pt();
-
-    GBRForest const * forest = forest_[selIndex];
-    if(useForestFromDB_){
-      edm::ESHandle<GBRForest> forestHandle;
-      es.get<GBRWrapperRcd>().get(forestLabel_[selIndex],forestHandle);
-      forest = forestHandle.product();
-    }
-
-    float gbrVals_[16];
-    gbrVals_[0] = tmva_pt_;
-    gbrVals_[1] = tmva_lostmidfrac_;
-    gbrVals_[2] = tmva_minlost_;
-    gbrVals_[3] = tmva_nhits_;
-    gbrVals_[4] = tmva_relpterr_;
-    gbrVals_[5] = tmva_eta_;
-    gbrVals_[6] = tmva_chi2n_no1dmod_;
-    gbrVals_[7] = tmva_chi2n_;
-    gbrVals_[8] = tmva_nlayerslost_;
-    gbrVals_[9] = tmva_nlayers3D_;
-    gbrVals_[10] = tmva_nlayers_;
-    gbrVals_[11] = tmva_ndof_;
-    gbrVals_[12] = tmva_absd0PV_;
-    gbrVals_[13] = tmva_absdzPV_;
-    gbrVals_[14] = tmva_absdz_;
-    gbrVals_[15] = tmva_absd0_;
-
-    if (mvaType_[selIndex] == "Prompt"){      
-      auto gbrVal = forest->GetClassifier(gbrVals_);
-      mvaVals_[current] = gbrVal;
-    }else{
-      float detachedGbrVals_[12];
-      for(int jjj = 0; jjj < 12; jjj++)detachedGbrVals_[jjj] = gbrVals_[jjj];
-      auto gbrVal = forest->GetClassifier(detachedGbrVals_);
-      mvaVals_[current] = gbrVal;
-    }
+  GBRForest const * forest = forest_[selIndex];
+  if(useForestFromDB_){
+    edm::ESHandle<GBRForest> forestHandle;
+    es.get<GBRWrapperRcd>().get(forestLabel_[selIndex],forestHandle);
+    forest = forestHandle.product();
   }
+  evaluateMVA(summary, *forest, selIndex, mvaVals_);
 
   if(writeIt){
     mvaFiller.insert(hSrcTrack,mvaVals_.begin(),mvaVals_.end());
@@ -633,7 +564,36 @@ void MultiTrackSelector::processMVA(edm::Event& evt, const edm::EventSetup& es,
 
 }
 
-MultiTrackSelector::Point MultiTrackSelector::getBestVertex(TrackBaseRef track,VertexCollection vertices) const {
+void MultiTrackSelector::evaluateMVA(const TrackSelectionSummary &summary, const GBRForest &forest, int selIndex, std::vector<float> & mvaVals_) const
+{
+  // the detached MVA uses only the first 12 variables
+  const bool prompt = mvaType_[selIndex] == "Prompt";
+
+  for (unsigned int current = 0, n = summary.size(); current < n; ++current) {
+    float gbrVals_[16];
+    gbrVals_[0] = summary.pt[current];
+    gbrVals_[1] = summary.lostMidFrac[current];
+    gbrVals_[2] = summary.minLost[current];
+    gbrVals_[3] = summary.nhits[current];
+    gbrVals_[4] = summary.relpterr[current];
+    gbrVals_[5] = summary.eta[current];
+    gbrVals_[6] = summary.chi2n_no1Dmod[current];
+    gbrVals_[7] = summary.chi2n[current];
+    gbrVals_[8] = summary.nlayersLost[current];
+    gbrVals_[9] = summary.nlayers3D[current];
+    gbrVals_[10] = summary.nlayers[current];
+    gbrVals_[11] = summary.ndof[current];
+    if (prompt) {
+      gbrVals_[12] = summary.absd0PV[current];
+      gbrVals_[13] = summary.absdzPV[current];
+      gbrVals_[14] = fabs(summary.dz[current]);
+      gbrVals_[15] = fabs(summary.d0[current]);
+    }
+    mvaVals_[current] = forest.GetClassifier(gbrVals_);
+  }
+}
+
+MultiTrackSelector::Point MultiTrackSelector::getBestVertex(const TrackBaseRef & track,const VertexCollection & vertices) const {
   Point p(0,0,-99999);
   Point p_dz(0,0,-99999);
   float bestWeight = 0;
@@ -31,6 +31,7 @@
 #include "DataFormats/TrackerRecHit2D/interface/SiStripRecHit1D.h"
 #include "CommonTools/Utils/interface/StringCutObjectSelector.h"
 #include "CondFormats/EgammaObjects/interface/GBRForest.h"
+#include "TrackSelectionSummary.h"
 
     class dso_hidden MultiTrackSelector : public edm::stream::EDProducer<> {
         private:
@@ -61,10 +62,18 @@
             }
             virtual void run( edm::Event& evt, const edm::EventSetup& es ) const;
 
+            /// fill the per-track quantities used by select and processMVA, once per event
+            void fillSummary(const edm::Handle<reco::TrackCollection> &hSrcTrack,
+                             const TrackingRecHitCollection & recHits,
+                             const reco::BeamSpot &vertexBeamSpot,
+                             const reco::VertexCollection *vertices,
+                             TrackSelectionSummary &summary) const;
+
             /// return class, or -1 if rejected
             bool select (unsigned tsNum,
 			 const reco::BeamSpot &vertexBeamSpot,
-                         const TrackingRecHitCollection & recHits,
+                         const TrackSelectionSummary &summary,
+                         unsigned int iTrack,
 			 const reco::Track &tk, 
 			 const std::vector<Point> &points,
 			 std::vector<float> &vterr,
@@ -76,8 +85,10 @@
 				  std::vector<float> &vterr,
 				  std::vector<float> &vzerr) const;
 
-	    void processMVA(edm::Event& evt, const edm::EventSetup& es,const  reco::BeamSpot& beamspot,const reco::VertexCollection& vertices, int selIndex, std::vector<float> & mvaVals_, bool writeIt=false) const;
-	    Point getBestVertex(const reco::TrackBaseRef,const reco::VertexCollection) const;
+	    void processMVA(edm::Event& evt, const edm::EventSetup& es, const TrackSelectionSummary &summary, int selIndex, std::vector<float> & mvaVals_, bool writeIt=false) const;
+	    /// the MVA values of the selection set selIndex from the summary
+	    void evaluateMVA(const TrackSelectionSummary &summary, const GBRForest &forest, int selIndex, std::vector<float> & mvaVals_) const;
+	    Point getBestVertex(const reco::TrackBaseRef &,const reco::VertexCollection &) const;
 
             /// source collection label
             edm::EDGetTokenT<reco::TrackCollection> src_;
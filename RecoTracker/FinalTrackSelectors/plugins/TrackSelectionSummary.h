@@ -0,0 +1,94 @@
+#ifndef RecoTracker_FinalTrackSelectors_TrackSelectionSummary_h
+#define RecoTracker_FinalTrackSelectors_TrackSelectionSummary_h
+
+#include "DataFormats/TrackReco/interface/Track.h"
+#include "DataFormats/TrackReco/interface/TrackFwd.h"
+#include "DataFormats/BeamSpot/interface/BeamSpot.h"
+#include "DataFormats/TrackingRecHit/interface/TrackingRecHitFwd.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// Structure of arrays of the track quantities used by the cut based and MVA
+// selections, one element per track of the source collection. It is filled
+// once per event, and shared by all the selection sets of a selector, that
+// would otherwise recompute the hit pattern counts and the chi2 for each set.
+struct TrackSelectionSummary {
+
+  void fill(const reco::TrackCollection & tracks,
+            const TrackingRecHitCollection & recHits,
+            const reco::BeamSpot & beamSpot) {
+    const unsigned int n = tracks.size();
+    nhits.resize(n); ndof.resize(n);
+    nlayers.resize(n); nlayers3D.resize(n); nlayersLost.resize(n);
+    chi2n.resize(n); chi2n_no1Dmod.resize(n);
+    pt.resize(n); eta.resize(n); relpterr.resize(n);
+    minLost.resize(n); lostMidFrac.resize(n);
+    d0.resize(n); d0E.resize(n); dz.resize(n); dzE.resize(n);
+    absd0PV.clear(); absdzPV.clear();
+
+    for (unsigned int i = 0; i < n; ++i) {
+      const reco::Track & tk = tracks[i];
+      const reco::HitPattern & hp = tk.hitPattern();
+      nhits[i] = tk.numberOfValidHits();
+      ndof[i] = tk.ndof();
+      nlayers[i] = hp.trackerLayersWithMeasurement();
+      nlayers3D[i] = hp.pixelLayersWithMeasurement() + hp.numberOfValidStripLayersWithMonoAndStereo();
+      nlayersLost[i] = hp.trackerLayersWithoutMeasurement(reco::HitPattern::TRACK_HITS);
+
+      // For each 1D rechit, the chi^2 and ndof is increased by one.  This is a way of retaining approximately
+      // the same normalized chi^2 distribution as with 2D rechits.
+      float chi2 = tk.normalizedChi2();
+      chi2n_no1Dmod[i] = chi2;
+      int count1dhits = 0;
+      auto ith = tk.extra()->firstRecHit();
+      auto edh = ith + tk.recHitsSize();
+      for (; ith<edh; ++ith) {
+        if (recHits[ith].dimension()==1) ++count1dhits;
+      }
+      if (count1dhits > 0) {
+        float tchi2 = tk.chi2();
+        float tndof = tk.ndof();
+        chi2 = (tchi2+count1dhits)/float(tndof+count1dhits);
+      }
+      chi2n[i] = chi2;
+
+      pt[i] = tk.pt();
+      eta[i] = tk.eta();
+      relpterr[i] = float(tk.ptError())/std::max(pt[i],0.000001f);
+
+      int lostIn = hp.numberOfLostTrackerHits(reco::HitPattern::MISSING_INNER_HITS);
+      int lostOut = hp.numberOfLostTrackerHits(reco::HitPattern::MISSING_OUTER_HITS);
+      minLost[i] = std::min(lostIn,lostOut);
+      lostMidFrac[i] = tk.numberOfLostHits() / (tk.numberOfValidHits() + tk.numberOfLostHits());
+
+      d0[i] = -tk.dxy(beamSpot.position());
+      d0E[i] = tk.d0Error();
+      dz[i] = tk.dz(beamSpot.position());
+      dzE[i] = tk.dzError();
+    }
+  }
+
+  unsigned int size() const { return pt.size(); }
+
+  std::vector<uint32_t> nhits;
+  std::vector<float> ndof;
+  std::vector<uint32_t> nlayers;
+  std::vector<uint32_t> nlayers3D;
+  std::vector<uint32_t> nlayersLost;
+  std::vector<float> chi2n;          // with the 1D hits counted as 2D ones
+  std::vector<float> chi2n_no1Dmod;
+  std::vector<float> pt;             // not bounded from below
+  std::vector<float> eta;
+  std::vector<float> relpterr;
+  std::vector<int> minLost;          // min of the missing inner and outer hits
+  std::vector<float> lostMidFrac;
+  std::vector<float> d0, d0E;        // w.r.t. the beam spot
+  std::vector<float> dz, dzE;
+  // w.r.t. the best vertex, filled only when an MVA is evaluated
+  std::vector<float> absd0PV, absdzPV;
+};
+
+#endif
@@ -0,0 +1,590 @@
+// MultiTrackSelector::select and evaluateMVA on the TrackSelectionSummary
+// against the per-track computation they replaced, on tracks with 1D strip
+// hits and lost hits and with the MVA enabled: the quality masks and the MVA
+// values must be the same bit for bit
+
+#include "RecoTracker/FinalTrackSelectors/plugins/MultiTrackSelector.cc"
+
+#include "DataFormats/Common/interface/TestHandle.h"
+#include "DataFormats/Provenance/interface/Provenance.h"
+#include "DataFormats/SiPixelDetId/interface/PixelSubdetector.h"
+#include "DataFormats/SiStripDetId/interface/StripSubdetector.h"
+#include "DataFormats/TrackingRecHit/interface/InvalidTrackingRecHit.h"
+
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+  std::mt19937 rng(5050);
+
+  double flat(double a, double b) { return std::uniform_real_distribution<double>(a,b)(rng); }
+  double gauss(double mean, double sigma) { return std::normal_distribution<double>(mean,sigma)(rng); }
+  int uniform(int a, int b) { return std::uniform_int_distribution<int>(a,b)(rng); }
+
+  // valid hit of the given dimension, only its dimension is used by the selection
+  class FakeHit final : public TrackingRecHit {
+  public:
+    FakeHit(DetId id, int dim) : TrackingRecHit(id), dim_(dim) {}
+    FakeHit * clone() const override { return new FakeHit(*this); }
+    AlgebraicVector parameters() const override { return AlgebraicVector(dim_); }
+    AlgebraicSymMatrix parametersError() const override { return AlgebraicSymMatrix(dim_); }
+    AlgebraicMatrix projectionMatrix() const override { return AlgebraicMatrix(dim_,5); }
+    int dimension() const override { return dim_; }
+    std::vector<const TrackingRecHit*> recHits() const override { return std::vector<const TrackingRecHit*>(); }
+    std::vector<TrackingRecHit*> recHits() override { return std::vector<TrackingRecHit*>(); }
+    LocalPoint localPosition() const override { return LocalPoint(); }
+    LocalError localPositionError() const override { return LocalError(); }
+  private:
+    int dim_;
+  };
+
+  // the selector, with select and processMVA as they computed the track
+  // quantities for each track and each selection set
+  class TestMultiTrackSelector : public MultiTrackSelector {
+  public:
+    using MultiTrackSelector::MultiTrackSelector;
+    using MultiTrackSelector::fillSummary;
+    using MultiTrackSelector::select;
+    using MultiTrackSelector::selectVertices;
+    using MultiTrackSelector::evaluateMVA;
+
+    unsigned int nSets() const { return qualityToSet_.size(); }
+    bool evaluatesMVA(unsigned int i) const { return useMVA_[i] || (useAnyMVA_ && i==0); }
+    bool prompt(unsigned int i) const { return mvaType_[i] == "Prompt"; }
+    reco::TrackBase::TrackQuality qualityToSet(unsigned int i) const { return qualityToSet_[i]; }
+
+    bool selectPerTrack(unsigned int tsNum,
+                        const reco::BeamSpot &vertexBeamSpot,
+                        const TrackingRecHitCollection & recHits,
+                        const reco::Track &tk,
+                        const std::vector<Point> &points,
+                        std::vector<float> &vterr,
+                        std::vector<float> &vzerr,
+                        double mvaVal) const;
+
+    void processMVAPerTrack(const edm::Handle<reco::TrackCollection> &hSrcTrack,
+                            const TrackingRecHitCollection & srcHits,
+                            const reco::BeamSpot& beamspot,
+                            const reco::VertexCollection& vertices,
+                            const GBRForest & forest,
+                            int selIndex, std::vector<float> & mvaVals_) const;
+
+    // the quality masks of the selection set i, as filled by run from the decisions of select
+    template<typename Select>
+    void qualities(unsigned int i, const reco::TrackCollection & srcTracks, const std::vector<Point> & points,
+                   std::vector<int> & selTracksSave, Select select) const;
+  };
+
+  bool TestMultiTrackSelector::selectPerTrack(unsigned int tsNum,
+                                              const reco::BeamSpot &vertexBeamSpot,
+                                              const TrackingRecHitCollection & recHits,
+                                              const reco::Track &tk,
+                                              const std::vector<Point> &points,
+                                              std::vector<float> &vterr,
+                                              std::vector<float> &vzerr,
+                                              double mvaVal) const {
+    using namespace std;
+
+    auto nhits = tk.numberOfValidHits();
+    if(nhits>=min_hits_bypass_[tsNum]) return true;
+    if(nhits < min_nhits_[tsNum]) return false;
+
+    if ( tk.ndof() < 1E-5 ) return false;
+
+    if(useAnyMVA_ && useMVA_[tsNum]){
+      if (useMVAonly_[tsNum]) return mvaVal > min_MVA_[tsNum];
+      if(mvaVal < min_MVA_[tsNum])return false;
+    }
+
+    uint32_t nlayers     = tk.hitPattern().trackerLayersWithMeasurement();
+    uint32_t nlayers3D   = tk.hitPattern().pixelLayersWithMeasurement() +
+      tk.hitPattern().numberOfValidStripLayersWithMonoAndStereo();
+    uint32_t nlayersLost = tk.hitPattern().trackerLayersWithoutMeasurement(reco::HitPattern::TRACK_HITS);
+    if (nlayers < min_layers_[tsNum]) return false;
+    if (nlayers3D < min_3Dlayers_[tsNum]) return false;
+    if (nlayersLost > max_lostLayers_[tsNum]) return false;
+
+    float chi2n =  tk.normalizedChi2();
+    float chi2n_no1Dmod = chi2n;
+
+    int count1dhits = 0;
+    auto ith = tk.extra()->firstRecHit();
+    auto  edh = ith + tk.recHitsSize();
+    for (; ith<edh; ++ith) {
+      const TrackingRecHit & hit = recHits[ith];
+      if (hit.dimension()==1) ++count1dhits;
+    }
+    if (count1dhits > 0) {
+      float chi2 = tk.chi2();
+      float ndof = tk.ndof();
+      chi2n = (chi2+count1dhits)/float(ndof+count1dhits);
+    }
+    if (chi2n > chi2n_par_[tsNum]*nlayers) return false;
+
+    if (chi2n_no1Dmod > chi2n_no1Dmod_par_[tsNum]*nlayers) return false;
+
+    float pt = std::max(float(tk.pt()),0.000001f);
+    float eta = tk.eta();
+    if (eta<min_eta_[tsNum] || eta>max_eta_[tsNum]) return false;
+
+    float relpterr = float(tk.ptError())/pt;
+    if(relpterr > max_relpterr_[tsNum]) return false;
+
+    int lostIn = tk.hitPattern().numberOfLostTrackerHits(reco::HitPattern::MISSING_INNER_HITS);
+    int lostOut = tk.hitPattern().numberOfLostTrackerHits(reco::HitPattern::MISSING_OUTER_HITS);
+    int minLost = std::min(lostIn,lostOut);
+    if (minLost > max_minMissHitOutOrIn_[tsNum]) return false;
+    float lostMidFrac = tk.numberOfLostHits() / (tk.numberOfValidHits() + tk.numberOfLostHits());
+    if (lostMidFrac > max_lostHitFraction_[tsNum]) return false;
+
+    float d0 = -tk.dxy(vertexBeamSpot.position()), d0E =  tk.d0Error(),
+      dz = tk.dz(vertexBeamSpot.position()), dzE =  tk.dzError();
+
+    float nomd0E = sqrt(res_par_[tsNum][0]*res_par_[tsNum][0]+(res_par_[tsNum][1]/pt)*(res_par_[tsNum][1]/pt));
+    float nomdzE = nomd0E*(std::cosh(eta));
+
+    float dzCut = std::min( powN(dz_par1_[tsNum][0]*nlayers,int(dz_par1_[tsNum][1]+0.5))*nomdzE,
+                            powN(dz_par2_[tsNum][0]*nlayers,int(dz_par2_[tsNum][1]+0.5))*dzE );
+    float d0Cut = std::min( powN(d0_par1_[tsNum][0]*nlayers,int(d0_par1_[tsNum][1]+0.5))*nomd0E,
+                            powN(d0_par2_[tsNum][0]*nlayers,int(d0_par2_[tsNum][1]+0.5))*d0E );
+
+    bool primaryVertexZCompatibility(false);
+    bool primaryVertexD0Compatibility(false);
+
+    if (points.empty()) {
+      if ( abs(dz) < hypot(vertexBeamSpot.sigmaZ()*nSigmaZ_[tsNum],dzCut) ) primaryVertexZCompatibility = true;
+      if (abs(d0) < d0Cut) primaryVertexD0Compatibility = true;
+    }
+
+    int iv=0;
+    for (std::vector<Point>::const_iterator point = points.begin(), end = points.end(); point != end; ++point) {
+      if(primaryVertexZCompatibility && primaryVertexD0Compatibility) break;
+      float dzPV = tk.dz(*point);
+      float d0PV = tk.dxy(*point);
+      if(useVtxError_){
+        float dzErrPV = std::sqrt(dzE*dzE+vzerr[iv]*vzerr[iv]);
+        float d0ErrPV = std::sqrt(d0E*d0E+vterr[iv]*vterr[iv]);
+        iv++;
+        if (abs(dzPV) < dz_par1_[tsNum][0]*pow(nlayers,dz_par1_[tsNum][1])*nomdzE &&
+            abs(dzPV) < dz_par2_[tsNum][0]*pow(nlayers,dz_par2_[tsNum][1])*dzErrPV &&
+            abs(dzPV) < max_z0_[tsNum])  primaryVertexZCompatibility = true;
+        if (abs(d0PV) < d0_par1_[tsNum][0]*pow(nlayers,d0_par1_[tsNum][1])*nomd0E &&
+            abs(d0PV) < d0_par2_[tsNum][0]*pow(nlayers,d0_par2_[tsNum][1])*d0ErrPV &&
+            abs(d0PV) < max_d0_[tsNum]) primaryVertexD0Compatibility = true;
+      }else{
+        if (abs(dzPV) < dzCut)  primaryVertexZCompatibility = true;
+        if (abs(d0PV) < d0Cut) primaryVertexD0Compatibility = true;
+      }
+    }
+
+    if (points.empty() && applyAbsCutsIfNoPV_[tsNum]) {
+      if ( abs(dz) > max_z0NoPV_[tsNum] || abs(d0) > max_d0NoPV_[tsNum]) return false;
+    }  else {
+      if (abs(d0) > max_d0_[tsNum] && !primaryVertexD0Compatibility) return false;
+      if (abs(dz) > max_z0_[tsNum] && !primaryVertexZCompatibility) return false;
+    }
+
+    if (applyAdaptedPVCuts_[tsNum]) {
+      return (primaryVertexD0Compatibility && primaryVertexZCompatibility);
+    } else {
+      return true;
+    }
+  }
+
+  void TestMultiTrackSelector::processMVAPerTrack(const edm::Handle<reco::TrackCollection> &hSrcTrack,
+                                                  const TrackingRecHitCollection & srcHits,
+                                                  const reco::BeamSpot& beamspot,
+                                                  const reco::VertexCollection& vertices,
+                                                  const GBRForest & forest,
+                                                  int selIndex, std::vector<float> & mvaVals_) const {
+    using namespace reco;
+
+    const TrackCollection& srcTracks(*hSrcTrack);
+    edm::RefToBaseProd<Track> rtbpTrackCollection(hSrcTrack);
+
+    size_t current = 0;
+    for (TrackCollection::const_iterator it = srcTracks.begin(), ed = srcTracks.end(); it != ed; ++it, ++current) {
+      const Track & trk = * it;
+      edm::RefToBase<Track> trackRef(rtbpTrackCollection,current);
+      auto tmva_ndof_ = trk.ndof();
+      auto tmva_nlayers_ = trk.hitPattern().trackerLayersWithMeasurement();
+      auto tmva_nlayers3D_ = trk.hitPattern().pixelLayersWithMeasurement()
+        + trk.hitPattern().numberOfValidStripLayersWithMonoAndStereo();
+      auto tmva_nlayerslost_ = trk.hitPattern().trackerLayersWithoutMeasurement(reco::HitPattern::TRACK_HITS);
+      float chi2n =  trk.normalizedChi2();
+      float chi2n_no1Dmod = chi2n;
+
+      int count1dhits = 0;
+      auto ith = trk.extra()->firstRecHit();
+      auto  edh = ith + trk.recHitsSize();
+      for (; ith<edh; ++ith) {
+        const TrackingRecHit & hit = srcHits[ith];
+        if (hit.dimension()==1) ++count1dhits;
+      }
+      if (count1dhits > 0) {
+        float chi2 = trk.chi2();
+        float ndof = trk.ndof();
+        chi2n = (chi2+count1dhits)/float(ndof+count1dhits);
+      }
+      auto tmva_chi2n_ = chi2n;
+      auto tmva_chi2n_no1dmod_ = chi2n_no1Dmod;
+      auto tmva_eta_ = trk.eta();
+      auto tmva_relpterr_ = float(trk.ptError())/std::max(float(trk.pt()),0.000001f);
+      auto tmva_nhits_ = trk.numberOfValidHits();
+      int lostIn = trk.hitPattern().numberOfLostTrackerHits(reco::HitPattern::MISSING_INNER_HITS);
+      int lostOut = trk.hitPattern().numberOfLostTrackerHits(reco::HitPattern::MISSING_OUTER_HITS);
+      auto tmva_minlost_ = std::min(lostIn,lostOut);
+      auto tmva_lostmidfrac_ = trk.numberOfLostHits() / (trk.numberOfValidHits() + trk.numberOfLostHits());
+      auto tmva_absd0_ = fabs(-trk.dxy(beamspot.position()));
+      auto tmva_absdz_ = fabs(trk.dz(beamspot.position()));
+      Point bestVertex = getBestVertex(trackRef,vertices);
+      auto tmva_absd0PV_ = fabs(trk.dxy(bestVertex));
+      auto tmva_absdzPV_ = fabs(trk.dz(bestVertex));
+      auto tmva_pt_ = trk.pt();
+
+      float gbrVals_[16];
+      gbrVals_[0] = tmva_pt_;
+      gbrVals_[1] = tmva_lostmidfrac_;
+      gbrVals_[2] = tmva_minlost_;
+      gbrVals_[3] = tmva_nhits_;
+      gbrVals_[4] = tmva_relpterr_;
+      gbrVals_[5] = tmva_eta_;
+      gbrVals_[6] = tmva_chi2n_no1dmod_;
+      gbrVals_[7] = tmva_chi2n_;
+      gbrVals_[8] = tmva_nlayerslost_;
+      gbrVals_[9] = tmva_nlayers3D_;
+      gbrVals_[10] = tmva_nlayers_;
+      gbrVals_[11] = tmva_ndof_;
+      gbrVals_[12] = tmva_absd0PV_;
+      gbrVals_[13] = tmva_absdzPV_;
+      gbrVals_[14] = tmva_absdz_;
+      gbrVals_[15] = tmva_absd0_;
+
+      if (mvaType_[selIndex] == "Prompt"){
+        auto gbrVal = forest.GetClassifier(gbrVals_);
+        mvaVals_[current] = gbrVal;
+      }else{
+        float detachedGbrVals_[12];
+        for(int jjj = 0; jjj < 12; jjj++)detachedGbrVals_[jjj] = gbrVals_[jjj];
+        auto gbrVal = forest.GetClassifier(detachedGbrVals_);
+        mvaVals_[current] = gbrVal;
+      }
+    }
+  }
+
+  template<typename Select>
+  void TestMultiTrackSelector::qualities(unsigned int i, const reco::TrackCollection & srcTracks, const std::vector<Point> & points,
+                                         std::vector<int> & selTracksSave, Select select) const {
+    using namespace reco;
+    const unsigned int trkSize = srcTracks.size();
+    std::vector<int> selTracks(trkSize,0);
+    for (unsigned int current = 0; current < trkSize; ++current) {
+      const Track & trk = srcTracks[current];
+      bool ok=true;
+      if (preFilter_[i]<i && selTracksSave[preFilter_[i]*trkSize+current] < 0) {
+        selTracks[current]=-1;
+        ok=false;
+        if ( !keepAllTracks_[i])
+          continue;
+      }
+      else {
+        ok = select(current);
+        if (!ok && !keepAllTracks_[i]) {
+          selTracks[current]=-1;
+          continue;
+        }
+      }
+      if (preFilter_[i]<i ) {
+        selTracks[current]=selTracksSave[preFilter_[i]*trkSize+current];
+      }
+      else {
+        selTracks[current]=trk.qualityMask();
+      }
+      if ( ok && setQualityBit_[i]) {
+        selTracks[current]= (selTracks[current] | (1<<qualityToSet_[i]));
+        if (qualityToSet_[i]==TrackBase::tight) {
+          selTracks[current]=(selTracks[current] | (1<<TrackBase::loose));
+        }
+        else if (qualityToSet_[i]==TrackBase::highPurity) {
+          selTracks[current]=(selTracks[current] | (1<<TrackBase::loose));
+          selTracks[current]=(selTracks[current] | (1<<TrackBase::tight));
+        }
+        if (!points.empty()) {
+          if (qualityToSet_[i]==TrackBase::loose) {
+            selTracks[current]=(selTracks[current] | (1<<TrackBase::looseSetWithPV));
+          }
+          else if (qualityToSet_[i]==TrackBase::highPurity) {
+            selTracks[current]=(selTracks[current] | (1<<TrackBase::looseSetWithPV));
+            selTracks[current]=(selTracks[current] | (1<<TrackBase::highPuritySetWithPV));
+          }
+        }
+      }
+    }
+    for ( unsigned int j=0; j< trkSize; j++ ) selTracksSave[j+i*trkSize]=selTracks[j];
+  }
+
+  // the loose, tight and highPurity sets of multiTrackSelector_cfi, with a
+  // prompt MVA for loose, a detached one for tight and the MVA only for highPurity
+  edm::ParameterSet selectorParameters() {
+    std::vector<edm::ParameterSet> sets(3);
+    const char * names[3] = {"TrkLoose", "TrkTight", "TrkHighPurity"};
+    const char * qualities[3] = {"loose", "tight", "highPurity"};
+    for (unsigned int i = 0; i < 3; ++i) {
+      auto & set = sets[i];
+      set.addParameter<std::string>("name",names[i]);
+      set.addParameter<std::string>("preFilterName", i==0 ? "" : names[i-1]);
+      set.addParameter<int32_t>("vtxNumber",-1);
+      set.addParameter<std::string>("vertexCut","ndof>=2&!isFake");
+      set.addParameter<std::string>("qualityBit",qualities[i]);
+      set.addParameter<double>("chi2n_par", i==0 ? 1.6 : 0.7);
+      set.addParameter<double>("chi2n_no1Dmod_par", i==0 ? 9999. : 1.2);
+      set.addParameter<std::vector<double> >("res_par", {0.003, i==2 ? 0.001 : 0.01});
+      set.addParameter<std::vector<double> >("d0_par1", {i==0 ? 0.55 : 0.3, 4.});
+      set.addParameter<std::vector<double> >("dz_par1", {i==0 ? 0.65 : 0.35, 4.});
+      set.addParameter<std::vector<double> >("d0_par2", {i==0 ? 0.55 : 0.4, 4.});
+      set.addParameter<std::vector<double> >("dz_par2", {i==0 ? 0.45 : 0.4, 4.});
+      set.addParameter<bool>("applyAdaptedPVCuts", i!=0);
+      set.addParameter<double>("max_d0",100.);
+      set.addParameter<double>("max_z0",100.);
+      set.addParameter<double>("nSigmaZ",4.);
+      set.addParameter<uint32_t>("minNumberLayers", i==0 ? 0 : 3);
+      set.addParameter<uint32_t>("minNumber3DLayers", i==0 ? 0 : 3);
+      set.addParameter<uint32_t>("maxNumberLostLayers", i==0 ? 999 : 2);
+      set.addParameter<uint32_t>("minHitsToBypassChecks",20);
+      set.addParameter<bool>("applyAbsCutsIfNoPV", i==1);
+      set.addParameter<double>("max_d0NoPV",1.);
+      set.addParameter<double>("max_z0NoPV",20.);
+      set.addParameter<bool>("keepAllTracks", i!=0);
+      set.addParameter<double>("max_relpterr", i==0 ? 9999. : 0.2);
+      set.addParameter<uint32_t>("min_nhits", i==0 ? 0 : 5);
+      set.addParameter<int32_t>("max_minMissHitOutOrIn", i==0 ? 99 : 1);
+      set.addParameter<double>("min_eta", i==0 ? -9999. : -2.3);
+      set.addParameter<double>("max_eta", i==0 ? 9999. : 2.3);
+      set.addParameter<bool>("useMVA",true);
+      set.addParameter<double>("minMVA", i==0 ? -0.5 : i==1 ? 0. : 0.2);
+      set.addParameter<std::string>("mvaType", i==1 ? "Detached" : "Prompt");
+      set.addParameter<bool>("useMVAonly", i==2);
+    }
+    edm::ParameterSet conf;
+    conf.addParameter<edm::InputTag>("src",edm::InputTag("generalTracks"));
+    conf.addParameter<edm::InputTag>("beamspot",edm::InputTag("offlineBeamSpot"));
+    conf.addParameter<bool>("useVertices",true);
+    conf.addParameter<bool>("useVtxError",false);
+    conf.addParameter<edm::InputTag>("vertices",edm::InputTag("firstStepPrimaryVertices"));
+    conf.addParameter<bool>("useAnyMVA",true);
+    conf.addParameter<std::vector<edm::ParameterSet> >("trackSelectors",sets);
+    return conf;
+  }
+
+  // ranges of the 16 MVA variables of processMVA, for the cuts of the trees
+  const float varMin[16] = {0.f, 0.f, 0.f,  3.f, 0.f,  -2.5f, 0.f, 0.f, 0.f, 0.f,  2.f,  0.f, 0.f, 0.f, 0.f,  0.f};
+  const float varMax[16] = {5.f, 1.f, 3.f, 22.f, 0.3f,  2.5f, 4.f, 4.f, 3.f, 8.f, 13.f, 25.f, 0.3f, 1.f, 10.f, 0.5f};
+
+  // forest of full trees of depth 3, cutting on the first nVariables variables
+  GBRForest makeForest(unsigned int nVariables, int nTrees) {
+    constexpr int nNodes = 7;
+    GBRForest forest;
+    forest.SetInitialResponse(flat(-0.1,0.1));
+    for (int it = 0; it < nTrees; ++it) {
+      GBRTree tree;
+      for (int node = 0; node < nNodes; ++node) {
+        int var = uniform(0,int(nVariables)-1);
+        tree.CutIndices().push_back(var);
+        tree.CutVals().push_back(flat(varMin[var],varMax[var]));
+        // the terminal nodes are stored as minus their index
+        int left = 2*node+1, right = 2*node+2;
+        tree.LeftIndices().push_back(left < nNodes ? left : -(left-nNodes));
+        tree.RightIndices().push_back(right < nNodes ? right : -(right-nNodes));
+      }
+      for (int leaf = 0; leaf <= nNodes; ++leaf) tree.Responses().push_back(flat(-0.4,0.4));
+      forest.Trees().push_back(tree);
+    }
+    return forest;
+  }
+
+  // a track crossing 3 pixel barrel layers, 4 TIB and 6 TOB layers, the first
+  // two of each strip subdetector double sided: the mono and stereo 1D hits
+  // or the matched 2D hit are taken, some layers are lost, and some inner and
+  // outer missing hits are added to the hit pattern
+  void makeTrack(reco::TrackCollection & tracks, reco::TrackExtraCollection & extras,
+                 TrackingRecHitCollection & hits, const std::vector<double> & vertexZ) {
+    const unsigned int firstHit = hits.size();
+    reco::HitPattern pattern;
+    std::vector<std::pair<uint16_t, TrackingRecHit::Type> > inner, outer;
+    int dims = 0;
+    for (int missing = uniform(-3,1); missing > 0; --missing) inner.emplace_back(PixelSubdetector::PixelBarrel, TrackingRecHit::missing_inner);
+    for (int missing = uniform(-3,2); missing > 0; --missing) outer.emplace_back(StripSubdetector::TOB, TrackingRecHit::missing_outer);
+
+    struct Layer { uint16_t subdet, layer; bool doubleSided; };
+    std::vector<Layer> layers;
+    for (uint16_t layer = 1; layer <= 3; ++layer) layers.push_back(Layer{PixelSubdetector::PixelBarrel, layer, false});
+    for (uint16_t layer = 1; layer <= 4; ++layer) layers.push_back(Layer{StripSubdetector::TIB, layer, layer <= 2});
+    for (uint16_t layer = 1; layer <= 6; ++layer) layers.push_back(Layer{StripSubdetector::TOB, layer, layer <= 2});
+    const unsigned int nLayers = uniform(4,int(layers.size()));
+
+    std::vector<std::pair<Layer, TrackingRecHit::Type> > patternHits;
+    for (unsigned int il = 0; il < nLayers; ++il) {
+      auto const & layer = layers[il];
+      DetId id(DetId::Tracker, layer.subdet);
+      double r = flat(0.,1.);
+      if (r < 0.08) continue;
+      if (r < 0.2) {
+        hits.push_back(new InvalidTrackingRecHit(TrackingRecHit::missing));
+        patternHits.emplace_back(layer, TrackingRecHit::missing);
+        continue;
+      }
+      if (layer.subdet == PixelSubdetector::PixelBarrel) {
+        hits.push_back(new FakeHit(id,2));
+        dims += 2;
+      } else if (layer.doubleSided && flat(0.,1.) < 0.5) {
+        hits.push_back(new FakeHit(id,2));
+        dims += 2;
+      } else {
+        hits.push_back(new FakeHit(id,1));
+        dims += 1;
+        if (layer.doubleSided) {
+          hits.push_back(new FakeHit(id,1));
+          dims += 1;
+        }
+      }
+      patternHits.emplace_back(layer, TrackingRecHit::valid);
+    }
+
+    double pt = flat(0.1,8.), phi = flat(-M_PI,M_PI), eta = flat(-2.6,2.6);
+    reco::Track::Vector momentum(pt*std::cos(phi), pt*std::sin(phi), pt*std::sinh(eta));
+    double p = pt*std::cosh(eta);
+    double relErr = flat(0.005,0.4), dxyError = flat(0.002,0.05), dzError = flat(0.003,0.1);
+    reco::Track::CovarianceMatrix cov;
+    cov(reco::TrackBase::i_qoverp,reco::TrackBase::i_qoverp) = relErr*relErr/(p*p);
+    cov(reco::TrackBase::i_lambda,reco::TrackBase::i_lambda) = 1.e-6;
+    cov(reco::TrackBase::i_phi,reco::TrackBase::i_phi) = 1.e-6;
+    cov(reco::TrackBase::i_dxy,reco::TrackBase::i_dxy) = dxyError*dxyError;
+    cov(reco::TrackBase::i_dsz,reco::TrackBase::i_dsz) = dzError*dzError*pt*pt/(p*p);
+    // prompt tracks from one of the vertices, or detached ones
+    double d0 = flat(0.,1.) < 0.8 ? gauss(0.,3.*dxyError) : flat(-2.,2.);
+    double z0 = vertexZ.empty() || flat(0.,1.) < 0.2 ? flat(-15.,15.) : vertexZ[uniform(0,int(vertexZ.size())-1)] + gauss(0.,3.*dzError);
+    reco::Track::Point point(d0*std::sin(phi), -d0*std::cos(phi), z0);
+    double ndof = dims-5;
+    double chi2 = std::max(ndof,0.)*std::exp(gauss(0.,0.6));
+    tracks.emplace_back(chi2,ndof,point,momentum,uniform(0,1) ? 1 : -1,cov);
+    auto & track = tracks.back();
+    track.setQualityMask(uniform(0,1) << reco::TrackBase::confirmed);
+
+    // each category in a row, as in the track producers
+    for (auto const & hit : patternHits) {
+      auto const & layer = hit.first;
+      track.appendTrackerHitPattern(layer.subdet,layer.layer,0,hit.second);
+      if (layer.doubleSided) track.appendTrackerHitPattern(layer.subdet,layer.layer,1,hit.second);
+    }
+    for (auto const & hit : inner) track.appendTrackerHitPattern(hit.first,1,0,hit.second);
+    for (auto const & hit : outer) track.appendTrackerHitPattern(hit.first,6,0,hit.second);
+
+    extras.emplace_back();
+    extras.back().setHits(TrackingRecHitRefProd(), firstHit, hits.size()-firstHit);
+  }
+
+  bool sameBits(float a, float b) { return std::memcmp(&a,&b,sizeof(float)) == 0; }
+
+  int failures = 0;
+
+}
+
+
+int main() {
+  const TestMultiTrackSelector selector(selectorParameters());
+  const unsigned int nSets = selector.nSets();
+
+  reco::BeamSpot::CovarianceMatrix bsError;
+  for (int i=0; i!=reco::BeamSpot::dimension; ++i) bsError(i,i) = 1.e-8;
+  const reco::BeamSpot bs(reco::BeamSpot::Point(0.05,-0.02,0.3),4.,0.,0.,0.002,bsError);
+
+  std::vector<GBRForest> forests;
+  for (unsigned int i = 0; i < nSets; ++i) forests.push_back(makeForest(selector.prompt(i) ? 16 : 12, 20));
+
+  std::vector<unsigned int> selected(nSets,0), rejected(nSets,0);
+  for (int ievt = 0; ievt < 20; ++ievt) {
+    // no vertex at all in the first event
+    reco::VertexCollection vertices;
+    std::vector<double> vertexZ;
+    for (int iv = ievt == 0 ? 0 : uniform(1,6); iv > 0; --iv) {
+      reco::Vertex::Error error;
+      error(0,0) = error(1,1) = 1.e-6;
+      error(2,2) = 1.e-4;
+      vertexZ.push_back(gauss(0.,5.));
+      vertices.emplace_back(reco::Vertex::Point(0.05,-0.02,vertexZ.back()),error,flat(0.,20.),flat(0.,20.),10);
+    }
+
+    reco::TrackCollection tracks;
+    reco::TrackExtraCollection extras;
+    TrackingRecHitCollection hits;
+    for (int itk = ievt == 1 ? 0 : uniform(50,200); itk > 0; --itk) makeTrack(tracks, extras, hits, vertexZ);
+
+    const edm::TestHandle<TrackingRecHitCollection> hHits(&hits, edm::ProductID(1,1));
+    const edm::TestHandle<reco::TrackExtraCollection> hExtras(&extras, edm::ProductID(1,2));
+    for (unsigned int i = 0; i < tracks.size(); ++i) {
+      extras[i].setHits(TrackingRecHitRefProd(hHits), extras[i].firstRecHit(), extras[i].recHitsSize());
+      tracks[i].setExtra(reco::TrackExtraRef(hExtras,i));
+    }
+    const edm::Provenance provenance;
+    const edm::Handle<reco::TrackCollection> hTracks(&tracks, &provenance);
+
+    TrackSelectionSummary summary;
+    selector.fillSummary(hTracks, hits, bs, &vertices, summary);
+
+    // as in run
+    const unsigned int trkSize = tracks.size();
+    std::vector<int> qualityPerTrack(nSets*trkSize,0), qualitySummary(nSets*trkSize,0);
+    std::vector<math::XYZPoint> points;
+    std::vector<float> vterr, vzerr;
+    selector.selectVertices(0, vertices, points, vterr, vzerr);
+    for (unsigned int i = 0; i < nSets; ++i) {
+      std::vector<float> mvaPerTrack(trkSize,-99.f), mvaSummary(trkSize,-99.f);
+      if (selector.evaluatesMVA(i)) {
+        selector.processMVAPerTrack(hTracks, hits, bs, vertices, forests[i], i, mvaPerTrack);
+        selector.evaluateMVA(summary, forests[i], i, mvaSummary);
+      }
+      for (unsigned int j = 0; j < trkSize; ++j) {
+        if (!sameBits(mvaPerTrack[j],mvaSummary[j])) {
+          std::cout << "event " << ievt << " set " << i << " track " << j << ": MVA "
+                    << mvaPerTrack[j] << " " << mvaSummary[j] << std::endl;
+          ++failures;
+        }
+      }
+
+      selector.selectVertices(i, vertices, points, vterr, vzerr);
+      selector.qualities(i, tracks, points, qualityPerTrack, [&](unsigned int j) {
+        return selector.selectPerTrack(i, bs, hits, tracks[j], points, vterr, vzerr, mvaPerTrack[j]); });
+      selector.qualities(i, tracks, points, qualitySummary, [&](unsigned int j) {
+        return selector.select(i, bs, summary, j, tracks[j], points, vterr, vzerr, mvaSummary[j]); });
+      for (unsigned int j = 0; j < trkSize; ++j) {
+        if (qualityPerTrack[i*trkSize+j] != qualitySummary[i*trkSize+j]) {
+          std::cout << "event " << ievt << " set " << i << " track " << j << ": quality "
+                    << qualityPerTrack[i*trkSize+j] << " " << qualitySummary[i*trkSize+j] << std::endl;
+          ++failures;
+        }
+        if (qualityPerTrack[i*trkSize+j] > 0 && (qualityPerTrack[i*trkSize+j] & (1<<selector.qualityToSet(i))))
+          ++selected[i];
+        else
+          ++rejected[i];
+      }
+    }
+  }
+
+  // the tracks must cover both sides of the cuts
+  for (unsigned int i = 0; i < nSets; ++i) {
+    if (selected[i] == 0 || rejected[i] == 0) {
+      std::cout << "set " << i << ": " << selected[i] << " tracks selected, " << rejected[i] << " rejected" << std::endl;
+      ++failures;
+    }
+  }
+
+  if (failures) {
+    std::cout << failures << " failures" << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -141,17 +141,21 @@ MeasurementTrackerEventProducer::updatePixels( const edm::Event& event, PxMeasur
 	
 	
 	// FIXME: should check if lower_bound is better
+	// for a collection filled on demand the dets keep the index of their
+	// DetSet, so that it is unpacked only for the dets actually used;
+	// otherwise the DetSets are set here
+	const bool onDemand = pixelCollection->onDemand();
 	int i = 0, endDet = thePxDets.size();
-	for (edmNew::DetSetVector<SiPixelCluster>::const_iterator it = pixelCollection->begin(), ed = pixelCollection->end(); it != ed; ++it) {
-	  edmNew::DetSet<SiPixelCluster> set(*it);
-	  unsigned int id = set.id();
+	for ( auto j = 0U; j< pixelCollection->size(); ++j) {
+	  unsigned int id = pixelCollection->id(j);
 	  while ( id != thePxDets.id(i)) { 
 	    ++i;
 	    if (endDet==i) throw "we have a problem!!!!";
 	  }
 	  // push cluster range in det
 	  if ( thePxDets.isActive(i) ) {
-	    thePxDets.update(i,set);         
+	    if (onDemand) thePxDets.update(i,j);
+	    else thePxDets.update(i,edmNew::DetSet<SiPixelCluster>(*pixelCollection,pixelCollection->item(j),false));
 	  }
 	}
       }
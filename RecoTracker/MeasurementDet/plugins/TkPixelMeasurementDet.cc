@@ -95,11 +95,12 @@ TkPixelMeasurementDet::compHits( const TrajectoryStateOnSurface& ts, const Measu
   RecHitContainer result;
   if (isEmpty(data.pixelData())== true ) return result;
   if (isActive(data) == false) return result;
+  // get the DetSet first: if the clusters are produced on demand, this fills it
+  const detset & detSet = data.pixelData().detSet(index());
   const SiPixelCluster* begin=0;
   if (0 != data.pixelData().handle()->data().size()) {
      begin = &(data.pixelData().handle()->data().front());
   }
-  const detset & detSet = data.pixelData().detSet(index());
   result.reserve(detSet.size());
 
   // pixel topology is rectangular, all positions are independent
@@ -2,6 +2,9 @@
 #define StMeasurementDetSet_H
 
 #include<vector>
+#include<atomic>
+#include<memory>
+#include<thread>
 class TkStripMeasurementDet;
 class TkStripMeasurementDet;
 class TkPixelMeasurementDet;
@@ -154,12 +157,13 @@ public:
     activeThisEvent_(cond.nDet(), true),
     detSet_(cond.nDet()),
     detIndex_(cond.nDet(),-1),
-    ready_(cond.nDet(),true),
+    detSetState_(new std::atomic<char>[cond.nDet()]),
     theRawInactiveStripDetIds_(),
     stripDefined_(0), 
     stripUpdated_(0), 
     stripRegions_(0) 
   {
+    std::fill(detSetState_.get(),detSetState_.get()+cond.nDet(),toBeSet);
   }
 
   ~StMeasurementDetSet() {
@@ -172,10 +176,11 @@ public:
   void update(int i,const StripDetset & detSet ) { 
     detSet_[i] = detSet;     
     empty_[i] = false;
+    detSetState_[i] = isSet;
   }
 
   void update(int i, int j ) {
-    assert(j>=0); assert(empty_[i]); assert(ready_[i]); 
+    assert(j>=0); assert(empty_[i]); assert(detSetState_[i]==toBeSet); 
     detIndex_[i] = j;
     empty_[i] = false;
     incReady();
@@ -197,7 +202,7 @@ public:
   void setEmpty() {
     printStat();
     std::fill(empty_.begin(),empty_.end(),true);
-    std::fill(ready_.begin(),ready_.end(),true);
+    std::fill(detSetState_.get(),detSetState_.get()+size(),toBeSet);
     std::fill(detIndex_.begin(),detIndex_.end(),-1);
     std::fill(activeThisEvent_.begin(), activeThisEvent_.end(),true);
     incTot(size());
@@ -210,7 +215,9 @@ public:
   edm::Handle<edmNew::DetSetVector<SiStripCluster> > & handle() {  return handle_; }
   const edm::Handle<edmNew::DetSetVector<SiStripCluster> > & handle() const {  return handle_; }
   // StripDetset & detSet(int i) { return detSet_[i]; }
-  const StripDetset & detSet(int i) const { if (ready_[i]) const_cast<StMeasurementDetSet*>(this)->getDetSet(i);     return detSet_[i]; }
+  /// the DetSet is set at its first use, that can come from several threads at once
+  /// (e.g. the trajectory building of several seeds in parallel)
+  const StripDetset & detSet(int i) const { if (detSetState_[i].load(std::memory_order_acquire)!=isSet) const_cast<StMeasurementDetSet*>(this)->getDetSet(i);     return detSet_[i]; }
   
 
   //// ------- pieces for on-demand unpacking -------- 
@@ -228,17 +235,25 @@ public:
 
 private:
 
+  // state of the DetSet of a det in the event
+  enum DetSetState : char { toBeSet, beingSet, isSet };
+
+  // only the thread that moves the state from toBeSet to beingSet writes the
+  // DetSet, the others wait for it; empty_ is left as set by update()
   void getDetSet(int i) {
+    char expected = toBeSet;
+    if (!detSetState_[i].compare_exchange_strong(expected,beingSet,std::memory_order_acq_rel)) {
+      while (detSetState_[i].load(std::memory_order_acquire)!=isSet) std::this_thread::yield();
+      return;
+    }
     if(detIndex_[i]>=0) {
       detSet_[i].set(*handle_,handle_->item(detIndex_[i]));
-      empty_[i]=false; // better be false already
       incAct();
     }  else { // we should not be here
       detSet_[i] = StripDetset();
-      empty_[i]=true;  
     }
-    ready_[i]=false;
     incSet();
+    detSetState_[i].store(isSet,std::memory_order_release);
   }
 
 
@@ -257,7 +272,7 @@ private:
   // full reco
   std::vector<StripDetset> detSet_;
   std::vector<int> detIndex_;
-  std::vector<bool> ready_; // to be cleaned
+  std::unique_ptr<std::atomic<char>[]> detSetState_;
   
  
   // note: not aligned to the index
@@ -341,8 +356,12 @@ public:
   PxMeasurementDetSet(const PxMeasurementConditionSet &cond) : 
     conditionSet_(&cond),
     detSet_(cond.nDet()),
+    detIndex_(cond.nDet(),-1),
+    detSetState_(new std::atomic<char>[cond.nDet()]),
     empty_(cond.nDet(), true),
-    activeThisEvent_(cond.nDet(), true)  {}
+    activeThisEvent_(cond.nDet(), true)  {
+    std::fill(detSetState_.get(),detSetState_.get()+cond.nDet(),toBeSet);
+  }
 
   const PxMeasurementConditionSet & conditions() const { return *conditionSet_; } 
 
@@ -356,6 +375,15 @@ public:
   void update(int i,const PixelDetSet & detSet ) { 
     detSet_[i] = detSet;     
     empty_[i] = false;
+    detSetState_[i] = isSet;
+  }
+
+  /// the DetSet is the j-th of the collection in handle(), it is set at first use
+  /// (for a collection filled on demand, so that only the dets used are unpacked)
+  void update(int i, int j ) {
+    assert(j>=0); assert(empty_[i]); assert(detSetState_[i]==toBeSet); 
+    detIndex_[i] = j;
+    empty_[i] = false;
   }
 
   bool empty(int i) const { return empty_[i];}  
@@ -365,6 +393,8 @@ public:
   
   void setEmpty() {
     std::fill(empty_.begin(),empty_.end(),true);
+    std::fill(detSetState_.get(),detSetState_.get()+size(),toBeSet);
+    std::fill(detIndex_.begin(),detIndex_.end(),-1);
     std::fill(activeThisEvent_.begin(), activeThisEvent_.end(),true);
   }
   void setActiveThisEvent(bool active) {
@@ -376,8 +406,26 @@ public:
   void setActiveThisEvent(int i, bool active) { activeThisEvent_[i] = active;  if (!active) empty_[i] = true; }
   const edm::Handle<edmNew::DetSetVector<SiPixelCluster> > & handle() const {  return handle_;}
   edm::Handle<edmNew::DetSetVector<SiPixelCluster> > & handle() {  return handle_;}
-  const PixelDetSet & detSet(int i) const { return detSet_[i];}
+  /// set at its first use if update(i,j) was called, as in StMeasurementDetSet
+  const PixelDetSet & detSet(int i) const { if (detSetState_[i].load(std::memory_order_acquire)!=isSet) const_cast<PxMeasurementDetSet*>(this)->getDetSet(i); return detSet_[i];}
 private:
+
+  enum DetSetState : char { toBeSet, beingSet, isSet };
+
+  void getDetSet(int i) {
+    char expected = toBeSet;
+    if (!detSetState_[i].compare_exchange_strong(expected,beingSet,std::memory_order_acq_rel)) {
+      while (detSetState_[i].load(std::memory_order_acquire)!=isSet) std::this_thread::yield();
+      return;
+    }
+    if(detIndex_[i]>=0) {
+      detSet_[i].set(*handle_,handle_->item(detIndex_[i]));
+    }  else { // we should not be here
+      detSet_[i] = PixelDetSet();
+    }
+    detSetState_[i].store(isSet,std::memory_order_release);
+  }
+
   friend class MeasurementTrackerImpl;
 
   const PxMeasurementConditionSet *conditionSet_;
@@ -387,6 +435,8 @@ private:
 
   // Locals, per-event
   std::vector<PixelDetSet> detSet_;
+  std::vector<int> detIndex_;
+  std::unique_ptr<std::atomic<char>[]> detSetState_;
   std::vector<bool> empty_;
   std::vector<bool> activeThisEvent_;
 };
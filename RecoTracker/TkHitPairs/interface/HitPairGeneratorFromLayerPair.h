@@ -19,7 +19,8 @@ public:
   HitPairGeneratorFromLayerPair(unsigned int inner,
                                 unsigned int outer,
                                 LayerCacheType* layerCache,
-				unsigned int max=0);
+				unsigned int max=0,
+				bool useTiles=false);
 
   ~HitPairGeneratorFromLayerPair();
 
@@ -64,6 +65,8 @@ private:
   const unsigned int theOuterLayer;
   const unsigned int theInnerLayer;
   const unsigned int theMaxElement;
+  // build the tiled index of the layers put in the cache
+  const bool theUseTiles;
 };
 
 #endif
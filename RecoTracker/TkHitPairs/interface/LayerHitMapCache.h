@@ -61,15 +61,17 @@ public:
     theCache.extend(other.theCache);
   }
   
+  /// withTiles: build the tiled index of the hits, if the layer is not yet in the cache
   const RecHitsSortedInPhi &
   operator()(const SeedingLayerSetsHits::SeedingLayer& layer, const TrackingRegion & region,
-	     const edm::EventSetup & iSetup) {
+	     const edm::EventSetup & iSetup, bool withTiles=false) {
     int key = layer.index();
     assert (key>=0);
     const RecHitsSortedInPhi * lhm = theCache.get(key);
     if (lhm==nullptr) {
       auto tmp=new RecHitsSortedInPhi (region.hits(iSetup,layer), region.origin(), layer.detLayer());
       tmp->theOrigin = region.origin();
+      if (withTiles) tmp->buildTiles();
       theCache.add( key, tmp);
       lhm = tmp;
       LogDebug("LayerHitMapCache")<<" I got"<< lhm->all().second-lhm->all().first<<" hits in the cache for: "<<layer.detLayer();
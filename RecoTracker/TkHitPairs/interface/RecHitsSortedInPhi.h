@@ -3,9 +3,11 @@
 
 #include "DataFormats/TrackerRecHit2D/interface/BaseTrackerRecHit.h"
 #include "TrackingTools/DetLayers/interface/DetLayer.h"
+#include "DataFormats/GeometryVector/interface/Pi.h"
 
 #include <vector>
 #include<array>
+#include<algorithm>
 
 #include<cassert>
 
@@ -85,6 +87,21 @@ public:
     return Range(theHits.begin(), theHits.end());
   }
 
+  // Optional (phi,v) tiled index of the hits.
+  //  The hits, sorted in phi, are split in phi bins of equal size, each one
+  //  further split in bins of v. The tile of a hit and its u, v and dv are
+  //  stored in tile order, so that the rz compatibility can run over the
+  //  tiles that overlap the allowed v window only.
+  void buildTiles();
+  bool hasTiles() const { return !tileStart.empty();}
+
+  int phiBin(float phi) const {
+    return std::min(std::max(int((phi+Geom::fpi())*(nPhiBins/Geom::ftwoPi())),0),nPhiBins-1);
+  }
+  int vBin(float vv) const {
+    return std::min(std::max(int((vv-vBinMin)*vBinInvSize),0),nVBins-1);
+  }
+
 public:
   float       phi(int i) const { return theHits[i].phi();}
   float       gv(int i) const { return isBarrel ? z[i] : gp(i).perp();}  // global v
@@ -112,6 +129,24 @@ public:
   std::vector<float> dv;
   std::vector<float> lphi;
 
+  // number of sigmas of the rz compatibility of the hits
+  static constexpr float nSigmaRZ = 3.46410161514f; // std::sqrt(12.f);
+
+  // tiled index, filled by buildTiles
+  int nPhiBins=0;
+  int nVBins=0;
+  float vBinMin=0;
+  float vBinInvSize=0;
+  float uMin=0;  // range of u of the layer hits
+  float uMax=0;
+  std::vector<int> tileStart;  // first element of each tile, phi bin major
+  std::vector<float> tileVLow; // range of v -+ nSigmaRZ*dv of the hits of each tile
+  std::vector<float> tileVHigh;
+  std::vector<int> tileHit;    // hit index, sorted in phi within a tile
+  std::vector<float> tileU;
+  std::vector<float> tileV;
+  std::vector<float> tileDV;
+
   static void copyResult( const Range& range, std::vector<Hit>& result) {
     result.reserve(result.size()+(range.second-range.first));
     for (HitIter i = range.first; i != range.second; i++) result.push_back( i->hit());
@@ -33,42 +33,18 @@ HitPairGeneratorFromLayerPair::HitPairGeneratorFromLayerPair(
 							     unsigned int inner,
 							     unsigned int outer,
 							     LayerCacheType* layerCache,
-							     unsigned int max)
-  : theLayerCache(layerCache), theOuterLayer(outer), theInnerLayer(inner), theMaxElement(max)
+							     unsigned int max,
+							     bool useTiles)
+  : theLayerCache(layerCache), theOuterLayer(outer), theInnerLayer(inner), theMaxElement(max), theUseTiles(useTiles)
 {
 }
 
 HitPairGeneratorFromLayerPair::~HitPairGeneratorFromLayerPair() {}
 
 // devirtualizer
-#include<tuple>
+#include "RecoTracker/TkHitPairs/src/HitRZCompatibilityKernel.h"
 namespace {
-
-  template<typename Algo>
-  struct Kernel {
-    using  Base = HitRZCompatibility;
-    void set(Base const * a) {
-      assert( a->algo()==Algo::me);
-      checkRZ=reinterpret_cast<Algo const *>(a);
-    }
-    
-    void operator()(int b, int e, const RecHitsSortedInPhi & innerHitsMap, bool * ok) const {
-      constexpr float nSigmaRZ = 3.46410161514f; // std::sqrt(12.f);
-      for (int i=b; i!=e; ++i) {
-	Range allowed = checkRZ->range(innerHitsMap.u[i]);
-	float vErr = nSigmaRZ * innerHitsMap.dv[i];
-	Range hitRZ(innerHitsMap.v[i]-vErr, innerHitsMap.v[i]+vErr);
-	Range crossRange = allowed.intersection(hitRZ);
-	ok[i-b] = ! crossRange.empty() ;
-      }
-    }
-    Algo const * checkRZ;
-    
-  };
-
-
-  template<typename ... Args> using Kernels = std::tuple<Kernel<Args>...>;
-
+  template<typename ... Args> using Kernels = HitRZCompatibilityKernels<Args...>;
 }
 
 
@@ -90,10 +66,10 @@ HitDoublets HitPairGeneratorFromLayerPair::doublets( const TrackingRegion& regio
                                                      const edm::Event & iEvent, const edm::EventSetup& iSetup, const Layer& innerLayer, const Layer& outerLayer,
                                                      LayerCacheType& layerCache) {
 
-  const RecHitsSortedInPhi & innerHitsMap = layerCache(innerLayer, region, iSetup);
+  const RecHitsSortedInPhi & innerHitsMap = layerCache(innerLayer, region, iSetup, theUseTiles);
   if (innerHitsMap.empty()) return HitDoublets(innerHitsMap,innerHitsMap);
 
-  const RecHitsSortedInPhi& outerHitsMap = layerCache(outerLayer, region, iSetup);
+  const RecHitsSortedInPhi& outerHitsMap = layerCache(outerLayer, region, iSetup, theUseTiles);
   if (outerHitsMap.empty()) return HitDoublets(innerHitsMap,outerHitsMap);
   HitDoublets result(innerHitsMap,outerHitsMap); result.reserve(std::max(innerHitsMap.size(),outerHitsMap.size()));
   doublets(region,
@@ -0,0 +1,87 @@
+#ifndef HitRZCompatibilityKernel_H
+#define HitRZCompatibilityKernel_H
+
+/** devirtualized rz compatibility of the hits of a layer,
+    with or without its (phi,v) tiled index */
+
+#include "RecoTracker/TkTrackingRegions/interface/HitRZCompatibility.h"
+#include "RecoTracker/TkTrackingRegions/interface/HitEtaCheck.h"
+#include "RecoTracker/TkTrackingRegions/interface/HitRCheck.h"
+#include "RecoTracker/TkTrackingRegions/interface/HitZCheck.h"
+
+#include "RecoTracker/TkHitPairs/interface/RecHitsSortedInPhi.h"
+
+#include<tuple>
+#include<limits>
+#include<algorithm>
+#include<cassert>
+
+template<typename Algo>
+struct HitRZCompatibilityKernel {
+  using  Base = HitRZCompatibility;
+  using  Range = HitRZCompatibility::Range;
+
+  void set(Base const * a) {
+    assert( a->algo()==Algo::me);
+    checkRZ=reinterpret_cast<Algo const *>(a);
+  }
+
+  void operator()(int b, int e, const RecHitsSortedInPhi & innerHitsMap, bool * ok) const {
+    if (innerHitsMap.hasTiles()) tiled(b,e,innerHitsMap,ok);
+    else (*this)(b,e,innerHitsMap.u.data(),innerHitsMap.v.data(),innerHitsMap.dv.data(),ok);
+  }
+
+  void operator()(int b, int e, float const * u, float const * v, float const * dv, bool * ok) const {
+    constexpr float nSigmaRZ = RecHitsSortedInPhi::nSigmaRZ;
+    for (int i=b; i!=e; ++i) {
+      Range allowed = checkRZ->range(u[i]);
+      float vErr = nSigmaRZ * dv[i];
+      Range hitRZ(v[i]-vErr, v[i]+vErr);
+      Range crossRange = allowed.intersection(hitRZ);
+      ok[i-b] = ! crossRange.empty() ;
+    }
+  }
+
+  // Window of v containing the allowed range of all the hits with u in (uMin,uMax).
+  // The bounds of the ranges are monotonic in u (or min/max of monotonic functions),
+  // so they are at the ends of the interval, up to the rounding covered by the margin.
+  // HitRCheck (and HitEtaCheck on a forward layer) returns a range up to HitRCheck::rBig
+  // when a line does not cross the layer: then the window is not restricted.
+  Range window(float uMin, float uMax) const {
+    constexpr float margin = 0.01f;
+    Range r1 = checkRZ->range(uMin);
+    Range r2 = checkRZ->range(uMax);
+    if (r1.max()>=HitRCheck::rBig || r2.max()>=HitRCheck::rBig)
+      return Range(-std::numeric_limits<float>::max(),std::numeric_limits<float>::max());
+    return Range(std::min(r1.min(),r2.min())-margin, std::max(r1.max(),r2.max())+margin);
+  }
+
+  // same as above, running over the tiles of the phi range that overlap the window in v
+  void tiled(int b, int e, const RecHitsSortedInPhi & innerHitsMap, bool * ok) const {
+    std::fill(ok,ok+(e-b),false);
+    if (b==e) return;
+    Range allowed = window(innerHitsMap.uMin,innerHitsMap.uMax);
+    int nv = innerHitsMap.nVBins;
+    int pb = innerHitsMap.phiBin(innerHitsMap.phi(b));
+    int pe = innerHitsMap.phiBin(innerHitsMap.phi(e-1));
+    for (int ip=pb; ip<=pe; ++ip) {
+      for (int t=ip*nv; t!=(ip+1)*nv; ++t) {
+        int tb = innerHitsMap.tileStart[t], te = innerHitsMap.tileStart[t+1];
+        if (tb==te || innerHitsMap.tileVHigh[t]<allowed.min() || innerHitsMap.tileVLow[t]>allowed.max()) continue;
+        bool tileOk[te-tb];
+        (*this)(tb,te,innerHitsMap.tileU.data(),innerHitsMap.tileV.data(),innerHitsMap.tileDV.data(),tileOk);
+        for (int i=tb; i!=te; ++i) {
+          int ih = innerHitsMap.tileHit[i];
+          if (tileOk[i-tb] && ih>=b && ih<e) ok[ih-b] = true;
+        }
+      }
+    }
+  }
+
+  Algo const * checkRZ;
+
+};
+
+template<typename ... Args> using HitRZCompatibilityKernels = std::tuple<HitRZCompatibilityKernel<Args>...>;
+
+#endif
@@ -3,6 +3,7 @@
 
 #include <algorithm>
 #include<cassert>
+#include<limits>
 
 
 
@@ -48,6 +49,55 @@ RecHitsSortedInPhi::RecHitsSortedInPhi(const std::vector<Hit>& hits, GlobalPoint
 }
 
 
+namespace {
+  // a few hits per tile, the number of bins is limited for the large layers
+  constexpr int hitsPerTile = 4;
+  constexpr int maxPhiBins = 64;
+  constexpr int maxVBins = 16;
+}
+
+void RecHitsSortedInPhi::buildTiles() {
+  const int n = theHits.size();
+  if (n==0) return;
+
+  auto ur = std::minmax_element(u.begin(),u.end());
+  uMin = *ur.first; uMax = *ur.second;
+  auto vr = std::minmax_element(v.begin(),v.end());
+  vBinMin = *vr.first;
+  const float vSize = *vr.second - vBinMin;
+
+  nPhiBins = std::min(maxPhiBins, std::max(1, n/(hitsPerTile*maxVBins)));
+  nVBins = vSize>0 ? std::min(maxVBins, std::max(1, n/(hitsPerTile*nPhiBins))) : 1;
+  vBinInvSize = vSize>0 ? nVBins/vSize : 0;
+
+  // stable counting sort of the hits by tile
+  const int nTiles = nPhiBins*nVBins;
+  std::vector<int> tile(n);
+  tileStart.assign(nTiles+1,0);
+  for (int i=0; i!=n; ++i) {
+    tile[i] = phiBin(phi(i))*nVBins + vBin(v[i]);
+    ++tileStart[tile[i]+1];
+  }
+  for (int t=1; t<=nTiles; ++t) tileStart[t] += tileStart[t-1];
+
+  std::vector<int> pos(tileStart.begin(),tileStart.end()-1);
+  tileVLow.assign(nTiles,std::numeric_limits<float>::max());
+  tileVHigh.assign(nTiles,std::numeric_limits<float>::lowest());
+  tileHit.resize(n); tileU.resize(n); tileV.resize(n); tileDV.resize(n);
+  for (int i=0; i!=n; ++i) {
+    const int t = tile[i];
+    const int ip = pos[t]++;
+    tileHit[ip] = i;
+    tileU[ip] = u[i];
+    tileV[ip] = v[i];
+    tileDV[ip] = dv[i];
+    const float vErr = nSigmaRZ * dv[i];
+    tileVLow[t] = std::min(tileVLow[t], v[i]-vErr);
+    tileVHigh[t] = std::max(tileVHigh[t], v[i]+vErr);
+  }
+}
+
+
 RecHitsSortedInPhi::DoubleRange RecHitsSortedInPhi::doubleRange(float phiMin, float phiMax) const {
   Range r1,r2;
   if ( phiMin < phiMax) {
@@ -4,47 +4,165 @@
 #include "RecoTracker/TkTrackingRegions/interface/HitZCheck.h"
 
 #include "RecoTracker/TkHitPairs/interface/RecHitsSortedInPhi.h"
+#include "RecoTracker/TkHitPairs/src/HitRZCompatibilityKernel.h"
+
+#include "TrackingTools/DetLayers/interface/DetLayer.h"
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
 
 typedef PixelRecoRange<float> Range;
 
 
-// devirtualizer
-#include<tuple>
+void testR(HitRZCompatibility const * algo, int b, int e, const RecHitsSortedInPhi & innerHitsMap, bool * ok) {
+  HitRZCompatibilityKernel<HitRCheck> k; k.set(algo);
+  k(b,e, innerHitsMap,ok);
+}
+
+void testZ(HitRZCompatibility const * algo, int b, int e, const RecHitsSortedInPhi & innerHitsMap, bool * ok) {
+  HitRZCompatibilityKernel<HitZCheck> k; k.set(algo);
+  k(b,e, innerHitsMap,ok);
+}
+
+
 namespace {
 
-  template<typename Algo>
-  struct Kernel {
-    using  Base = HitRZCompatibility;
-    void set(Base const * a) {
-      assert( a->algo()==Algo::me);
-      checkRZ=reinterpret_cast<Algo const *>(a);
+  // only isBarrel is used by RecHitsSortedInPhi
+  class FakeDetLayer final : public DetLayer {
+  public:
+    explicit FakeDetLayer(bool barrel) : DetLayer(false,barrel) {}
+    const BoundSurface& surface() const override { return *theSurface; }
+    const std::vector<const GeometricSearchDet*>& components() const override { return theComponents; }
+    const std::vector<const GeomDet*>& basicComponents() const override { return theBasicComponents; }
+    std::pair<bool, TrajectoryStateOnSurface>
+    compatible(const TrajectoryStateOnSurface& ts, const Propagator&, const MeasurementEstimator&) const override {
+      return std::make_pair(false,ts);
+    }
+    SubDetector subDetector() const override { return isBarrel() ? GeomDetEnumerators::PixelBarrel : GeomDetEnumerators::PixelEndcap; }
+    Location location() const override { return isBarrel() ? GeomDetEnumerators::barrel : GeomDetEnumerators::endcap; }
+  private:
+    BoundSurface const * theSurface = nullptr;
+    std::vector<const GeometricSearchDet*> theComponents;
+    std::vector<const GeomDet*> theBasicComponents;
+  };
+
+  std::mt19937 rng(1234);
+
+  float flat(float a, float b) { return std::uniform_real_distribution<float>(a,b)(rng); }
+
+  // n hits at random phi, u and v, with the rz errors of the pixels
+  RecHitsSortedInPhi makeLayer(DetLayer const & layer, int n, float uMin, float uMax, float vMin, float vMax) {
+    RecHitsSortedInPhi hits(std::vector<RecHitsSortedInPhi::Hit>(), GlobalPoint(0,0,0), &layer);
+    std::vector<float> phi(n);
+    for (auto & p : phi) p = flat(-Geom::fpi(),Geom::fpi());
+    std::sort(phi.begin(),phi.end());
+    for (auto p : phi) {
+      hits.theHits.emplace_back(p);
+      hits.u.push_back(flat(uMin,uMax));
+      hits.v.push_back(flat(vMin,vMax));
+      hits.dv.push_back(flat(0.001f,0.02f));
     }
-    
-    void operator()(int b, int e, const RecHitsSortedInPhi & innerHitsMap, bool * ok) const {
-      constexpr float nSigmaRZ = 3.46410161514; // std::sqrt(12.f);
-      for (int i=b; i!=e; ++i) {
-	Range allowed = checkRZ->range(innerHitsMap.u[i]);
-	float vErr = nSigmaRZ * innerHitsMap.dv[i];
-	Range hitRZ(innerHitsMap.v[i]-vErr, innerHitsMap.v[i]+vErr);
-	Range crossRange = allowed.intersection(hitRZ);
-	ok[i-b] = ! crossRange.empty() ;
+    return hits;
+  }
+
+  // a random constraint from a vertex in (zv-dz,zv+dz) to an outer point
+  HitRZConstraint makeConstraint(float rOuter, float zOuter) {
+    float zv = flat(-10.f,10.f), dz = flat(0.1f,5.f);
+    HitRZConstraint::Point outer(rOuter,zOuter);
+    return HitRZConstraint(HitRZConstraint::Line(HitRZConstraint::Point(0,zv-dz),outer),
+                           HitRZConstraint::Line(HitRZConstraint::Point(0,zv+dz),outer));
+  }
+
+  int failures = 0;
+  int accepted = 0;
+
+  // the hits of random phi ranges, with and without the tiles
+  template<typename Algo>
+  void compare(char const * what, Algo const & check, RecHitsSortedInPhi const & tiled, RecHitsSortedInPhi const & untiled) {
+    HitRZCompatibilityKernel<Algo> kernel; kernel.set(&check);
+    for (int trial=0; trial!=20; ++trial) {
+      float phi = flat(-Geom::fpi(),Geom::fpi()), dphi = flat(0.01f,0.5f);
+      auto range = tiled.doubleRange(phi-dphi,phi+dphi);
+      for (int j=0; j<3; j+=2) {
+        auto b = range[j]; auto e=range[j+1];
+        std::unique_ptr<bool[]> okTiled(new bool[e-b+1]), okUntiled(new bool[e-b+1]);
+        kernel(b,e,tiled,okTiled.get());
+        kernel(b,e,untiled,okUntiled.get());
+        for (int i=0; i!=e-b; ++i) {
+          if (okTiled[i]!=okUntiled[i]) {
+            std::cout << what << ": hit " << b+i << " tiled " << okTiled[i]
+                      << " untiled " << okUntiled[i] << std::endl;
+            ++failures;
+          }
+          if (okUntiled[i]) ++accepted;
+        }
       }
     }
-    Algo const * checkRZ;
-    
-  };
+  }
 
+  // barrel layer: u=r, v=z
+  void testBarrel() {
+    FakeDetLayer layer(true);
+    for (int n : {10, 100, 1000, 5000}) {
+      auto tiled = makeLayer(layer,n,6.5f,7.5f,-27.f,27.f);
+      auto untiled = tiled;
+      tiled.buildTiles();
+      if (n>=1000 && (tiled.nPhiBins<2 || tiled.nVBins<2)) {
+        std::cout << "barrel: " << n << " hits in a single tile" << std::endl;
+        ++failures;
+      }
+      for (int k=0; k!=50; ++k) {
+        auto rz = makeConstraint(flat(9.f,12.f),flat(-40.f,40.f));
+        compare("barrel z", HitZCheck(rz,HitZCheck::Margin(flat(0.f,0.1f),flat(0.f,0.1f))), tiled, untiled);
+        // the lines of HitEtaCheck go through the outer hit
+        HitRZConstraint::Point outer(flat(9.f,12.f),flat(-40.f,40.f));
+        float cot = flat(-3.f,3.f);
+        compare("barrel eta", HitEtaCheck(true,outer,cot+flat(0.f,0.2f),cot), tiled, untiled);
+      }
+    }
+  }
 
-  template<typename ... Args> using Kernels = std::tuple<Kernel<Args>...>;
+  // forward layer: u=z, v=r
+  // the constraints pointing away from the layer, or almost parallel to it, are
+  // not restricted in r (up to HitRCheck::rBig) and all the tiles are run over
+  void testForward() {
+    FakeDetLayer layer(false);
+    for (int n : {10, 100, 1000, 5000}) {
+      auto tiled = makeLayer(layer,n,34.f,36.f,4.5f,16.f);
+      auto untiled = tiled;
+      tiled.buildTiles();
+      for (int k=0; k!=50; ++k) {
+        // through the layer
+        auto rz = makeConstraint(flat(5.f,15.f),flat(45.f,55.f));
+        compare("forward r", HitRCheck(rz,HitRCheck::Margin(flat(0.f,0.1f),flat(0.f,0.1f))), tiled, untiled);
+        // not crossing it
+        auto away = makeConstraint(flat(5.f,15.f),flat(-55.f,-45.f));
+        compare("forward r away", HitRCheck(away), tiled, untiled);
+        auto flatLines = makeConstraint(flat(30.f,100.f),flat(-1.f,1.f));
+        compare("forward r parallel", HitRCheck(flatLines), tiled, untiled);
+        HitRZConstraint::Point outer(flat(5.f,15.f),flat(45.f,55.f));
+        float cot = flat(-2.f,10.f);
+        compare("forward eta", HitEtaCheck(false,outer,cot+flat(0.f,0.5f),cot), tiled, untiled);
+      }
+    }
+  }
 
 }
 
-void testR(HitRZCompatibility const * algo, int b, int e, const RecHitsSortedInPhi & innerHitsMap, bool * ok) {
-  Kernel<HitRCheck> k; k.set(algo);
-  k(b,e, innerHitsMap,ok);
-}
 
-void testZ(HitRZCompatibility const * algo, int b, int e, const RecHitsSortedInPhi & innerHitsMap, bool * ok) {
-  Kernel<HitZCheck> k; k.set(algo);
-  k(b,e, innerHitsMap,ok);
+int main() {
+  testBarrel();
+  testForward();
+  if (accepted==0) {
+    std::cout << "no hit accepted" << std::endl;
+    ++failures;
+  }
+  if (failures) {
+    std::cout << failures << " failures" << std::endl;
+    return 1;
+  }
+  return 0;
 }
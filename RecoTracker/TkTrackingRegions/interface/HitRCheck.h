@@ -10,6 +10,7 @@
 class HitRCheck final : public HitRZCompatibility {
 public:
   static constexpr Algo me =rAlgo;
+  static constexpr float rBig = 150.f; //something above the detector ranges
 
   typedef TkTrackingRegionsMargin<float> Margin;
 
@@ -35,7 +36,6 @@ private:
 
 HitRCheck::Range HitRCheck::range(const float & z) const
 {
-  constexpr float rBig = 150.; //something above the detector ranges
   const auto & lineLeft =  theRZ.lineLeft();
   const auto & lineRight = theRZ.lineRight();
   
@@ -47,6 +47,8 @@ using namespace PixelRecoUtilities;
 using namespace std;
 using namespace ctfseeding; 
 
+constexpr float HitRCheck::rBig;
+
 RectangularEtaPhiTrackingRegion::UseMeasurementTracker RectangularEtaPhiTrackingRegion::stringToUseMeasurementTracker(const std::string& name) {
   std::string tmp = name;
   std::transform(tmp.begin(), tmp.end(), tmp.begin(), ::tolower);
@@ -142,6 +142,15 @@ public:
 
   bool gsfIntermediarySmoothing() const { return gsfIntermediarySmoothing_;}
 
+  /**
+   *   Linearize and weight the tracks of large vertices in parallel.
+   *   Only to be used with a thread-safe annealing schedule, compatibility
+   *   estimator and linearized track factory, as the default ones.
+   *   The result does not depend on the number of threads.
+   */
+  void parallelTracks(bool p) { parallelTracks_ = p; }
+  bool parallelTracks() const { return parallelTracks_; }
+
 private:
   /**
    * Construct new a container of VertexTrack with a new linearization point
@@ -199,6 +208,12 @@ private:
                      bool withPrior) const;
 
   double getWeight ( float chi2 ) const;
+
+  /**
+   *  Whether the per-track loops over nTracks tracks, with the given
+   *  vertex, are to be run in parallel.
+   */
+  bool runInParallel ( unsigned int nTracks, const CachingVertex<5> & vertex ) const;
 private:
   double theMaxShift;
   double theMaxLPShift;
@@ -213,6 +228,7 @@ private:
   VertexTrackCompatibilityEstimator<5> * theComp;
   const AbstractLTSFactory<5> * theLinTrkFactory;
   bool gsfIntermediarySmoothing_;
+  bool parallelTracks_;
 };
 
 #endif
@@ -8,6 +8,9 @@
 
 #include <algorithm>
 
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+
 using namespace edm;
 
 // #define STORE_WEIGHTS
@@ -57,6 +60,31 @@ namespace {
 
   GlobalError const linPointError = initLinePointError();
 
+  // minimum number of tracks for which the per-track loops are run in parallel
+  const unsigned int minParallelTracks = 32;
+
+  // the vertex states compute their position, error and weight on demand
+  void fillCaches ( const VertexState & state ) {
+      state.position();
+      state.time();
+      state.error4D();
+      state.weight4D();
+      state.weightTimesPosition4D();
+  }
+
+  // run f(i) for i in [0,n), in parallel or not
+  template <typename F>
+  void forEachTrack ( unsigned int n, bool parallel, const F & f ) {
+      if ( parallel ) {
+        tbb::parallel_for ( tbb::blocked_range<unsigned int>(0, n),
+                            [&f](const tbb::blocked_range<unsigned int> & r) {
+                              for ( unsigned int i = r.begin(); i != r.end(); ++i ) f(i);
+                            } );
+      } else {
+        for ( unsigned int i = 0; i != n; ++i ) f(i);
+      }
+  }
+
 
 
 
@@ -103,7 +131,7 @@ AdaptiveVertexFitter::AdaptiveVertexFitter(
     theLinP(linP.clone()), theUpdator( updator.clone()),
     theSmoother ( smoother.clone() ), theAssProbComputer( ann.clone() ),
     theComp ( crit.clone() ), theLinTrkFactory ( ltsf.clone() ),
-    gsfIntermediarySmoothing_(false)
+    gsfIntermediarySmoothing_(false), parallelTracks_(false)
 {
   setParameters();
 }
@@ -123,7 +151,8 @@ AdaptiveVertexFitter::AdaptiveVertexFitter
     theAssProbComputer ( o.theAssProbComputer->clone() ),
     theComp ( o.theComp->clone() ),
     theLinTrkFactory ( o.theLinTrkFactory->clone() ),
-    gsfIntermediarySmoothing_(o.gsfIntermediarySmoothing_)
+    gsfIntermediarySmoothing_(o.gsfIntermediarySmoothing_),
+    parallelTracks_(o.parallelTracks_)
 {}
 
 AdaptiveVertexFitter::~AdaptiveVertexFitter()
@@ -315,20 +344,20 @@ AdaptiveVertexFitter::linearizeTracks(const vector<reco::TransientTrack> & track
                                       const VertexState & seed ) const
 {
   const GlobalPoint & linP ( seed.position() );
-  vector<RefCountedLinearizedTrackState> lTracks;
-  for(vector<reco::TransientTrack>::const_iterator i = tracks.begin();
-      i != tracks.end(); ++i )
-  {
+  vector<RefCountedLinearizedTrackState> lTracks ( tracks.size() );
+  forEachTrack ( tracks.size(), parallelTracks_ && tracks.size() >= minParallelTracks,
+                 [&](unsigned int i) {
     try {
-      RefCountedLinearizedTrackState lTrData
-        = theLinTrkFactory->linearizedTrackState(linP, *i);
-      lTracks.push_back(lTrData);
+      lTracks[i] = theLinTrkFactory->linearizedTrackState(linP, tracks[i]);
     } catch ( exception & e ) {
       LogInfo("RecoVertex/AdaptiveVertexFitter") 
         << "Exception " << e.what() << " in ::linearizeTracks."
         << "Your future vertex has just lost a track.";
     };
-  }
+  } );
+  // drop the tracks which could not be linearized, keeping the order
+  lTracks.erase ( std::remove ( lTracks.begin(), lTracks.end(),
+                                RefCountedLinearizedTrackState() ), lTracks.end() );
   return weightTracks(lTracks, seed );
 }
 
@@ -344,25 +373,21 @@ AdaptiveVertexFitter::reLinearizeTracks(
 {
   VertexState seed = vertex.vertexState();
   GlobalPoint linP = seed.position();
-  vector<RefCountedLinearizedTrackState> lTracks;
-  for(vector<RefCountedVertexTrack>::const_iterator i = tracks.begin();
-    i != tracks.end(); i++)
-  {
+  vector<RefCountedLinearizedTrackState> lTracks ( tracks.size() );
+  forEachTrack ( tracks.size(), parallelTracks_ && tracks.size() >= minParallelTracks,
+                 [&](unsigned int i) {
     try {
-      RefCountedLinearizedTrackState lTrData
-        = theLinTrkFactory->linearizedTrackState( linP, (**i).linearizedTrack()->track() );
+      lTracks[i] = theLinTrkFactory->linearizedTrackState( linP, tracks[i]->linearizedTrack()->track() );
       /*
-      RefCountedLinearizedTrackState lTrData =
-              (**i).linearizedTrack()->stateWithNewLinearizationPoint(linP);
+      lTracks[i] = tracks[i]->linearizedTrack()->stateWithNewLinearizationPoint(linP);
               */
-      lTracks.push_back(lTrData);
     } catch ( exception & e ) {
       LogInfo("RecoVertex/AdaptiveVertexFitter") 
         << "Exception " << e.what() << " in ::relinearizeTracks. "
         << "Will not relinearize this track.";
-      lTracks.push_back ( (**i).linearizedTrack() );
+      lTracks[i] = tracks[i]->linearizedTrack();
     };
-  };
+  } );
   return reWeightTracks(lTracks, vertex );
 }
 
@@ -389,6 +414,25 @@ double AdaptiveVertexFitter::getWeight ( float chi2 ) const
   return weight;
 }
 
+bool AdaptiveVertexFitter::runInParallel ( unsigned int nTracks,
+                                           const CachingVertex<5> & vertex ) const
+{
+  #ifdef STORE_WEIGHTS
+  return false;
+  #endif
+  if ( !parallelTracks_ || nTracks < minParallelTracks ) return false;
+  // the vertex is shared between the threads: fill its caches beforehand.
+  // If this fails, leave it to the serial loop to report the problem.
+  try {
+    fillCaches ( vertex.vertexState() );
+    if ( vertex.hasPrior() ) fillCaches ( vertex.priorVertexState() );
+    vertex.degreesOfFreedom();
+  } catch ( exception & e ) {
+    return false;
+  }
+  return true;
+}
+
 vector<AdaptiveVertexFitter::RefCountedVertexTrack>
 AdaptiveVertexFitter::reWeightTracks(
                     const vector<RefCountedLinearizedTrackState> & lTracks,
@@ -399,19 +443,20 @@ AdaptiveVertexFitter::reWeightTracks(
   theNr++;
   // GlobalPoint pos = seed.position();
 
-  vector<RefCountedVertexTrack> finalTracks;
+  vector<RefCountedVertexTrack> finalTracks ( lTracks.size() );
   VertexTrackFactory<5> vTrackFactory;
   #ifdef STORE_WEIGHTS
   iter++;
   #endif
-  for(vector<RefCountedLinearizedTrackState>::const_iterator i
-        = lTracks.begin(); i != lTracks.end(); i++)
-  {
+  // each track is weighted independently of the others
+  forEachTrack ( lTracks.size(), runInParallel ( lTracks.size(), vertex ),
+                 [&](unsigned int ind) {
+    const RefCountedLinearizedTrackState * i = &lTracks[ind];
     double weight=0.;
     // cout << "[AdaptiveVertexFitter] estimate " << endl;
     pair < bool, double > chi2Res ( false, 0. );
     try {
-      chi2Res =  theComp->estimate ( vertex, *i, std::distance(lTracks.begin(),i) );
+      chi2Res =  theComp->estimate ( vertex, *i, ind );
     } catch ( exception const & e ) {};
     // cout << "[AdaptiveVertexFitter] /estimate " << endl;
     if (!chi2Res.first) {
@@ -436,8 +481,8 @@ AdaptiveVertexFitter::reWeightTracks(
     dataharvester::Writer::file("w.txt").save ( m );
     #endif
 
-    finalTracks.push_back(vTrData);
-  }
+    finalTracks[ind] = vTrData;
+  } );
   sortByDistanceToRefPoint( finalTracks, vertex.position() );
   // cout << "[AdaptiveVertexFitter] /now reweight" << endl;
   return finalTracks;
@@ -454,17 +499,16 @@ AdaptiveVertexFitter::weightTracks(
    * be done with a reset annealer! */
   theAssProbComputer->resetAnnealing();
 
-  vector<RefCountedVertexTrack> finalTracks;
+  vector<RefCountedVertexTrack> finalTracks ( lTracks.size() );
   VertexTrackFactory<5> vTrackFactory;
   #ifdef STORE_WEIGHTS
   iter++;
   #endif
-  for(vector<RefCountedLinearizedTrackState>::const_iterator i
-        = lTracks.begin(); i != lTracks.end(); i++)
-  {
-
+  forEachTrack ( lTracks.size(), runInParallel ( lTracks.size(), seedvtx ),
+                 [&](unsigned int ind) {
+    const RefCountedLinearizedTrackState * i = &lTracks[ind];
     double weight = 0.;
-    pair<bool, double> chi2Res = theComp->estimate ( seedvtx, *i, std::distance(lTracks.begin(),i) );
+    pair<bool, double> chi2Res = theComp->estimate ( seedvtx, *i, ind );
     if (!chi2Res.first) {
       // cout << "[AdaptiveVertexFitter] Aiee! " << endl;
       LogInfo ("AdaptiveVertexFitter" ) << "When weighting a track, chi2 calculation failed;"
@@ -484,8 +528,8 @@ AdaptiveVertexFitter::weightTracks(
     m["pos"]="weight";
     dataharvester::Writer::file("w.txt").save ( m );
     #endif
-    finalTracks.push_back(vTrData);
-  }
+    finalTracks[ind] = vTrData;
+  } );
   return finalTracks;
 }
 
@@ -0,0 +1,114 @@
+// AdaptiveVertexFitter with parallelTracks(true), on several threads,
+// against the serial fit: the same position, covariance, chi2 and track
+// weights, bit for bit, with and without a beam spot constraint
+
+#include "RecoVertex/AdaptiveVertexFit/interface/AdaptiveVertexFitter.h"
+
+#include "DataFormats/BeamSpot/interface/BeamSpot.h"
+#include "DataFormats/TrackReco/interface/Track.h"
+#include "MagneticField/UniformEngine/interface/UniformMagneticField.h"
+#include "TrackingTools/TransientTrack/interface/TransientTrack.h"
+
+#include "tbb/task_scheduler_init.h"
+
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+  std::mt19937 rng(38);
+
+  double flat(double a, double b) { return std::uniform_real_distribution<double>(a,b)(rng); }
+  double gauss(double mean, double sigma) { return std::normal_distribution<double>(mean,sigma)(rng); }
+
+  // tracks from a vertex, a fifth of them from another vertex close in z,
+  // so that the fit gives them intermediate and small weights
+  std::vector<reco::TransientTrack> makeVertex(unsigned int nTracks, reco::BeamSpot const & bs, MagneticField const * field) {
+    const double xv = gauss(0.,0.002), yv = gauss(0.,0.002), zv = gauss(0.,4.);
+    std::vector<reco::TransientTrack> tracks;
+    for (unsigned int it = 0; it != nTracks; ++it) {
+      const double z = it%5==4 ? zv+flat(0.02,0.3) : zv;
+      double pt = flat(0.7,5.), phi = flat(-M_PI,M_PI), eta = flat(-2.4,2.4);
+      reco::Track::Vector momentum(pt*std::cos(phi), pt*std::sin(phi), pt*std::sinh(eta));
+      double p = pt*std::cosh(eta);
+      double dxyError = flat(0.002,0.02), dzError = flat(0.003,0.05);
+      reco::Track::CovarianceMatrix cov;
+      cov(reco::TrackBase::i_qoverp,reco::TrackBase::i_qoverp) = 1.e-4/(p*p);
+      cov(reco::TrackBase::i_lambda,reco::TrackBase::i_lambda) = 1.e-6;
+      cov(reco::TrackBase::i_phi,reco::TrackBase::i_phi) = 1.e-6;
+      cov(reco::TrackBase::i_dxy,reco::TrackBase::i_dxy) = dxyError*dxyError;
+      cov(reco::TrackBase::i_dsz,reco::TrackBase::i_dsz) = dzError*dzError*pt*pt/(p*p);
+      const double d0 = gauss(0.,dxyError);
+      reco::Track::Point point(xv+d0*std::sin(phi), yv-d0*std::cos(phi), z+gauss(0.,dzError));
+      reco::Track track(10.,10.,point,momentum,it%2 ? 1 : -1,cov);
+      tracks.emplace_back(track,field);
+      tracks.back().setBeamSpot(bs);
+    }
+    return tracks;
+  }
+
+  int failures = 0;
+
+  void compare(CachingVertex<5> const & serial, CachingVertex<5> const & parallel, unsigned int nTracks, const char * what) {
+    bool same = serial.isValid() == parallel.isValid();
+    if (same && serial.isValid()) {
+      const GlobalPoint & ps = serial.position(), & pp = parallel.position();
+      same = ps.x() == pp.x() && ps.y() == pp.y() && ps.z() == pp.z();
+      const GlobalError es = serial.error(), ep = parallel.error();
+      same = same && es.cxx() == ep.cxx() && es.cyx() == ep.cyx() && es.cyy() == ep.cyy() &&
+	es.czx() == ep.czx() && es.czy() == ep.czy() && es.czz() == ep.czz();
+      same = same && serial.totalChiSquared() == parallel.totalChiSquared() &&
+	serial.degreesOfFreedom() == parallel.degreesOfFreedom();
+      const auto ts = serial.tracks(), tp = parallel.tracks();
+      same = same && ts.size() == tp.size();
+      for (unsigned int i = 0; same && i < ts.size(); ++i) same = ts[i]->weight() == tp[i]->weight();
+    }
+    if (!same) {
+      std::cout << nTracks << " tracks, " << what << ": the parallel fit differs";
+      if (serial.isValid() && parallel.isValid())
+	std::cout << ", z " << serial.position().z() << " " << parallel.position().z()
+		  << " chi2 " << serial.totalChiSquared() << " " << parallel.totalChiSquared();
+      std::cout << std::endl;
+      ++failures;
+    }
+  }
+
+}
+
+
+int main() {
+  tbb::task_scheduler_init init(4);
+
+  UniformMagneticField field(3.8);
+  reco::BeamSpot::CovarianceMatrix bsError;
+  for (int i=0; i!=reco::BeamSpot::dimension; ++i) bsError(i,i) = 1.e-8;
+  reco::BeamSpot bs(reco::BeamSpot::Point(0.,0.,0.),4.,0.,0.,0.002,bsError);
+
+  AdaptiveVertexFitter serial;
+  AdaptiveVertexFitter parallel;
+  parallel.parallelTracks(true);
+
+  unsigned int valid = 0;
+  // below and above the minimum number of tracks of the parallel loops
+  for (unsigned int nTracks : {5, 31, 32, 50, 100, 200}) {
+    for (int trial = 0; trial < 10; ++trial) {
+      auto tracks = makeVertex(nTracks, bs, &field);
+      auto reference = serial.vertex(tracks);
+      compare(reference, parallel.vertex(tracks), nTracks, "no constraint");
+      compare(serial.vertex(tracks, bs), parallel.vertex(tracks, bs), nTracks, "beam spot constraint");
+      if (reference.isValid()) ++valid;
+    }
+  }
+
+  if (valid == 0) {
+    std::cout << "no valid vertex" << std::endl;
+    ++failures;
+  }
+  if (failures) {
+    std::cout << failures << " failures" << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -54,6 +54,10 @@ PrimaryVertexProducer::PrimaryVertexProducer(const edm::ParameterSet& conf)
     theTrackClusterizer = new DAClusterizerInZT(conf.getParameter<edm::ParameterSet>("TkClusParameters").getParameter<edm::ParameterSet>("TkDAClusParameters"));
     f4D = true;
   }
+  else if( clusteringAlgorithm=="DA2D_vect" ) {
+    theTrackClusterizer = new DAClusterizerInZT_vect(conf.getParameter<edm::ParameterSet>("TkClusParameters").getParameter<edm::ParameterSet>("TkDAClusParameters"));
+    f4D = true;
+  }
 
   else{
     throw VertexException("PrimaryVertexProducerAlgorithm: unknown clustering algorithm: " + clusteringAlgorithm);  
@@ -76,7 +80,9 @@ PrimaryVertexProducer::PrimaryVertexProducer(const edm::ParameterSet& conf)
       if (fitterAlgorithm=="KalmanVertexFitter") {
 	algorithm.fitter= new KalmanVertexFitter();
       } else if( fitterAlgorithm=="AdaptiveVertexFitter") {
-	algorithm.fitter= new AdaptiveVertexFitter( GeometricAnnealing( algoconf->getParameter<double>("chi2cutoff")));
+	AdaptiveVertexFitter * fitter = new AdaptiveVertexFitter( GeometricAnnealing( algoconf->getParameter<double>("chi2cutoff")));
+	fitter->parallelTracks(true);
+	algorithm.fitter= fitter;
       } else {
 	throw VertexException("PrimaryVertexProducerAlgorithm: unknown algorithm: " + fitterAlgorithm);  
       }
@@ -96,7 +102,9 @@ PrimaryVertexProducer::PrimaryVertexProducer(const edm::ParameterSet& conf)
     if (fitterAlgorithm=="KalmanVertexFitter") {
       algorithm.fitter= new KalmanVertexFitter();
     } else if( fitterAlgorithm=="AdaptiveVertexFitter") {
-      algorithm.fitter= new AdaptiveVertexFitter();
+      AdaptiveVertexFitter * fitter = new AdaptiveVertexFitter();
+      fitter->parallelTracks(true);
+      algorithm.fitter= fitter;
     } else {
       throw VertexException("PrimaryVertexProducerAlgorithm: unknown algorithm: " + fitterAlgorithm);  
     }
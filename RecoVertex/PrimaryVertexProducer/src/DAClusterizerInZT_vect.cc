@@ -0,0 +1,819 @@
+#include "RecoVertex/PrimaryVertexProducer/interface/DAClusterizerInZT_vect.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "DataFormats/GeometryCommonDetAlgo/interface/Measurement1D.h"
+#include "RecoVertex/VertexPrimitives/interface/VertexException.h"
+
+#include <cmath>
+#include <cassert>
+#include <limits>
+#include <iomanip>
+#include "FWCore/Utilities/interface/isFinite.h"
+#include "vdt/vdtMath.h"
+
+using namespace std;
+
+namespace {
+  constexpr double epsilon = 1.0e-3;
+  constexpr double vertexSizeTime = 0.008;
+  constexpr double dtCutOff = 4.0;
+
+  double sqr(double f) { return f*f; }
+
+  inline double local_exp( double const& inp) {
+    return vdt::fast_exp( inp );
+  }
+
+  inline void local_exp_list( double const * __restrict__ arg_inp, double * __restrict__ arg_out, const int arg_arr_size) {
+    for(int i=0; i!=arg_arr_size; ++i ) arg_out[i]=vdt::fast_exp(arg_inp[i]);
+  }
+
+  inline
+  double Eik(double t_z, double k_z, double t_dz2, double t_t, double k_t, double t_dt2) {
+    return sqr(t_z - k_z) * t_dz2 + sqr(t_t - k_t) * t_dt2;
+  }
+}
+
+
+DAClusterizerInZT_vect::DAClusterizerInZT_vect(const edm::ParameterSet& conf) :
+  verbose_(conf.getUntrackedParameter<bool>("verbose", false)),
+  useTc_(true),
+  vertexSize_(conf.getParameter<double>("vertexSize")),
+  maxIterations_(100),
+  coolingFactor_(std::sqrt(conf.getParameter<double>("coolingFactor"))),
+  betamax_(0.1),
+  betastop_(1.0),
+  dzCutOff_(conf.getParameter<double>("dzCutOff")),
+  d0CutOff_(conf.getParameter<double>("d0CutOff")),
+  dtCutOff_(dtCutOff)
+{
+
+  double Tmin = conf.getParameter<double>("Tmin")*std::sqrt(2.0);// scale up by sqrt(D=2)
+  if (Tmin==0){
+    edm::LogWarning("DAClusterizerInZT_vect") << "DAClusterizerInZT_vect: invalid Tmin" << Tmin << "  reset do default " << 1./betamax_ << endl;
+  }else{
+    betamax_ = 1./Tmin;
+  }
+
+  // for testing, negative cooling factor: revert to old splitting scheme
+  if(coolingFactor_<0){
+    coolingFactor_=-coolingFactor_; useTc_=false;
+  }
+
+  logCoolingFactor_ = 1.0/std::log(coolingFactor_);
+}
+
+
+DAClusterizerInZT_vect::track_t
+DAClusterizerInZT_vect::fill(const vector<reco::TransientTrack> & tracks) const {
+
+  // prepare track data for clustering
+  track_t tks;
+  for (auto it = tracks.begin(); it!= tracks.end(); it++){
+    double t_pi=1.;
+    auto tsPCA = (*it).stateAtBeamLine().trackStateAtPCA();
+    double t_z = tsPCA.position().z();
+    double t_t = it->timeExt(); // the time
+    if (std::abs(t_z) > 1000.) continue;
+    auto const & t_mom = tsPCA.momentum();
+    //  get the beam-spot
+    reco::BeamSpot beamspot = (*it).stateAtBeamLine().beamSpot();
+    double t_dz2 =
+      sqr((*it).track().dzError()) // track errror
+      + (sqr(beamspot.BeamWidthX()*t_mom.x())+sqr(beamspot.BeamWidthY()*t_mom.y()))*sqr(t_mom.z())/sqr(t_mom.perp2()) // beam spot width
+      + sqr(vertexSize_); // intrinsic vertex size, safer for outliers and short lived decays
+    double t_dt2 = sqr((*it).dtErrorExt()) + sqr(vertexSizeTime); // the ~injected~ timing error, need to add a small minimum vertex size in time
+    if (d0CutOff_ > 0) {
+      Measurement1D atIP =
+	(*it).stateAtBeamLine().transverseImpactParameter();// error contains beamspot
+      t_pi = 1. / (1. + std::exp(sqr(atIP.value() / atIP.error()) - sqr(d0CutOff_))); // reduce weight for high ip tracks
+    }
+    if (edm::isNotFinite(t_pi) || t_pi < std::numeric_limits<double>::epsilon()) continue;
+    tks.AddItem(t_z, t_t, t_dz2, t_dt2, &(*it), t_pi);
+  }
+  tks.ExtractRaw();
+
+  if (verbose_) {
+    std::cout << "Track count " << tks.GetSize() << std::endl;
+  }
+
+  return tks;
+}
+
+
+double DAClusterizerInZT_vect::update(double beta, track_t & gtracks,
+				      vertex_t & gvertices, const double rho0) const {
+
+  // MVF style, no more vertex weights, update tracks weights and vertex positions, with noise
+  // returns the squared sum of changes of vertex positions
+
+  const unsigned int nt = gtracks.GetSize();
+  const unsigned int nv = gvertices.GetSize();
+
+  //initialize sums
+  double sumpi = 0;
+
+  // intial value of a sum, cut-off (eventually add finite size in time)
+  const double Z_init = rho0 * local_exp(-beta * dzCutOff_ * dzCutOff_);
+
+  // define kernels
+  auto kernel_calc_exp_arg = [ beta, nv ] ( const unsigned int itrack,
+					     track_t const& tracks,
+					     vertex_t const& vertices ) {
+    const double track_z = tracks._z[itrack];
+    const double track_t = tracks._t[itrack];
+    const double botrack_dz2 = -beta*tracks._dz2[itrack];
+    const double botrack_dt2 = -beta*tracks._dt2[itrack];
+
+    // auto-vectorized
+    for ( unsigned int ivertex = 0; ivertex < nv; ++ivertex) {
+      const auto mult_resz = track_z - vertices._z[ivertex];
+      const auto mult_rest = track_t - vertices._t[ivertex];
+      vertices._ei_cache[ivertex] = botrack_dz2 * ( mult_resz * mult_resz ) + botrack_dt2 * ( mult_rest * mult_rest );
+    }
+  };
+
+  auto kernel_add_Z = [ nv, Z_init ] (vertex_t const& vertices) -> double
+    {
+      double ZTemp = Z_init;
+      for (unsigned int ivertex = 0; ivertex < nv; ++ivertex) {
+	ZTemp += vertices._pk[ivertex] * vertices._ei[ivertex];
+      }
+      return ZTemp;
+    };
+
+  auto kernel_calc_normalization = [ beta, nv ] (const unsigned int track_num,
+						  track_t & tks_vec,
+						  vertex_t & y_vec ) {
+    auto tmp_trk_pi = tks_vec._pi[track_num];
+    auto o_trk_Z_sum = 1./tks_vec._Z_sum[track_num];
+    auto o_trk_sum_w = tks_vec._sum_w[track_num];
+    auto tmp_trk_z = tks_vec._z[track_num];
+    auto tmp_trk_t = tks_vec._t[track_num];
+    auto obeta =  -1./beta;
+
+    // auto-vectorized
+    for (unsigned int k = 0; k < nv; ++k) {
+      y_vec._se[k] +=  y_vec._ei[k] * (tmp_trk_pi* o_trk_Z_sum);
+      auto w = y_vec._pk[k] * y_vec._ei[k] * (tmp_trk_pi*o_trk_Z_sum *o_trk_sum_w);
+      y_vec._sw[k]  += w;
+      y_vec._swz[k] += w * tmp_trk_z;
+      y_vec._swt[k] += w * tmp_trk_t;
+      y_vec._swE[k] += w * y_vec._ei_cache[k]*obeta;
+    }
+  };
+
+
+  for (auto ivertex = 0U; ivertex < nv; ++ivertex) {
+    gvertices._se[ivertex] = 0.0;
+    gvertices._sw[ivertex] = 0.0;
+    gvertices._swz[ivertex] = 0.0;
+    gvertices._swt[ivertex] = 0.0;
+    gvertices._swE[ivertex] = 0.0;
+    gvertices._tC[ivertex] = 0.0;
+  }
+
+
+
+  // loop over tracks
+  for (auto itrack = 0U; itrack < nt; ++itrack) {
+    kernel_calc_exp_arg(itrack, gtracks, gvertices);
+    local_exp_list(gvertices._ei_cache, gvertices._ei, nv);
+
+    gtracks._Z_sum[itrack] = kernel_add_Z(gvertices);
+    // used in the next major loop to follow
+    sumpi += gtracks._pi[itrack];
+
+    if (gtracks._Z_sum[itrack] > 0){
+      kernel_calc_normalization(itrack, gtracks, gvertices);
+    }
+  }
+
+  // now update z, t and pk
+  double delta=0;
+  for (unsigned int ivertex = 0; ivertex < nv; ++ ivertex ) {
+    if (gvertices._sw[ivertex] > 0) {
+      const double znew = gvertices._swz[ ivertex ] / gvertices._sw[ ivertex ];
+      const double tnew = gvertices._swt[ ivertex ] / gvertices._sw[ ivertex ];
+      delta += sqr( gvertices._z[ ivertex ] - znew ) + sqr( gvertices._t[ ivertex ] - tnew );
+      gvertices._z[ ivertex ] = znew;
+      gvertices._t[ ivertex ] = tnew;
+      gvertices._tC[ ivertex ] = 2 * gvertices._swE[ ivertex ] / gvertices._sw[ ivertex ];
+    } else {
+      edm::LogInfo("sumw") << "invalid sum of weights in fit: " << gvertices._sw[ivertex] << endl;
+      if (verbose_) {
+	std::cout  << " a cluster melted away ?  pk=" << gvertices._pk[ ivertex ] << " sumw="
+		   << gvertices._sw[ivertex] << endl;
+      }
+      gvertices._tC[ ivertex ] = (rho0 == 0. ? -1 : 0);
+    }
+  }
+
+  if (rho0 == 0.) {
+    auto osumpi = 1./sumpi;
+    for (unsigned int ivertex = 0; ivertex < nv; ++ ivertex )
+      gvertices._pk[ ivertex ] = gvertices._pk[ ivertex ] * gvertices._se[ ivertex ] * osumpi;
+  }
+
+  // return how much the prototypes moved
+  return delta;
+}
+
+
+
+
+bool DAClusterizerInZT_vect::merge(vertex_t & y, int nt)const{
+  // merge clusters that collapsed or never separated, return true if vertices were merged, false otherwise
+  const unsigned int nv = y.GetSize();
+
+  if (nv < 2)
+    return false;
+
+  for (unsigned int k = 0; (k + 1) < nv; k++) {
+    if ( std::abs(y._z[k + 1] - y._z[k]) < epsilon &&
+	 std::abs(y._t[k + 1] - y._t[k]) < epsilon    ) {  // with fabs if only called after freeze-out (splitAll() at highter T)
+      double rho = y._pk[k] + y._pk[k+1];
+      if(rho > 0){
+	y._z[k] = (y._pk[k]*y._z[k] + y._pk[k+1]*y._z[k + 1])/rho;
+	y._t[k] = (y._pk[k]*y._t[k] + y._pk[k+1]*y._t[k + 1])/rho;
+      }else{
+	y._z[k] = 0.5 * (y._z[k] + y._z[k + 1]);
+	y._t[k] = 0.5 * (y._t[k] + y._t[k + 1]);
+      }
+      y._pk[k] = rho;
+
+      y.RemoveItem(k+1);
+      return true;
+    }
+  }
+
+  return false;
+}
+
+
+
+
+bool DAClusterizerInZT_vect::merge(vertex_t & y, double & beta)const{
+  // merge clusters that collapsed or never separated,
+  // only merge if the estimated critical temperature of the merged vertex is below the current temperature
+  // return true if vertices were merged, false otherwise
+  const unsigned int nv = y.GetSize();
+
+  if (nv < 2)
+    return false;
+
+  for (unsigned int k = 0; (k + 1) < nv; k++) {
+    if ( std::abs(y._z[k + 1] - y._z[k]) < 2*epsilon &&
+	 std::abs(y._t[k + 1] - y._t[k]) < 2*epsilon    ) {
+      double rho = y._pk[k]+y._pk[k+1];
+      double swE = y._swE[k]+y._swE[k+1]-y._pk[k]*y._pk[k+1] / rho*( sqr(y._z[k+1]-y._z[k]) +
+								     sqr(y._t[k+1]-y._t[k])   );
+      double Tc = 2*swE / (y._sw[k]+y._sw[k+1]);
+
+      if(Tc*beta < 1){
+	if(rho > 0){
+	  y._z[k] = (y._pk[k]*y._z[k] + y._pk[k+1]*y._z[k + 1])/rho;
+	  y._t[k] = (y._pk[k]*y._t[k] + y._pk[k+1]*y._t[k + 1])/rho;
+	}else{
+	  y._z[k] = 0.5 * (y._z[k] + y._z[k + 1]);
+	  y._t[k] = 0.5 * (y._t[k] + y._t[k + 1]);
+	}
+	y._pk[k] = rho;
+	y._sw[k] += y._sw[k+1];
+	y._swE[k] = swE;
+	y._tC[k] = Tc;
+	y.RemoveItem(k+1);
+	return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+
+
+
+bool
+DAClusterizerInZT_vect::purge(vertex_t & y, track_t & tks, double & rho0, const double beta) const {
+  // eliminate clusters with only one significant/unique track
+  const unsigned int nv = y.GetSize();
+  const unsigned int nt = tks.GetSize();
+
+  if (nv < 2)
+    return false;
+
+  double sumpmin = nt;
+  unsigned int k0 = nv;
+
+  // arguments and values of the exponentials of one vertex, for all tracks
+  std::vector<double> arg(nt), p(nt);
+
+  for (unsigned int k = 0; k < nv; k++) {
+
+    int nUnique = 0;
+    double sump = 0;
+
+    double pmax = y._pk[k] / (y._pk[k] + rho0 * local_exp(-beta * dzCutOff_* dzCutOff_));
+    for (unsigned int i = 0; i < nt; i++) {
+      arg[i] = -beta * Eik(tks._z[i], y._z[k], tks._dz2[i], tks._t[i], y._t[k], tks._dt2[i]);
+    }
+    local_exp_list(arg.data(), p.data(), nt);
+    for (unsigned int i = 0; i < nt; i++) {
+      if (tks._Z_sum[i] > 0) {
+	const double pik = y._pk[k] * p[i] / tks._Z_sum[i];
+	sump += pik;
+	if ((pik > 0.9 * pmax) && (tks._pi[i] > 0)) {
+	  nUnique++;
+	}
+      }
+    }
+
+    if ((nUnique < 2) && (sump < sumpmin)) {
+      sumpmin = sump;
+      k0 = k;
+    }
+
+  }
+
+  if (k0 != nv) {
+    if (verbose_) {
+      std::cout  << "eliminating prototype at " << y._z[k0] << "," << y._t[k0]
+		 << " with sump=" << sumpmin << endl;
+    }
+    y.RemoveItem(k0);
+    return true;
+  } else {
+    return false;
+  }
+}
+
+
+
+
+double
+DAClusterizerInZT_vect::beta0(double betamax, track_t const  & tks, vertex_t & y) const {
+
+  double T0 = 0; // max Tc for beta=0
+  // estimate critical temperature from beta=0 (T=inf)
+  const unsigned int nt = tks.GetSize();
+  const unsigned int nv = y.GetSize();
+
+  for (unsigned int k = 0; k < nv; k++) {
+
+    // vertex fit at T=inf
+    double sumwz = 0;
+    double sumwt = 0;
+    double sumw = 0;
+    for (unsigned int i = 0; i < nt; i++) {
+      double w = tks._pi[i] * tks._sum_w[i];
+      sumwz += w * tks._z[i];
+      sumwt += w * tks._t[i];
+      sumw += w;
+    }
+    y._z[k] = sumwz / sumw;
+    y._t[k] = sumwt / sumw;
+
+    // estimate Tcrit, eventually do this in the same loop
+    double a = 0, b = 0;
+    for (unsigned int i = 0; i < nt; i++) {
+      double w = tks._pi[i] * tks._sum_w[i];
+      a += w * Eik(tks._z[i], y._z[k], tks._dz2[i], tks._t[i], y._t[k], tks._dt2[i]);
+      b += w;
+    }
+    double Tc = 2. * a / b; // the critical temperature of this vertex
+    if (Tc > T0) T0 = Tc;
+  }// vertex loop (normally there should be only one vertex at beta=0)
+
+  if(verbose_){
+    std::cout << "DAClustrizerInZT_vect.beta0:   Tc = " << T0 << std::endl;
+  }
+
+  if (T0 > 1. / betamax) {
+    return betamax / std::pow(coolingFactor_, int(std::log(T0 * betamax) * logCoolingFactor_) - 1);
+  } else {
+    // ensure at least one annealing step
+    return betamax / coolingFactor_;
+  }
+}
+
+
+
+bool
+DAClusterizerInZT_vect::split(const double beta,  track_t &tks, vertex_t & y, double threshold ) const{
+  // split only critical vertices (Tc >~ T=1/beta   <==>   beta*Tc>~1)
+  // an update must have been made just before doing this (same beta, no merging)
+  // returns true if at least one cluster was split
+
+  unsigned int nv = y.GetSize();
+
+  // avoid left-right biases by splitting highest Tc first
+
+  std::vector<std::pair<double, unsigned int> > critical;
+  for(unsigned int k=0; k<nv; k++){
+    if (beta*y._tC[k] > threshold){
+      critical.push_back( make_pair(y._tC[k], k));
+    }
+  }
+  if (critical.size()==0) return false;
+
+
+  std::stable_sort(critical.begin(), critical.end(), std::greater<std::pair<double, unsigned int> >() );
+
+
+  bool split=false;
+  const unsigned int nt = tks.GetSize();
+
+  // arguments and values of the exponentials of the split vertex, for all tracks
+  std::vector<double> arg(nt), p(nt);
+
+  for(unsigned int ic=0; ic<critical.size(); ic++){
+    unsigned int k=critical[ic].second;
+
+    for(unsigned int i=0; i<nt; i++){
+      arg[i] = -beta * Eik(tks._z[i], y._z[k], tks._dz2[i], tks._t[i], y._t[k], tks._dt2[i]);
+    }
+    local_exp_list(arg.data(), p.data(), nt);
+
+    // estimate subcluster positions and weight
+    double p1=0, z1=0, t1=0, w1=0;
+    double p2=0, z2=0, t2=0, w2=0;
+    for(unsigned int i=0; i<nt; i++){
+      if (tks._Z_sum[i] > 0) {
+	double pik = y._pk[k] * p[i] / tks._Z_sum[i] * tks._pi[i];
+	double w = pik * tks._sum_w[i];
+	if(tks._z[i] < y._z[k]){
+	  p1 += pik; z1 += w*tks._z[i]; t1 += w*tks._t[i]; w1 += w;
+	}else{
+	  p2 += pik; z2 += w*tks._z[i]; t2 += w*tks._t[i]; w2 += w;
+	}
+      }
+    }
+
+    if(w1>0){ z1 = z1/w1; t1 = t1/w1; } else { z1=y._z[k]-epsilon; t1=y._t[k]-epsilon; }
+    if(w2>0){ z2 = z2/w2; t2 = t2/w2; } else { z2=y._z[k]+epsilon; t2=y._t[k]+epsilon; }
+
+    // reduce split size if there is not enough room
+    if( ( k   > 0 ) && ( y._z[k-1] >= z1 ) ){ z1 = 0.5*(y._z[k] + y._z[k-1]); t1 = 0.5*(y._t[k] + y._t[k-1]); }
+    if( ( k+1 < nv) && ( y._z[k+1] <= z2 ) ){ z2 = 0.5*(y._z[k] + y._z[k+1]); t2 = 0.5*(y._t[k] + y._t[k+1]); }
+
+    // split if the new subclusters are significantly separated
+    if( std::abs(z2-z1) > epsilon || std::abs(t2-t1) > epsilon ){
+      split = true;
+      double pk1 = p1*y._pk[k]/(p1+p2);
+      double pk2 = p2*y._pk[k]/(p1+p2);
+      y._z[k]  =  z2;
+      y._t[k]  =  t2;
+      y._pk[k] = pk2;
+      y.InsertItem(k, z1, t1, pk1);
+      nv++;
+
+     // adjust remaining pointers
+      for(unsigned int jc=ic; jc < critical.size(); jc++){
+        if (critical[jc].second > k) {critical[jc].second++;}
+      }
+    }
+  }
+  return split;
+}
+
+
+
+void DAClusterizerInZT_vect::splitAll( vertex_t & y) const {
+
+  const unsigned int nv = y.GetSize();
+
+  constexpr double zsep = 2 * epsilon; // split vertices that are isolated by at least zsep (vertices that haven't collapsed)
+  constexpr double tsep = 2 * epsilon; // check t as well
+  vertex_t y1;
+
+  for (unsigned int k = 0; k < nv; k++) {
+    if (
+	( (k == 0)       	|| ( y._z[k - 1]	< (y._z[k] - zsep)) ) &&
+	( ((k + 1) == nv)	|| ( y._z[k + 1] 	> (y._z[k] + zsep)) )   )
+      {
+	// isolated prototype, split
+	double new_z = y._z[k] - epsilon;
+	double new_t = y._t[k] - epsilon;
+	y._z[k] = y._z[k] + epsilon;
+	y._t[k] = y._t[k] + epsilon;
+
+	double new_pk = 0.5 * y._pk[k];
+	y._pk[k] = 0.5 * y._pk[k];
+
+	y1.AddItem(new_z, new_t, new_pk);
+	y1.AddItem(y._z[k], y._t[k], y._pk[k]);
+      }
+    else if ( (y1.GetSize() == 0 ) ||
+	      (y1._z[y1.GetSize() - 1] <  (y._z[k] - zsep)) ||
+	      (y1._t[y1.GetSize() - 1] <  (y._t[k] - tsep))  )
+      {
+	y1.AddItem(y._z[k], y._t[k], y._pk[k]);
+      }
+    else
+      {
+	y1._z[y1.GetSize() - 1] = y1._z[y1.GetSize() - 1] - epsilon;
+	y1._t[y1.GetSize() - 1] = y1._t[y1.GetSize() - 1] - epsilon;
+	y._z[k] = y._z[k] + epsilon;
+	y._t[k] = y._t[k] + epsilon;
+	y1.AddItem( y._z[k], y._t[k], y._pk[k]);
+      }
+  }// vertex loop
+
+  y = y1;
+  y.ExtractRaw();
+}
+
+
+
+
+void DAClusterizerInZT_vect::dump(const double beta, const vertex_t & y, const track_t & tks, int verbosity) const{
+
+  const unsigned int nv = y.GetSize();
+  const unsigned int nt = tks.GetSize();
+
+  // tracks sorted in z for nicer printout
+  std::vector<unsigned int> iz;
+  for(unsigned int j = 0; j < nt; j++){ iz.push_back(j); }
+  std::stable_sort(iz.begin(), iz.end(), [&tks](unsigned int a, unsigned int b){ return tks._z[a] < tks._z[b]; });
+
+  std::cout << "-----DAClusterizerInZT_vect::dump ----" << std::endl;
+  std::cout << " beta=" << beta << "   betamax= " << betamax_ << std::endl;
+  std::cout << "                                                               z= ";
+  std::cout.precision(4);
+  for (unsigned int ivertex = 0; ivertex < nv; ++ ivertex) {
+    std::cout << setw(8) << fixed << y._z[ivertex];
+  }
+  std::cout << endl << "                                                               t= ";
+  for (unsigned int ivertex = 0; ivertex < nv; ++ ivertex) {
+    std::cout << setw(8) << fixed << y._t[ivertex];
+  }
+  std::cout << endl << "T=" << setw(15) << 1. / beta
+	    << "                                             Tc= ";
+  for (unsigned int ivertex = 0; ivertex < nv; ++ ivertex) {
+    std::cout << setw(8) << fixed << y._tC[ivertex];
+  }
+
+  std::cout << endl
+	    << "                                                              pk=";
+  for (unsigned int ivertex = 0; ivertex < nv; ++ ivertex) {
+    std::cout << setw(8) << setprecision(3) << fixed << y._pk[ivertex];
+  }
+  std::cout << endl;
+
+  if (verbosity > 0) {
+    double E = 0, F = 0;
+    std::cout << endl;
+    std::cout
+      << "----       z +/- dz        t +/- dt        ip +/-dip       pt    phi  eta    weights  ----"
+      << endl;
+    std::cout.precision(4);
+    for (unsigned int i0 = 0; i0 < nt; i0++) {
+      unsigned int i = iz[i0];
+      if (tks._Z_sum[i] > 0) {
+	F -= std::log(tks._Z_sum[i]) / beta;
+      }
+      double tz = tks._z[i];
+      double tt = tks._t[i];
+      std::cout << setw(3) << i << ")" << setw(8) << fixed << setprecision(4)
+		<< tz << " +/-" << setw(6) << sqrt(1./tks._dz2[i])
+		<< setw(8) << fixed << setprecision(4) << tt << " +/-" << setw(6) << sqrt(1./tks._dt2[i]);
+
+      const reco::Track & trk = tks.tt[i]->track();
+      if (trk.quality(reco::TrackBase::highPurity)) {
+	std::cout << " *";
+      } else {
+	std::cout << "  ";
+      }
+      if (trk.hitPattern().hasValidHitInPixelLayer(PixelSubdetector::SubDetector::PixelBarrel, 1)) {
+	std::cout << "+";
+      } else {
+	std::cout << "-";
+      }
+      std::cout << setw(1) << trk.hitPattern().pixelBarrelLayersWithMeasurement(); // see DataFormats/TrackReco/interface/HitPattern.h
+      std::cout << setw(1) << trk.hitPattern().pixelEndcapLayersWithMeasurement();
+      std::cout << setw(1) << hex << trk.hitPattern().trackerLayersWithMeasurement() - trk.hitPattern().pixelLayersWithMeasurement() << dec;
+      std::cout << "=" << setw(1) << hex << trk.hitPattern().numberOfHits(reco::HitPattern::MISSING_OUTER_HITS) << dec;
+
+      Measurement1D IP = tks.tt[i]->stateAtBeamLine().transverseImpactParameter();
+      std::cout << setw(8) << IP.value() << "+/-" << setw(6) << IP.error();
+      std::cout << " " << setw(6) << setprecision(2) << trk.pt() * trk.charge();
+      std::cout << " " << setw(5) << setprecision(2) << trk.phi() << " " << setw(5)
+		<< setprecision(2) << trk.eta();
+
+      double sump = 0.;
+      for (unsigned int ivertex = 0; ivertex < nv; ++ ivertex) {
+	if ((tks._pi[i] > 0) && (tks._Z_sum[i] > 0)) {
+	  const double eik = Eik(tks._z[i], y._z[ivertex], tks._dz2[i], tks._t[i], y._t[ivertex], tks._dt2[i]);
+	  double p = y._pk[ivertex] * std::exp(-beta * eik) / tks._Z_sum[i];
+	  if (p > 0.0001) {
+	    std::cout << setw(8) << setprecision(3) << p;
+	  } else {
+	    std::cout << "    .   ";
+	  }
+	  E += p * eik;
+	  sump += p;
+	} else {
+	  std::cout << "        ";
+	}
+      }
+      std::cout << endl;
+    }
+    std::cout << endl << "T=" << 1 / beta << " E=" << E << " n=" << y.GetSize()
+	      << "  F= " << F << endl << "----------" << endl;
+  }
+}
+
+
+
+
+vector<TransientVertex>
+DAClusterizerInZT_vect::vertices(const vector<reco::TransientTrack> & tracks, const int verbosity) const {
+  track_t && tks = fill(tracks);
+  tks.ExtractRaw();
+
+  unsigned int nt = tks.GetSize();
+  double rho0 = 0.0; // start with no outlier rejection
+
+  vector<TransientVertex> clusters;
+  if (tks.GetSize() == 0) return clusters;
+
+  vertex_t y; // the vertex prototypes
+
+  // initialize:single vertex at infinite temperature
+  y.AddItem( 0, 0, 1.0);
+
+  int niter = 0; // number of iterations
+
+
+  // estimate first critical temperature
+  double beta = beta0(betamax_, tks, y);
+  if ( verbose_) std::cout << "Beta0 is " << beta << std::endl;
+
+  niter = 0;
+  while ((update(beta, tks, y) > 1.e-6) &&
+	 (niter++ < maxIterations_)) {}
+
+  // annealing loop, stop when T<Tmin  (i.e. beta>1/Tmin)
+  while (beta < betamax_) {
+    if(useTc_){
+      update(beta, tks, y);
+      while(merge(y, beta)){update(beta, tks, y);}
+      split(beta, tks, y, 1.);
+      beta=beta/coolingFactor_;
+    }else{
+      beta=beta/coolingFactor_;
+      splitAll(y);
+    }
+
+    // make sure we are not too far from equilibrium before cooling further
+    niter = 0;
+    while ((update(beta, tks, y) > 1.e-6) &&
+	   (niter++ < maxIterations_)) {}
+  }
+
+
+  if(useTc_){
+    // last round of splitting, make sure no critical clusters are left
+    update(beta, tks, y);
+    while(merge(y, beta)){update(beta, tks, y);}
+    unsigned int ntry=0;
+    while( split(beta, tks, y, 1.) && (ntry++<10) ){
+      niter=0;
+      while((update(beta, tks, y)>1.e-6)  && (niter++ < maxIterations_)){}
+      merge(y, beta);
+      update(beta, tks, y);
+    }
+  }else{
+    // merge collapsed clusters
+    while(merge(y, beta)){update(beta, tks, y);}
+    if(verbose_ ){ std::cout << "dump after 1st merging " << endl;  dump(beta, y, tks, 2);}
+  }
+
+
+  // switch on outlier rejection
+  rho0 = 1./nt;
+  for (unsigned int k = 0; k < y.GetSize(); k++) { y._pk[k] = 1.; } // democratic
+  niter = 0;
+  while ((update(beta, tks, y, rho0) > 1.e-8) && (niter++ < maxIterations_)) {}
+  if (verbose_) {
+    std::cout << "rho0=" << rho0 << " niter=" << niter << endl;
+    dump(beta, y, tks, 2);
+  }
+
+
+  // merge again  (some cluster split by outliers collapse here)
+  while (merge(y, tks.GetSize())) {}
+  if (verbose_) {
+    std::cout  << "dump after 2nd merging " << endl;
+    dump(beta, y, tks, 2);
+  }
+
+
+  // continue from freeze-out to Tstop (=1) without splitting, eliminate insignificant vertices
+  while (beta <= betastop_) {
+    while (purge(y, tks, rho0, beta)) {
+      niter = 0;
+      while ((update(beta, tks, y, rho0) > 1.e-6) && (niter++ < maxIterations_)) {}
+    }
+    beta /= coolingFactor_;
+    niter = 0;
+    while ((update(beta, tks, y, rho0) > 1.e-6) && (niter++ < maxIterations_)) {}
+  }
+
+  if (verbose_) {
+    std::cout << "Final result, rho0=" << rho0 << endl;
+    dump(beta, y, tks, 2);
+  }
+
+
+  // ensure correct normalization of probabilities, should make double assginment reasonably impossible
+  const unsigned int nv = y.GetSize();
+  for (unsigned int i = 0; i < nt; i++) {
+    tks._Z_sum[i] = rho0 * local_exp(-beta * dzCutOff_ * dzCutOff_);
+    for (unsigned int k = 0; k < nv; k++) {
+      tks._Z_sum[i] += y._pk[k] * local_exp(-beta * Eik(tks._z[i], y._z[k], tks._dz2[i], tks._t[i], y._t[k], tks._dt2[i]));
+    }
+  }
+
+
+  for (unsigned int k = 0; k < nv; k++) {
+    GlobalPoint pos(0, 0, y._z[k]);
+    double time = y._t[k];
+    vector<reco::TransientTrack> vertexTracks;
+    double mean = 0.;
+    double expv_x2 = 0.;
+    double normw = 0.;
+    for (unsigned int i = 0; i < nt; i++) {
+      const double invdt = std::sqrt(tks._dt2[i]);
+      if (tks._Z_sum[i] > 0) {
+	double p = y._pk[k] * local_exp(-beta * Eik(tks._z[i], y._z[k], tks._dz2[i], tks._t[i], y._t[k], tks._dt2[i])) / tks._Z_sum[i];
+	if ((tks._pi[i] > 0) && (p > 0.5)) {
+	  vertexTracks.push_back(*(tks.tt[i]));
+	  tks._Z_sum[i] = 0; // setting Z=0 excludes double assignment
+	  mean     += tks._t[i]*invdt*p;
+	  expv_x2  += tks._t[i]*tks._t[i]*invdt*p;
+	  normw    += invdt*p;
+	}
+      }
+    }
+    mean = mean/normw;
+    expv_x2 = expv_x2/normw;
+    const double time_var = expv_x2 - mean*mean;
+    const double crappy_error_guess = std::sqrt(time_var);
+    GlobalError dummyErrorWithTime(0,
+				   0,0,
+				   0,0,0,
+				   0,0,0,crappy_error_guess);
+    TransientVertex v(pos, time, dummyErrorWithTime, vertexTracks, 5);
+    clusters.push_back(v);
+  }
+
+
+  return clusters;
+
+}
+
+
+
+
+vector<vector<reco::TransientTrack> >
+DAClusterizerInZT_vect::clusterize(const vector<reco::TransientTrack> & tracks)
+  const
+{
+  if (verbose_) {
+    std::cout << "###################################################" << endl;
+    std::cout << "# vectorized DAClusterizerInZT_vect::clusterize   nt=" << tracks.size() << endl;
+    std::cout << "###################################################" << endl;
+  }
+
+  vector<vector<reco::TransientTrack> > clusters;
+  vector<TransientVertex> && pv = vertices(tracks);
+
+  if (verbose_) {
+    std::cout << "# DAClusterizerInZT_vect::clusterize   pv.size=" << pv.size() << endl;
+  }
+  if (pv.size() == 0) {
+    return clusters;
+  }
+
+
+  // fill into clusters and merge
+  vector<reco::TransientTrack> aCluster = pv.begin()->originalTracks();
+
+  for (auto k = pv.begin() + 1; k != pv.end(); k++) {
+    if ( std::abs(k->position().z() - (k - 1)->position().z()) > (2 * vertexSize_) ||
+	 std::abs(k->time() - (k - 1)->time()) > 2 * vertexSizeTime ) {
+      // close a cluster
+      clusters.push_back(aCluster);
+      aCluster.clear();
+    }
+    for (unsigned int i = 0; i < k->originalTracks().size(); i++) {
+      aCluster.push_back(k->originalTracks()[i]);
+    }
+
+  }
+  clusters.emplace_back(std::move(aCluster));
+
+  return clusters;
+
+}
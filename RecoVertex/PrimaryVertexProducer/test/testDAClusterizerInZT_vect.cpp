@@ -0,0 +1,136 @@
+// DAClusterizerInZT_vect (DA2D_vect) against DAClusterizerInZT (DA2D)
+// on events of random vertices in z and t
+
+#include "RecoVertex/PrimaryVertexProducer/interface/DAClusterizerInZT.h"
+#include "RecoVertex/PrimaryVertexProducer/interface/DAClusterizerInZT_vect.h"
+
+#include "DataFormats/BeamSpot/interface/BeamSpot.h"
+#include "DataFormats/TrackReco/interface/Track.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "MagneticField/UniformEngine/interface/UniformMagneticField.h"
+#include "TrackingTools/TransientTrack/interface/TransientTrack.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+  std::mt19937 rng(4242);
+
+  double flat(double a, double b) { return std::uniform_real_distribution<double>(a,b)(rng); }
+  double gauss(double mean, double sigma) { return std::normal_distribution<double>(mean,sigma)(rng); }
+
+  // as TkDAClusParameters of DA2D_vectParameters
+  edm::ParameterSet daParameters() {
+    edm::ParameterSet conf;
+    conf.addParameter<double>("coolingFactor",0.6);
+    conf.addParameter<double>("Tmin",4.);
+    conf.addParameter<double>("vertexSize",0.01);
+    conf.addParameter<double>("d0CutOff",3.);
+    conf.addParameter<double>("dzCutOff",4.);
+    return conf;
+  }
+
+  // tracks from nVertices vertices spread as the luminous region,
+  // with the dz errors of the tracker and the time resolution of the timing layers
+  std::vector<reco::TransientTrack> makeEvent(int nVertices, reco::BeamSpot const & bs, MagneticField const * field) {
+    constexpr double dtError = 0.035; // ns
+    std::vector<reco::TransientTrack> tracks;
+    for (int iv=0; iv!=nVertices; ++iv) {
+      double zv = gauss(0.,4.), tv = gauss(0.,0.18);
+      int nTracks = 4+int(flat(0.,30.));
+      for (int it=0; it!=nTracks; ++it) {
+        double pt = flat(0.7,5.), phi = flat(-M_PI,M_PI), eta = flat(-2.4,2.4);
+        reco::Track::Vector momentum(pt*std::cos(phi), pt*std::sin(phi), pt*std::sinh(eta));
+        double p = pt*std::cosh(eta);
+        double dxyError = flat(0.002,0.02), dzError = flat(0.003,0.05);
+        reco::Track::CovarianceMatrix cov;
+        cov(reco::TrackBase::i_qoverp,reco::TrackBase::i_qoverp) = 1.e-4/(p*p);
+        cov(reco::TrackBase::i_lambda,reco::TrackBase::i_lambda) = 1.e-6;
+        cov(reco::TrackBase::i_phi,reco::TrackBase::i_phi) = 1.e-6;
+        cov(reco::TrackBase::i_dxy,reco::TrackBase::i_dxy) = dxyError*dxyError;
+        cov(reco::TrackBase::i_dsz,reco::TrackBase::i_dsz) = dzError*dzError*pt*pt/(p*p);
+        reco::Track::Point point(gauss(0.,dxyError)*std::sin(phi), -gauss(0.,dxyError)*std::cos(phi), zv+gauss(0.,dzError));
+        reco::Track track(10.,10.,point,momentum,it%2 ? 1 : -1,cov);
+        tracks.emplace_back(track,gauss(tv,dtError),dtError,field);
+        tracks.back().setBeamSpot(bs);
+      }
+    }
+    return tracks;
+  }
+
+  bool byZ(TransientVertex const & a, TransientVertex const & b) {
+    return a.position().z() < b.position().z();
+  }
+
+  // same number of vertices, at the same (z,t) and with the same number of tracks
+  bool sameVertices(std::vector<TransientVertex> a, std::vector<TransientVertex> b) {
+    constexpr double zTolerance = 1.e-3; // cm
+    constexpr double tTolerance = 1.e-3; // ns
+    if (a.size()!=b.size()) {
+      std::cout << a.size() << " vertices against " << b.size() << std::endl;
+      return false;
+    }
+    std::sort(a.begin(),a.end(),byZ);
+    std::sort(b.begin(),b.end(),byZ);
+    bool same = true;
+    for (unsigned int k=0; k!=a.size(); ++k) {
+      double za = a[k].position().z(), zb = b[k].position().z();
+      double ta = a[k].time(), tb = b[k].time();
+      unsigned int na = a[k].originalTracks().size(), nb = b[k].originalTracks().size();
+      if (std::abs(za-zb)>zTolerance || std::abs(ta-tb)>tTolerance || na!=nb) {
+        std::cout << "vertex " << k << ": z " << za << " " << zb << " t " << ta << " " << tb
+                  << " tracks " << na << " " << nb << std::endl;
+        same = false;
+      }
+    }
+    return same;
+  }
+
+}
+
+
+int main() {
+  UniformMagneticField field(3.8);
+  reco::BeamSpot::CovarianceMatrix bsError;
+  for (int i=0; i!=reco::BeamSpot::dimension; ++i) bsError(i,i) = 1.e-8;
+  reco::BeamSpot bs(reco::BeamSpot::Point(0.,0.,0.),4.,0.,0.,0.001,bsError);
+
+  edm::ParameterSet conf = daParameters();
+  DAClusterizerInZT da2d(conf);
+  DAClusterizerInZT_vect da2dVect(conf);
+
+  // the vectorized version uses vdt::fast_exp and sums in another order, a
+  // split or a merge near threshold may go the other way in a few events
+  constexpr int nEvents = 40;
+  int differ = 0;
+  unsigned int found = 0;
+  for (int ievt=0; ievt!=nEvents; ++ievt) {
+    auto tracks = makeEvent(5+ievt, bs, &field);
+    auto reference = da2d.vertices(tracks);
+    auto vect = da2dVect.vertices(tracks);
+    found += reference.size();
+    if (!sameVertices(reference,vect)) {
+      std::cout << "event " << ievt << " differs" << std::endl;
+      ++differ;
+    }
+  }
+
+  int failures = 0;
+  if (found==0) {
+    std::cout << "no vertex found" << std::endl;
+    ++failures;
+  }
+  if (differ > nEvents/10) {
+    std::cout << differ << " of " << nEvents << " events differ" << std::endl;
+    ++failures;
+  }
+  if (failures) {
+    std::cout << failures << " failures" << std::endl;
+    return 1;
+  }
+  return 0;
+}
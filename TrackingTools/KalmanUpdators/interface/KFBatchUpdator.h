@@ -0,0 +1,40 @@
+#ifndef _TRACKER_KFBATCHUPDATOR_H_
+#define _TRACKER_KFBATCHUPDATOR_H_
+
+/** \class KFBatchUpdator
+ * Kalman filter update of several predicted states, each with its own hit.
+ * Gives the same result as KFUpdator hit by hit, up to rounding.
+ *
+ * The 2D hits measuring the local position (pixels, matched and 2D strip hits)
+ * are updated a batch of "width" at a time: the states, covariances and hits
+ * are stored as structures of arrays with one element per lane, and each step
+ * of the update is a loop over the lanes of fixed length, that the compiler
+ * vectorizes. The other hits are updated with KFUpdator.
+ */
+
+#include "TrackingTools/KalmanUpdators/interface/KFUpdator.h"
+#include "TrackingTools/TrajectoryState/interface/TrajectoryStateOnSurface.h"
+
+#include <vector>
+
+class TrackingRecHit;
+
+class KFBatchUpdator {
+
+public:
+
+  static constexpr unsigned int width = 8;
+
+  KFBatchUpdator() {}
+
+  /// update states[i] with hits[i], the results are appended to "updated" in the same order
+  void update(const std::vector<const TrajectoryStateOnSurface*> & states,
+              const std::vector<const TrackingRecHit*> & hits,
+              std::vector<TrajectoryStateOnSurface> & updated) const;
+
+private:
+
+  KFUpdator theUpdator;
+};
+
+#endif
@@ -0,0 +1,163 @@
+#include "TrackingTools/KalmanUpdators/interface/KFBatchUpdator.h"
+#include "DataFormats/TrackingRecHit/interface/TrackingRecHit.h"
+#include "DataFormats/TrackingRecHit/interface/KfComponentsHolder.h"
+#include "DataFormats/Math/interface/ProjectMatrix.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+
+namespace {
+
+  constexpr unsigned int W = KFBatchUpdator::width;
+
+  // index of element (i,j) of a symmetric 5x5 matrix in the packed lower triangle
+  constexpr unsigned int sym(unsigned int i, unsigned int j) {
+    return i>=j ? i*(i+1)/2+j : j*(j+1)/2+i;
+  }
+
+  // W updates with a 2D hit measuring the local position (local parameters 3 and 4),
+  // one per lane. The hits must have the projection H = (0 0 0 1 0, 0 0 0 0 1): the
+  // gain and the filtered covariance use the columns 3 and 4 of the predicted covariance.
+  struct alignas(64) Batch2D {
+    double x[5][W];    // predicted local parameters
+    double c[15][W];   // predicted local covariance (packed)
+    double m[2][W];    // hit local position
+    double v[3][W];    // hit local covariance (xx, xy, yy)
+    double xm[2][W];   // measured parameters, H*x
+    double vm[3][W];   // measured covariance, H*C*H^T
+    double fx[5][W];   // filtered local parameters
+    double fc[15][W];  // filtered local covariance (packed)
+    bool ok[W];        // covariance of the residuals positive definite
+
+    void fill(unsigned int l, const AlgebraicVector5 & lx, const AlgebraicSymMatrix55 & lc,
+              const AlgebraicVector2 & lm, const AlgebraicSymMatrix22 & lv,
+              const AlgebraicVector2 & lxm, const AlgebraicSymMatrix22 & lvm) {
+      for (unsigned int i=0; i<5; ++i) x[i][l] = lx[i];
+      for (unsigned int i=0; i<5; ++i)
+        for (unsigned int j=0; j<=i; ++j) c[sym(i,j)][l] = lc(i,j);
+      m[0][l] = lm[0]; m[1][l] = lm[1];
+      v[0][l] = lv(0,0); v[1][l] = lv(0,1); v[2][l] = lv(1,1);
+      xm[0][l] = lxm[0]; xm[1][l] = lxm[1];
+      vm[0][l] = lvm(0,0); vm[1][l] = lvm(0,1); vm[2][l] = lvm(1,1);
+    }
+
+    // fill the unused lanes with a copy of the last used one
+    void pad(unsigned int n) {
+      for (unsigned int l=n; l<W; ++l) {
+        for (auto & e : x) e[l] = e[n-1];
+        for (auto & e : c) e[l] = e[n-1];
+        for (auto & e : m) e[l] = e[n-1];
+        for (auto & e : v) e[l] = e[n-1];
+        for (auto & e : xm) e[l] = e[n-1];
+        for (auto & e : vm) e[l] = e[n-1];
+      }
+    }
+
+    void update() {
+      // inverse of the covariance of the residuals (as fastInvertPDM2), and residuals;
+      // the lanes where it is not positive definite give garbage, flagged in "ok"
+      double ri[3][W], r[2][W];
+      for (unsigned int l=0; l<W; ++l) {
+        const double m0 = v[0][l] + vm[0][l];
+        const double m1 = v[1][l] + vm[1][l];
+        const double m2 = v[2][l] + vm[2][l];
+        const double c0 = 1./m0;
+        const double c1 = m1*m1*c0;
+        const double c2 = 1./(m2 - c1);
+        ok[l] = m0>0 && m2-c1>0;
+        ri[0][l] = c1*c0*c2 + c0;
+        ri[1][l] = -m1*c0*c2;
+        ri[2][l] = c2;
+        r[0][l] = m[0][l] - xm[0][l];
+        r[1][l] = m[1][l] - xm[1][l];
+      }
+
+      // Kalman gain and filtered parameters
+      double k[5][2][W];
+      for (unsigned int i=0; i<5; ++i)
+        for (unsigned int l=0; l<W; ++l) {
+          k[i][0][l] = c[sym(i,3)][l]*ri[0][l] + c[sym(i,4)][l]*ri[1][l];
+          k[i][1][l] = c[sym(i,3)][l]*ri[1][l] + c[sym(i,4)][l]*ri[2][l];
+          fx[i][l] = x[i][l] + (k[i][0][l]*r[0][l] + k[i][1][l]*r[1][l]);
+        }
+
+      // filtered covariance, M*C*M^T + K*V*K^T with M = 1 - K*H
+      double a[5][5][W];
+      for (unsigned int i=0; i<5; ++i)
+        for (unsigned int j=0; j<5; ++j)
+          for (unsigned int l=0; l<W; ++l)
+            a[i][j][l] = c[sym(i,j)][l] - k[i][0][l]*c[sym(3,j)][l] - k[i][1][l]*c[sym(4,j)][l];
+      for (unsigned int i=0; i<5; ++i)
+        for (unsigned int j=0; j<=i; ++j)
+          for (unsigned int l=0; l<W; ++l) {
+            const double kv0 = v[0][l]*k[j][0][l] + v[1][l]*k[j][1][l];
+            const double kv1 = v[1][l]*k[j][0][l] + v[2][l]*k[j][1][l];
+            fc[sym(i,j)][l] = a[i][j][l] - a[i][3][l]*k[j][0][l] - a[i][4][l]*k[j][1][l]
+              + k[i][0][l]*kv0 + k[i][1][l]*kv1;
+          }
+    }
+
+    TrajectoryStateOnSurface result(unsigned int l, const TrajectoryStateOnSurface & tsos) const {
+      if (!ok[l]) {
+        AlgebraicSymMatrix22 R;
+        R(0,0) = v[0][l] + vm[0][l]; R(0,1) = v[1][l] + vm[1][l]; R(1,1) = v[2][l] + vm[2][l];
+        edm::LogError("KFBatchUpdator")<<" could not invert martix:\n"<< R;
+        return TrajectoryStateOnSurface();
+      }
+      AlgebraicVector5 lx;
+      for (unsigned int i=0; i<5; ++i) lx[i] = fx[i][l];
+      AlgebraicSymMatrix55 lc;
+      for (unsigned int i=0; i<5; ++i)
+        for (unsigned int j=0; j<=i; ++j) lc(i,j) = fc[sym(i,j)][l];
+      return TrajectoryStateOnSurface( LocalTrajectoryParameters(lx, tsos.localParameters().pzSign()),
+                                       LocalTrajectoryError(lc), tsos.surface(),
+                                       &(tsos.globalParameters().magneticField()), tsos.surfaceSide() );
+    }
+  };
+
+}
+
+void KFBatchUpdator::update(const std::vector<const TrajectoryStateOnSurface*> & states,
+                            const std::vector<const TrackingRecHit*> & hits,
+                            std::vector<TrajectoryStateOnSurface> & updated) const {
+  const unsigned int first = updated.size();
+  updated.resize(first + states.size());
+
+  Batch2D batch;
+  unsigned int lanes[W];
+  unsigned int n = 0;
+  auto flush = [&]() {
+    if (n==0) return;
+    batch.pad(n);
+    batch.update();
+    for (unsigned int l=0; l<n; ++l)
+      updated[first+lanes[l]] = batch.result(l, *states[lanes[l]]);
+    n = 0;
+  };
+
+  for (unsigned int i=0; i<states.size(); ++i) {
+    const TrajectoryStateOnSurface & tsos = *states[i];
+    const TrackingRecHit & hit = *hits[i];
+    if (hit.dimension()!=2) {
+      updated[first+i] = theUpdator.update(tsos, hit);
+      continue;
+    }
+
+    auto && x = tsos.localParameters().vector();
+    auto && C = tsos.localError().matrix();
+    ProjectMatrix<double,5,2> pf;
+    AlgebraicVector2 r, rMeas;
+    AlgebraicSymMatrix22 V, VMeas;
+    KfComponentsHolder holder;
+    holder.setup<2>(&r, &V, &pf, &rMeas, &VMeas, x, C);
+    hit.getKfComponents(holder);
+    // only the local position hits take the batch path
+    if (pf.index[0]!=3 || pf.index[1]!=4) {
+      updated[first+i] = theUpdator.update(tsos, hit);
+      continue;
+    }
+
+    batch.fill(n, x, C, r, V, rMeas, VMeas);
+    lanes[n++] = i;
+    if (n==W) flush();
+  }
+  flush();
+}
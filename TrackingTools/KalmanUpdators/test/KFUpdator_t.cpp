@@ -1,4 +1,5 @@
 #include "TrackingTools/KalmanUpdators/interface/KFUpdator.h"
+#include "TrackingTools/KalmanUpdators/interface/KFBatchUpdator.h"
 #include "TrackingTools/KalmanUpdators/interface/Chi2MeasurementEstimator.h"
 
 #include "TrackingTools/TrajectoryState/interface/TrajectoryStateOnSurface.h"
@@ -102,6 +103,9 @@ void print(TrajectoryStateOnSurface const & ts) {
 #include "FWCore/Utilities/interface/HRRealTime.h"
 #include<iostream>
 #include<vector>
+#include<algorithm>
+#include<cmath>
+#include<cassert>
 
 bool isAligned(const void* data, long alignment)
 {
@@ -257,6 +261,42 @@ int main() {
   chi2.time(ts2,*thit);
 
 
+  std::cout << "\n** batch KFU ** \n" << std::endl;
+
+  // more states than the batch width, mixing hits updated in batch and not
+  std::vector<const TrajectoryStateOnSurface*> states;
+  std::vector<const TrackingRecHit*> hits;
+  for (int i=0; i<3; ++i) {
+    for (auto const * h : std::vector<const TrackingRecHit*>{thit,&hit2d,&hitpx,&hitpj,&hit1d}) {
+      states.push_back(i%2 ? &ts : &ts2);
+      hits.push_back(h);
+    }
+  }
+  std::vector<TrajectoryStateOnSurface> updated;
+  KFBatchUpdator().update(states,hits,updated);
+  assert(updated.size()==states.size());
+  KFUpdator kfu;
+  double maxDiff=0;
+  for (unsigned int i=0; i<states.size(); ++i) {
+    TrajectoryStateOnSurface ref = kfu.update(*states[i],*hits[i]);
+    for (int j=0; j<5; ++j) {
+      maxDiff = std::max(maxDiff,std::abs(ref.localParameters().vector()[j]-updated[i].localParameters().vector()[j]));
+      for (int k=0; k<5; ++k)
+        maxDiff = std::max(maxDiff,std::abs(ref.localError().matrix()(j,k)-updated[i].localError().matrix()(j,k)));
+    }
+  }
+  std::cout << "max difference to KFUpdator " << maxDiff << std::endl;
+  assert(maxDiff<1.e-9);
+
+  // a hit with a covariance that makes the residual one not positive definite
+  // gives an invalid state in its lane only
+  SiPixelRecHit hitbad(m,LocalError(-1.,0.,-1.),1.,*det,pref);
+  states.assign(3,&ts2);
+  hits.assign({&hitpx,&hitbad,&hitpx});
+  updated.clear();
+  KFBatchUpdator().update(states,hits,updated);
+  assert(updated[0].isValid() && updated[2].isValid());
+  assert(!updated[1].isValid());
 
   return 0;
 
@@ -0,0 +1,47 @@
+#ifndef STORAGE_FACTORY_MEMORY_MAPPED_FILE_H
+# define STORAGE_FACTORY_MEMORY_MAPPED_FILE_H
+
+# include "Utilities/StorageFactory/interface/Storage.h"
+# include "Utilities/StorageFactory/interface/File.h"
+# include <string>
+
+/** Read-only local file accessed through a memory mapping of the whole
+    file.  Reads are plain copies out of the page cache, without a system
+    call per request; the kernel is told to read ahead sequentially.  */
+class MemoryMappedFile : public Storage
+{
+public:
+  MemoryMappedFile (const std::string &name, int flags = IOFlags::OpenRead);
+  ~MemoryMappedFile (void);
+
+  using Storage::read;
+  using Storage::write;
+  using Storage::position;
+
+  virtual bool		prefetch (const IOPosBuffer *what, IOSize n);
+  virtual IOSize	read (void *into, IOSize n);
+  virtual IOSize	read (void *into, IOSize n, IOOffset pos);
+  virtual IOSize	readv (IOBuffer *into, IOSize n);
+  virtual IOSize	readv (IOPosBuffer *into, IOSize n);
+  virtual IOSize	write (const void *from, IOSize n);
+  virtual IOSize	write (const void *from, IOSize n, IOOffset pos);
+  virtual IOSize	writev (const IOBuffer *from, IOSize n);
+  virtual IOSize	writev (const IOPosBuffer *from, IOSize n);
+
+  virtual IOOffset	size (void) const;
+  virtual IOOffset	position (IOOffset offset, Relative whence = SET);
+  virtual void		resize (IOOffset size);
+  virtual void		flush (void);
+  virtual void		close (void);
+
+private:
+  IOSize		copy (void *into, IOSize n, IOOffset pos) const;
+  void			unmap (void);
+
+  File			file_;
+  const char		*data_;
+  IOOffset		size_;
+  IOOffset		position_;
+};
+
+#endif // STORAGE_FACTORY_MEMORY_MAPPED_FILE_H
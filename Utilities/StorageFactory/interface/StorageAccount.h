@@ -23,6 +23,10 @@ public:
     prefetch,
     read,
     readActual,
+    readAhead,
+    readAheadHit,
+    readAheadMiss,
+    readAheadWasted,
     readAsync,
     readPrefetchToCache,
     readViaCache,
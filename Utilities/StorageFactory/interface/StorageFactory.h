@@ -25,7 +25,8 @@ public:
   {
     READ_HINT_UNBUFFERED,
     READ_HINT_READAHEAD,
-    READ_HINT_AUTO
+    READ_HINT_AUTO,
+    READ_HINT_MMAP
   };
 
   static const StorageFactory *get (void);
@@ -51,11 +52,17 @@ public:
   void          setDebugLevel(unsigned int level);
   unsigned int  debugLevel(void) const;
 
+  void		setPrefetchClusters(unsigned int clusters, IOSize poolSize);
+  unsigned int	prefetchClusters(void) const;
+  IOSize	prefetchPoolSize(void) const;
+
   void		setTempDir (const std::string &s, double minFreeSpace);
   std::string	tempDir (void) const;
   std::string	tempPath (void) const;
   double	tempMinFree (void) const;
 
+  bool		isLocalPath (const std::string &path) const;
+
   void		stagein (const std::string &url) const;
   std::unique_ptr<Storage>	open (const std::string &url,
 	    	      int mode = IOFlags::OpenRead) const;
@@ -86,6 +93,8 @@ private:
   std::string m_unusableDirWarnings;
   unsigned int  m_timeout;
   unsigned int  m_debugLevel;
+  unsigned int  m_prefetchClusters;
+  IOSize        m_prefetchPoolSize;
   LocalFileSystem m_lfs;
   static StorageFactory s_instance;
 };
@@ -4,6 +4,7 @@
 #include "Utilities/StorageFactory/interface/StorageMakerFactory.h"
 #include "Utilities/StorageFactory/interface/StorageFactory.h"
 #include "Utilities/StorageFactory/interface/File.h"
+#include "Utilities/StorageFactory/interface/MemoryMappedFile.h"
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <unistd.h>
@@ -20,6 +21,13 @@ public:
       StorageFactory::ReadHint readHint = f->readHint();
       StorageFactory::CacheHint cacheHint = f->cacheHint();
 
+      // Memory-map read-only input, but only on file systems known to be
+      // local; network file systems keep going through plain reads.
+      if (readHint == StorageFactory::READ_HINT_MMAP
+	  && ! (mode & (IOFlags::OpenWrite | IOFlags::OpenWrap))
+	  && f->isLocalPath(path))
+	return std::make_unique<MemoryMappedFile> (path, mode);
+
       if (readHint != StorageFactory::READ_HINT_UNBUFFERED
 	  || cacheHint == StorageFactory::CACHE_HINT_STORAGE)
 	mode &= ~IOFlags::OpenUnbuffered;
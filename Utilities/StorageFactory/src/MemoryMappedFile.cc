@@ -0,0 +1,164 @@
+#include "Utilities/StorageFactory/interface/MemoryMappedFile.h"
+#include "Utilities/StorageFactory/src/Throw.h"
+#include "FWCore/Utilities/interface/EDMException.h"
+#include <algorithm>
+#include <cassert>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <errno.h>
+
+static void
+nowrite(const std::string &why)
+{
+  cms::Exception ex("MemoryMappedFile");
+  ex << "Cannot change file but operation '" << why << "' was called";
+  ex.addContext("MemoryMappedFile::" + why + "()");
+  throw ex;
+}
+
+MemoryMappedFile::MemoryMappedFile(const std::string &name, int flags /* = IOFlags::OpenRead */)
+  : file_(name, flags & ~(IOFlags::OpenWrite | IOFlags::OpenUnbuffered)),
+    data_(nullptr),
+    size_(file_.size()),
+    position_(0)
+{
+  // An empty file cannot be mapped; every read is then at end of file.
+  if (size_ == 0)
+    return;
+
+  void *window = mmap(0, size_, PROT_READ, MAP_SHARED, file_.fd(), 0);
+  if (window == MAP_FAILED)
+    throwStorageError(edm::errors::FileOpenError, "Calling MemoryMappedFile::MemoryMappedFile()", "mmap()", errno);
+
+  // ROOT reads the baskets of a cluster mostly in increasing file order.
+  // The hint is only advisory, so a failure is not an error.
+  madvise(window, size_, MADV_SEQUENTIAL);
+  data_ = static_cast<const char *>(window);
+}
+
+MemoryMappedFile::~MemoryMappedFile(void)
+{
+  unmap();
+}
+
+void
+MemoryMappedFile::unmap(void)
+{
+  if (data_)
+  {
+    munmap(const_cast<char *>(data_), size_);
+    data_ = nullptr;
+  }
+}
+
+IOSize
+MemoryMappedFile::copy(void *into, IOSize n, IOOffset pos) const
+{
+  assert (pos >= 0);
+  if (! data_ || pos >= size_)
+    return 0;
+
+  n = std::min(n, IOSized(size_ - pos));
+  memcpy(into, data_ + pos, n);
+  return n;
+}
+
+IOSize
+MemoryMappedFile::read(void *into, IOSize n)
+{
+  IOSize s = copy(into, n, position_);
+  position_ += s;
+  return s;
+}
+
+IOSize
+MemoryMappedFile::read(void *into, IOSize n, IOOffset pos)
+{ return copy(into, n, pos); }
+
+IOSize
+MemoryMappedFile::readv(IOBuffer *into, IOSize n)
+{
+  IOSize total = 0;
+  for (IOSize i = 0; i < n; ++i)
+    total += read(into[i].data(), into[i].size());
+  return total;
+}
+
+IOSize
+MemoryMappedFile::readv(IOPosBuffer *into, IOSize n)
+{
+  IOSize total = 0;
+  for (IOSize i = 0; i < n; ++i)
+    total += copy(into[i].data(), into[i].size(), into[i].offset());
+  return total;
+}
+
+IOSize
+MemoryMappedFile::write(const void */*from*/, IOSize)
+{ nowrite("write"); return 0; }
+
+IOSize
+MemoryMappedFile::write(const void */*from*/, IOSize, IOOffset /*pos*/)
+{ nowrite("write"); return 0; }
+
+IOSize
+MemoryMappedFile::writev(const IOBuffer */*from*/, IOSize)
+{ nowrite("writev"); return 0; }
+
+IOSize
+MemoryMappedFile::writev(const IOPosBuffer */*from*/, IOSize)
+{ nowrite("writev"); return 0; }
+
+IOOffset
+MemoryMappedFile::size(void) const
+{ return size_; }
+
+IOOffset
+MemoryMappedFile::position(IOOffset offset, Relative whence /* = SET */)
+{
+  assert (whence == CURRENT || whence == SET || whence == END);
+  IOOffset result = (whence == SET ? offset
+		     : whence == CURRENT ? position_ + offset
+		     : size_ + offset);
+  if (result < 0)
+    throwStorageError("FilePositionError", "Calling MemoryMappedFile::position()", "seek", EINVAL);
+
+  position_ = result;
+  return position_;
+}
+
+void
+MemoryMappedFile::resize(IOOffset /*size*/)
+{ nowrite("resize"); }
+
+void
+MemoryMappedFile::flush(void)
+{ nowrite("flush"); }
+
+void
+MemoryMappedFile::close(void)
+{
+  unmap();
+  file_.close();
+}
+
+bool
+MemoryMappedFile::prefetch(const IOPosBuffer *what, IOSize n)
+{
+  if (! data_)
+    return false;
+
+  // Answer the ROOT probe (see Storage.h), then ask the kernel to start
+  // reading the pages in the background.
+  long pageSize = sysconf(_SC_PAGESIZE);
+  for (IOSize i = 0; i < n; ++i)
+  {
+    IOOffset start = std::min(what[i].offset(), size_);
+    IOOffset end = std::min(what[i].offset() + static_cast<IOOffset>(what[i].size()), size_);
+    start -= start % pageSize;
+    if (end > start)
+      madvise(const_cast<char *>(data_) + start, end - start, MADV_WILLNEED);
+  }
+  return true;
+}
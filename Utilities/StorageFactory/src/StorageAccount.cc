@@ -17,6 +17,10 @@ namespace {
     "prefetch",
     "read",
     "readActual",
+    "readAhead",
+    "readAheadHit",
+    "readAheadMiss",
+    "readAheadWasted",
     "readAsync",
     "readPrefetchToCache",
     "readViaCache",
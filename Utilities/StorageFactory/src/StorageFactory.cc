@@ -17,7 +17,9 @@ StorageFactory::StorageFactory (void)
     m_tempfree (4.), // GB
     m_temppath (".:$TMPDIR"),
     m_timeout(0U),
-    m_debugLevel(0U)
+    m_debugLevel(0U),
+    m_prefetchClusters(0U),
+    m_prefetchPoolSize(0U)
 {
   setTempDir(m_temppath, m_tempfree);
 }
@@ -78,6 +80,21 @@ unsigned int
 StorageFactory::debugLevel(void) const
 { return m_debugLevel; }
 
+void
+StorageFactory::setPrefetchClusters(unsigned int clusters, IOSize poolSize)
+{
+  m_prefetchClusters = clusters;
+  m_prefetchPoolSize = poolSize;
+}
+
+unsigned int
+StorageFactory::prefetchClusters(void) const
+{ return m_prefetchClusters; }
+
+IOSize
+StorageFactory::prefetchPoolSize(void) const
+{ return m_prefetchPoolSize; }
+
 void
 StorageFactory::setTempDir(const std::string &s, double minFreeSpace)
 {
@@ -130,6 +147,10 @@ double
 StorageFactory::tempMinFree(void) const
 { return m_tempfree; }
 
+bool
+StorageFactory::isLocalPath(const std::string &path) const
+{ return m_lfs.isLocalPath(path); }
+
 StorageMaker *
 StorageFactory::getMaker (const std::string &proto) const
 {
@@ -0,0 +1,71 @@
+#include "Utilities/StorageFactory/test/Test.h"
+#include "Utilities/StorageFactory/interface/Storage.h"
+#include "Utilities/StorageFactory/interface/File.h"
+#include "Utilities/StorageFactory/interface/MemoryMappedFile.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include <cstring>
+
+int main (int, char **/*argv*/) try
+{
+  initTest();
+
+  StorageFactory::getToModify ()->setReadHint (StorageFactory::READ_HINT_MMAP);
+
+  // The hint must select the memory mapped implementation for a local file;
+  // without the accounting, the storage is not wrapped in a StorageAccountProxy.
+  bool accounting = StorageFactory::getToModify ()->enableAccounting (false);
+  auto unwrapped = StorageFactory::get ()->open ("/etc/passwd");
+  StorageFactory::getToModify ()->enableAccounting (accounting);
+  if (StorageFactory::get ()->isLocalPath ("/etc/passwd")
+      && ! dynamic_cast<MemoryMappedFile *> (unwrapped.get ()))
+  {
+    std::cerr << "the storage is not a MemoryMappedFile" << std::endl;
+    return EXIT_FAILURE;
+  }
+  unwrapped->close ();
+
+  auto s = StorageFactory::get ()->open ("/etc/passwd");
+  File		f ("/etc/passwd");
+  char		mapped [256];
+  char		plain [256];
+  IOSize	n;
+  IOOffset	pos = 0;
+
+  // Sequential reads must give the same bytes as plain reads.
+  while ((n = s->read (mapped, sizeof (mapped))))
+  {
+    if (f.read (plain, n, pos) != n || memcmp (mapped, plain, n) != 0)
+    {
+      std::cerr << "mismatch at offset " << pos << std::endl;
+      return EXIT_FAILURE;
+    }
+    pos += n;
+  }
+  if (pos != s->size ())
+  {
+    std::cerr << "read " << pos << " bytes out of " << s->size () << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // So must vectored reads, including one past the end of file.
+  IOPosBuffer	iov [2] = { IOPosBuffer (1, mapped, 16), IOPosBuffer (pos - 8, mapped + 16, 16) };
+  if (s->readv (iov, 2) != 24
+      || f.read (plain, 16, 1) != 16
+      || memcmp (mapped, plain, 16) != 0)
+  {
+    std::cerr << "vectored read mismatch" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  s->close();
+  f.close();
+
+  std::cout << StorageAccount::summaryText (true) << std::endl;
+  return EXIT_SUCCESS;
+} catch(cms::Exception const& e) {
+  std::cerr << e.explainSelf() << std::endl;
+  return EXIT_FAILURE;
+} catch(std::exception const& e) {
+  std::cerr << e.what() << std::endl;
+  return EXIT_FAILURE;
+}